@@ -0,0 +1,18 @@
+import type { HttpContext } from '@adonisjs/core/http'
+
+export default class StationBenchmarkController {
+  /**
+   * Accepts a request body and discards it, for the firmware's HTTP transport benchmark.
+   *
+   * POST /stations/:station_id/benchmark
+   * Body: any
+   *
+   * Nothing is validated, stored or broadcast, so the station can post real
+   * telemetry bodies without them showing up as data. The answer is as short
+   * as the telemetry endpoints' and reports the body size that arrived.
+   */
+  async store({ request, response }: HttpContext) {
+    const bytes = Number(request.header('content-length') ?? 0)
+    return response.ok({ ok: true, bytes })
+  }
+}
@@ -1,5 +1,7 @@
 import type { HttpContext } from '@adonisjs/core/http'
 import StationConfig from '#app/models/station_config'
+import { configEtag, currentConfigBody } from '#app/services/station_config_version'
+import { configVersionCache } from '#app/services/config_version_cache'
 
 // Define a type that supports indexing with strings
 type ConfigRecord = Record<string, any>
@@ -7,37 +9,26 @@ type ConfigRecord = Record<string, any>
 export default class StationConfigsController {
   /**
    * Get the current configuration for a station
+   *
+   * The response carries an ETag. The firmware sends it back as If-None-Match and
+   * gets 304 Not Modified without a body while the configuration is unchanged.
    */
-  async show({ params, response }: HttpContext) {
+  async show({ params, request, response }: HttpContext) {
     const stationId = params.station_id
 
     try {
-      // Get the latest config for the station
-      const config = await StationConfig.query()
-        .where('stationId', stationId)
-        .orderBy('id', 'desc')
-        .first()
-
-      if (!config) {
-        return {
-          stationId: stationId,
-          tempInterval: null,
-          windSendInterval: null,
-          windSampleInterval: null,
-          diagInterval: null,
-          timeInterval: null,
-          restartInterval: null,
-          sleepStartHour: null,
-          sleepEndHour: null,
-          otaHour: null,
-          otaMinute: null,
-          otaDuration: null,
-          remoteOta: false,
-          message: 'No configuration found for this station. Default values will be used.',
-        }
+      const snapshot = configVersionCache.snapshot()
+      const body = await currentConfigBody(stationId)
+
+      const etag = configEtag(body)
+      // The config was read anyway; refresh the version the telemetry responses announce
+      configVersionCache.set(stationId, etag, snapshot)
+      response.header('ETag', etag)
+      if (request.fresh()) {
+        return response.notModified()
       }
 
-      return config
+      return body
     } catch (error) {
       console.error(`Error fetching configuration for station ${stationId}:`, error)
       return response.status(500).json({ error: 'Failed to fetch station configuration' })
@@ -78,13 +69,15 @@ export default class StationConfigsController {
         'otaMinute',
         'otaDuration',
         'remoteOta',
+        'windBatchSize',
+        'coapTelemetry',
       ]
 
       // Process numeric fields
       for (const field of validFields) {
         if (data[field] !== undefined) {
-          // Skip the boolean field (handle separately)
-          if (field === 'remoteOta') continue
+          // Skip the boolean fields (handle separately)
+          if (field === 'remoteOta' || field === 'coapTelemetry') continue
 
           const value = Number(data[field])
           if (isNaN(value)) {
@@ -99,6 +92,29 @@ export default class StationConfigsController {
         configData.remoteOta = Boolean(data.remoteOta)
       }
 
+      // Handle coapTelemetry flag (boolean, null keeps the station's setting)
+      if (data.coapTelemetry !== undefined) {
+        configData.coapTelemetry = data.coapTelemetry === null ? null : Boolean(data.coapTelemetry)
+      }
+
+      // Handle wind vane calibration (8 distinct 12-bit ADC levels, N to NW)
+      if (data.vaneCalibration !== undefined && data.vaneCalibration !== null) {
+        const levels = data.vaneCalibration
+        const isValid =
+          Array.isArray(levels) &&
+          levels.length === 8 &&
+          levels.every((level) => Number.isInteger(level) && level >= 0 && level <= 4095) &&
+          new Set(levels).size === levels.length
+
+        if (!isValid) {
+          return response.badRequest({
+            error:
+              'Invalid value for vaneCalibration. Must be 8 distinct integers between 0 and 4095.',
+          })
+        }
+        configData.vaneCalibration = levels
+      }
+
       // Add stationId to the data
       configData.stationId = stationId
 
@@ -153,6 +169,9 @@ export default class StationConfigsController {
         otaMinute: config.otaMinute,
         otaDuration: config.otaDuration,
         remoteOta: false, // Reset the OTA flag
+        vaneCalibration: config.vaneCalibration,
+        windBatchSize: config.windBatchSize,
+        coapTelemetry: config.coapTelemetry,
       }
 
       await StationConfig.create(configData)
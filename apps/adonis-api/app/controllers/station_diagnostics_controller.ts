@@ -1,7 +1,6 @@
 import type { HttpContext } from '@adonisjs/core/http'
-import transmit from '@adonisjs/transmit/services/main'
 import StationDiagnostic from '#app/models/station_diagnostic'
-import { stationDataCache } from '#app/services/station_data_cache'
+import { recordDiagnostics, validateDiagnostics } from '#app/services/station_telemetry'
 
 export default class StationDiagnosticsController {
   /**
@@ -15,53 +14,12 @@ export default class StationDiagnosticsController {
     const data = request.body()
 
     try {
-      // Validate required fields
-      const { batteryVoltage, solarVoltage, signalQuality, uptime } = data
-      if (
-        typeof batteryVoltage !== 'number' ||
-        typeof solarVoltage !== 'number' ||
-        typeof signalQuality !== 'number' ||
-        typeof uptime !== 'number'
-      ) {
-        return response.badRequest({
-          error:
-            'Invalid diagnostics data. Required fields: batteryVoltage, solarVoltage, signalQuality, uptime',
-        })
+      const error = validateDiagnostics(data)
+      if (error) {
+        return response.badRequest({ error })
       }
 
-      // Prepare diagnostics data with timestamp
-      const diagnosticsData = {
-        ...data,
-        timestamp: data.timestamp || arrivalTimestamp,
-      }
-
-      // Cache the diagnostics data
-      stationDataCache.setDiagnosticsData(stationId, {
-        batteryVoltage,
-        solarVoltage,
-        signalQuality,
-        uptime,
-        internalTemperature: data.internalTemperature,
-        timestamp: diagnosticsData.timestamp,
-      })
-
-      // Save diagnostics to database
-      await StationDiagnostic.create({
-        stationId: stationId,
-        batteryVoltage: batteryVoltage,
-        solarVoltage: solarVoltage,
-        internalTemperature: data.internalTemperature || null,
-        signalQuality: signalQuality,
-        uptime: uptime,
-      })
-
-      // Broadcast the diagnostics data via Transmit
-      await transmit.broadcast(`station/diagnostics/${stationId}`, diagnosticsData)
-
-      // Log diagnostics in development
-      if (process.env.NODE_ENV === 'development') {
-        console.log(`Diagnostics for station ${stationId}:`, diagnosticsData)
-      }
+      await recordDiagnostics(stationId, data, arrivalTimestamp)
 
       return { ok: true }
     } catch (error) {
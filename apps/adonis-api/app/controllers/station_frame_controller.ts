@@ -0,0 +1,85 @@
+import type { HttpContext } from '@adonisjs/core/http'
+import {
+  recordDiagnostics,
+  recordTemperature,
+  recordWind,
+  validateDiagnostics,
+  validateTemperature,
+  validateWind,
+} from '#app/services/station_telemetry'
+
+// Parts a frame can carry, in the order they are recorded
+const FRAME_PARTS = ['wind', 'temperature', 'diagnostics'] as const
+type FramePart = (typeof FRAME_PARTS)[number]
+
+const validators: Record<FramePart, (body: Record<string, any>) => string | null> = {
+  wind: validateWind,
+  temperature: validateTemperature,
+  diagnostics: validateDiagnostics,
+}
+
+function isObject(value: unknown): value is Record<string, any> {
+  return value !== null && typeof value === 'object' && !Array.isArray(value)
+}
+
+export default class StationFrameController {
+  /**
+   * Receives the readings a station had due at about the same time in one request.
+   *
+   * POST /stations/:station_id/frame
+   * Body: { wind?: {...}, temperature?: {...}, diagnostics?: {...}, timestamp?: string }
+   *
+   * Each part has the body its own endpoint takes (POST /wind, /temperature,
+   * /diagnostics) and is processed the same way. A frame-level timestamp applies
+   * to the parts that carry none. Each part is validated on its own: the valid
+   * parts are recorded and the invalid ones listed under `rejected`, so one bad
+   * part does not lose readings that would have been stored if posted on their
+   * own. The station does not resend a frame answered with 4xx. Only a frame
+   * without any valid part is rejected as a whole.
+   */
+  async store({ params, request, response }: HttpContext) {
+    // Capture arrival timestamp immediately for accuracy
+    const arrivalTimestamp = new Date().toISOString()
+
+    const stationId = params.station_id
+    const frame = request.body()
+    const frameTimestamp = typeof frame.timestamp === 'string' ? frame.timestamp : undefined
+
+    const parts = FRAME_PARTS.filter((part) => frame[part] !== undefined)
+    if (parts.length === 0) {
+      return response.badRequest({ error: 'Empty frame' })
+    }
+
+    const bodies: Partial<Record<FramePart, Record<string, any>>> = {}
+    const rejected: { part: FramePart; error: string }[] = []
+    for (const part of parts) {
+      const body = frame[part]
+      const error = isObject(body) ? validators[part](body) : 'Invalid frame part'
+      if (error) {
+        rejected.push({ part, error })
+        continue
+      }
+      bodies[part] = frameTimestamp && body.timestamp === undefined ? { ...body, timestamp: frameTimestamp } : body
+    }
+
+    const recorded = parts.filter((part) => bodies[part] !== undefined)
+    if (recorded.length === 0) {
+      return response.badRequest({ ...rejected[0], rejected })
+    }
+    if (rejected.length > 0) {
+      console.warn(`Frame from station ${stationId} with rejected parts:`, rejected)
+    }
+
+    if (bodies.wind) {
+      await recordWind(stationId, bodies.wind, arrivalTimestamp)
+    }
+    if (bodies.temperature) {
+      await recordTemperature(stationId, bodies.temperature, arrivalTimestamp)
+    }
+    if (bodies.diagnostics) {
+      await recordDiagnostics(stationId, bodies.diagnostics, arrivalTimestamp)
+    }
+
+    return rejected.length > 0 ? { ok: true, parts: recorded, rejected } : { ok: true, parts: recorded }
+  }
+}
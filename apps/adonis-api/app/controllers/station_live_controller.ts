@@ -2,6 +2,14 @@ import type { HttpContext } from '@adonisjs/core/http'
 import transmit from '@adonisjs/transmit/services/main'
 import { stationDataCache } from '#app/services/station_data_cache'
 import { windAggregationService } from '#app/services/wind_aggregation_service'
+import { recordWind, validateWind } from '#app/services/station_telemetry'
+import {
+  TELEMETRY_CONTENT_TYPE,
+  TelemetryDecodeError,
+  TelemetryRecordType,
+  decodeTelemetry,
+  type TelemetryRecord,
+} from '#app/services/telemetry_codec'
 
 // In-memory interval map for dev-only mock streaming
 interface MockStationData {
@@ -11,6 +19,30 @@ interface MockStationData {
 }
 const mockStationStates: Record<string, MockStationData> = {}
 
+// The firmware sends at most 60 buffered livestream readings per request (WindSampleBatch::CAPACITY)
+const MAX_WIND_BATCH_SAMPLES = 60
+
+// The firmware sends at most 12 completed buckets per request (WindAggregateBatch::CAPACITY)
+const MAX_WIND_AGGREGATES = 12
+
+/**
+ * Decode the body of a binary telemetry request.
+ * Returns undefined for other content types and null if the record is malformed.
+ */
+function telemetryRecord(request: HttpContext['request']): TelemetryRecord | null | undefined {
+  if (!request.is([TELEMETRY_CONTENT_TYPE])) {
+    return undefined
+  }
+  try {
+    return decodeTelemetry(Buffer.from(request.raw() ?? '', 'latin1'))
+  } catch (error) {
+    if (error instanceof TelemetryDecodeError) {
+      return null
+    }
+    throw error
+  }
+}
+
 export default class StationLiveController {
   /**
    * Receives wind data and broadcasts it via Transmit SSE for real-time updates.
@@ -24,43 +56,204 @@ export default class StationLiveController {
    * - Development and testing purposes
    * - IoT/CoAP proxy integration
    *
-   * Body: { windSpeed: number, windDirection: number, timestamp?: string }
+   * Body: { windSpeed: number, windDirection: number, timestamp?: string, windGust?: number, windLull?: number }
+   *
+   * Averaged readings from the firmware also carry the 3 s gust and lull of the period,
+   * and optionally a windRose histogram of [sector, speedBin, count] triples.
+   *
+   * The same fields are accepted as a binary reading or summary record with
+   * Content-Type application/vnd.aiolos.telemetry (see telemetry_codec.ts).
    */
   async wind({ params, request, response }: HttpContext) {
     // Capture arrival timestamp immediately for accuracy
     const arrivalTimestamp = new Date().toISOString()
 
     const { station_id } = params
-    const { windSpeed, windDirection, timestamp } = request.only([
-      'windSpeed',
-      'windDirection',
-      'timestamp',
-    ])
-    if (typeof windSpeed !== 'number' || typeof windDirection !== 'number') {
+    const record = telemetryRecord(request)
+    if (
+      record === null ||
+      (record &&
+        record.type !== TelemetryRecordType.WindReading &&
+        record.type !== TelemetryRecordType.WindSummary)
+    ) {
       return response.badRequest({ error: 'Invalid wind data' })
     }
+    const body: Record<string, any> =
+      record ??
+      request.only([
+        'windSpeed',
+        'windDirection',
+        'timestamp',
+        'windGust',
+        'windLull',
+        'windSpeedStdDev',
+        'windDirectionStdDev',
+        'windResultantSpeed',
+        'windResultantDirection',
+        'windPersistence',
+        'windRose',
+      ])
+    const error = validateWind(body)
+    if (error) {
+      return response.badRequest({ error })
+    }
 
-    // Use station-provided timestamp if available, otherwise use server arrival time
-    const windTimestamp = timestamp || arrivalTimestamp
+    await recordWind(station_id, body, arrivalTimestamp)
 
-    // Cache the latest wind data using the shared cache service
-    stationDataCache.setWindData(station_id, {
-      windSpeed,
-      windDirection,
-      timestamp: windTimestamp,
-    })
+    return { ok: true }
+  }
 
-    // Process data for 1-minute aggregation
-    await windAggregationService.processWindData(station_id, windSpeed, windDirection, windTimestamp)
+  /**
+   * Receives livestream readings that the firmware buffered and sent in one request.
+   *
+   * POST /stations/:station_id/wind/batch
+   * Body: { samples: [{ windSpeed: number, windDirection: number, ageMs?: number }], timestamp?: string }
+   *
+   * ageMs is how long before sending the station took the reading. It is subtracted
+   * from the arrival time to restore the timestamps, and the readings are processed
+   * oldest first as if they had arrived one by one. A batch replayed from the station's
+   * offline queue carries the ISO time it was made in timestamp; the ages are then
+   * relative to it instead.
+   *
+   * A binary batch record (Content-Type application/vnd.aiolos.telemetry) is accepted
+   * in place of the JSON body.
+   */
+  async windBatch({ params, request, response }: HttpContext) {
+    // Capture arrival time immediately, the sample ages are relative to it
+    const arrivalMs = Date.now()
 
-    // Broadcast to SSE subscribers
-    await transmit.broadcast(`wind/live/${station_id}`, {
-      windSpeed,
-      windDirection,
-      timestamp: windTimestamp,
-    })
+    const { station_id } = params
+    const record = telemetryRecord(request)
+    if (record === null || (record && record.type !== TelemetryRecordType.WindBatch)) {
+      return response.badRequest({ error: 'Invalid wind data' })
+    }
+    const samples = record ? record.samples : request.input('samples')
+    const isValid =
+      Array.isArray(samples) &&
+      samples.length > 0 &&
+      samples.length <= MAX_WIND_BATCH_SAMPLES &&
+      samples.every(
+        (sample) =>
+          sample !== null &&
+          typeof sample === 'object' &&
+          typeof sample.windSpeed === 'number' &&
+          typeof sample.windDirection === 'number' &&
+          (sample.ageMs === undefined || (typeof sample.ageMs === 'number' && sample.ageMs >= 0))
+      )
+    if (!isValid) {
+      return response.badRequest({ error: 'Invalid wind data' })
+    }
 
-    return { ok: true }
+    const replayedAt = request.input('timestamp')
+    const replayedMs = typeof replayedAt === 'string' ? Date.parse(replayedAt) : Number.NaN
+    const referenceMs = Number.isNaN(replayedMs) ? arrivalMs : Math.min(replayedMs, arrivalMs)
+
+    const readings = samples
+      .map((sample: { windSpeed: number; windDirection: number; ageMs?: number }) => ({
+        windSpeed: sample.windSpeed,
+        windDirection: sample.windDirection,
+        timestamp: new Date(referenceMs - (sample.ageMs ?? 0)).toISOString(),
+      }))
+      .sort((a: { timestamp: string }, b: { timestamp: string }) =>
+        a.timestamp.localeCompare(b.timestamp)
+      )
+
+    for (const reading of readings) {
+      await windAggregationService.processWindData(
+        station_id,
+        reading.windSpeed,
+        reading.windDirection,
+        reading.timestamp
+      )
+      await transmit.broadcast(`wind/live/${station_id}`, reading)
+    }
+
+    // The newest reading is the station's current wind, unless a replayed batch is older
+    const newest = readings[readings.length - 1]
+    const cached = stationDataCache.getWindData(station_id)
+    if (!cached || Date.parse(cached.timestamp) <= Date.parse(newest.timestamp)) {
+      stationDataCache.setWindData(station_id, newest)
+    }
+
+    return { ok: true, accepted: readings.length }
+  }
+
+  /**
+   * Receives the 1 min and 10 min buckets a station aggregated itself.
+   *
+   * POST /stations/:station_id/wind/aggregates
+   * Body: { aggregates: [{ level: 1 | 10, windSpeed, windDirection, windGust, windLull,
+   *         sampleCount, durationMs, ageMs }], timestamp?: string }
+   *
+   * Firmware built with WIND_AGGREGATES sends these; they are computed from every
+   * anemometer pulse rather than the readings that reached the server, and are stored
+   * as the station's 1 min and 10 min rows in place of the server's own aggregation.
+   * ageMs is how long before sending the bucket ended, relative to the arrival time or,
+   * for a replayed request, to timestamp as in windBatch.
+   *
+   * A binary aggregates record (Content-Type application/vnd.aiolos.telemetry) is
+   * accepted in place of the JSON body.
+   */
+  async windAggregates({ params, request, response }: HttpContext) {
+    // Capture arrival time immediately, the bucket ages are relative to it
+    const arrivalMs = Date.now()
+
+    const { station_id } = params
+    const record = telemetryRecord(request)
+    if (record === null || (record && record.type !== TelemetryRecordType.WindAggregates)) {
+      return response.badRequest({ error: 'Invalid wind data' })
+    }
+    const aggregates = record ? record.aggregates : request.input('aggregates')
+    const isNumber = (value: unknown) => typeof value === 'number' && Number.isFinite(value)
+    const isValid =
+      Array.isArray(aggregates) &&
+      aggregates.length > 0 &&
+      aggregates.length <= MAX_WIND_AGGREGATES &&
+      aggregates.every(
+        (entry) =>
+          entry !== null &&
+          typeof entry === 'object' &&
+          (entry.level === 1 || entry.level === 10) &&
+          ['windSpeed', 'windDirection', 'windGust', 'windLull'].every((key) =>
+            isNumber(entry[key])
+          ) &&
+          Number.isInteger(entry.sampleCount) &&
+          entry.sampleCount >= 0 &&
+          isNumber(entry.durationMs) &&
+          entry.durationMs > 0 &&
+          isNumber(entry.ageMs) &&
+          entry.ageMs >= 0
+      )
+    if (!isValid) {
+      return response.badRequest({ error: 'Invalid wind data' })
+    }
+
+    const replayedAt = request.input('timestamp')
+    const replayedMs = typeof replayedAt === 'string' ? Date.parse(replayedAt) : Number.NaN
+    const referenceMs = Number.isNaN(replayedMs) ? arrivalMs : Math.min(replayedMs, arrivalMs)
+
+    // 1 min buckets first, so a 10 min bucket's tendency sees the rows it closed with
+    const ordered = [...aggregates].sort(
+      (a: { level: number; ageMs: number }, b: { level: number; ageMs: number }) =>
+        a.level - b.level || b.ageMs - a.ageMs
+    )
+    for (const entry of ordered) {
+      const level = entry.level as 1 | 10
+      await windAggregationService.recordStationAggregate(station_id, {
+        level,
+        intervalStart: windAggregationService.stationIntervalStart(
+          level,
+          referenceMs - entry.ageMs - entry.durationMs
+        ),
+        windSpeed: entry.windSpeed,
+        windDirection: entry.windDirection,
+        windGust: entry.windGust,
+        windLull: entry.windLull,
+        sampleCount: entry.sampleCount,
+      })
+    }
+
+    return { ok: true, accepted: aggregates.length }
   }
 
   /**
@@ -1,19 +1,9 @@
 import TemperatureReading from '#models/temperature_reading'
 import type { HttpContext } from '@adonisjs/core/http'
-import { stationDataCache } from '#app/services/station_data_cache'
-import transmit from '@adonisjs/transmit/services/main'
+import { recordTemperature, validateTemperature } from '#app/services/station_telemetry'
 import { DateTime } from 'luxon'
 
 export default class StationTemperatureController {
-  /**
-   * Validate if temperature reading is reasonable
-   * Filters out common sensor error values like -127
-   */
-  private isValidTemperature(temperature: number): boolean {
-    // Filter out obvious sensor errors and unrealistic values
-    return temperature > -40 && temperature < 60 && temperature !== -127
-  }
-
   /**
    * @summary Store temperature reading
    * @description Store a temperature reading from the station's external temperature sensor
@@ -25,45 +15,21 @@ export default class StationTemperatureController {
     // Capture arrival timestamp immediately for accuracy
     const arrivalTimestamp = new Date().toISOString()
 
-    const temperature = request.input('temperature')
-
-    if (temperature === undefined) {
-      return response.badRequest({ error: 'Temperature value is required' })
+    const body = request.only(['temperature', 'timestamp'])
+    const error = validateTemperature(body)
+    if (error) {
+      return response.badRequest({ error })
     }
 
-    // Use station-provided timestamp if available, otherwise use server arrival time
-    const temperatureTimestamp = request.input('timestamp') || arrivalTimestamp
-
-    // Silently filter invalid temperature readings
-    if (!this.isValidTemperature(temperature)) {
-      console.warn(
-        `Filtered invalid temperature reading: ${temperature}°C from station ${params.station_id}`
-      )
-      // Return success but don't update cache/broadcast/store
+    const reading = await recordTemperature(params.station_id, body, arrivalTimestamp)
+    if (!reading) {
+      // Filtered as a sensor error: return success but nothing was cached, broadcast or stored
       return response.created({
         message: 'Reading received',
         filtered: true
       })
     }
 
-    // Cache the temperature data
-    stationDataCache.setTemperatureData(params.station_id, {
-      temperature,
-      timestamp: temperatureTimestamp,
-    })
-
-    // Broadcast to SSE subscribers with timestamp
-    await transmit.broadcast(`temperature/live/${params.station_id}`, {
-      temperature,
-      timestamp: temperatureTimestamp,
-    })
-
-    const reading = await TemperatureReading.create({
-      stationId: params.station_id,
-      temperature,
-      readingTimestamp: DateTime.fromISO(temperatureTimestamp),
-    })
-
     // Return the same structure as the old SensorReading for API compatibility
     return response.created({
       id: reading.id,
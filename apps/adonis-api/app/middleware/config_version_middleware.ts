@@ -0,0 +1,27 @@
+import type { HttpContext } from '@adonisjs/core/http'
+import type { NextFn } from '@adonisjs/core/types/http'
+import { CONFIG_VERSION_HEADER, configVersion } from '#app/services/station_config_version'
+
+/**
+ * Adds the station's current config version to successful telemetry responses.
+ * The firmware reads this one header from the responses it already waits for
+ * and fetches GET /config only when the version differs from its stored ETag,
+ * instead of polling the configuration on a fixed interval.
+ */
+export default class ConfigVersionMiddleware {
+  async handle({ params, response }: HttpContext, next: NextFn) {
+    await next()
+
+    const status = response.getStatus()
+    if (!params.station_id || status < 200 || status >= 300) {
+      return
+    }
+
+    try {
+      response.header(CONFIG_VERSION_HEADER, await configVersion(params.station_id))
+    } catch (error) {
+      // The telemetry was stored; the station falls back to its periodic config poll
+      console.error(`Error reading config version for station ${params.station_id}:`, error)
+    }
+  }
+}
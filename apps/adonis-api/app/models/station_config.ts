@@ -1,7 +1,8 @@
 import { DateTime } from 'luxon'
-import { BaseModel, column, belongsTo } from '@adonisjs/lucid/orm'
+import { BaseModel, column, belongsTo, afterSave, afterDelete } from '@adonisjs/lucid/orm'
 import type { BelongsTo } from '@adonisjs/lucid/types/relations'
 import WeatherStation from './weather_station.js'
+import { configVersionCache } from '#app/services/config_version_cache'
 
 export default class StationConfig extends BaseModel {
   @column({ isPrimary: true })
@@ -46,12 +47,46 @@ export default class StationConfig extends BaseModel {
   @column()
   declare remoteOta: boolean
 
+  /**
+   * Wind vane ADC level per direction, in the order N, NE, E, SE, S, SW, W, NW.
+   * Null keeps the calibration stored on the station.
+   */
+  @column({
+    prepare: (value: number[] | null) => (value ? JSON.stringify(value) : null),
+    consume: (value: string | null) => (value ? JSON.parse(value) : null),
+  })
+  declare vaneCalibration: number[] | null
+
+  /**
+   * Livestream wind readings the station sends per request.
+   * Null or 1 sends every reading on its own.
+   */
+  @column()
+  declare windBatchSize: number | null
+
+  /**
+   * Whether the station sends wind and temperature over CoAP instead of HTTP.
+   * Null keeps the setting stored on the station. Firmware built without
+   * HTTP_ASYNC ignores a request to turn it on.
+   */
+  @column()
+  declare coapTelemetry: boolean | null
+
   @column.dateTime({ autoCreate: true })
   declare createdAt: DateTime
 
   @column.dateTime({ autoCreate: true, autoUpdate: true })
   declare updatedAt: DateTime
 
+  /**
+   * A written or deleted config changes the version the telemetry responses announce
+   */
+  @afterSave()
+  @afterDelete()
+  static forgetConfigVersion(config: StationConfig) {
+    configVersionCache.forget(config.stationId)
+  }
+
   /**
    * Relationships
    */
@@ -25,6 +25,51 @@ export default class StationDiagnostic extends BaseModel {
   @column()
   declare uptime: number
 
+  /**
+   * Drift of the wind vane ADC clusters from the stored calibration
+   * (0 = none, 1 = a direction reached its calibrated threshold)
+   */
+  @column()
+  declare vaneDivergence: number | null
+
+  /**
+   * Wind sampling task cadence since the previous report (microseconds)
+   */
+  @column()
+  declare windJitterAvgUs: number | null
+
+  @column()
+  declare windJitterMaxUs: number | null
+
+  @column()
+  declare windTickOverruns: number | null
+
+  /**
+   * HTTP requests sent on a reused / a new connection since boot
+   * (only reported when keep-alive is enabled on the station)
+   */
+  @column()
+  declare httpReuseHits: number | null
+
+  @column()
+  declare httpReuseMisses: number | null
+
+  /**
+   * Offline telemetry queue: records waiting, percent of its flash budget in use,
+   * and records replayed / lost since boot
+   */
+  @column()
+  declare queueDepth: number | null
+
+  @column()
+  declare queueFill: number | null
+
+  @column()
+  declare queueDrained: number | null
+
+  @column()
+  declare queueDropped: number | null
+
   @column.dateTime({ autoCreate: true })
   declare createdAt: DateTime
 
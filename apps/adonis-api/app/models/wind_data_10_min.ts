@@ -4,6 +4,7 @@ import type { BelongsTo } from '@adonisjs/lucid/types/relations'
 import WeatherStation from './weather_station.js'
 
 export type WindTendency = 'increasing' | 'decreasing' | 'stable'
+export type WindAggregateSource = 'server' | 'station'
 
 export default class WindData10Min extends BaseModel {
   static table = 'wind_data_10min'
@@ -74,6 +75,12 @@ export default class WindData10Min extends BaseModel {
   @column()
   declare tendency: WindTendency
 
+  /**
+   * @summary Who aggregated the interval: the station itself or the server
+   */
+  @column()
+  declare source: WindAggregateSource
+
   /**
    * @summary Creation timestamp
    */
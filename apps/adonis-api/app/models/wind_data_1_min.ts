@@ -2,6 +2,7 @@ import { DateTime } from 'luxon'
 import { BaseModel, column, belongsTo } from '@adonisjs/lucid/orm'
 import type { BelongsTo } from '@adonisjs/lucid/types/relations'
 import WeatherStation from './weather_station.js'
+import type { WindAggregateSource } from './wind_data_10_min.js'
 
 export default class WindData1Min extends BaseModel {
   static table = 'wind_data_1min'
@@ -72,6 +73,12 @@ export default class WindData1Min extends BaseModel {
   @column()
   declare sampleCount: number
 
+  /**
+   * @summary Who aggregated the interval: the station itself or the server
+   */
+  @column()
+  declare source: WindAggregateSource
+
   /**
    * @summary Creation timestamp
    */
@@ -0,0 +1,66 @@
+/**
+ * Config Version Cache
+ *
+ * Remembers each station's config version, so the telemetry endpoints do not
+ * query and hash the configuration on every reading (about once a second for
+ * a livestreaming station). StationConfig hooks drop a station's entry
+ * whenever one of its configs is saved or deleted. Entries also expire after
+ * a minute, which bounds how long a write that bypasses the model (a bulk
+ * query, another API instance) can go unnoticed.
+ */
+
+const CONFIG_VERSION_TTL_MS = 60_000
+
+interface CachedConfigVersion {
+  version: string
+  expiresAt: number
+}
+
+class ConfigVersionCacheService {
+  private versions = new Map<string, CachedConfigVersion>()
+  private invalidations = 0
+
+  /**
+   * Cached version of a station, undefined if unknown or expired
+   */
+  get(stationId: string): string | undefined {
+    const cached = this.versions.get(stationId)
+    if (!cached) {
+      return undefined
+    }
+    if (cached.expiresAt <= Date.now()) {
+      this.versions.delete(stationId)
+      return undefined
+    }
+    return cached.version
+  }
+
+  /**
+   * Token to pass to set(): taken before the config is read, it lets set()
+   * detect a write that happened while the version was being computed
+   */
+  snapshot(): number {
+    return this.invalidations
+  }
+
+  /**
+   * Cache a version computed since snapshot(); skipped if a config was written meanwhile
+   */
+  set(stationId: string, version: string, snapshot: number): void {
+    if (snapshot !== this.invalidations) {
+      return
+    }
+    this.versions.set(stationId, { version, expiresAt: Date.now() + CONFIG_VERSION_TTL_MS })
+  }
+
+  /**
+   * Drop a station's version after its configuration changed
+   */
+  forget(stationId: string): void {
+    this.invalidations++
+    this.versions.delete(stationId)
+  }
+}
+
+// Export singleton instance
+export const configVersionCache = new ConfigVersionCacheService()
@@ -0,0 +1,68 @@
+/**
+ * Station Config Version
+ *
+ * Builds the configuration response a station receives and its version, a
+ * strong ETag hashed from that body. GET /config sends the version as ETag;
+ * the telemetry endpoints repeat it in the X-Config-Version header so a
+ * station only fetches the configuration when the version changed.
+ */
+
+import { createHash } from 'node:crypto'
+import StationConfig from '#app/models/station_config'
+import { configVersionCache } from '#app/services/config_version_cache'
+
+export const CONFIG_VERSION_HEADER = 'X-Config-Version'
+
+/**
+ * Body of GET /config for a station: the latest config, or the defaults notice
+ */
+export async function currentConfigBody(stationId: string): Promise<Record<string, any>> {
+  const config = await StationConfig.query()
+    .where('stationId', stationId)
+    .orderBy('id', 'desc')
+    .first()
+
+  return config
+    ? config.serialize()
+    : {
+        stationId: stationId,
+        tempInterval: null,
+        windSendInterval: null,
+        windSampleInterval: null,
+        diagInterval: null,
+        timeInterval: null,
+        restartInterval: null,
+        sleepStartHour: null,
+        sleepEndHour: null,
+        otaHour: null,
+        otaMinute: null,
+        otaDuration: null,
+        remoteOta: false,
+        message: 'No configuration found for this station. Default values will be used.',
+      }
+}
+
+/**
+ * Strong ETag of a config response: a hash of the body the station receives
+ */
+export function configEtag(body: unknown): string {
+  return `"${createHash('sha1').update(JSON.stringify(body)).digest('hex').slice(0, 20)}"`
+}
+
+/**
+ * Current config version of a station, equal to the ETag GET /config answers with
+ *
+ * Served from the config version cache; the config is only read and hashed
+ * after it changed or the cached version expired.
+ */
+export async function configVersion(stationId: string): Promise<string> {
+  const cached = configVersionCache.get(stationId)
+  if (cached) {
+    return cached
+  }
+
+  const snapshot = configVersionCache.snapshot()
+  const version = configEtag(await currentConfigBody(stationId))
+  configVersionCache.set(stationId, version, snapshot)
+  return version
+}
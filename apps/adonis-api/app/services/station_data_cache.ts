@@ -22,6 +22,7 @@ interface StationDiagnosticsData {
   signalQuality: number
   uptime: number
   internalTemperature?: number
+  vaneDivergence?: number
   timestamp: string
 }
 
@@ -0,0 +1,262 @@
+import transmit from '@adonisjs/transmit/services/main'
+import { DateTime } from 'luxon'
+import StationDiagnostic from '#app/models/station_diagnostic'
+import TemperatureReading from '#app/models/temperature_reading'
+import { stationDataCache } from '#app/services/station_data_cache'
+import { windAggregationService } from '#app/services/wind_aggregation_service'
+
+/**
+ * Ingestion of the readings a station posts: validation, cache, broadcast
+ * and storage. Shared by the per-reading endpoints (/wind, /temperature,
+ * /diagnostics) and the composite /frame endpoint, which carries several
+ * of them in one request.
+ *
+ * Each kind has a validate function returning an error message, or null
+ * if the body is acceptable, and a record function for validated bodies.
+ */
+
+// Wind rose cells are [sector, speedBin, count] triples; the firmware uses
+// 8 direction sectors and 8 speed bins
+const WIND_ROSE_SECTORS = 8
+const WIND_ROSE_SPEED_BINS = 8
+
+// Optional statistics sent with averaged wind readings
+const WIND_PERIOD_STATS = [
+  'windGust',
+  'windLull',
+  'windSpeedStdDev',
+  'windDirectionStdDev',
+  'windResultantSpeed',
+  'windResultantDirection',
+  'windPersistence',
+] as const
+
+function isWindRose(value: unknown): value is [number, number, number][] {
+  return (
+    Array.isArray(value) &&
+    value.every(
+      (cell) =>
+        Array.isArray(cell) &&
+        cell.length === 3 &&
+        cell.every((v) => Number.isInteger(v) && v >= 0) &&
+        cell[0] < WIND_ROSE_SECTORS &&
+        cell[1] < WIND_ROSE_SPEED_BINS
+    )
+  )
+}
+
+// --- Wind --------------------------------------------------------------------
+
+export function validateWind(body: Record<string, any>): string | null {
+  const { windSpeed, windDirection, windRose } = body
+  if (typeof windSpeed !== 'number' || typeof windDirection !== 'number') {
+    return 'Invalid wind data'
+  }
+  if (WIND_PERIOD_STATS.some((key) => body[key] !== undefined && typeof body[key] !== 'number')) {
+    return 'Invalid wind data'
+  }
+  if (windRose !== undefined && !isWindRose(windRose)) {
+    return 'Invalid wind data'
+  }
+  return null
+}
+
+/**
+ * Cache, aggregate and broadcast a wind reading or averaged period
+ */
+export async function recordWind(
+  stationId: string,
+  body: Record<string, any>,
+  arrivalTimestamp: string
+) {
+  const {
+    windSpeed,
+    windDirection,
+    timestamp,
+    windGust,
+    windLull,
+    windSpeedStdDev,
+    windDirectionStdDev,
+    windResultantSpeed,
+    windResultantDirection,
+    windPersistence,
+    windRose,
+  } = body
+
+  // Use station-provided timestamp if available, otherwise use server arrival time
+  const windTimestamp = timestamp || arrivalTimestamp
+
+  // Cache the latest wind data using the shared cache service
+  stationDataCache.setWindData(stationId, {
+    windSpeed,
+    windDirection,
+    timestamp: windTimestamp,
+  })
+
+  // Process data for 1-minute aggregation
+  await windAggregationService.processWindData(
+    stationId,
+    windSpeed,
+    windDirection,
+    windTimestamp,
+    windGust,
+    windLull
+  )
+
+  // Broadcast to SSE subscribers
+  await transmit.broadcast(`wind/live/${stationId}`, {
+    windSpeed,
+    windDirection,
+    timestamp: windTimestamp,
+    ...(windGust !== undefined && { windGust }),
+    ...(windLull !== undefined && { windLull }),
+    ...(windSpeedStdDev !== undefined && { windSpeedStdDev }),
+    ...(windDirectionStdDev !== undefined && { windDirectionStdDev }),
+    ...(windResultantSpeed !== undefined && { windResultantSpeed }),
+    ...(windResultantDirection !== undefined && { windResultantDirection }),
+    ...(windPersistence !== undefined && { windPersistence }),
+    ...(windRose !== undefined && { windRose }),
+  })
+}
+
+// --- Temperature -------------------------------------------------------------
+
+export function validateTemperature(body: Record<string, any>): string | null {
+  return body.temperature === undefined ? 'Temperature value is required' : null
+}
+
+/**
+ * Filters out common sensor error values like -127 and unrealistic readings
+ */
+function isPlausibleTemperature(temperature: number): boolean {
+  return temperature > -40 && temperature < 60 && temperature !== -127
+}
+
+/**
+ * Cache, broadcast and store a temperature reading
+ *
+ * @returns The stored reading, or null if the value was filtered as a sensor error
+ */
+export async function recordTemperature(
+  stationId: string,
+  body: Record<string, any>,
+  arrivalTimestamp: string
+): Promise<TemperatureReading | null> {
+  const { temperature } = body
+
+  // Use station-provided timestamp if available, otherwise use server arrival time
+  const temperatureTimestamp = body.timestamp || arrivalTimestamp
+
+  // Silently filter invalid temperature readings
+  if (!isPlausibleTemperature(temperature)) {
+    console.warn(`Filtered invalid temperature reading: ${temperature}°C from station ${stationId}`)
+    return null
+  }
+
+  // Cache the temperature data
+  stationDataCache.setTemperatureData(stationId, {
+    temperature,
+    timestamp: temperatureTimestamp,
+  })
+
+  // Broadcast to SSE subscribers with timestamp
+  await transmit.broadcast(`temperature/live/${stationId}`, {
+    temperature,
+    timestamp: temperatureTimestamp,
+  })
+
+  return TemperatureReading.create({
+    stationId,
+    temperature,
+    readingTimestamp: DateTime.fromISO(temperatureTimestamp),
+  })
+}
+
+// --- Diagnostics -------------------------------------------------------------
+
+export function validateDiagnostics(body: Record<string, any>): string | null {
+  const { batteryVoltage, solarVoltage, signalQuality, uptime } = body
+  if (
+    typeof batteryVoltage !== 'number' ||
+    typeof solarVoltage !== 'number' ||
+    typeof signalQuality !== 'number' ||
+    typeof uptime !== 'number'
+  ) {
+    return 'Invalid diagnostics data. Required fields: batteryVoltage, solarVoltage, signalQuality, uptime'
+  }
+  return null
+}
+
+/**
+ * Cache, store and broadcast a diagnostics report
+ */
+export async function recordDiagnostics(
+  stationId: string,
+  data: Record<string, any>,
+  arrivalTimestamp: string
+) {
+  const { batteryVoltage, solarVoltage, signalQuality, uptime } = data
+
+  // Optional wind vane drift metric
+  const vaneDivergence = typeof data.vaneDivergence === 'number' ? data.vaneDivergence : undefined
+
+  // Optional wind sampling cadence, HTTP connection reuse and offline queue statistics
+  const optionalNumber = (value: unknown) => (typeof value === 'number' ? value : null)
+
+  // Prepare diagnostics data with timestamp
+  const diagnosticsData = {
+    ...data,
+    timestamp: data.timestamp || arrivalTimestamp,
+  }
+
+  // Diagnostics replayed from the station's offline queue are dated when they were taken
+  const takenAt = typeof data.timestamp === 'string' ? DateTime.fromISO(data.timestamp) : null
+  const createdAt = takenAt?.isValid ? takenAt : undefined
+
+  // Cache the diagnostics data, unless the cache already holds newer ones
+  const cached = stationDataCache.getDiagnosticsData(stationId)
+  const isNewest =
+    !cached || new Date(cached.timestamp).getTime() <= new Date(diagnosticsData.timestamp).getTime()
+  if (isNewest) {
+    stationDataCache.setDiagnosticsData(stationId, {
+      batteryVoltage,
+      solarVoltage,
+      signalQuality,
+      uptime,
+      internalTemperature: data.internalTemperature,
+      vaneDivergence,
+      timestamp: diagnosticsData.timestamp,
+    })
+  }
+
+  // Save diagnostics to database
+  await StationDiagnostic.create({
+    stationId: stationId,
+    batteryVoltage: batteryVoltage,
+    solarVoltage: solarVoltage,
+    internalTemperature: data.internalTemperature || null,
+    signalQuality: signalQuality,
+    uptime: uptime,
+    vaneDivergence: vaneDivergence ?? null,
+    windJitterAvgUs: optionalNumber(data.windJitterAvgUs),
+    windJitterMaxUs: optionalNumber(data.windJitterMaxUs),
+    windTickOverruns: optionalNumber(data.windTickOverruns),
+    httpReuseHits: optionalNumber(data.httpReuseHits),
+    httpReuseMisses: optionalNumber(data.httpReuseMisses),
+    queueDepth: optionalNumber(data.queueDepth),
+    queueFill: optionalNumber(data.queueFill),
+    queueDrained: optionalNumber(data.queueDrained),
+    queueDropped: optionalNumber(data.queueDropped),
+    ...(createdAt && { createdAt }),
+  })
+
+  // Broadcast the diagnostics data via Transmit; replayed older data is not live
+  if (isNewest) {
+    await transmit.broadcast(`station/diagnostics/${stationId}`, diagnosticsData)
+  }
+
+  // Log diagnostics in development
+  if (process.env.NODE_ENV === 'development') {
+    console.log(`Diagnostics for station ${stationId}:`, diagnosticsData)
+  }
+}
@@ -0,0 +1,283 @@
+/**
+ * Telemetry Codec
+ *
+ * Decodes the compact binary wind records the firmware sends instead of JSON
+ * when built with TELEMETRY_BINARY (firmware/src/core/TelemetryCodec.h).
+ *
+ * Layout, little endian:
+ *   u8 version (1), u8 record type, then per type:
+ *   WIND_READING  u16 speed, u16 direction
+ *   WIND_SUMMARY  u16 speed, direction, gust, lull, speedStdDev, directionStdDev,
+ *                 resultantSpeed, resultantDirection, persistence,
+ *                 u8 cell count, cells of { u8 sector << 4 | speedBin, u16 count }
+ *   WIND_BATCH    u8 count, samples of { u16 speed, u16 direction, u32 ageMs }
+ *   WIND_AGGREGATES u8 count, entries of { u8 level minutes, u16 speed, direction,
+ *                 gust, lull, u16 sampleCount, u32 durationMs, u32 ageMs }
+ *
+ * Speeds are in 0.01 m/s, directions in 0.1°, persistence in 0.0001.
+ */
+
+export const TELEMETRY_CONTENT_TYPE = 'application/vnd.aiolos.telemetry'
+export const TELEMETRY_VERSION = 1
+
+export enum TelemetryRecordType {
+  WindReading = 1,
+  WindSummary = 2,
+  WindBatch = 3,
+  WindAggregates = 4,
+}
+
+const SPEED_SCALE = 0.01
+const DIRECTION_SCALE = 0.1
+const PERSISTENCE_SCALE = 0.0001
+
+export interface WindReadingRecord {
+  type: TelemetryRecordType.WindReading
+  windSpeed: number
+  windDirection: number
+}
+
+export interface WindSummaryRecord {
+  type: TelemetryRecordType.WindSummary
+  windSpeed: number
+  windDirection: number
+  windGust: number
+  windLull: number
+  windSpeedStdDev: number
+  windDirectionStdDev: number
+  windResultantSpeed: number
+  windResultantDirection: number
+  windPersistence: number
+  windRose: [number, number, number][]
+}
+
+export interface WindBatchRecord {
+  type: TelemetryRecordType.WindBatch
+  samples: { windSpeed: number; windDirection: number; ageMs: number }[]
+}
+
+export interface WindAggregateEntry {
+  level: number
+  windSpeed: number
+  windDirection: number
+  windGust: number
+  windLull: number
+  sampleCount: number
+  durationMs: number
+  ageMs: number
+}
+
+export interface WindAggregatesRecord {
+  type: TelemetryRecordType.WindAggregates
+  aggregates: WindAggregateEntry[]
+}
+
+export type TelemetryRecord =
+  | WindReadingRecord
+  | WindSummaryRecord
+  | WindBatchRecord
+  | WindAggregatesRecord
+
+export class TelemetryDecodeError extends Error {}
+
+/**
+ * Round a decoded fixed-point value to the precision it was sent with
+ */
+function fromFixed(raw: number, scale: number): number {
+  const decimals = Math.round(-Math.log10(scale))
+  return Number((raw * scale).toFixed(decimals))
+}
+
+function toFixed(value: number, scale: number): number {
+  const steps = Math.round(value / scale)
+  return Number.isFinite(steps) ? Math.min(Math.max(steps, 0), 0xffff) : 0
+}
+
+class Reader {
+  private offset = 0
+
+  constructor(private readonly buffer: Buffer) {}
+
+  private need(bytes: number) {
+    if (this.offset + bytes > this.buffer.length) {
+      throw new TelemetryDecodeError('Telemetry record is truncated')
+    }
+  }
+
+  u8(): number {
+    this.need(1)
+    return this.buffer.readUInt8(this.offset++)
+  }
+
+  u16(): number {
+    this.need(2)
+    const value = this.buffer.readUInt16LE(this.offset)
+    this.offset += 2
+    return value
+  }
+
+  u32(): number {
+    this.need(4)
+    const value = this.buffer.readUInt32LE(this.offset)
+    this.offset += 4
+    return value
+  }
+
+  fixed16(scale: number): number {
+    return fromFixed(this.u16(), scale)
+  }
+
+  end() {
+    if (this.offset !== this.buffer.length) {
+      throw new TelemetryDecodeError('Unexpected bytes after telemetry record')
+    }
+  }
+}
+
+/**
+ * Decode one binary telemetry record
+ *
+ * @throws TelemetryDecodeError if the record is malformed or of an unknown version or type
+ */
+export function decodeTelemetry(buffer: Buffer): TelemetryRecord {
+  const reader = new Reader(buffer)
+  const version = reader.u8()
+  if (version !== TELEMETRY_VERSION) {
+    throw new TelemetryDecodeError(`Unsupported telemetry version ${version}`)
+  }
+
+  const type = reader.u8()
+  let record: TelemetryRecord
+  switch (type) {
+    case TelemetryRecordType.WindReading:
+      record = {
+        type,
+        windSpeed: reader.fixed16(SPEED_SCALE),
+        windDirection: reader.fixed16(DIRECTION_SCALE),
+      }
+      break
+
+    case TelemetryRecordType.WindSummary: {
+      const summary: WindSummaryRecord = {
+        type,
+        windSpeed: reader.fixed16(SPEED_SCALE),
+        windDirection: reader.fixed16(DIRECTION_SCALE),
+        windGust: reader.fixed16(SPEED_SCALE),
+        windLull: reader.fixed16(SPEED_SCALE),
+        windSpeedStdDev: reader.fixed16(SPEED_SCALE),
+        windDirectionStdDev: reader.fixed16(DIRECTION_SCALE),
+        windResultantSpeed: reader.fixed16(SPEED_SCALE),
+        windResultantDirection: reader.fixed16(DIRECTION_SCALE),
+        windPersistence: reader.fixed16(PERSISTENCE_SCALE),
+        windRose: [],
+      }
+      const cells = reader.u8()
+      for (let i = 0; i < cells; i++) {
+        const cell = reader.u8()
+        summary.windRose.push([cell >> 4, cell & 0x0f, reader.u16()])
+      }
+      record = summary
+      break
+    }
+
+    case TelemetryRecordType.WindBatch: {
+      const batch: WindBatchRecord = { type, samples: [] }
+      const count = reader.u8()
+      for (let i = 0; i < count; i++) {
+        batch.samples.push({
+          windSpeed: reader.fixed16(SPEED_SCALE),
+          windDirection: reader.fixed16(DIRECTION_SCALE),
+          ageMs: reader.u32(),
+        })
+      }
+      record = batch
+      break
+    }
+
+    case TelemetryRecordType.WindAggregates: {
+      const aggregates: WindAggregatesRecord = { type, aggregates: [] }
+      const count = reader.u8()
+      for (let i = 0; i < count; i++) {
+        aggregates.aggregates.push({
+          level: reader.u8(),
+          windSpeed: reader.fixed16(SPEED_SCALE),
+          windDirection: reader.fixed16(DIRECTION_SCALE),
+          windGust: reader.fixed16(SPEED_SCALE),
+          windLull: reader.fixed16(SPEED_SCALE),
+          sampleCount: reader.u16(),
+          durationMs: reader.u32(),
+          ageMs: reader.u32(),
+        })
+      }
+      record = aggregates
+      break
+    }
+
+    default:
+      throw new TelemetryDecodeError(`Unknown telemetry record type ${type}`)
+  }
+
+  reader.end()
+  return record
+}
+
+/**
+ * Encode a record the way the firmware does; used by tests and tools
+ */
+export function encodeTelemetry(record: TelemetryRecord): Buffer {
+  const bytes: number[] = [TELEMETRY_VERSION, record.type]
+  const u16 = (value: number) => bytes.push(value & 0xff, (value >> 8) & 0xff)
+  const u32 = (value: number) => {
+    u16(value & 0xffff)
+    u16((value >>> 16) & 0xffff)
+  }
+
+  switch (record.type) {
+    case TelemetryRecordType.WindReading:
+      u16(toFixed(record.windSpeed, SPEED_SCALE))
+      u16(toFixed(record.windDirection, DIRECTION_SCALE))
+      break
+
+    case TelemetryRecordType.WindSummary:
+      u16(toFixed(record.windSpeed, SPEED_SCALE))
+      u16(toFixed(record.windDirection, DIRECTION_SCALE))
+      u16(toFixed(record.windGust, SPEED_SCALE))
+      u16(toFixed(record.windLull, SPEED_SCALE))
+      u16(toFixed(record.windSpeedStdDev, SPEED_SCALE))
+      u16(toFixed(record.windDirectionStdDev, DIRECTION_SCALE))
+      u16(toFixed(record.windResultantSpeed, SPEED_SCALE))
+      u16(toFixed(record.windResultantDirection, DIRECTION_SCALE))
+      u16(toFixed(record.windPersistence, PERSISTENCE_SCALE))
+      bytes.push(record.windRose.length)
+      for (const [sector, bin, count] of record.windRose) {
+        bytes.push((sector << 4) | bin)
+        u16(count)
+      }
+      break
+
+    case TelemetryRecordType.WindBatch:
+      bytes.push(record.samples.length)
+      for (const sample of record.samples) {
+        u16(toFixed(sample.windSpeed, SPEED_SCALE))
+        u16(toFixed(sample.windDirection, DIRECTION_SCALE))
+        u32(sample.ageMs)
+      }
+      break
+
+    case TelemetryRecordType.WindAggregates:
+      bytes.push(record.aggregates.length)
+      for (const entry of record.aggregates) {
+        bytes.push(entry.level)
+        u16(toFixed(entry.windSpeed, SPEED_SCALE))
+        u16(toFixed(entry.windDirection, DIRECTION_SCALE))
+        u16(toFixed(entry.windGust, SPEED_SCALE))
+        u16(toFixed(entry.windLull, SPEED_SCALE))
+        u16(Math.min(entry.sampleCount, 0xffff))
+        u32(entry.durationMs)
+        u32(entry.ageMs)
+      }
+      break
+  }
+
+  return Buffer.from(bytes)
+}
@@ -4,6 +4,19 @@ import WindData10Min from '#models/wind_data_10_min'
 import type { WindTendency } from '#models/wind_data_10_min'
 import transmit from '@adonisjs/transmit/services/main'
 
+/**
+ * A bucket the station aggregated itself (firmware built with WIND_AGGREGATES)
+ */
+export interface StationWindAggregate {
+  level: 1 | 10
+  intervalStart: DateTime
+  windSpeed: number
+  windDirection: number
+  windGust: number
+  windLull: number
+  sampleCount: number
+}
+
 /**
  * Data structure for tracking wind data in a minute interval
  */
@@ -32,7 +45,14 @@ export class WindAggregationService {
   /**
    * Process incoming wind data and update aggregation buckets
    */
-  async processWindData(stationId: string, windSpeed: number, windDirection: number, timestamp: string): Promise<void> {
+  async processWindData(
+    stationId: string,
+    windSpeed: number,
+    windDirection: number,
+    timestamp: string,
+    gust?: number,
+    lull?: number
+  ): Promise<void> {
     const dataTime = DateTime.fromISO(timestamp)
     const intervalStart = this.getIntervalStart(dataTime)
     const bucketKey = `${stationId}_${intervalStart.toISODate()}_${intervalStart.toFormat('HH:mm')}`
@@ -48,8 +68,8 @@ export class WindAggregationService {
         intervalStart,
         speedSum: 0,
         speedCount: 0,
-        minSpeed: windSpeed,
-        maxSpeed: windSpeed,
+        minSpeed: lull ?? windSpeed,
+        maxSpeed: gust ?? windSpeed,
         directionFrequency: {},
         sampleCount: 0,
       }
@@ -59,8 +79,9 @@ export class WindAggregationService {
     // Update bucket with new data
     bucket.speedSum += windSpeed
     bucket.speedCount += 1
-    bucket.minSpeed = Math.min(bucket.minSpeed, windSpeed)
-    bucket.maxSpeed = Math.max(bucket.maxSpeed, windSpeed)
+    // Averaged readings carry the station's 3 s gust and lull, which bound the speed better than the mean
+    bucket.minSpeed = Math.min(bucket.minSpeed, lull ?? windSpeed)
+    bucket.maxSpeed = Math.max(bucket.maxSpeed, gust ?? windSpeed)
     bucket.sampleCount += 1
 
     // Track direction frequency (round to nearest degree)
@@ -99,6 +120,16 @@ export class WindAggregationService {
    */
   private async saveAggregatedData(bucket: WindBucket): Promise<void> {
     try {
+      // The station's own bucket for this minute was computed from every pulse; keep it
+      const stationRow = await WindData1Min.query()
+        .where('stationId', bucket.stationId)
+        .where('timestamp', bucket.intervalStart.setZone('utc').toISO()!)
+        .where('source', 'station')
+        .first()
+      if (stationRow) {
+        return
+      }
+
       // Calculate statistics
       const avgSpeed = bucket.speedSum / bucket.speedCount
       const dominantDirection = this.calculateDominantDirection(bucket.directionFrequency)
@@ -310,6 +341,16 @@ export class WindAggregationService {
         return // No data to aggregate
       }
 
+      // Check if record already exists
+      const existingRecord = await WindData10Min.query()
+        .where('stationId', stationId)
+        .where('timestamp', intervalStart.toISO()!)
+        .first()
+
+      if (existingRecord?.source === 'station') {
+        return // The station reported this interval itself
+      }
+
       // Calculate aggregated statistics
       const totalSpeedSum = oneMinuteData.reduce((sum, record) => sum + record.avgSpeed, 0)
       const avgSpeed = totalSpeedSum / oneMinuteData.length
@@ -324,12 +365,6 @@ export class WindAggregationService {
 
       let windData: WindData10Min
 
-      // Check if record already exists
-      const existingRecord = await WindData10Min.query()
-        .where('stationId', stationId)
-        .where('timestamp', intervalStart.toISO()!)
-        .first()
-
       if (existingRecord) {
         // Update existing record
         windData = await existingRecord.merge({
@@ -369,6 +404,79 @@ export class WindAggregationService {
     }
   }
 
+  /**
+   * Store a 1 min or 10 min bucket the station aggregated itself and broadcast it
+   *
+   * It replaces a bucket the server aggregated for the same interval, and the
+   * server's own aggregation leaves it alone from then on.
+   */
+  async recordStationAggregate(stationId: string, aggregate: StationWindAggregate): Promise<void> {
+    const { level, intervalStart } = aggregate
+    const values = {
+      avgSpeed: Math.round(aggregate.windSpeed * 100) / 100,
+      minSpeed: aggregate.windLull,
+      maxSpeed: aggregate.windGust,
+      dominantDirection: Math.round(aggregate.windDirection) % 360,
+      source: 'station' as const,
+    }
+
+    if (level === 1) {
+      const existing = await WindData1Min.query()
+        .where('stationId', stationId)
+        .where('timestamp', intervalStart.toISO()!)
+        .first()
+      const windData = existing
+        ? await existing.merge({ ...values, sampleCount: aggregate.sampleCount }).save()
+        : await WindData1Min.create({
+            stationId,
+            timestamp: intervalStart,
+            ...values,
+            sampleCount: aggregate.sampleCount,
+          })
+
+      await transmit.broadcast(`wind/aggregated/1min/${stationId}`, {
+        stationId,
+        timestamp: intervalStart.toISO(),
+        avgSpeed: windData.avgSpeed,
+        minSpeed: windData.minSpeed,
+        maxSpeed: windData.maxSpeed,
+        dominantDirection: windData.dominantDirection,
+        sampleCount: windData.sampleCount,
+      })
+      return
+    }
+
+    const tendency = await this.calculateTendency(stationId, intervalStart, values.avgSpeed)
+    const existing = await WindData10Min.query()
+      .where('stationId', stationId)
+      .where('timestamp', intervalStart.toISO()!)
+      .first()
+    const windData = existing
+      ? await existing.merge({ ...values, tendency }).save()
+      : await WindData10Min.create({ stationId, timestamp: intervalStart, ...values, tendency })
+
+    await transmit.broadcast(`wind/aggregated/10min/${stationId}`, {
+      stationId,
+      timestamp: intervalStart.toISO(),
+      avgSpeed: windData.avgSpeed,
+      minSpeed: windData.minSpeed,
+      maxSpeed: windData.maxSpeed,
+      dominantDirection: windData.dominantDirection,
+      tendency: windData.tendency,
+    })
+  }
+
+  /**
+   * Label a station bucket with the wall-clock interval whose start is nearest to its own.
+   * The station's buckets follow its uptime, not the clock.
+   */
+  stationIntervalStart(level: 1 | 10, startMs: number): DateTime {
+    const start = DateTime.fromMillis(startMs, { zone: 'utc' })
+    return level === 1
+      ? start.plus({ seconds: 30 }).startOf('minute')
+      : this.get10MinuteIntervalStart(start.plus({ minutes: 5 }))
+  }
+
   /**
    * Calculate dominant direction from 1-minute records
    */
@@ -29,6 +29,16 @@ const bodyParserConfig = defineConfig({
     ],
   },
 
+  /**
+   * Config for the raw body parser. Binary wind telemetry from the
+   * firmware is read as latin1 so every byte maps to one character
+   * and can be turned back into a Buffer losslessly.
+   */
+  raw: {
+    encoding: 'latin1',
+    types: ['application/vnd.aiolos.telemetry'],
+  },
+
   /**
    * Config for the "multipart/form-data" content-type parser.
    * File uploads are handled by the multipart parser.
@@ -0,0 +1,18 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_configs'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      // JSON array of 8 wind vane ADC levels (N, NE, E, SE, S, SW, W, NW)
+      table.text('vane_calibration').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('vane_calibration')
+    })
+  }
+}
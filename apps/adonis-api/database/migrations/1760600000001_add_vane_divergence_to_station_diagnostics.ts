@@ -0,0 +1,17 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_diagnostics'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.float('vane_divergence').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('vane_divergence')
+    })
+  }
+}
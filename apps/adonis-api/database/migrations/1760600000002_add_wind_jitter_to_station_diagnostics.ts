@@ -0,0 +1,21 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_diagnostics'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.integer('wind_jitter_avg_us').nullable()
+      table.integer('wind_jitter_max_us').nullable()
+      table.integer('wind_tick_overruns').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('wind_jitter_avg_us')
+      table.dropColumn('wind_jitter_max_us')
+      table.dropColumn('wind_tick_overruns')
+    })
+  }
+}
@@ -0,0 +1,18 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_configs'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      // Livestream wind readings per request (1 or null: one request per reading)
+      table.integer('wind_batch_size').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('wind_batch_size')
+    })
+  }
+}
@@ -0,0 +1,20 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_diagnostics'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      // Keep-alive connection reuse counters, cumulative since boot
+      table.integer('http_reuse_hits').nullable()
+      table.integer('http_reuse_misses').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('http_reuse_hits')
+      table.dropColumn('http_reuse_misses')
+    })
+  }
+}
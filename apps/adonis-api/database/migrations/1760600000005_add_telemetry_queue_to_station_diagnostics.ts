@@ -0,0 +1,24 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_diagnostics'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      // Offline telemetry queue state; drained and dropped are cumulative since boot
+      table.integer('queue_depth').nullable()
+      table.integer('queue_fill').nullable()
+      table.integer('queue_drained').nullable()
+      table.integer('queue_dropped').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('queue_depth')
+      table.dropColumn('queue_fill')
+      table.dropColumn('queue_drained')
+      table.dropColumn('queue_dropped')
+    })
+  }
+}
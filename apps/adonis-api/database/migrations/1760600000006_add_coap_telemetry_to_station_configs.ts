@@ -0,0 +1,18 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  protected tableName = 'station_configs'
+
+  async up() {
+    this.schema.alterTable(this.tableName, (table) => {
+      // Telemetry over CoAP instead of HTTP (null keeps the station's setting)
+      table.boolean('coap_telemetry').nullable()
+    })
+  }
+
+  async down() {
+    this.schema.alterTable(this.tableName, (table) => {
+      table.dropColumn('coap_telemetry')
+    })
+  }
+}
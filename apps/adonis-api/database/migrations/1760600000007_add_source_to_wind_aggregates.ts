@@ -0,0 +1,21 @@
+import { BaseSchema } from '@adonisjs/lucid/schema'
+
+export default class extends BaseSchema {
+  async up() {
+    for (const tableName of ['wind_data_1min', 'wind_data_10min']) {
+      this.schema.alterTable(tableName, (table) => {
+        // 'station' for buckets the station aggregated itself (WIND_AGGREGATES firmware),
+        // 'server' for buckets aggregated here from the raw readings
+        table.string('source').notNullable().defaultTo('server')
+      })
+    }
+  }
+
+  async down() {
+    for (const tableName of ['wind_data_1min', 'wind_data_10min']) {
+      this.schema.alterTable(tableName, (table) => {
+        table.dropColumn('source')
+      })
+    }
+  }
+}
@@ -11,10 +11,13 @@ import router from '@adonisjs/core/services/router'
 import AutoSwagger from 'adonis-autoswagger'
 import swagger from '#config/swagger'
 import transmit from '@adonisjs/transmit/services/main'
+import { middleware } from '#start/kernel'
 
 // Import controllers
 const StationLiveController = () => import('#app/controllers/station_live_controller')
 const StationDiagnosticsController = () => import('#app/controllers/station_diagnostics_controller')
+const StationFrameController = () => import('#app/controllers/station_frame_controller')
+const StationBenchmarkController = () => import('#app/controllers/station_benchmark_controller')
 const StationConfigsController = () => import('#app/controllers/station_configs_controller')
 const SystemConfigsController = () => import('#app/controllers/system_configs_controller')
 const StationTemperatureController = () => import('#app/controllers/station_temperature_controller')
@@ -115,15 +118,22 @@ router
       .group(() => {
         // Apply .as() to name routes for reverse routing
 
-        // Temperature data endpoint for firmware
-        router.post('/temperature', [StationTemperatureController, 'store']).as('temperature.store')
+        // Temperature data endpoint for firmware. The firmware telemetry endpoints answer
+        // with the station's config version (X-Config-Version), see config_version_middleware
+        router
+          .post('/temperature', [StationTemperatureController, 'store'])
+          .as('temperature.store')
+          .use(middleware.configVersion())
         router.get('/temperature', [StationTemperatureController, 'index']).as('temperature.index')
         router
           .get('/temperature/latest', [StationTemperatureController, 'latest'])
           .as('temperature.latest')
 
         // Station diagnostics endpoints
-        router.post('/diagnostics', [StationDiagnosticsController, 'store']).as('diagnostics.store')
+        router
+          .post('/diagnostics', [StationDiagnosticsController, 'store'])
+          .as('diagnostics.store')
+          .use(middleware.configVersion())
         router.get('/diagnostics', [StationDiagnosticsController, 'show']).as('diagnostics.show')
 
         // Station configuration endpoints (includes all config and flags)
@@ -134,7 +144,31 @@ router
         router.post('/ota-confirm', [StationConfigsController, 'confirmOta']).as('ota.confirm')
 
         // Wind data endpoint for firmware (maps to same controller as live/wind)
-        router.post('/wind', [StationLiveController, 'wind']).as('wind')
+        router
+          .post('/wind', [StationLiveController, 'wind'])
+          .as('wind')
+          .use(middleware.configVersion())
+
+        // Batched livestream readings from firmware (windBatchSize > 1)
+        router
+          .post('/wind/batch', [StationLiveController, 'windBatch'])
+          .as('wind.batch')
+          .use(middleware.configVersion())
+
+        // 1 min and 10 min buckets aggregated on the station (WIND_AGGREGATES firmware)
+        router
+          .post('/wind/aggregates', [StationLiveController, 'windAggregates'])
+          .as('wind.aggregates')
+          .use(middleware.configVersion())
+
+        // Wind, temperature and diagnostics that came due together, in one request
+        router
+          .post('/frame', [StationFrameController, 'store'])
+          .as('frame.store')
+          .use(middleware.configVersion())
+
+        // Discards the body; the firmware's transport benchmark posts here
+        router.post('/benchmark', [StationBenchmarkController, 'store']).as('benchmark.store')
 
         // Aggregated wind data endpoints
         router
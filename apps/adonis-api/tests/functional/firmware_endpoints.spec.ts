@@ -3,6 +3,14 @@ import TemperatureReading from '#app/models/temperature_reading'
 import StationDiagnostic from '#app/models/station_diagnostic'
 import StationConfig from '#app/models/station_config'
 import WeatherStation from '#app/models/weather_station'
+import WindData1Min from '#app/models/wind_data_1_min'
+import WindData10Min from '#app/models/wind_data_10_min'
+import {
+  TELEMETRY_CONTENT_TYPE,
+  TelemetryRecordType,
+  encodeTelemetry,
+} from '#app/services/telemetry_codec'
+import { stationDataCache } from '#app/services/station_data_cache'
 
 /**
  * Firmware Critical Endpoints Test Suite
@@ -11,10 +19,14 @@ import WeatherStation from '#app/models/weather_station'
  * Based on AiolosHttpClient.cpp analysis, these are the critical endpoints:
  *
  * 1. POST /api/stations/{stationId}/wind - sendWindData()
+ *    POST /api/stations/{stationId}/wind/batch - sendWindBatch()
+ *    POST /api/stations/{stationId}/wind/aggregates - sendWindAggregates()
  * 2. POST /api/stations/{stationId}/temperature - sendTemperatureData()
  * 3. POST /api/stations/{stationId}/diagnostics - sendDiagnostics()
+ *    POST /api/stations/{stationId}/frame - flushFrame()
  * 4. GET /api/stations/{stationId}/config - fetchConfiguration()
  * 5. POST /api/stations/{stationId}/ota-confirm - confirmOtaStarted()
+ * 6. POST /api/stations/{stationId}/benchmark - runHttpTransportBenchmark()
  *
  * These tests ensure the firmware contract remains stable and unchanged.
  * All tests are in a flat structure to comply with Japa/AdonisJS requirements.
@@ -66,6 +78,240 @@ test.group('Firmware Critical Endpoints', (group) => {
     response.assertBody({ ok: true })
   })
 
+  test('should accept averaged wind data with gust and lull', async ({ client }) => {
+    const windData = {
+      windSpeed: 6.2,
+      windDirection: 225,
+      windGust: 9.8,
+      windLull: 3.1,
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind`).json(windData)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true })
+  })
+
+  test('should reject invalid wind gust', async ({ client }) => {
+    const windData = {
+      windSpeed: 6.2,
+      windDirection: 225,
+      windGust: 'invalid',
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind`).json(windData)
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
+  test('should accept averaged wind data with variability statistics', async ({ client }) => {
+    const windData = {
+      windSpeed: 6.2,
+      windDirection: 225,
+      windGust: 9.8,
+      windLull: 3.1,
+      windSpeedStdDev: 1.4,
+      windDirectionStdDev: 18.5,
+      windResultantSpeed: 5.6,
+      windResultantDirection: 228.4,
+      windPersistence: 0.9,
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind`).json(windData)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true })
+  })
+
+  test('should accept averaged wind data with a wind rose histogram', async ({ client }) => {
+    const windData = {
+      windSpeed: 4.1,
+      windDirection: 270,
+      windRose: [
+        [6, 3, 112],
+        [6, 4, 31],
+        [7, 3, 7],
+      ],
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind`).json(windData)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true })
+  })
+
+  test('should reject a wind rose cell outside the histogram', async ({ client }) => {
+    const windData = {
+      windSpeed: 4.1,
+      windDirection: 270,
+      windRose: [[8, 3, 112]],
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind`).json(windData)
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
+  test('should accept a batch of livestream wind readings', async ({ client }) => {
+    const batch = {
+      samples: [
+        { windSpeed: 5.1, windDirection: 180, ageMs: 2000 },
+        { windSpeed: 5.4, windDirection: 185, ageMs: 1000 },
+        { windSpeed: 5.0, windDirection: 175, ageMs: 0 },
+      ],
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind/batch`).json(batch)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, accepted: 3 })
+  })
+
+  test('should date a replayed wind batch from its timestamp', async ({ client, assert }) => {
+    stationDataCache.clearStationData(testStationId)
+    const batch = {
+      samples: [
+        { windSpeed: 4.2, windDirection: 90, ageMs: 30000 },
+        { windSpeed: 4.6, windDirection: 95, ageMs: 0 },
+      ],
+      timestamp: '2025-06-01T12:00:00Z',
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind/batch`).json(batch)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, accepted: 2 })
+    assert.equal(stationDataCache.getWindData(testStationId)?.timestamp, '2025-06-01T12:00:00.000Z')
+  })
+
+  test('should reject a wind batch with an invalid reading', async ({ client }) => {
+    const batch = {
+      samples: [
+        { windSpeed: 5.1, windDirection: 180, ageMs: 1000 },
+        { windSpeed: 'fast', windDirection: 185, ageMs: 0 },
+      ],
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind/batch`).json(batch)
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
+  test('should reject an empty wind batch', async ({ client }) => {
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind/batch`)
+      .json({ samples: [] })
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
+  test('should store the station aggregates as its 1 min and 10 min rows', async ({
+    client,
+    assert,
+  }) => {
+    await WindData1Min.query().where('stationId', testStationId).delete()
+    await WindData10Min.query().where('stationId', testStationId).delete()
+    const aggregates = {
+      aggregates: [
+        {
+          level: 1,
+          windSpeed: 4.25,
+          windDirection: 270,
+          windGust: 6.8,
+          windLull: 2.1,
+          sampleCount: 240,
+          durationMs: 60000,
+          ageMs: 10000,
+        },
+        {
+          level: 10,
+          windSpeed: 3.9,
+          windDirection: 265.5,
+          windGust: 7.2,
+          windLull: 1.5,
+          sampleCount: 2400,
+          durationMs: 600000,
+          ageMs: 10000,
+        },
+      ],
+      // Replayed: the buckets ended at 12:09:50 and so started at 12:08:50 and 11:59:50
+      timestamp: '2025-06-01T12:10:00Z',
+    }
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind/aggregates`)
+      .json(aggregates)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, accepted: 2 })
+
+    const minute = await WindData1Min.query().where('stationId', testStationId).firstOrFail()
+    assert.equal(minute.timestamp.toISO(), '2025-06-01T12:09:00.000Z')
+    assert.equal(minute.avgSpeed, 4.25)
+    assert.equal(minute.maxSpeed, 6.8)
+    assert.equal(minute.minSpeed, 2.1)
+    assert.equal(minute.sampleCount, 240)
+    assert.equal(minute.source, 'station')
+
+    const tenMinutes = await WindData10Min.query().where('stationId', testStationId).firstOrFail()
+    assert.equal(tenMinutes.timestamp.toISO(), '2025-06-01T12:00:00.000Z')
+    assert.equal(tenMinutes.avgSpeed, 3.9)
+    assert.equal(tenMinutes.dominantDirection, 266)
+    assert.equal(tenMinutes.source, 'station')
+  })
+
+  test('should reject station aggregates of an unknown level', async ({ client }) => {
+    const response = await client.post(`/api/stations/${testStationId}/wind/aggregates`).json({
+      aggregates: [
+        {
+          level: 5,
+          windSpeed: 4.25,
+          windDirection: 270,
+          windGust: 6.8,
+          windLull: 2.1,
+          sampleCount: 240,
+          durationMs: 300000,
+          ageMs: 0,
+        },
+      ],
+    })
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
+  test('should reject a wind batch larger than the firmware sends', async ({ client }) => {
+    const samples = Array.from({ length: 61 }, (_, i) => ({
+      windSpeed: 5.0,
+      windDirection: 180,
+      ageMs: (60 - i) * 1000,
+    }))
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind/batch`)
+      .json({ samples })
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
+  test('should reject invalid wind direction standard deviation', async ({ client }) => {
+    const windData = {
+      windSpeed: 6.2,
+      windDirection: 225,
+      windDirectionStdDev: 'wide',
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/wind`).json(windData)
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
   test('should reject invalid wind speed', async ({ client }) => {
     const windData = {
       windSpeed: 'invalid',
@@ -124,6 +370,81 @@ test.group('Firmware Critical Endpoints', (group) => {
     response.assertBody({ ok: true })
   })
 
+  /**
+   * Binary telemetry (firmware built with TELEMETRY_BINARY)
+   * Same endpoints, Content-Type application/vnd.aiolos.telemetry
+   */
+  test('should accept a binary wind reading', async ({ client }) => {
+    const record = encodeTelemetry({
+      type: TelemetryRecordType.WindReading,
+      windSpeed: 12.5,
+      windDirection: 270,
+    })
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind`)
+      .json(record)
+      .type(TELEMETRY_CONTENT_TYPE)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true })
+  })
+
+  test('should accept a binary wind batch', async ({ client }) => {
+    const record = encodeTelemetry({
+      type: TelemetryRecordType.WindBatch,
+      samples: [
+        { windSpeed: 5.1, windDirection: 180, ageMs: 2000 },
+        { windSpeed: 5.4, windDirection: 185, ageMs: 1000 },
+        { windSpeed: 5.0, windDirection: 175, ageMs: 0 },
+      ],
+    })
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind/batch`)
+      .json(record)
+      .type(TELEMETRY_CONTENT_TYPE)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, accepted: 3 })
+  })
+
+  test('should accept binary station aggregates', async ({ client }) => {
+    const record = encodeTelemetry({
+      type: TelemetryRecordType.WindAggregates,
+      aggregates: [
+        {
+          level: 1,
+          windSpeed: 4.25,
+          windDirection: 270,
+          windGust: 6.8,
+          windLull: 2.1,
+          sampleCount: 240,
+          durationMs: 60000,
+          ageMs: 0,
+        },
+      ],
+    })
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind/aggregates`)
+      .json(record)
+      .type(TELEMETRY_CONTENT_TYPE)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, accepted: 1 })
+  })
+
+  test('should reject a truncated binary wind reading', async ({ client }) => {
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind`)
+      .json(Buffer.from('010100', 'hex'))
+      .type(TELEMETRY_CONTENT_TYPE)
+
+    response.assertStatus(400)
+    response.assertBodyContains({ error: 'Invalid wind data' })
+  })
+
   /**
    * Temperature Data Endpoint Tests
    * POST /api/stations/:station_id/temperature
@@ -242,6 +563,88 @@ test.group('Firmware Critical Endpoints', (group) => {
     response.assertBody({ ok: true })
   })
 
+  test('should store the optional wind vane and sampling diagnostics', async ({
+    client,
+    assert,
+  }) => {
+    const diagnosticsData = {
+      batteryVoltage: 3.7,
+      solarVoltage: 5.1,
+      signalQuality: 80,
+      uptime: 3600,
+      vaneDivergence: 0.25,
+      windJitterAvgUs: 120,
+      windJitterMaxUs: 2400,
+      windTickOverruns: 0,
+    }
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/diagnostics`)
+      .json(diagnosticsData)
+
+    response.assertStatus(200)
+
+    const stored = await StationDiagnostic.query().where('stationId', testStationId).first()
+    assert.exists(stored)
+    assert.equal(stored!.vaneDivergence, 0.25)
+    assert.equal(stored!.windJitterAvgUs, 120)
+    assert.equal(stored!.windJitterMaxUs, 2400)
+    assert.equal(stored!.windTickOverruns, 0)
+  })
+
+  test('should store the optional HTTP connection reuse counters', async ({ client, assert }) => {
+    const diagnosticsData = {
+      batteryVoltage: 3.7,
+      solarVoltage: 5.1,
+      signalQuality: 80,
+      uptime: 3600,
+      httpReuseHits: 3480,
+      httpReuseMisses: 12,
+    }
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/diagnostics`)
+      .json(diagnosticsData)
+
+    response.assertStatus(200)
+
+    const stored = await StationDiagnostic.query().where('stationId', testStationId).first()
+    assert.exists(stored)
+    assert.equal(stored!.httpReuseHits, 3480)
+    assert.equal(stored!.httpReuseMisses, 12)
+  })
+
+  test('should store replayed diagnostics at the time they were taken', async ({
+    client,
+    assert,
+  }) => {
+    const diagnosticsData = {
+      batteryVoltage: 3.7,
+      solarVoltage: 5.1,
+      signalQuality: 80,
+      uptime: 3600,
+      queueDepth: 42,
+      queueFill: 7,
+      queueDrained: 120,
+      queueDropped: 0,
+      timestamp: '2025-06-01T12:00:00Z',
+    }
+
+    const response = await client
+      .post(`/api/stations/${testStationId}/diagnostics`)
+      .json(diagnosticsData)
+
+    response.assertStatus(200)
+
+    const stored = await StationDiagnostic.query().where('stationId', testStationId).first()
+    assert.exists(stored)
+    assert.equal(stored!.queueDepth, 42)
+    assert.equal(stored!.queueFill, 7)
+    assert.equal(stored!.queueDrained, 120)
+    assert.equal(stored!.queueDropped, 0)
+    assert.equal(stored!.createdAt.toUTC().toISO(), '2025-06-01T12:00:00.000Z')
+  })
+
   test('should reject missing battery voltage', async ({ client }) => {
     const diagnosticsData = {
       solarVoltage: 5.0,
@@ -370,6 +773,95 @@ test.group('Firmware Critical Endpoints', (group) => {
     })
   })
 
+  /**
+   * Composite Frame Endpoint Tests
+   * POST /api/stations/:station_id/frame
+   * Readings due together arrive in one request and are fanned out
+   */
+  test('should record every part of a telemetry frame', async ({ client, assert }) => {
+    const frame = {
+      wind: { windSpeed: 6.2, windDirection: 240, windGust: 8.1, windLull: 4.4 },
+      temperature: { temperature: 18.5 },
+      diagnostics: { batteryVoltage: 3.9, solarVoltage: 5.2, signalQuality: 70, uptime: 600 },
+    }
+
+    const response = await client.post(`/api/stations/${testStationId}/frame`).json(frame)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, parts: ['wind', 'temperature', 'diagnostics'] })
+
+    const temperature = await TemperatureReading.query().where('stationId', testStationId).first()
+    assert.equal(temperature!.temperature, 18.5)
+    const diagnostics = await StationDiagnostic.query().where('stationId', testStationId).first()
+    assert.equal(diagnostics!.batteryVoltage, 3.9)
+  })
+
+  test('should date frame parts from the frame timestamp', async ({ client, assert }) => {
+    const response = await client.post(`/api/stations/${testStationId}/frame`).json({
+      temperature: { temperature: 12 },
+      timestamp: '2025-06-01T12:00:00Z',
+    })
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, parts: ['temperature'] })
+
+    const temperature = await TemperatureReading.query().where('stationId', testStationId).first()
+    assert.equal(temperature!.readingTimestamp.toUTC().toISO(), '2025-06-01T12:00:00.000Z')
+  })
+
+  test('should record the valid parts of a frame and report the invalid ones', async ({
+    client,
+    assert,
+  }) => {
+    const response = await client.post(`/api/stations/${testStationId}/frame`).json({
+      temperature: { temperature: 18.5 },
+      diagnostics: { batteryVoltage: 3.9, solarVoltage: 5.2, signalQuality: 70 },
+    })
+
+    response.assertStatus(200)
+    response.assertBodyContains({ ok: true, parts: ['temperature'] })
+    assert.lengthOf(response.body().rejected, 1)
+    assert.equal(response.body().rejected[0].part, 'diagnostics')
+    assert.lengthOf(await TemperatureReading.query().where('stationId', testStationId), 1)
+    assert.lengthOf(await StationDiagnostic.query().where('stationId', testStationId), 0)
+  })
+
+  test('should reject a frame without any valid part', async ({ client, assert }) => {
+    const response = await client.post(`/api/stations/${testStationId}/frame`).json({
+      temperature: {},
+      diagnostics: 'low battery',
+    })
+
+    response.assertStatus(400)
+    response.assertBodyContains({ part: 'temperature' })
+    assert.deepEqual(
+      response.body().rejected.map((rejection: { part: string }) => rejection.part),
+      ['temperature', 'diagnostics']
+    )
+    assert.lengthOf(await TemperatureReading.query().where('stationId', testStationId), 0)
+  })
+
+  test('should reject an empty frame', async ({ client }) => {
+    const response = await client.post(`/api/stations/${testStationId}/frame`).json({})
+
+    response.assertStatus(400)
+    response.assertBody({ error: 'Empty frame' })
+  })
+
+  /**
+   * Transport Benchmark Endpoint Test
+   * POST /api/stations/:station_id/benchmark
+   */
+  test('should accept a benchmark body without recording it', async ({ client, assert }) => {
+    stationDataCache.clearStationData(testStationId)
+    const body = { windSpeed: 7.25, windDirection: 243.5 }
+    const response = await client.post(`/api/stations/${testStationId}/benchmark`).json(body)
+
+    response.assertStatus(200)
+    response.assertBody({ ok: true, bytes: JSON.stringify(body).length })
+    assert.isNull(stationDataCache.getWindData(testStationId))
+  })
+
   /**
    * Station Configuration Endpoint Tests
    * GET /api/stations/:station_id/config
@@ -512,6 +1004,72 @@ test.group('Firmware Critical Endpoints', (group) => {
     response.assertBodyContains({ ok: true, message: 'OTA confirmation received' })
   })
 
+  /**
+   * Config version hint
+   * Telemetry responses carry X-Config-Version, equal to the ETag of GET /config
+   */
+  test('should announce the config version on telemetry responses', async ({
+    client,
+    assert,
+  }) => {
+    const configResponse = await client.get(`/api/stations/${testStationId}/config`)
+    const etag = configResponse.header('etag')
+
+    const windResponse = await client
+      .post(`/api/stations/${testStationId}/wind`)
+      .json({ windSpeed: 5, windDirection: 90 })
+    windResponse.assertStatus(200)
+    assert.equal(windResponse.header('x-config-version'), etag)
+
+    await StationConfig.create({ stationId: testStationId, remoteOta: true })
+
+    const tempResponse = await client
+      .post(`/api/stations/${testStationId}/temperature`)
+      .json({ temperature: 20 })
+    tempResponse.assertStatus(201)
+    assert.notEqual(tempResponse.header('x-config-version'), etag)
+
+    const changedConfig = await client.get(`/api/stations/${testStationId}/config`)
+    assert.equal(tempResponse.header('x-config-version'), changedConfig.header('etag'))
+  })
+
+  test('should announce the new config version after an OTA confirmation', async ({
+    client,
+    assert,
+  }) => {
+    await StationConfig.create({ stationId: testStationId, remoteOta: true })
+
+    // The first telemetry response caches the version
+    const before = await client
+      .post(`/api/stations/${testStationId}/wind`)
+      .json({ windSpeed: 5, windDirection: 90 })
+    before.assertStatus(200)
+
+    const confirm = await client.post(`/api/stations/${testStationId}/ota-confirm`)
+    confirm.assertStatus(200)
+
+    const after = await client
+      .post(`/api/stations/${testStationId}/wind`)
+      .json({ windSpeed: 5, windDirection: 90 })
+    after.assertStatus(200)
+    assert.notEqual(after.header('x-config-version'), before.header('x-config-version'))
+
+    const config = await client.get(`/api/stations/${testStationId}/config`)
+    assert.equal(after.header('x-config-version'), config.header('etag'))
+  })
+
+  test('should not announce the config version on rejected telemetry', async ({
+    client,
+    assert,
+  }) => {
+    const response = await client
+      .post(`/api/stations/${testStationId}/wind`)
+      .json({ windSpeed: 'invalid', windDirection: 90 })
+
+    response.assertStatus(400)
+    assert.isUndefined(response.header('x-config-version'))
+  })
+
   /**
    * Critical Field Validation Tests
    * Ensure all firmware-expected fields maintain their exact structure
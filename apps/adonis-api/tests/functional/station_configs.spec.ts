@@ -424,4 +424,132 @@ test.group('Station Configs Controller', (group) => {
     assert.equal(body.windSendInterval, 60)
     assert.equal(body.windSampleInterval, 10)
   })
+
+  /**
+   * Test: POST /api/stations/:station_id/config - Wind vane calibration round trip
+   * The firmware expands this table into its direction lookup table
+   */
+  test('should store and return the wind vane calibration table', async ({ client, assert }) => {
+    const stationId = 'test-station-009'
+    const apiKey = process.env.ADMIN_API_KEY || 'test-api-key'
+    process.env.ADMIN_API_KEY = apiKey
+
+    await WeatherStation.create({
+      stationId: stationId,
+      name: 'Test Station 9',
+      location: 'Test Environment',
+      description: 'Test station for vane calibration test',
+      isActive: true,
+    })
+
+    const vaneCalibration = [3071, 1909, 330, 586, 1023, 2427, 3927, 3546]
+
+    const invalidResponse = await client
+      .post(`/api/stations/${stationId}/config`)
+      .header('X-API-Key', apiKey)
+      .json({ vaneCalibration: [3071, 1909, 330] })
+    invalidResponse.assertStatus(400)
+    assert.include(invalidResponse.body().error, 'Invalid value for vaneCalibration')
+
+    const storeResponse = await client
+      .post(`/api/stations/${stationId}/config`)
+      .header('X-API-Key', apiKey)
+      .json({ tempInterval: 300, vaneCalibration })
+    storeResponse.assertStatus(200)
+
+    const configResponse = await client.get(`/api/stations/${stationId}/config`)
+    configResponse.assertStatus(200)
+    assert.deepEqual(configResponse.body().vaneCalibration, vaneCalibration)
+  })
+
+  test('should store and return the wind batch size', async ({ client, assert }) => {
+    const stationId = 'test-station-010'
+    const apiKey = process.env.ADMIN_API_KEY || 'test-api-key'
+    process.env.ADMIN_API_KEY = apiKey
+
+    await WeatherStation.create({
+      stationId: stationId,
+      name: 'Test Station 10',
+      location: 'Test Environment',
+      description: 'Test station for wind batch size test',
+      isActive: true,
+    })
+
+    const storeResponse = await client
+      .post(`/api/stations/${stationId}/config`)
+      .header('X-API-Key', apiKey)
+      .json({ windSendInterval: 1000, windBatchSize: 10 })
+    storeResponse.assertStatus(200)
+
+    const configResponse = await client.get(`/api/stations/${stationId}/config`)
+    configResponse.assertStatus(200)
+    assert.equal(configResponse.body().windBatchSize, 10)
+  })
+
+  test('should answer 304 while the configuration is unchanged', async ({ client, assert }) => {
+    const stationId = 'test-station-011'
+    const apiKey = process.env.ADMIN_API_KEY || 'test-api-key'
+    process.env.ADMIN_API_KEY = apiKey
+
+    await WeatherStation.create({
+      stationId: stationId,
+      name: 'Test Station 11',
+      location: 'Test Environment',
+      description: 'Test station for conditional config fetch',
+      isActive: true,
+    })
+
+    await client
+      .post(`/api/stations/${stationId}/config`)
+      .header('X-API-Key', apiKey)
+      .json({ windSendInterval: 1000 })
+
+    const first = await client.get(`/api/stations/${stationId}/config`)
+    first.assertStatus(200)
+    const etag = first.header('etag')
+    assert.isString(etag)
+
+    const unchanged = await client
+      .get(`/api/stations/${stationId}/config`)
+      .header('If-None-Match', etag)
+    unchanged.assertStatus(304)
+    assert.equal(unchanged.text(), '')
+
+    await client
+      .post(`/api/stations/${stationId}/config`)
+      .header('X-API-Key', apiKey)
+      .json({ windSendInterval: 2000 })
+
+    const changed = await client
+      .get(`/api/stations/${stationId}/config`)
+      .header('If-None-Match', etag)
+    changed.assertStatus(200)
+    assert.equal(changed.body().windSendInterval, 2000)
+    assert.notEqual(changed.header('etag'), etag)
+  })
+
+  test('should store and return the CoAP telemetry switch', async ({ client, assert }) => {
+    const stationId = 'test-station-012'
+    const apiKey = process.env.ADMIN_API_KEY || 'test-api-key'
+    process.env.ADMIN_API_KEY = apiKey
+
+    await WeatherStation.create({
+      stationId: stationId,
+      name: 'Test Station 12',
+      location: 'Test Environment',
+      description: 'Test station for CoAP telemetry test',
+      isActive: true,
+    })
+
+    const storeResponse = await client
+      .post(`/api/stations/${stationId}/config`)
+      .header('X-API-Key', apiKey)
+      .json({ windSendInterval: 1000, coapTelemetry: true })
+    storeResponse.assertStatus(200)
+
+    const configResponse = await client.get(`/api/stations/${stationId}/config`)
+    configResponse.assertStatus(200)
+    // SQLite stores true as 1
+    assert.equal(configResponse.body().coapTelemetry, 1)
+  })
 })
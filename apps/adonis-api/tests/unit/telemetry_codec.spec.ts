@@ -0,0 +1,106 @@
+import { test } from '@japa/runner'
+import {
+  TelemetryDecodeError,
+  TelemetryRecordType,
+  decodeTelemetry,
+  encodeTelemetry,
+} from '#app/services/telemetry_codec'
+
+// The hex vectors are shared with the firmware encoder test
+// (firmware/test/test_telemetry_codec); change them in both places.
+test.group('Telemetry codec', () => {
+  test('should decode a livestream reading encoded by the firmware', ({ assert }) => {
+    // TelemetryCodec::encodeWindReading(5.123, 271.26)
+    const record = decodeTelemetry(Buffer.from('01010002990a', 'hex'))
+
+    assert.deepEqual(record, {
+      type: TelemetryRecordType.WindReading,
+      windSpeed: 5.12,
+      windDirection: 271.3,
+    })
+  })
+
+  test('should round trip an averaged period with its wind rose', ({ assert }) => {
+    const summary = {
+      type: TelemetryRecordType.WindSummary as const,
+      windSpeed: 6.2,
+      windDirection: 225,
+      windGust: 9.8,
+      windLull: 3.1,
+      windSpeedStdDev: 1.4,
+      windDirectionStdDev: 18.5,
+      windResultantSpeed: 5.6,
+      windResultantDirection: 228.4,
+      windPersistence: 0.9,
+      windRose: [
+        [6, 3, 2],
+        [7, 4, 1],
+      ] as [number, number, number][],
+    }
+
+    const encoded = encodeTelemetry(summary)
+
+    assert.equal(encoded.toString('hex'), '01026c02ca08d40336018c00b9003002ec08282302630200740100')
+    assert.deepEqual(decodeTelemetry(encoded), summary)
+  })
+
+  test('should round trip a batch of readings', ({ assert }) => {
+    const batch = {
+      type: TelemetryRecordType.WindBatch as const,
+      samples: [
+        { windSpeed: 5.1, windDirection: 180, ageMs: 2000 },
+        { windSpeed: 5.4, windDirection: 185, ageMs: 1000 },
+      ],
+    }
+
+    const encoded = encodeTelemetry(batch)
+
+    assert.lengthOf(encoded, 3 + 2 * 8)
+    assert.equal(encoded.toString('hex'), '010302fe010807d00700001c023a07e8030000')
+    assert.deepEqual(decodeTelemetry(encoded), batch)
+  })
+
+  test('should round trip the station aggregates', ({ assert }) => {
+    const aggregates = {
+      type: TelemetryRecordType.WindAggregates as const,
+      aggregates: [
+        {
+          level: 1,
+          windSpeed: 4.25,
+          windDirection: 270,
+          windGust: 6.8,
+          windLull: 2.1,
+          sampleCount: 240,
+          durationMs: 60000,
+          ageMs: 10000,
+        },
+        {
+          level: 10,
+          windSpeed: 3.9,
+          windDirection: 265.5,
+          windGust: 7.2,
+          windLull: 1.5,
+          sampleCount: 2400,
+          durationMs: 600000,
+          ageMs: 10000,
+        },
+      ],
+    }
+
+    const encoded = encodeTelemetry(aggregates)
+
+    assert.lengthOf(encoded, 3 + 2 * 19)
+    assert.equal(
+      encoded.toString('hex'),
+      '01040201a9018c0aa802d200f00060ea0000102700000a86015f0ad00296006009c027090010270000'
+    )
+    assert.deepEqual(decodeTelemetry(encoded), aggregates)
+  })
+
+  test('should reject truncated, unknown and oversized records', ({ assert }) => {
+    assert.throws(() => decodeTelemetry(Buffer.from('010100', 'hex')), TelemetryDecodeError)
+    assert.throws(() => decodeTelemetry(Buffer.from('02010002990a', 'hex')), TelemetryDecodeError)
+    assert.throws(() => decodeTelemetry(Buffer.from('01090002990a', 'hex')), TelemetryDecodeError)
+    assert.throws(() => decodeTelemetry(Buffer.from('01010002990a00', 'hex')), TelemetryDecodeError)
+  })
+})
@@ -137,9 +137,130 @@
 #define DEFAULT_TIME_UPDATE_INTERVAL 3600000  // Default time sync interval (ms) - 1 hour
 #define DEFAULT_CONFIG_UPDATE_INTERVAL 300000 // Default remote configuration update interval (ms) - 5 minutes
 
+// Telemetry responses announce the current config version (X-Config-Version).
+// While they do, the configuration is fetched when the announced version
+// differs from the one in effect, and otherwise only polled as a fallback.
+#define CONFIG_VERSION_POLL_INTERVAL 3600000 // Fallback poll while version hints arrive (ms) - 1 hour
+#define CONFIG_VERSION_FETCH_SPACING 30000   // Minimum time between version-triggered fetches (ms)
+
 // Wind sensor specific settings
 #define WIND_AVERAGING_SAMPLE_INTERVAL_MS 10000 // (10s) Interval for samples within a larger averaging period
 
+// Livestream readings can be sent in batches (windBatchSize in the remote
+// configuration). 1 sends every reading on its own. A batch is flushed when
+// it is full or its oldest reading reaches the maximum age.
+#define DEFAULT_WIND_BATCH_SIZE 1
+#define WIND_BATCH_MAX_AGE_MS 15000
+
+// Offline telemetry queue. Uploads that cannot be delivered are kept in
+// LittleFS segment files and replayed, with the time they were taken, once
+// the station is back online. The oldest segment is dropped when the queue
+// holds the maximum number of segments.
+#define TELEMETRY_QUEUE_SEGMENT_SIZE 16384         // Bytes per segment file
+#define TELEMETRY_QUEUE_MAX_SEGMENTS 16            // Flash budget: 256 KB
+#define TELEMETRY_QUEUE_DRAIN_BATCH 4              // Records replayed per loop pass, and per NVS read position write
+#define TELEMETRY_QUEUE_OFFLINE_BATCH_AGE_MS 60000 // Livestream readings are batched this long while offline
+
+// Anemometer pulse counting. The GPIO interrupt path with software debounce is
+// the default. Define ANEMOMETER_USE_PCNT to count with the ESP32 PCNT
+// peripheral instead; its glitch filter stops EMI spikes but not reed switch
+// bounce, so it suits only anemometers with a clean (e.g. Hall effect) output.
+#define ANEMOMETER_PCNT_FILTER_CYCLES 1023 // PCNT glitch filter in APB cycles (max 1023 = ~12.8us)
+#define ANEMOMETER_DEBOUNCE_MS 10          // Software debounce of the interrupt path
+
+// Wind vane ADC is sampled in the background and read as a filtered value
+#define WIND_VANE_SAMPLE_PERIOD_MS 10 // Background ADC sample period (8-sample moving average)
+
+// Vane cluster tracking follows ADC drift; the lookup table is rebuilt (in RAM
+// only) once a tracked center has moved this far from the active table
+#define WIND_VANE_RETUNE_SHIFT_ADC 4
+
+// Wind acquisition runs in its own task on the application core, above the
+// Arduino loop priority, so modem and HTTP calls cannot delay it
+#define WIND_TASK_TICK_MS 250     // Fixed sampling cadence (WMO 4 Hz gust ticks)
+#define WIND_TASK_PRIORITY 5      // Arduino loop runs at priority 1
+#define WIND_TASK_CORE 1          // Application core; the WiFi/BT stack lives on core 0
+#define WIND_TASK_STACK_SIZE 6144 // Logger formats into a 512 byte stack buffer
+
+// Define WIND_AGGREGATES to keep 1 min and 10 min wind statistics on the
+// station (sensors/WindAggregationPyramid.h) and upload each completed bucket
+// to /wind/aggregates. The server stores them as the station's 1 min and
+// 10 min rows instead of recomputing those from the raw readings.
+
+// HTTP connection reuse. Define HTTP_KEEP_ALIVE to keep the TCP connection to
+// the server open between requests. Idle connections are closed before the
+// server's keep-alive timeout (Node.js default: 5 s) would close them.
+#ifdef CONFIG_HTTP_KEEP_ALIVE_IDLE_MS
+#define HTTP_KEEP_ALIVE_IDLE_MS CONFIG_HTTP_KEEP_ALIVE_IDLE_MS
+#else
+#define HTTP_KEEP_ALIVE_IDLE_MS 4000
+#endif
+
+// Define HTTP_ASYNC to send the telemetry POSTs without blocking the loop
+// (core/AsyncHttpRequest.h). Each loop pass advances the request in flight
+// for at most HTTP_ASYNC_SLICE_MS; only the TCP connect waits on the modem.
+#define HTTP_ASYNC_SLICE_MS 20
+#define HTTP_ASYNC_CONNECT_TIMEOUT_S 10
+#define HTTP_ASYNC_RESPONSE_TIMEOUT_MS 30000 // Without a byte received; as ArduinoHttpClient
+#define HTTP_ASYNC_WRITE_CHUNK 256           // Bytes per write: one AT+CIPSEND of a few ms at 115200 baud
+#define HTTP_ASYNC_READ_CHUNK 128            // Bytes per read, on the loop's stack
+#define HTTP_ASYNC_POLL_INTERVAL_MS 10       // Loop delay while a request is in flight
+
+// Define HTTP_MODEM_STACK to send the blocking telemetry POSTs through the
+// SIM7000's own HTTP client (core/ModemHttpTransport.h) instead of the socket.
+// The "bench" serial command compares both, HTTP_BENCHMARK_ROUNDS per payload.
+#define MODEM_HTTP_BODY_MAX 4096              // AT+SHCONF "BODYLEN", the modem's limit
+#define MODEM_HTTP_HEADER_MAX 350             // AT+SHCONF "HEADERLEN", the modem's limit
+#define MODEM_HTTP_CONNECT_TIMEOUT_MS 30000   // AT+SHCONN
+#define MODEM_HTTP_BODY_TIMEOUT_MS 5000       // AT+SHBOD prompt and transfer
+#define MODEM_HTTP_RESPONSE_TIMEOUT_MS 30000  // AT+SHREQ result; as ArduinoHttpClient
+#define HTTP_BENCHMARK_ROUNDS 10
+
+// Define TELEMETRY_COAP to send wind and temperature telemetry as confirmable
+// CoAP POSTs over UDP (core/CoapTransport.h) instead of HTTP; the coapTelemetry
+// config key switches it remotely, but only turns it on in HTTP_ASYNC builds,
+// where an exchange does not hold the loop. An exchange without ACK is sent over HTTP,
+// and COAP_MAX_FAILURES of those in a row switch CoAP off for this firmware version,
+// across restarts, until coapTelemetry is switched off and on again.
+// MAX_RETRANSMIT is 2 instead of RFC 7252's 4, which keeps the longest wait
+// (MAX_TRANSMIT_WAIT, 21 s) below the HTTP response timeout.
+#define COAP_ACK_TIMEOUT_MS 2000
+#define COAP_ACK_RANDOM_FACTOR_PERCENT 150
+#define COAP_MAX_RETRANSMIT 2
+#define COAP_PAYLOAD_MAX 1024     // No blockwise transfer; larger bodies (full batches) go over HTTP
+#define COAP_DATAGRAM_MAX 1152    // Payload, header, token and the Uri-Path options
+#define COAP_POLL_INTERVAL_MS 50  // Between checks for a reply on the modem
+#define COAP_MODEM_MUX 7          // Modem connection of the UDP socket; TinyGSM's client uses 0
+#define COAP_MAX_FAILURES 3       // Exchanges in a row without ACK before CoAP is switched off
+
+// Composite telemetry frames. Averaged wind, temperature and diagnostics that
+// come due within this window of each other are sent in one POST to /frame
+// instead of one request each; readings due before the frame closes are taken
+// early to ride along. 0 sends each on its own.
+#ifdef CONFIG_TELEMETRY_FRAME_WINDOW_MS
+#define TELEMETRY_FRAME_WINDOW_MS CONFIG_TELEMETRY_FRAME_WINDOW_MS
+#else
+#define TELEMETRY_FRAME_WINDOW_MS 20000
+#endif
+
+// Outbound request scheduling. Each class of network work waits at most this
+// long for dispatch; the earliest deadline goes first, so live wind is sent
+// ahead of the rest on a slow link. A loop pass starts no new request after
+// OUTBOUND_DISPATCH_BUDGET_MS; what is left waits for the next pass.
+#define OUTBOUND_DEADLINE_WIND_MS 2000
+#define OUTBOUND_DEADLINE_CONFIG_MS 30000
+#define OUTBOUND_DEADLINE_FRAME_MS 30000
+#define OUTBOUND_DEADLINE_TEMPERATURE_MS 60000
+#define OUTBOUND_DEADLINE_DIAGNOSTICS_MS 300000
+#define OUTBOUND_DEADLINE_AGGREGATES_MS 60000
+#define OUTBOUND_DEADLINE_REPLAY_MS 600000
+#define OUTBOUND_DISPATCH_BUDGET_MS 5000
+#define WIND_SUMMARY_PENDING_MAX 4 // Averaged wind periods kept for dispatch; the oldest then goes to the offline queue
+
+// Define TELEMETRY_BINARY to send the wind uploads as compact binary records
+// (core/TelemetryCodec.h) instead of JSON. The client falls back to JSON if
+// the server does not accept the format.
+
 // Watchdog settings
 #define WDT_TIMEOUT 120000 // Watchdog timeout in ms (120 seconds), was 30000
 // Define this to enable temporary watchdog disabling during modem operations
@@ -172,3 +293,10 @@
 #else
 #define SERVER_PORT (uint16_t)80
 #endif
+
+// CoAP telemetry goes to the same host, over UDP
+#ifdef CONFIG_COAP_PORT
+#define COAP_PORT (uint16_t)CONFIG_COAP_PORT
+#else
+#define COAP_PORT (uint16_t)5683
+#endif
@@ -8,12 +8,99 @@
 #include <ArduinoJson.h> // Use ArduinoJson for robust parsing
 #include "esp_task_wdt.h"
 #include "core/ModemManager.h"
+#include "../sensors/VaneCalibration.h"
+#include "../config/Config.h"
+#include "TelemetryCodec.h"
+#include "TelemetryQueue.h"
+#include <Preferences.h>
 
 #define LOG_TAG_HTTP "HTTP"
 
 // Global instance
 AiolosHttpClient httpClient;
 
+namespace
+{
+    /**
+     * @brief Read-only view of a response body that ends after its Content-Length
+     *
+     * Lets ArduinoJson parse from the socket without reading past the body
+     * into whatever follows on a kept-alive connection.
+     */
+    class ResponseBodyStream : public Stream
+    {
+    public:
+        // length -1: no Content-Length, the body ends when the server closes
+        ResponseBodyStream(Stream &inner, int length) : _inner(inner), _remaining(length) {}
+
+        int available() override
+        {
+            int available = _inner.available();
+            return _remaining >= 0 && available > _remaining ? _remaining : available;
+        }
+
+        int read() override
+        {
+            if (_remaining == 0)
+            {
+                return -1;
+            }
+            int c = _inner.read();
+            if (c >= 0 && _remaining > 0)
+            {
+                _remaining--;
+            }
+            return c;
+        }
+
+        int peek() override { return _remaining == 0 ? -1 : _inner.peek(); }
+
+        size_t write(uint8_t) override { return 0; }
+
+        int remaining() const { return _remaining < 0 ? 0 : _remaining; }
+
+    private:
+        Stream &_inner;
+        int _remaining;
+    };
+
+    // CoAP switched off after COAP_MAX_FAILURES, kept across restarts for the firmware version that failed
+    const char *COAP_NVS_NAMESPACE = "coap";
+    const char *COAP_NVS_KEY = "offFor";
+
+    bool isCoapFallbackStored()
+    {
+        Preferences prefs;
+        if (!prefs.begin(COAP_NVS_NAMESPACE, true))
+        {
+            return false;
+        }
+        char version[16] = "";
+        prefs.getString(COAP_NVS_KEY, version, sizeof(version));
+        prefs.end();
+        // An updated firmware tries CoAP again
+        return strcmp(version, FIRMWARE_VERSION) == 0;
+    }
+
+    void storeCoapFallback(bool fallback)
+    {
+        Preferences prefs;
+        if (!prefs.begin(COAP_NVS_NAMESPACE, false))
+        {
+            return;
+        }
+        if (fallback)
+        {
+            prefs.putString(COAP_NVS_KEY, FIRMWARE_VERSION);
+        }
+        else if (prefs.isKey(COAP_NVS_KEY))
+        {
+            prefs.remove(COAP_NVS_KEY);
+        }
+        prefs.end();
+    }
+}
+
 AiolosHttpClient::AiolosHttpClient()
 {
     // Constructor is intentionally empty. Initialization is done in init().
@@ -120,6 +207,205 @@ bool AiolosHttpClient::init(ModemManager &modemManager, const char *serverAddres
         return false;
     }
 
+#ifdef HTTP_KEEP_ALIVE
+    _keepAlive = true;
+#endif
+#ifdef TELEMETRY_BINARY
+    _binaryTelemetry = true;
+#endif
+#ifdef HTTP_ASYNC
+    _async = true;
+#endif
+#ifdef HTTP_MODEM_STACK
+    _transport = TRANSPORT_MODEM;
+#endif
+    _frameWindowMs = TELEMETRY_FRAME_WINDOW_MS;
+    if (_coapTelemetry && isCoapFallbackStored())
+    {
+        Logger.warn(LOG_TAG_COAP, "CoAP telemetry stays off, it got no acknowledgements before the last restart");
+        _coapTelemetry = false;
+    }
+
+    _outbound.setDeadline(OutboundScheduler::WIND, OUTBOUND_DEADLINE_WIND_MS);
+    _outbound.setDeadline(OutboundScheduler::CONFIG, OUTBOUND_DEADLINE_CONFIG_MS);
+    _outbound.setDeadline(OutboundScheduler::FRAME, OUTBOUND_DEADLINE_FRAME_MS);
+    _outbound.setDeadline(OutboundScheduler::TEMPERATURE, OUTBOUND_DEADLINE_TEMPERATURE_MS);
+    _outbound.setDeadline(OutboundScheduler::DIAGNOSTICS, OUTBOUND_DEADLINE_DIAGNOSTICS_MS);
+    _outbound.setDeadline(OutboundScheduler::AGGREGATES, OUTBOUND_DEADLINE_AGGREGATES_MS);
+    _outbound.setDeadline(OutboundScheduler::REPLAY, OUTBOUND_DEADLINE_REPLAY_MS);
+
+    if (!_createArduinoClient())
+    {
+        return false;
+    }
+    _request.begin(*_client, _serverAddress, _serverPort);
+    _modemTransport.begin(*_modemManager->getModem(), _serverAddress, _serverPort);
+    _coap.begin(*_modemManager->getModem(), _serverAddress, COAP_PORT);
+
+    Logger.info(LOG_TAG_HTTP, "HTTP client initialized for server %s:%u (keep-alive %s, %s, %s transport, %s wind telemetry, CoAP %s, frame window %lu ms)",
+                _serverAddress, _serverPort, _keepAlive ? "on" : "off", _async ? "async" : "blocking",
+                _transport == TRANSPORT_MODEM ? "modem" : "socket", _binaryTelemetry ? "binary" : "JSON",
+                _coapTelemetry ? "on" : "off", _frameWindowMs);
+    return true;
+}
+
+/**
+ * @brief Enable or disable connection reuse
+ */
+void AiolosHttpClient::setKeepAlive(bool enabled)
+{
+    if (enabled == _keepAlive)
+    {
+        return;
+    }
+    _keepAlive = enabled;
+
+    // ArduinoHttpClient cannot switch back to "Connection: close", so start over
+    if (_arduinoClient)
+    {
+        _arduinoClient->stop();
+        delete _arduinoClient;
+        _arduinoClient = nullptr;
+        _createArduinoClient();
+    }
+    Logger.info(LOG_TAG_HTTP, "HTTP keep-alive %s", enabled ? "enabled" : "disabled");
+}
+
+/**
+ * @brief Select the transport of the blocking telemetry POSTs
+ */
+void AiolosHttpClient::setTransport(Transport transport)
+{
+    if (transport == _transport)
+    {
+        return;
+    }
+    _awaitRequest();
+    if (_transport == TRANSPORT_MODEM)
+    {
+        _modemTransport.disconnect();
+    }
+    _transport = transport;
+    Logger.info(LOG_TAG_HTTP, "HTTP transport: %s", transport == TRANSPORT_MODEM ? "modem" : "socket");
+}
+
+int AiolosHttpClient::postRaw(const char *path, const char *contentType, const uint8_t *body, size_t bodyLength)
+{
+    _awaitRequest();
+    return _performLightweightPost(path, contentType, body, bodyLength);
+}
+
+/**
+ * @brief Enable or disable wind and temperature telemetry over CoAP
+ */
+void AiolosHttpClient::setCoapTelemetry(bool enabled)
+{
+    if (!enabled)
+    {
+        storeCoapFallback(false); // Switching it off clears an automatic fallback
+    }
+    else if (!_coapTelemetry && isCoapFallbackStored())
+    {
+        Logger.warn(LOG_TAG_COAP, "CoAP telemetry stays off after failing on this firmware; switch it off and on to retry");
+        return;
+    }
+    if (enabled == _coapTelemetry)
+    {
+        return;
+    }
+    _awaitRequest();
+    _coapTelemetry = enabled;
+    _coapFailures = 0;
+    if (!enabled)
+    {
+        _coap.close();
+    }
+    Logger.info(LOG_TAG_COAP, "CoAP telemetry %s", enabled ? "enabled" : "disabled");
+}
+
+/**
+ * @brief Enable or disable non-blocking telemetry sends
+ */
+void AiolosHttpClient::setAsync(bool enabled)
+{
+    if (!enabled)
+    {
+        _awaitRequest();
+    }
+    _async = enabled;
+}
+
+/**
+ * @brief Advance the request in flight and complete it once it has finished
+ */
+void AiolosHttpClient::poll()
+{
+    if (_coap.poll())
+    {
+        _completeCoapUpload(_coap.statusCode());
+        return;
+    }
+    if (!_request.poll())
+    {
+        return;
+    }
+
+    const char *contentType = _upload.binaryLength > 0 ? TELEMETRY_CONTENT_TYPE : "application/json";
+    int statusCode = _request.statusCode();
+    if (statusCode < 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "HTTP request failed, error: %d", statusCode);
+        _handleHttpFailure();
+        _finishRequest(false);
+    }
+    else
+    {
+        if (_keepAlive)
+        {
+            if (_request.wasReused())
+            {
+                _reuseHits++;
+            }
+            else
+            {
+                _reuseMisses++;
+            }
+        }
+        Logger.debug(LOG_TAG_HTTP, "HTTP Status: %d", statusCode);
+        _finishRequest(_request.isReusable());
+        _handleLightweightStatus(statusCode, contentType, _responseVersionHeader, _responseConfigVersion);
+    }
+    _completeUpload(statusCode);
+}
+
+const char *AiolosHttpClient::describeLastSend() const
+{
+    if (isRequestInFlight())
+    {
+        return "sending";
+    }
+    return isFrameOpen() ? "staged for the telemetry frame" : "sent successfully";
+}
+
+/**
+ * @brief Blocks until the request in flight has finished.
+ * Sends never overlap: the body of the one in flight is still in its buffer,
+ * and ArduinoHttpClient requests share its socket.
+ */
+void AiolosHttpClient::_awaitRequest()
+{
+    while (isRequestInFlight())
+    {
+        poll();
+        delay(1);
+    }
+}
+
+/**
+ * @brief Creates the ArduinoHttpClient on top of the modem socket.
+ */
+bool AiolosHttpClient::_createArduinoClient()
+{
     // Initialize the ArduinoHttpClient as a pointer
     _arduinoClient = new HttpClient(*_client, _serverAddress, _serverPort);
 
@@ -132,10 +418,176 @@ bool AiolosHttpClient::init(ModemManager &modemManager, const char *serverAddres
     // Set the connection timeout. This is important for cellular connections.
     _arduinoClient->setTimeout(30000L); // 30 seconds
 
-    Logger.info(LOG_TAG_HTTP, "HTTP client initialized for server %s:%u", _serverAddress, _serverPort);
+    if (_keepAlive)
+    {
+        // Send "Connection: keep-alive" and only connect when the socket is closed
+        _arduinoClient->connectionKeepAlive();
+    }
+    return true;
+}
+
+/**
+ * @brief Decides whether the next request can use the open connection.
+ *
+ * A connection is only reused if the modem still reports the socket as
+ * connected and it has been idle for less than HTTP_KEEP_ALIVE_IDLE_MS, so
+ * a request never races the server closing an idle connection.
+ * @return true if the open connection will be reused
+ */
+bool AiolosHttpClient::_prepareConnection()
+{
+    if (!_keepAlive || !_client->connected())
+    {
+        return false;
+    }
+
+    if (millis() - _lastRequestEndMs >= HTTP_KEEP_ALIVE_IDLE_MS)
+    {
+        Logger.debug(LOG_TAG_HTTP, "Closing connection idle for %lu ms", millis() - _lastRequestEndMs);
+        _arduinoClient->stop();
+        return false;
+    }
     return true;
 }
 
+/**
+ * @brief Sends the request and reads the status line.
+ *
+ * In keep-alive mode an open connection is reused. If it turns out to have
+ * been closed by the server in the meantime, the request is sent once more
+ * on a new connection.
+ * @param headerName Optional extra request header, sent with headerValue.
+ * @return The HTTP status code, or a negative ArduinoHttpClient error.
+ */
+int AiolosHttpClient::_startRequest(const char *method, const char *path, const char *contentType,
+                                    const uint8_t *body, size_t bodyLength, const char *headerName,
+                                    const char *headerValue)
+{
+    bool reused = _prepareConnection();
+    bool isPost = strcmp(method, "POST") == 0;
+
+    for (;;)
+    {
+        int err = 0;
+        if (headerName && headerValue)
+        {
+            // Headers stay open after post()/get() until endRequest(), the body follows
+            _arduinoClient->beginRequest();
+            err = isPost ? _arduinoClient->post(path, contentType, (int)bodyLength, nullptr) : _arduinoClient->get(path);
+            if (err == 0)
+            {
+                _arduinoClient->sendHeader(headerName, headerValue);
+                _arduinoClient->endRequest();
+                if (isPost && bodyLength > 0)
+                {
+                    _arduinoClient->write(body, bodyLength);
+                }
+            }
+        }
+        else if (isPost)
+        {
+            err = _arduinoClient->post(path, contentType, (int)bodyLength, body);
+        }
+        else
+        {
+            err = _arduinoClient->get(path);
+        }
+
+        int statusCode = err != 0 ? err : _arduinoClient->responseStatusCode();
+        if (statusCode < 0 && reused)
+        {
+            Logger.info(LOG_TAG_HTTP, "Reused connection was closed by the server, reconnecting");
+            _arduinoClient->stop();
+            reused = false; // The retry counts as a miss
+            continue;
+        }
+
+        if (_keepAlive && statusCode >= 0)
+        {
+            if (reused)
+            {
+                _reuseHits++;
+            }
+            else
+            {
+                _reuseMisses++;
+            }
+        }
+        return statusCode;
+    }
+}
+
+/**
+ * @brief Reads exactly the announced response body so the connection can be reused.
+ * @param responseBody Receives the body, or nullptr to discard it.
+ * @return true if the whole body was read and the connection is clean.
+ */
+bool AiolosHttpClient::_readBodyByLength(int contentLength, String *responseBody)
+{
+    unsigned long lastRead = millis();
+    const unsigned long readTimeout = 30000; // 30 seconds timeout - matches HttpClient timeout
+    int remaining = contentLength;
+
+    while (remaining > 0 && _arduinoClient->connected() && (millis() - lastRead < readTimeout))
+    {
+        while (remaining > 0 && _arduinoClient->available())
+        {
+            char c = _arduinoClient->read();
+            if (responseBody)
+            {
+                *responseBody += c;
+            }
+            remaining--;
+            lastRead = millis(); // Reset timeout timer with each byte received
+        }
+    }
+    return remaining == 0;
+}
+
+/**
+ * @brief Reads the response headers, feeding each byte to a scanner.
+ * Same loop and timeout as HttpClient::skipResponseHeaders().
+ * @return true if the end of the headers was reached.
+ */
+bool AiolosHttpClient::_scanResponseHeaders(ResponseHeaderScanner &scanner)
+{
+    unsigned long lastRead = millis();
+    const unsigned long readTimeout = 30000; // 30 seconds timeout - matches HttpClient timeout
+
+    while (!_arduinoClient->endOfHeadersReached() && (millis() - lastRead < readTimeout))
+    {
+        if (_arduinoClient->available())
+        {
+            int c = _arduinoClient->readHeader();
+            if (c >= 0)
+            {
+                scanner.feed((char)c);
+            }
+            lastRead = millis();
+        }
+        else
+        {
+            delay(10);
+        }
+    }
+    return _arduinoClient->endOfHeadersReached();
+}
+
+/**
+ * @brief Ends a request: keeps the connection for the next one or closes it.
+ */
+void AiolosHttpClient::_finishRequest(bool reusable)
+{
+    if (_keepAlive && reusable)
+    {
+        _lastRequestEndMs = millis();
+        return;
+    }
+
+    // Close the connection; without keep-alive every request opens its own
+    _arduinoClient->stop();
+}
+
 /**
  * @brief Performs the actual HTTP request and handles the response.
  * @param method The HTTP method ("GET" or "POST").
@@ -146,6 +598,8 @@ bool AiolosHttpClient::init(ModemManager &modemManager, const char *serverAddres
  */
 int AiolosHttpClient::_performRequest(const char *method, const char *path, const char *body, String &responseBody)
 {
+    _awaitRequest();
+
     if (this->isConnectionThrottled())
     {
         return 0; // Throttled, do not attempt
@@ -165,26 +619,15 @@ int AiolosHttpClient::_performRequest(const char *method, const char *path, cons
 
     Logger.debug(LOG_TAG_HTTP, "Sending %s request to %s", method, path);
 
-    int err = 0;
-    if (strcmp(method, "POST") == 0)
-    {
-        const char *requestBody = (body != nullptr) ? body : "";
-        err = _arduinoClient->post(path, "application/json", requestBody);
-    }
-    else
-    {
-        err = _arduinoClient->get(path);
-    }
-
-    if (err != 0)
+    const char *requestBody = (body != nullptr) ? body : "";
+    int statusCode = _startRequest(method, path, "application/json", (const uint8_t *)requestBody, strlen(requestBody));
+    if (statusCode < 0)
     {
-        Logger.error(LOG_TAG_HTTP, "HTTP request failed to connect, error: %d", err);
+        Logger.error(LOG_TAG_HTTP, "HTTP request failed to connect, error: %d", statusCode);
         _handleHttpFailure();
         _arduinoClient->stop(); // Ensure the client is stopped on failure
-        return err;             // Return the error code from the library
+        return statusCode;      // Return the error code from the library
     }
-
-    int statusCode = _arduinoClient->responseStatusCode();
     Logger.debug(LOG_TAG_HTTP, "HTTP Status: %d", statusCode);
 
     // Skip response headers to get to the body
@@ -198,29 +641,38 @@ int AiolosHttpClient::_performRequest(const char *method, const char *path, cons
 
     // Get the content length from the headers
     int contentLength = _arduinoClient->contentLength();
-    if (contentLength == 0 || contentLength == -1)
-    {
-        Logger.warn(LOG_TAG_HTTP, "Content-Length is 0 or not specified. Reading until timeout.");
-    }
 
     // Read the response body with a timeout
     responseBody = ""; // Clear the string
+    bool reusable = false;
 
-    unsigned long lastRead = millis();
-    const unsigned long readTimeout = 30000; // 30 seconds timeout - matches HttpClient timeout
-
-    while (_arduinoClient->connected() && (millis() - lastRead < readTimeout))
+    if (_keepAlive && contentLength >= 0)
+    {
+        // The server keeps the connection open, so stop after the announced length
+        reusable = _readBodyByLength(contentLength, &responseBody);
+    }
+    else
     {
-        while (_arduinoClient->available())
+        if (contentLength == 0 || contentLength == -1)
         {
-            char c = _arduinoClient->read();
-            responseBody += c;
-            lastRead = millis(); // Reset timeout timer with each byte received
+            Logger.warn(LOG_TAG_HTTP, "Content-Length is 0 or not specified. Reading until timeout.");
+        }
+
+        unsigned long lastRead = millis();
+        const unsigned long readTimeout = 30000; // 30 seconds timeout - matches HttpClient timeout
+
+        while (_arduinoClient->connected() && (millis() - lastRead < readTimeout))
+        {
+            while (_arduinoClient->available())
+            {
+                char c = _arduinoClient->read();
+                responseBody += c;
+                lastRead = millis(); // Reset timeout timer with each byte received
+            }
         }
     }
 
-    // It's important to stop the client after each request to close the connection
-    _arduinoClient->stop();
+    _finishRequest(reusable);
 
     if (responseBody.length() > 0)
     {
@@ -246,14 +698,26 @@ int AiolosHttpClient::_performRequest(const char *method, const char *path, cons
 }
 
 /**
- * @brief Performs a lightweight HTTP POST request without reading response body.
- * Optimized for high-frequency data sending where only status code matters.
+ * @brief Performs a GET request and parses the JSON response while it downloads.
+ *
+ * The body is fed to ArduinoJson straight from the socket instead of being
+ * collected into a String first. With the filter only known keys are kept,
+ * so memory use does not depend on the size of the response.
  * @param path The URL path for the request.
- * @param body The request body.
- * @return The HTTP status code, or 0 on failure.
+ * @param doc Receives the filtered document of a 2xx response.
+ * @param filter ArduinoJson filter; keys set to true are kept.
+ * @param error Receives the parse result of a 2xx response.
+ * @param etag Optional ETag buffer. A non-empty value is sent as If-None-Match,
+ *             and the ETag of a 2xx response replaces it.
+ * @param etagSize Size of the etag buffer.
+ * @return The HTTP status code (304 if the resource is unchanged), or 0 on
+ *         failure before sending.
  */
-int AiolosHttpClient::_performLightweightPost(const char *path, const char *body)
+int AiolosHttpClient::_performJsonGet(const char *path, JsonDocument &doc, const JsonDocument &filter,
+                                      DeserializationError &error, char *etag, size_t etagSize)
 {
+    _awaitRequest();
+
     if (this->isConnectionThrottled())
     {
         return 0; // Throttled, do not attempt
@@ -271,26 +735,57 @@ int AiolosHttpClient::_performLightweightPost(const char *path, const char *body
         return 0;
     }
 
-    Logger.debug(LOG_TAG_HTTP, "Sending lightweight POST request to %s", path);
-
-    const char *requestBody = (body != nullptr) ? body : "";
-    int err = _arduinoClient->post(path, "application/json", requestBody);
+    Logger.debug(LOG_TAG_HTTP, "Sending GET request to %s", path);
 
-    if (err != 0)
+    bool conditional = etag && etagSize > 0 && etag[0] != '\0';
+    int statusCode = _startRequest("GET", path, "application/json", nullptr, 0, conditional ? "If-None-Match" : nullptr,
+                                   conditional ? etag : nullptr);
+    if (statusCode < 0)
     {
-        Logger.error(LOG_TAG_HTTP, "HTTP request failed to connect, error: %d", err);
+        Logger.error(LOG_TAG_HTTP, "HTTP request failed to connect, error: %d", statusCode);
         _handleHttpFailure();
         _arduinoClient->stop();
-        return err;
+        return statusCode;
     }
-
-    int statusCode = _arduinoClient->responseStatusCode();
     Logger.debug(LOG_TAG_HTTP, "HTTP Status: %d", statusCode);
 
-    // Important: stop the client immediately to close the connection
-    _arduinoClient->stop();
+    // Pick the ETag out of the response headers
+    char responseEtag[STATION_CONFIG_ETAG_SIZE] = "";
+    while (etag && _arduinoClient->headerAvailable())
+    {
+        if (_arduinoClient->readHeaderName().equalsIgnoreCase("ETag"))
+        {
+            strlcpy(responseEtag, _arduinoClient->readHeaderValue().c_str(), sizeof(responseEtag));
+        }
+    }
+
+    if (_arduinoClient->skipResponseHeaders() < 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Failed to skip response headers");
+        _handleHttpFailure();
+        _arduinoClient->stop();
+        return 0;
+    }
+
+    // A 304 never has a body, whatever the headers say
+    int contentLength = statusCode == HTTP_NOT_MODIFIED ? 0 : _arduinoClient->contentLength();
+    ResponseBodyStream body(*_arduinoClient, contentLength);
+    body.setTimeout(30000); // 30 seconds timeout - matches HttpClient timeout
 
     if (statusCode >= 200 && statusCode < 300)
+    {
+        error = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+        if (etag && !error)
+        {
+            strlcpy(etag, responseEtag, etagSize);
+        }
+    }
+
+    // Drain what the parser left (trailing whitespace or an error body) so the connection stays usable
+    bool reusable = _keepAlive && contentLength >= 0 && _readBodyByLength(body.remaining(), nullptr);
+    _finishRequest(reusable);
+
+    if ((statusCode >= 200 && statusCode < 300) || statusCode == HTTP_NOT_MODIFIED)
     {
         _resetBackoff();
     }
@@ -304,50 +799,540 @@ int AiolosHttpClient::_performLightweightPost(const char *path, const char *body
 }
 
 /**
- * @brief Send diagnostics data to the server
+ * @brief Performs a lightweight HTTP POST request without reading response body.
+ * Optimized for high-frequency data sending where only status code matters.
+ * The headers are scanned for the config version hint (X-Config-Version).
+ * In keep-alive mode the body is still drained, unparsed, so the connection
+ * can carry the next request. With TRANSPORT_MODEM the modem sends it.
+ * @param path The URL path for the request.
+ * @param contentType The Content-Type header value.
+ * @param body The request body.
+ * @param bodyLength Length of the body in bytes.
+ * @return The HTTP status code, or 0 on failure.
  */
-bool AiolosHttpClient::sendDiagnostics(const char *stationId, float batteryVoltage, float solarVoltage, float internalTemp, int signalQuality, unsigned long uptime)
+int AiolosHttpClient::_performLightweightPost(const char *path, const char *contentType, const uint8_t *body,
+                                              size_t bodyLength)
 {
-    Logger.info(LOG_TAG_HTTP, "Sending diagnostics data for station %s", stationId);
+    if (this->isConnectionThrottled())
+    {
+        return 0; // Throttled, do not attempt
+    }
 
-    // Create JSON payload using ArduinoJson with fixed-size document
-    JsonDocument doc;
-    doc.to<JsonObject>(); // Ensure it's an object
-    doc["batteryVoltage"] = batteryVoltage;
-    doc["solarVoltage"] = solarVoltage;
-    doc["internalTemperature"] = internalTemp;
-    doc["signalQuality"] = signalQuality;
-    doc["uptime"] = uptime;
+    if (!_modemManager)
+    {
+        Logger.error(LOG_TAG_HTTP, "HTTP client not initialized");
+        return 0;
+    }
+
+    if (!_modemManager->isNetworkConnected() || !_modemManager->isGprsConnected())
+    {
+        Logger.error(LOG_TAG_HTTP, "Network not connected, cannot send request");
+        return 0;
+    }
 
-    String jsonBuffer;
-    serializeJson(doc, jsonBuffer);
+    // Only the config version header is kept; the body is never parsed
+    char configVersion[STATION_CONFIG_ETAG_SIZE];
+    ResponseHeaderScanner versionHeader(CONFIG_VERSION_HEADER, configVersion, sizeof(configVersion));
 
-    // Build the URL path
-    char urlPath[URL_PATH_SIZE];
-    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/diagnostics", stationId);
+    if (_transport == TRANSPORT_MODEM && ModemHttpTransport::fits(bodyLength))
+    {
+        Logger.debug(LOG_TAG_HTTP, "Sending POST request to %s through the modem", path);
+        int statusCode = _modemTransport.post(path, contentType, body, bodyLength);
+        if (statusCode < 0)
+        {
+            Logger.error(LOG_TAG_HTTP, "HTTP request failed, error: %d", statusCode);
+            _handleHttpFailure();
+            return statusCode;
+        }
+        Logger.debug(LOG_TAG_HTTP, "HTTP Status: %d", statusCode);
+        _handleLightweightStatus(statusCode, contentType, versionHeader, configVersion);
+        return statusCode;
+    }
 
-    String responseBody;
-    int statusCode = _performRequest("POST", urlPath, jsonBuffer.c_str(), responseBody);
+    Logger.debug(LOG_TAG_HTTP, "Sending lightweight POST request to %s", path);
 
+    int statusCode = _startRequest("POST", path, contentType, body, bodyLength);
+    if (statusCode < 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "HTTP request failed to connect, error: %d", statusCode);
+        _handleHttpFailure();
+        _arduinoClient->stop();
+        return statusCode;
+    }
+    Logger.debug(LOG_TAG_HTTP, "HTTP Status: %d", statusCode);
+
+    bool headersRead = _scanResponseHeaders(versionHeader);
+
+    // Without keep-alive, stop the client right after the headers to close the connection
+    bool reusable = false;
+    if (_keepAlive && headersRead)
+    {
+        int contentLength = _arduinoClient->contentLength();
+        reusable = contentLength >= 0 && _readBodyByLength(contentLength, nullptr);
+    }
+    _finishRequest(reusable);
+    _handleLightweightStatus(statusCode, contentType, versionHeader, configVersion);
+    return statusCode;
+}
+
+/**
+ * @brief Backoff and config version hint after a lightweight POST got a response.
+ * @param configVersion Buffer of versionHeader
+ */
+void AiolosHttpClient::_handleLightweightStatus(int statusCode, const char *contentType,
+                                                const ResponseHeaderScanner &versionHeader, const char *configVersion)
+{
     if (statusCode >= 200 && statusCode < 300)
     {
-        Logger.info(LOG_TAG_HTTP, "Diagnostics data sent successfully");
+        _resetBackoff();
+        if (versionHeader.found())
+        {
+            strlcpy(_configVersionHint, configVersion, sizeof(_configVersionHint));
+        }
+    }
+    else if (statusCode == HTTP_UNSUPPORTED_MEDIA_TYPE)
+    {
+        // The body format was refused, not the link; the caller falls back to JSON
+        Logger.warn(LOG_TAG_HTTP, "Server does not accept %s", contentType);
+    }
+    else
+    {
+        _handleHttpFailure();
+        Logger.error(LOG_TAG_HTTP, "HTTP request failed with status code: %d", statusCode);
+    }
+}
+
+/**
+ * @brief Starts a lightweight POST that poll() carries out.
+ * @return false if it could not be started; nothing was sent.
+ */
+bool AiolosHttpClient::_startAsyncPost(const char *path, const char *contentType, const uint8_t *body,
+                                       size_t bodyLength)
+{
+    if (this->isConnectionThrottled())
+    {
+        return false; // Throttled, do not attempt
+    }
+
+    if (!_modemManager)
+    {
+        Logger.error(LOG_TAG_HTTP, "HTTP client not initialized");
+        return false;
+    }
+
+    if (!_modemManager->isNetworkConnected() || !_modemManager->isGprsConnected())
+    {
+        Logger.error(LOG_TAG_HTTP, "Network not connected, cannot send request");
+        return false;
+    }
+
+    Logger.debug(LOG_TAG_HTTP, "Starting POST request to %s", path);
+
+    bool reused = _prepareConnection();
+    _responseVersionHeader =
+        ResponseHeaderScanner(CONFIG_VERSION_HEADER, _responseConfigVersion, sizeof(_responseConfigVersion));
+    if (!_request.startPost(path, contentType, body, bodyLength, _keepAlive, reused, &_responseVersionHeader))
+    {
+        Logger.error(LOG_TAG_HTTP, "Request to %s does not fit its buffer", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Length of the binary record just encoded into _uploadRecord, 0 to send JSON.
+ */
+size_t AiolosHttpClient::_binaryLength(size_t encodedLength)
+{
+    if (encodedLength == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Telemetry record does not fit its buffer, sending JSON");
+    }
+    return encodedLength;
+}
+
+/**
+ * @brief Sends a telemetry body; blocking or, in async mode, started for poll().
+ * @return true if delivered, or in async mode if the request was started.
+ */
+bool AiolosHttpClient::_sendUpload(const char *path, const Upload &upload)
+{
+    _upload = upload;
+    _uploadOverHttp = false;
+    strlcpy(_uploadPath, path, sizeof(_uploadPath));
+    return _startUpload();
+}
+
+bool AiolosHttpClient::_startUpload()
+{
+    bool binary = _upload.binaryLength > 0;
+    const char *contentType = binary ? TELEMETRY_CONTENT_TYPE : "application/json";
+    const uint8_t *body = binary ? _uploadRecord : (const uint8_t *)_upload.json;
+    size_t length = binary ? _upload.binaryLength : _upload.jsonLength;
+
+    if (_usesCoap(length))
+    {
+        return _startCoapUpload(binary ? TELEMETRY_COAP_CONTENT_FORMAT : Coap::FORMAT_JSON, body, length);
+    }
+    if (!_async)
+    {
+        return _completeUpload(_performLightweightPost(_uploadPath, contentType, body, length));
+    }
+    if (_startAsyncPost(_uploadPath, contentType, body, length))
+    {
         return true;
     }
+    return _completeUpload(0); // Not sent, as if offline
+}
+
+/**
+ * @brief Whether the upload goes over CoAP: wind and temperature, and frames
+ * carrying only them, that fit one datagram and have not fallen back to HTTP.
+ * Diagnostics stay on HTTP, framed or not: their responses carry the
+ * X-Config-Version hint that lets the config be polled rarely.
+ */
+bool AiolosHttpClient::_usesCoap(size_t length) const
+{
+    if (!_coapTelemetry || _uploadOverHttp || _upload.kind == TelemetryQueueRecord::DIAGNOSTICS ||
+        !CoapTransport::fits(length))
+    {
+        return false;
+    }
+    return _upload.kind != TelemetryQueueRecord::FRAME || strstr(_upload.json, "\"diagnostics\":") == nullptr;
+}
+
+/**
+ * @brief Sends the upload as a confirmable CoAP POST; blocking or, in async mode, completed by poll().
+ * @return true if delivered, or in async mode if the exchange was started.
+ */
+bool AiolosHttpClient::_startCoapUpload(uint16_t contentFormat, const uint8_t *body, size_t length)
+{
+    if (!_modemManager->isNetworkConnected() || !_modemManager->isGprsConnected())
+    {
+        Logger.error(LOG_TAG_HTTP, "Network not connected, cannot send request");
+        return _completeUpload(0); // Not sent, as if offline
+    }
+
+    if (!_coap.start(_uploadPath, contentFormat, body, length))
+    {
+        return _completeCoapUpload(HTTP_ERROR_CONNECTION_FAILED);
+    }
+    if (_async)
+    {
+        return true;
+    }
+    while (!_coap.poll())
+    {
+        delay(1);
+    }
+    return _completeCoapUpload(_coap.statusCode());
+}
+
+/**
+ * @brief Outcome of a CoAP exchange. One without ACK is sent over HTTP instead,
+ * and CoAP is switched off after COAP_MAX_FAILURES of those in a row.
+ * @return As _completeUpload()
+ */
+bool AiolosHttpClient::_completeCoapUpload(int statusCode)
+{
+    if (statusCode >= 0)
+    {
+        _coapFailures = 0;
+        return _completeUpload(statusCode);
+    }
+
+    if (++_coapFailures >= COAP_MAX_FAILURES)
+    {
+        Logger.warn(LOG_TAG_COAP, "No CoAP acknowledgement %u times in a row, CoAP telemetry disabled", _coapFailures);
+        _coapTelemetry = false;
+        _coap.close();
+        storeCoapFallback(true);
+    }
+    Logger.info(LOG_TAG_COAP, "Sending %s over HTTP", _upload.description);
+    _uploadOverHttp = true;
+    return _startUpload();
+}
+
+/**
+ * @brief Outcome of an upload: binary fallback, offline queue, log and callback.
+ * @param statusCode Result of the send, 0 or negative if it never got a response.
+ * @return true if delivered, or if the JSON fallback was started in async mode.
+ */
+bool AiolosHttpClient::_completeUpload(int statusCode)
+{
+    if (statusCode == HTTP_UNSUPPORTED_MEDIA_TYPE && _upload.binaryLength > 0)
+    {
+        Logger.warn(LOG_TAG_HTTP, "Binary telemetry disabled, falling back to JSON");
+        _binaryTelemetry = false;
+        _upload.binaryLength = 0;
+        return _startUpload();
+    }
+
+    _uploadStatus = statusCode;
+    bool delivered = statusCode >= 200 && statusCode < 300;
+    if (_upload.replay)
+    {
+        _completeReplay(statusCode);
+    }
     else
     {
-        Logger.error(LOG_TAG_HTTP, "Failed to send diagnostics data.");
+        _queueIfUndelivered(_upload.kind, statusCode, _upload.json);
+        if (delivered)
+        {
+            Logger.info(LOG_TAG_HTTP, "Sent %s successfully", _upload.description);
+        }
+        else
+        {
+            Logger.error(LOG_TAG_HTTP, "Failed to send %s.", _upload.description);
+        }
+    }
+
+    if (_requestCallback)
+    {
+        _requestCallback(delivered);
+    }
+    return delivered;
+}
+
+/**
+ * @brief A replayed record leaves the queue once delivered or refused (4xx);
+ * otherwise it stays at the head for the next drain.
+ */
+void AiolosHttpClient::_completeReplay(int statusCode)
+{
+    if (statusCode >= 200 && statusCode < 300)
+    {
+        _offlineQueue->pop();
+        if (_async)
+        {
+            Logger.info(LOG_TAG_HTTP, "Replayed queued %s data, %lu waiting", TelemetryQueueRecord::endpoint(_upload.kind),
+                        (unsigned long)_offlineQueue->getStats().depth);
+        }
+    }
+    else if (statusCode > 0 && statusCode < 500)
+    {
+        Logger.warn(LOG_TAG_HTTP, "Server refused queued %s data (status %d), dropped",
+                    TelemetryQueueRecord::endpoint(_upload.kind), statusCode);
+        _offlineQueue->discard();
+    }
+}
+
+/**
+ * @brief Queues a body whose send did not reach the server or failed there.
+ * Bodies the server refused (4xx) are not queued; they would be refused again.
+ * @param statusCode Result of the send, 0 or negative if it never got a response.
+ */
+void AiolosHttpClient::_queueIfUndelivered(TelemetryQueueRecord::Kind kind, int statusCode, const char *json)
+{
+    if ((statusCode > 0 && statusCode < 500) || !_offlineQueue || !_offlineQueue->isReady())
+    {
+        return;
+    }
+
+    if (_offlineQueue->push(kind, json, strlen(json)))
+    {
+        Logger.info(LOG_TAG_HTTP, "Queued %s data for later delivery (%lu waiting)", TelemetryQueueRecord::endpoint(kind),
+                    (unsigned long)_offlineQueue->getStats().depth);
+    }
+}
+
+/**
+ * @brief Called before a framed send writes its body.
+ * @return true if the body is to be staged rather than posted. A part that is
+ *         already staged sends the open frame first, its body is about to be overwritten.
+ */
+bool AiolosHttpClient::_beginFramePart(FramePart part, const char *stationId)
+{
+    if (_frameWindowMs == 0)
+    {
+        return false;
+    }
+    if (_frameParts & part)
+    {
+        flushFrame(stationId);
+    }
+    return true;
+}
+
+void AiolosHttpClient::_stageFramePart(FramePart part)
+{
+    if (_frameParts == 0)
+    {
+        _frameOpenedMs = millis();
+    }
+    _frameParts |= part;
+}
+
+unsigned long AiolosHttpClient::getFrameTimeLeft() const
+{
+    if (_frameParts == 0)
+    {
+        return 0;
+    }
+    unsigned long elapsed = millis() - _frameOpenedMs;
+    return elapsed >= _frameWindowMs ? 0 : _frameWindowMs - elapsed;
+}
+
+bool AiolosHttpClient::isFrameDue() const
+{
+    return _frameParts == FRAME_ALL || (_frameParts != 0 && getFrameTimeLeft() == 0);
+}
+
+/**
+ * @brief Send the staged parts in one POST; the frame is closed even if it fails.
+ */
+bool AiolosHttpClient::flushFrame(const char *stationId)
+{
+    if (_frameParts == 0)
+    {
+        return true;
+    }
+    _awaitRequest();
+
+    uint8_t parts = _frameParts;
+    _frameParts = 0;
+
+    Logger.info(LOG_TAG_HTTP, "Sending telemetry frame (%s%s%s) for station %s", parts & FRAME_WIND ? " wind" : "",
+                parts & FRAME_TEMPERATURE ? " temperature" : "", parts & FRAME_DIAGNOSTICS ? " diagnostics" : "",
+                stationId);
+
+    // The batch buffer is free between sends; each part is still in its own buffer
+    size_t length =
+        JsonPayloads::writeFrame(_windBatchJson, sizeof(_windBatchJson), parts & FRAME_WIND ? _windSummaryJson : nullptr,
+                                 parts & FRAME_TEMPERATURE ? _temperatureJson : nullptr,
+                                 parts & FRAME_DIAGNOSTICS ? _diagnosticsJson : nullptr);
+    if (length == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Telemetry frame does not fit its buffer");
+        return false;
+    }
+
+    // Build the URL path
+    char urlPath[URL_PATH_SIZE];
+    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/frame", stationId);
+
+    Upload upload = {TelemetryQueueRecord::FRAME, _windBatchJson, length, 0, "telemetry frame", false};
+    return _sendUpload(urlPath, upload);
+}
+
+/**
+ * @brief Sends queued records, oldest first, each with the time it was taken.
+ */
+uint8_t AiolosHttpClient::drainOfflineQueue(const char *stationId, uint8_t maxRecords)
+{
+    if (!_offlineQueue || !_offlineQueue->isReady() || _offlineQueue->isEmpty())
+    {
+        return 0;
+    }
+    _awaitRequest();
+
+    unsigned long startMs = millis();
+    uint8_t delivered = 0;
+    size_t deliveredBytes = 0;
+    TelemetryQueueRecord::Header header;
+
+    // Records are replayed through the largest payload buffer, which is free
+    // between live sends and has room for the added timestamp
+    const size_t capacity = sizeof(_windBatchJson) - JsonPayloads::TIMESTAMP_MEMBER_MAX;
+    while (delivered < maxRecords && !isConnectionThrottled() &&
+           _offlineQueue->peek(header, _windBatchJson, capacity))
+    {
+        size_t length =
+            JsonPayloads::appendTimestamp(_windBatchJson, header.length, sizeof(_windBatchJson), header.epoch);
+        if (length == 0)
+        {
+            Logger.warn(LOG_TAG_HTTP, "Queued record is not a JSON object, dropped");
+            _offlineQueue->discard();
+            continue;
+        }
+
+        char urlPath[URL_PATH_SIZE];
+        snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/%s", stationId, TelemetryQueueRecord::endpoint(header.kind));
+
+        // The record leaves the queue once delivered or refused, see _completeReplay()
+        Upload upload = {(TelemetryQueueRecord::Kind)header.kind, _windBatchJson, length, 0, "queued record", true};
+        if (_sendUpload(urlPath, upload))
+        {
+            delivered++;
+            deliveredBytes += length;
+            if (_async)
+            {
+                break; // One record at a time; poll() completes it
+            }
+        }
+        else if (_uploadStatus <= 0 || _uploadStatus >= 500)
+        {
+            break; // Not delivered; it stays at the head of the queue
+        }
+    }
+
+    if (delivered > 0 && !_async)
+    {
+        Logger.info(LOG_TAG_HTTP, "Replayed %u queued records (%u bytes) in %lu ms, %lu waiting", delivered,
+                    (unsigned)deliveredBytes, millis() - startMs, (unsigned long)_offlineQueue->getStats().depth);
+    }
+    return delivered;
+}
+
+/**
+ * @brief Send diagnostics data to the server
+ */
+bool AiolosHttpClient::sendDiagnostics(const char *stationId, float batteryVoltage, float solarVoltage, float internalTemp, int signalQuality, unsigned long uptime,
+                                       float vaneDivergence, const SampleJitterSnapshot *windJitter)
+{
+    Logger.info(LOG_TAG_HTTP, "Sending diagnostics data for station %s", stationId);
+    _awaitRequest();
+
+    bool framed = _beginFramePart(FRAME_DIAGNOSTICS, stationId);
+
+    JsonPayloads::Diagnostics diagnostics;
+    diagnostics.batteryVoltage = batteryVoltage;
+    diagnostics.solarVoltage = solarVoltage;
+    diagnostics.internalTemperature = internalTemp;
+    diagnostics.signalQuality = signalQuality;
+    diagnostics.uptime = uptime;
+    diagnostics.vaneDivergence = vaneDivergence;
+    diagnostics.windJitter = windJitter;
+    diagnostics.connectionReuse = _keepAlive;
+    diagnostics.reuseHits = _reuseHits;
+    diagnostics.reuseMisses = _reuseMisses;
+    if (_offlineQueue && _offlineQueue->isReady())
+    {
+        TelemetryQueue::Stats queue = _offlineQueue->getStats();
+        diagnostics.offlineQueue = true;
+        diagnostics.queueDepth = queue.depth;
+        diagnostics.queueFill = _offlineQueue->getFillPercent();
+        diagnostics.queueDrained = queue.drained;
+        diagnostics.queueDropped = queue.dropped;
+    }
+    size_t length = JsonPayloads::writeDiagnostics(_diagnosticsJson, sizeof(_diagnosticsJson), diagnostics);
+    if (length == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Diagnostics payload does not fit its buffer");
         return false;
     }
+
+    if (framed)
+    {
+        _stageFramePart(FRAME_DIAGNOSTICS);
+        Logger.info(LOG_TAG_HTTP, "Diagnostics staged for the telemetry frame");
+        return true;
+    }
+
+    // Build the URL path
+    char urlPath[URL_PATH_SIZE];
+    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/diagnostics", stationId);
+
+    // Only the status matters; the response body is drained without storing it
+    Upload upload = {TelemetryQueueRecord::DIAGNOSTICS, _diagnosticsJson, length, 0, "diagnostics data", false};
+    return _sendUpload(urlPath, upload);
 }
 
 /**
  * @brief Fetch configuration from the server
  */
-bool AiolosHttpClient::fetchConfiguration(const char *stationId, unsigned long *tempInterval, unsigned long *windInterval,
-                                          unsigned long *windSampleInterval, unsigned long *diagInterval, unsigned long *timeInterval,
-                                          unsigned long *restartInterval, int *sleepStartHour, int *sleepEndHour,
-                                          int *otaHour, int *otaMinute, int *otaDuration, bool *remoteOta)
+bool AiolosHttpClient::fetchConfiguration(const char *stationId, StationConfig &config, char *etag, size_t etagSize,
+                                          bool *notModified)
 {
     Logger.info(LOG_TAG_HTTP, "Fetching configuration for station %s", stationId);
 
@@ -355,84 +1340,131 @@ bool AiolosHttpClient::fetchConfiguration(const char *stationId, unsigned long *
     char urlPath[URL_PATH_SIZE];
     snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/config", stationId);
 
-    String responseBody;
-    int statusCode = _performRequest("GET", urlPath, nullptr, responseBody);
+    // Only these keys are kept while parsing; anything else the server adds is skipped
+    JsonDocument filter;
+    filter["tempInterval"] = true;
+    filter["windSendInterval"] = true;
+    filter["windSampleInterval"] = true;
+    filter["diagInterval"] = true;
+    filter["timeInterval"] = true;
+    filter["restartInterval"] = true;
+    filter["sleepStartHour"] = true;
+    filter["sleepEndHour"] = true;
+    filter["otaHour"] = true;
+    filter["otaMinute"] = true;
+    filter["otaDuration"] = true;
+    filter["remoteOta"] = true;
+    filter["windBatchSize"] = true;
+    filter["coapTelemetry"] = true;
+    filter["vaneCalibration"] = true;
 
-    if (statusCode >= 200 && statusCode < 300)
-    {
-        Logger.info(LOG_TAG_HTTP, "Configuration data received.");
+    JsonDocument doc;
+    DeserializationError error;
+    int statusCode = _performJsonGet(urlPath, doc, filter, error, etag, etagSize);
 
-        // Use a JsonDocument for configuration data
-        JsonDocument doc;
-        Logger.debug(LOG_TAG_HTTP, "About to parse JSON with length: %d", responseBody.length());
-        DeserializationError error = deserializeJson(doc, responseBody);
+    if (notModified)
+    {
+        *notModified = statusCode == HTTP_NOT_MODIFIED;
+    }
+    if (statusCode == HTTP_NOT_MODIFIED)
+    {
+        Logger.info(LOG_TAG_HTTP, "Configuration unchanged (ETag %s)", etag);
+        return true;
+    }
 
+    if (statusCode >= 200 && statusCode < 300)
+    {
         if (error)
         {
             Logger.error(LOG_TAG_HTTP, "Failed to parse JSON configuration: %s", error.c_str());
-            Logger.error(LOG_TAG_HTTP, "JSON was: %s", responseBody.c_str());
             _handleHttpFailure(); // Treat parsing error as a failure for backoff
             return false;
         }
 
-        Logger.debug(LOG_TAG_HTTP, "JSON parsed successfully");
+        Logger.info(LOG_TAG_HTTP, "Configuration data received.");
 
         // Safely extract values using the parsed JSON document
         if (!doc["tempInterval"].isNull())
         {
-            unsigned long value = doc["tempInterval"].as<unsigned long>();
-            Logger.debug(LOG_TAG_HTTP, "tempInterval from JSON: %lu", value);
-            *tempInterval = value;
+            config.tempInterval = doc["tempInterval"].as<unsigned long>();
+            Logger.debug(LOG_TAG_HTTP, "tempInterval from JSON: %lu", config.tempInterval);
         }
         if (!doc["windSendInterval"].isNull())
         {
-            unsigned long value = doc["windSendInterval"].as<unsigned long>();
-            Logger.debug(LOG_TAG_HTTP, "windSendInterval from JSON: %lu", value);
-            *windInterval = value;
+            config.windSendInterval = doc["windSendInterval"].as<unsigned long>();
+            Logger.debug(LOG_TAG_HTTP, "windSendInterval from JSON: %lu", config.windSendInterval);
         }
-        if (windSampleInterval && !doc["windSampleInterval"].isNull())
+        if (!doc["windSampleInterval"].isNull())
         {
-            unsigned long value = doc["windSampleInterval"].as<unsigned long>();
-            Logger.debug(LOG_TAG_HTTP, "windSampleInterval from JSON: %lu", value);
-            *windSampleInterval = value;
+            config.windSampleInterval = doc["windSampleInterval"].as<unsigned long>();
+            Logger.debug(LOG_TAG_HTTP, "windSampleInterval from JSON: %lu", config.windSampleInterval);
         }
         if (!doc["diagInterval"].isNull())
         {
-            unsigned long value = doc["diagInterval"].as<unsigned long>();
-            Logger.debug(LOG_TAG_HTTP, "diagInterval from JSON: %lu", value);
-            *diagInterval = value;
+            config.diagInterval = doc["diagInterval"].as<unsigned long>();
+            Logger.debug(LOG_TAG_HTTP, "diagInterval from JSON: %lu", config.diagInterval);
+        }
+        if (!doc["timeInterval"].isNull())
+        {
+            config.timeInterval = doc["timeInterval"].as<unsigned long>();
+        }
+        if (!doc["restartInterval"].isNull())
+        {
+            config.restartInterval = doc["restartInterval"].as<unsigned long>();
+        }
+        if (!doc["sleepStartHour"].isNull())
+        {
+            config.sleepStartHour = doc["sleepStartHour"].as<int>();
         }
-        if (timeInterval && !doc["timeInterval"].isNull())
+        if (!doc["sleepEndHour"].isNull())
         {
-            *timeInterval = doc["timeInterval"].as<unsigned long>();
+            config.sleepEndHour = doc["sleepEndHour"].as<int>();
         }
-        if (restartInterval && !doc["restartInterval"].isNull())
+        if (!doc["otaHour"].isNull())
         {
-            *restartInterval = doc["restartInterval"].as<unsigned long>();
+            config.otaHour = doc["otaHour"].as<int>();
         }
-        if (sleepStartHour && !doc["sleepStartHour"].isNull())
+        if (!doc["otaMinute"].isNull())
         {
-            *sleepStartHour = doc["sleepStartHour"].as<int>();
+            config.otaMinute = doc["otaMinute"].as<int>();
         }
-        if (sleepEndHour && !doc["sleepEndHour"].isNull())
+        if (!doc["otaDuration"].isNull())
         {
-            *sleepEndHour = doc["sleepEndHour"].as<int>();
+            config.otaDuration = doc["otaDuration"].as<int>();
         }
-        if (otaHour && !doc["otaHour"].isNull())
+        if (!doc["remoteOta"].isNull())
         {
-            *otaHour = doc["otaHour"].as<int>();
+            config.remoteOta = doc["remoteOta"].as<bool>();
         }
-        if (otaMinute && !doc["otaMinute"].isNull())
+        if (!doc["windBatchSize"].isNull())
         {
-            *otaMinute = doc["otaMinute"].as<int>();
+            config.windBatchSize = doc["windBatchSize"].as<unsigned long>();
         }
-        if (otaDuration && !doc["otaDuration"].isNull())
+        if (!doc["coapTelemetry"].isNull())
+        {
+            config.coapTelemetry = doc["coapTelemetry"].as<bool>() ? 1 : 0;
+        }
+
+        // Eight ADC levels in the order N, NE, E, SE, S, SW, W, NW
+        config.vaneCalibrationReceived = false;
+        JsonArrayConst levels = doc["vaneCalibration"].as<JsonArrayConst>();
+        if (levels.size() == VaneCalibration::DIRECTION_COUNT)
         {
-            *otaDuration = doc["otaDuration"].as<int>();
+            bool valid = true;
+            for (size_t i = 0; i < levels.size(); i++)
+            {
+                if (!levels[i].is<unsigned int>() || levels[i].as<unsigned int>() >= VaneCalibration::ADC_RANGE)
+                {
+                    valid = false;
+                    break;
+                }
+                config.vaneCalibration[i] = (uint16_t)levels[i].as<unsigned int>();
+            }
+            config.vaneCalibrationReceived = valid;
         }
-        if (remoteOta && !doc["remoteOta"].isNull())
+        else if (!levels.isNull())
         {
-            *remoteOta = doc["remoteOta"].as<bool>();
+            Logger.warn(LOG_TAG_HTTP, "Ignoring vaneCalibration with %u entries", levels.size());
         }
 
         return true;
@@ -450,67 +1482,155 @@ bool AiolosHttpClient::fetchConfiguration(const char *stationId, unsigned long *
 bool AiolosHttpClient::sendWindData(const char *stationId, float windSpeed, float windDirection)
 {
     Logger.info(LOG_TAG_HTTP, "Sending wind data for station %s", stationId);
+    _awaitRequest();
 
-    // Create JSON payload using ArduinoJson with fixed-size document
-    JsonDocument doc;
-    doc.to<JsonObject>(); // Ensure it's an object
-    doc["windSpeed"] = windSpeed;
-    doc["windDirection"] = windDirection;
+    // Build the URL path
+    char urlPath[URL_PATH_SIZE];
+    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/wind", stationId);
 
-    String jsonBuffer;
-    serializeJson(doc, jsonBuffer);
+    // The JSON body is also what gets queued if the reading cannot be delivered
+    size_t length = JsonPayloads::writeWindReading(_windJson, sizeof(_windJson), windSpeed, windDirection);
+    if (length == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Wind payload does not fit its buffer");
+        return false;
+    }
+
+    // Use lightweight POST method that doesn't read response body for speed
+    Upload upload = {TelemetryQueueRecord::WIND_READING, _windJson, length, 0, "wind data", false};
+    if (_binaryTelemetry)
+    {
+        upload.binaryLength = _binaryLength(
+            TelemetryCodec::encodeWindReading(_uploadRecord, sizeof(_uploadRecord), windSpeed, windDirection));
+    }
+    return _sendUpload(urlPath, upload);
+}
+
+/**
+ * @brief Send an averaged wind period including gust and lull
+ */
+bool AiolosHttpClient::sendWindData(const char *stationId, const WindSummary &summary)
+{
+    Logger.info(LOG_TAG_HTTP, "Sending averaged wind data for station %s", stationId);
+    _awaitRequest();
 
     // Build the URL path
     char urlPath[URL_PATH_SIZE];
     snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/wind", stationId);
 
-    // Use lightweight POST method that doesn't read response body for speed
-    int statusCode = _performLightweightPost(urlPath, jsonBuffer.c_str());
+    bool framed = _beginFramePart(FRAME_WIND, stationId);
+    size_t length = JsonPayloads::writeWindSummary(_windSummaryJson, sizeof(_windSummaryJson), summary);
+    if (length == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Averaged wind payload does not fit its buffer");
+        return false;
+    }
 
-    if (statusCode >= 200 && statusCode < 300)
+    if (framed)
     {
-        Logger.info(LOG_TAG_HTTP, "Wind data sent successfully");
+        // Frames are JSON; binary telemetry only applies to wind sent on its own
+        _stageFramePart(FRAME_WIND);
+        Logger.info(LOG_TAG_HTTP, "Averaged wind staged for the telemetry frame");
         return true;
     }
-    else
+
+    Upload upload = {TelemetryQueueRecord::WIND_SUMMARY, _windSummaryJson, length, 0, "averaged wind data", false};
+    if (_binaryTelemetry)
     {
-        Logger.error(LOG_TAG_HTTP, "Failed to send wind data.");
-        return false;
+        upload.binaryLength =
+            _binaryLength(TelemetryCodec::encodeWindSummary(_uploadRecord, sizeof(_uploadRecord), summary));
     }
+    return _sendUpload(urlPath, upload);
 }
 
 /**
- * @brief Send temperature data to the server (optimized for high-frequency sending)
+ * @brief Send buffered livestream readings in a single POST
  */
-bool AiolosHttpClient::sendTemperatureData(const char *stationId, float internalTemp, float externalTemp)
+bool AiolosHttpClient::sendWindBatch(const char *stationId, const WindSampleBatch &batch)
 {
-    Logger.info(LOG_TAG_HTTP, "Sending temperature data for station %s", stationId);
+    Logger.info(LOG_TAG_HTTP, "Sending %u batched wind readings for station %s", batch.size(), stationId);
+    _awaitRequest();
 
-    // Create JSON payload using ArduinoJson with fixed-size document
-    JsonDocument doc;
-    doc.to<JsonObject>(); // Ensure it's an object
-    doc["temperature"] = externalTemp;
+    // Build the URL path
+    char urlPath[URL_PATH_SIZE];
+    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/wind/batch", stationId);
 
-    String jsonBuffer;
-    serializeJson(doc, jsonBuffer);
+    uint32_t now = millis(); // Sample ages are relative to this
+    size_t length = JsonPayloads::writeWindBatch(_windBatchJson, sizeof(_windBatchJson), batch, now);
+    if (length == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Wind batch payload does not fit its buffer");
+        return false;
+    }
+
+    Upload upload = {TelemetryQueueRecord::WIND_BATCH, _windBatchJson, length, 0, "wind batch", false};
+    if (_binaryTelemetry)
+    {
+        upload.binaryLength =
+            _binaryLength(TelemetryCodec::encodeWindBatch(_uploadRecord, sizeof(_uploadRecord), batch, now));
+    }
+    return _sendUpload(urlPath, upload);
+}
+
+/**
+ * @brief Send completed 1 min and 10 min wind buckets in a single POST
+ */
+bool AiolosHttpClient::sendWindAggregates(const char *stationId, const WindAggregateBatch &batch)
+{
+    Logger.info(LOG_TAG_HTTP, "Sending %u wind aggregates for station %s", batch.size(), stationId);
+    _awaitRequest();
 
     // Build the URL path
     char urlPath[URL_PATH_SIZE];
-    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/temperature", stationId);
+    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/wind/aggregates", stationId);
 
-    // Use lightweight POST method that doesn't read response body for speed
-    int statusCode = _performLightweightPost(urlPath, jsonBuffer.c_str());
+    uint32_t now = millis(); // Bucket ages are relative to this
+    size_t length = JsonPayloads::writeWindAggregates(_windBatchJson, sizeof(_windBatchJson), batch, now);
+    if (length == 0)
+    {
+        Logger.error(LOG_TAG_HTTP, "Wind aggregates payload does not fit its buffer");
+        return false;
+    }
 
-    if (statusCode >= 200 && statusCode < 300)
+    Upload upload = {TelemetryQueueRecord::WIND_AGGREGATES, _windBatchJson, length, 0, "wind aggregates", false};
+    if (_binaryTelemetry)
     {
-        Logger.info(LOG_TAG_HTTP, "Temperature data sent successfully");
-        return true;
+        upload.binaryLength =
+            _binaryLength(TelemetryCodec::encodeWindAggregates(_uploadRecord, sizeof(_uploadRecord), batch, now));
     }
-    else
+    return _sendUpload(urlPath, upload);
+}
+
+/**
+ * @brief Send temperature data to the server (optimized for high-frequency sending)
+ */
+bool AiolosHttpClient::sendTemperatureData(const char *stationId, float internalTemp, float externalTemp)
+{
+    Logger.info(LOG_TAG_HTTP, "Sending temperature data for station %s", stationId);
+    _awaitRequest();
+
+    bool framed = _beginFramePart(FRAME_TEMPERATURE, stationId);
+    size_t length = JsonPayloads::writeTemperature(_temperatureJson, sizeof(_temperatureJson), externalTemp);
+    if (length == 0)
     {
-        Logger.error(LOG_TAG_HTTP, "Failed to send temperature data.");
+        Logger.error(LOG_TAG_HTTP, "Temperature payload does not fit its buffer");
         return false;
     }
+
+    if (framed)
+    {
+        _stageFramePart(FRAME_TEMPERATURE);
+        Logger.info(LOG_TAG_HTTP, "Temperature staged for the telemetry frame");
+        return true;
+    }
+
+    // Build the URL path
+    char urlPath[URL_PATH_SIZE];
+    snprintf(urlPath, sizeof(urlPath), "/api/stations/%s/temperature", stationId);
+
+    // Use lightweight POST method that doesn't read response body for speed
+    Upload upload = {TelemetryQueueRecord::TEMPERATURE, _temperatureJson, length, 0, "temperature data", false};
+    return _sendUpload(urlPath, upload);
 }
 
 /**
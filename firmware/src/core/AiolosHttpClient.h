@@ -12,14 +12,39 @@
 
 #include <Arduino.h>
 #include <ArduinoHttpClient.h>
+#include <ArduinoJson.h>
 #include <TinyGsmClient.h>
+#include "../sensors/WindSummary.h"
+#include "../sensors/SampleJitterStats.h"
+#include "WindSampleBatch.h"
+#include "WindAggregateBatch.h"
+#include "JsonPayloads.h"
+#include "StationConfig.h"
+#include "ResponseHeaderScanner.h"
+#include "TelemetryQueueRecord.h"
+#include "OutboundScheduler.h"
+#include "AsyncHttpRequest.h"
+#include "ModemHttpTransport.h"
+#include "CoapTransport.h"
+#include "TelemetryCodec.h"
+
+// Response header of the telemetry endpoints carrying the current config version
+#define CONFIG_VERSION_HEADER "X-Config-Version"
 
 // Forward declarations
 class ModemManager;
+class TelemetryQueue;
 
 class AiolosHttpClient
 {
 public:
+    // How the telemetry POSTs reach the server
+    enum Transport : uint8_t
+    {
+        TRANSPORT_SOCKET, // ArduinoHttpClient over a TinyGSM socket
+        TRANSPORT_MODEM   // The modem's own HTTP client, see ModemHttpTransport
+    };
+
     AiolosHttpClient();  // Constructor
     ~AiolosHttpClient(); // Destructor to clean up the client
 
@@ -43,10 +68,13 @@ public:
      * @param internalTemp Internal temperature in Celsius
      * @param signalQuality Signal quality in dBm
      * @param uptime System uptime in seconds
-     * @return true if successful
+     * @param vaneDivergence Wind vane cluster drift (see WindSensor::getVaneDivergence), omitted if negative
+     * @param windJitter Wind sampling cadence statistics, omitted if null
+     * @return true if successful, staged for a frame (see setFrameWindow()) or started (see setAsync())
      * @return false if failed
      */
-    bool sendDiagnostics(const char *stationId, float batteryVoltage, float solarVoltage, float internalTemp, int signalQuality, unsigned long uptime);
+    bool sendDiagnostics(const char *stationId, float batteryVoltage, float solarVoltage, float internalTemp, int signalQuality, unsigned long uptime,
+                         float vaneDivergence = -1.0f, const SampleJitterSnapshot *windJitter = nullptr);
 
     /**
      * @brief Send wind data to the server
@@ -54,34 +82,70 @@ public:
      * @param stationId Station identifier
      * @param windSpeed Wind speed in m/s
      * @param windDirection Wind direction in degrees (0-360)
-     * @return true if successful
+     * @return true if successful, or in async mode started (see setAsync())
      * @return false if failed
      */
     bool sendWindData(const char *stationId, float windSpeed, float windDirection);
 
+    /**
+     * @brief Send an averaged wind period to the server
+     *
+     * Sends the mean speed and direction together with the 3 s gust and lull.
+     *
+     * @param stationId Station identifier
+     * @param summary Averaged wind data for the period
+     * @return true if successful, staged for a frame (see setFrameWindow()) or started (see setAsync())
+     * @return false if failed
+     */
+    bool sendWindData(const char *stationId, const WindSummary &summary);
+
+    /**
+     * @brief Send a batch of livestream wind readings in one request
+     *
+     * Each reading carries its age relative to the time of sending, so the
+     * server can restore its timestamp without a clock on the station.
+     *
+     * @param stationId Station identifier
+     * @param batch Buffered readings, oldest first
+     * @return true if successful, or in async mode started (see setAsync())
+     * @return false if failed
+     */
+    bool sendWindBatch(const char *stationId, const WindSampleBatch &batch);
+
+    /**
+     * @brief Send completed 1 min and 10 min wind buckets in one request
+     *
+     * Each bucket carries its age relative to the time of sending, like
+     * the batched readings, so the server can place it in its interval.
+     *
+     * @param stationId Station identifier
+     * @param batch Buckets waiting for upload, oldest first
+     * @return true if successful, or in async mode started (see setAsync())
+     * @return false if failed
+     */
+    bool sendWindAggregates(const char *stationId, const WindAggregateBatch &batch);
+
     /**
      * @brief Fetch configuration from the server
      *
+     * The response is parsed while it downloads, keeping only the known keys.
+     * Fields the server did not send keep their value in config.
+     *
+     * With an ETag from an earlier fetch the request is conditional: if the
+     * configuration did not change the server answers 304 without a body,
+     * config is left untouched and notModified is set.
+     *
      * @param stationId Station identifier
-     * @param tempInterval Pointer to store retrieved temperature interval
-     * @param windInterval Pointer to store retrieved wind interval
-     * @param diagInterval Pointer to store retrieved diagnostics interval
-     * @param timeInterval Pointer to store retrieved time sync interval
-     * @param restartInterval Pointer to store retrieved restart interval
-     * @param sleepStartHour Pointer to store retrieved sleep start hour
-     * @param sleepEndHour Pointer to store retrieved sleep end hour
-     * @param otaHour Pointer to store retrieved OTA hour
-     * @param otaMinute Pointer to store retrieved OTA minute
-     * @param otaDuration Pointer to store retrieved OTA duration in minutes
-     * @param remoteOta Pointer to store retrieved remote OTA flag
-     * @return true if successful
+     * @param config Receives the configuration
+     * @param etag In: ETag of the configuration in use (may be empty).
+     *             Out: ETag of the received configuration.
+     * @param etagSize Size of the etag buffer
+     * @param notModified Optional, set to true if the server answered 304
+     * @return true if successful (including 304)
      * @return false if failed
      */
-    bool fetchConfiguration(const char *stationId, unsigned long *tempInterval, unsigned long *windInterval,
-                            unsigned long *windSampleInterval, unsigned long *diagInterval, unsigned long *timeInterval = nullptr,
-                            unsigned long *restartInterval = nullptr, int *sleepStartHour = nullptr,
-                            int *sleepEndHour = nullptr, int *otaHour = nullptr,
-                            int *otaMinute = nullptr, int *otaDuration = nullptr, bool *remoteOta = nullptr);
+    bool fetchConfiguration(const char *stationId, StationConfig &config, char *etag = nullptr, size_t etagSize = 0,
+                            bool *notModified = nullptr);
 
     /**
      * @brief Checks if the HTTP client is currently in a backoff period.
@@ -102,7 +166,7 @@ public:
      * @param stationId Station identifier
      * @param internalTemp Internal temperature in Celsius (kept for backward compatibility)
      * @param externalTemp External temperature in Celsius
-     * @return true if successful
+     * @return true if successful, staged for a frame (see setFrameWindow()) or started (see setAsync())
      * @return false if failed
      */
     bool sendTemperatureData(const char *stationId, float internalTemp, float externalTemp);
@@ -118,6 +182,243 @@ public:
      */
     bool confirmOtaStarted(const char *stationId);
 
+    /**
+     * @brief Keep the TCP connection open between requests
+     *
+     * Off by default, on when built with HTTP_KEEP_ALIVE. Requests then send
+     * "Connection: keep-alive", read the response body by its Content-Length
+     * and leave the socket open. A connection idle for HTTP_KEEP_ALIVE_IDLE_MS
+     * is closed before the next request, and a request on a connection the
+     * server has closed is retried once on a new one.
+     *
+     * @param enabled true to reuse connections
+     */
+    void setKeepAlive(bool enabled);
+
+    bool isKeepAliveEnabled() const { return _keepAlive; }
+
+    /**
+     * @brief Requests sent on a reused connection since boot (keep-alive only)
+     */
+    uint32_t getConnectionReuseHits() const { return _reuseHits; }
+
+    /**
+     * @brief Requests that needed a new connection since boot (keep-alive only)
+     */
+    uint32_t getConnectionReuseMisses() const { return _reuseMisses; }
+
+    /**
+     * @brief Send the wind uploads as binary records instead of JSON
+     *
+     * Off by default, on when built with TELEMETRY_BINARY. Readings, averaged
+     * periods and batches are then encoded with TelemetryCodec and sent as
+     * TELEMETRY_CONTENT_TYPE. If the server answers 415 Unsupported Media
+     * Type, binary telemetry is switched off and the reading is sent as JSON.
+     *
+     * @param enabled true to send binary records
+     */
+    void setBinaryTelemetry(bool enabled) { _binaryTelemetry = enabled; }
+
+    bool isBinaryTelemetryEnabled() const { return _binaryTelemetry; }
+
+    /**
+     * @brief Choose the transport of the blocking telemetry POSTs
+     *
+     * TRANSPORT_SOCKET by default, TRANSPORT_MODEM when built with
+     * HTTP_MODEM_STACK. The modem's HTTP client keeps its connection open by
+     * itself and only the body and the status code cross the UART; it passes
+     * no response headers, so no config version hint is seen
+     * (getConfigVersionHint()). Bodies the modem cannot take, async sends,
+     * configuration fetches and the OTA confirmation use the socket.
+     */
+    void setTransport(Transport transport);
+
+    Transport getTransport() const { return _transport; }
+
+    /**
+     * @brief Send a body as it is, over the selected transport, and wait for the status
+     *
+     * For measurements; no queueing, framing or callback. Backoff applies.
+     *
+     * @return The HTTP status code, 0 if not attempted, or a negative HTTP_ERROR_* code
+     */
+    int postRaw(const char *path, const char *contentType, const uint8_t *body, size_t bodyLength);
+
+    /**
+     * @brief Send wind and temperature telemetry over CoAP
+     *
+     * Off by default, on when built with TELEMETRY_COAP or when the remote
+     * configuration sets coapTelemetry (honoured in HTTP_ASYNC builds only,
+     * see applyStationConfig() in main.cpp). Livestream readings, averaged
+     * periods, temperatures and frames that fit one datagram are then sent
+     * as confirmable CoAP POSTs over UDP to COAP_PORT (CoapTransport), with
+     * the path and body their HTTP request would have; async mode applies
+     * as for HTTP. An upload whose exchange gets no ACK is sent over HTTP,
+     * and after COAP_MAX_FAILURES of those in a row CoAP is switched off.
+     * That is kept in NVS: it stays off after a restart until the firmware
+     * version changes or this is called with false and then true again.
+     * Diagnostics, also in frames, always go over HTTP.
+     *
+     * @param enabled true to send over CoAP
+     */
+    void setCoapTelemetry(bool enabled);
+
+    bool isCoapTelemetryEnabled() const { return _coapTelemetry; }
+
+    const CoapTransport::Stats &getCoapStats() const { return _coap.getStats(); }
+
+    /**
+     * @brief Send the telemetry POSTs without blocking the loop
+     *
+     * Off by default, on when built with HTTP_ASYNC. The wind, temperature,
+     * diagnostics, frame and replay sends then only start their request and
+     * return true; poll() carries it out in short steps (AsyncHttpRequest)
+     * and the outcome goes to the request callback. A send while a request
+     * is in flight waits for it first. Configuration fetches and the OTA
+     * confirmation still block; they are rare.
+     *
+     * Switching it off waits for the request in flight, e.g. before a restart.
+     *
+     * @param enabled true to send without blocking
+     */
+    void setAsync(bool enabled);
+
+    bool isAsync() const { return _async; }
+
+    /**
+     * @brief Advance the request in flight; call on every loop pass
+     *
+     * Returns within HTTP_ASYNC_SLICE_MS, unless a new connection has to be
+     * opened (up to HTTP_ASYNC_CONNECT_TIMEOUT_S).
+     */
+    void poll();
+
+    bool isRequestInFlight() const { return _request.isBusy() || _coap.isBusy(); }
+
+    /**
+     * @brief Receive the outcome of each telemetry send once it is known
+     *
+     * In async mode that is when its request finishes, from poll(); otherwise
+     * before the send returns. Not called for parts staged for a frame.
+     *
+     * @param callback Called with whether the server accepted the data, nullptr for none
+     */
+    void setRequestCallback(void (*callback)(bool delivered)) { _requestCallback = callback; }
+
+    /**
+     * @brief What became of the last send that returned true, for the log
+     *
+     * @return "sent successfully", "staged for the telemetry frame" or, in async mode, "sending"
+     */
+    const char *describeLastSend() const;
+
+    /**
+     * @brief Coalesce averaged wind, temperature and diagnostics into frames
+     *
+     * With a window, sendWindData(summary), sendTemperatureData() and
+     * sendDiagnostics() stage their body instead of posting it and return
+     * true. The staged parts go out together in one POST to /frame once all
+     * three are staged or the window since the first one has passed
+     * (isFrameDue()). A part staged twice flushes the frame first.
+     * Livestream readings and batches are not framed.
+     *
+     * @param windowMs How long a staged part waits for the others, 0 to send each on its own
+     */
+    void setFrameWindow(unsigned long windowMs) { _frameWindowMs = windowMs; }
+
+    bool isFrameOpen() const { return _frameParts != 0; }
+
+    /**
+     * @brief Milliseconds until the open frame is sent, 0 if none is open
+     *
+     * Readings due before then can be taken early to ride along.
+     */
+    unsigned long getFrameTimeLeft() const;
+
+    /**
+     * @brief Whether the open frame is complete or its window has passed
+     */
+    bool isFrameDue() const;
+
+    /**
+     * @brief Send the open frame now, e.g. before a restart
+     *
+     * @return true if there was nothing to send or it was delivered (in async mode: started)
+     */
+    bool flushFrame(const char *stationId);
+
+    /**
+     * @brief Keep uploads that cannot be delivered in a flash-backed queue
+     *
+     * Wind, temperature and diagnostics bodies whose send gets no response
+     * (offline, backoff, connection errors) or a 5xx are appended to the
+     * queue, dated by its clock. drainOfflineQueue() sends them later.
+     *
+     * @param queue Queue to use, nullptr to drop undelivered data as before
+     */
+    void setOfflineQueue(TelemetryQueue *queue) { _offlineQueue = queue; }
+
+    /**
+     * @brief Send queued uploads, oldest first
+     *
+     * Each record goes to the endpoint it was meant for with a "timestamp"
+     * member holding the time it was taken. Stops at the first record that
+     * cannot be delivered; records the server refuses (4xx) are dropped.
+     *
+     * In async mode one record is started per call; it leaves the queue
+     * when poll() sees it delivered or refused.
+     *
+     * @param stationId Station identifier
+     * @param maxRecords Upper bound of requests for this call
+     * @return Number of records delivered (in async mode: started)
+     */
+    uint8_t drainOfflineQueue(const char *stationId, uint8_t maxRecords);
+
+    /**
+     * @brief Mark a class of outbound work as due
+     *
+     * The caller keeps the data; a request for a class that is already
+     * pending is coalesced, and the dispatch sends the newest data. A class
+     * whose send is in flight can be requested again.
+     * Deadlines are OUTBOUND_DEADLINE_*_MS, see OutboundScheduler.
+     */
+    void requestOutbound(OutboundScheduler::Class cls) { _outbound.request(cls, millis()); }
+
+    bool isOutboundPending(OutboundScheduler::Class cls) const { return _outbound.isPending(cls); }
+
+    /**
+     * @brief Pending class of outbound work with the earliest deadline
+     *
+     * @return false if nothing is pending
+     */
+    bool nextOutbound(OutboundScheduler::Class &cls) const { return _outbound.next(cls); }
+
+    /**
+     * @brief Take a pending class for its send and record its queue latency
+     */
+    void beginOutbound(OutboundScheduler::Class cls) { _outbound.dispatch(cls, millis()); }
+
+    /**
+     * @brief Record the outcome of a class's send
+     *
+     * @param delivered Whether the send succeeded
+     */
+    void completeOutbound(OutboundScheduler::Class cls, bool delivered) { _outbound.complete(cls, delivered); }
+
+    const OutboundScheduler::ClassStats &getOutboundStats(OutboundScheduler::Class cls) const
+    {
+        return _outbound.getStats(cls);
+    }
+
+    /**
+     * @brief Config version announced by the last successful telemetry response
+     *
+     * The telemetry endpoints answer with an X-Config-Version header equal to
+     * the ETag GET /config would return, so a change can be detected without
+     * polling the configuration. Empty until a response carried the header.
+     */
+    const char *getConfigVersionHint() const { return _configVersionHint; }
+
     /**
      * @brief Get the local IP address of the device
      *
@@ -132,6 +433,9 @@ private:
     // URL path buffer size
     static const size_t URL_PATH_SIZE = 64;
 
+    static const int HTTP_NOT_MODIFIED = 304;
+    static const int HTTP_UNSUPPORTED_MEDIA_TYPE = 415;
+
     // Backoff constants
     static const unsigned long BASE_BACKOFF_DELAY_MS = 5000;  // 5 seconds
     static const unsigned long MAX_BACKOFF_DELAY_MS = 300000; // 5 minutes
@@ -147,6 +451,98 @@ private:
     ModemManager *_modemManager = nullptr;
     TinyGsmClient *_client = nullptr;
 
+    // Connection reuse state
+    bool _keepAlive = false;
+    unsigned long _lastRequestEndMs = 0;
+    uint32_t _reuseHits = 0;
+    uint32_t _reuseMisses = 0;
+
+    // Upload encoding
+    bool _binaryTelemetry = false;
+
+    // POSTs through the modem's HTTP client, TRANSPORT_MODEM
+    Transport _transport = TRANSPORT_SOCKET;
+    ModemHttpTransport _modemTransport;
+
+    // Wind and temperature telemetry over CoAP, see setCoapTelemetry().
+    // Set here, not in init(), so a stored remote configuration applied before init() is kept.
+#ifdef TELEMETRY_COAP
+    bool _coapTelemetry = true;
+#else
+    bool _coapTelemetry = false;
+#endif
+    CoapTransport _coap;
+    uint8_t _coapFailures = 0; // Exchanges in a row without ACK
+    bool _uploadOverHttp = false; // The upload fell back from CoAP
+
+    // Store-and-forward of undelivered uploads, optional
+    TelemetryQueue *_offlineQueue = nullptr;
+
+    // Outbound work waiting for dispatch, by class
+    OutboundScheduler _outbound;
+
+    // Non-blocking telemetry POSTs
+    bool _async = false;
+    AsyncHttpRequest _request;
+    void (*_requestCallback)(bool delivered) = nullptr;
+    char _responseConfigVersion[STATION_CONFIG_ETAG_SIZE] = "";
+    ResponseHeaderScanner _responseVersionHeader =
+        ResponseHeaderScanner(CONFIG_VERSION_HEADER, _responseConfigVersion, sizeof(_responseConfigVersion));
+
+    // The telemetry upload in flight, or the last one sent
+    struct Upload
+    {
+        TelemetryQueueRecord::Kind kind;
+        const char *json; // Body, queued if undelivered
+        size_t jsonLength;
+        size_t binaryLength;     // Record in _uploadRecord sent instead of the JSON, 0 for none
+        const char *description; // For the log
+        bool replay;             // Record at the head of the offline queue
+    };
+    Upload _upload = {};
+    int _uploadStatus = 0;
+    char _uploadPath[URL_PATH_SIZE] = "";
+    uint8_t _uploadRecord[TelemetryCodec::WIND_BATCH_MAX_SIZE];
+    static_assert(TelemetryCodec::WIND_BATCH_MAX_SIZE >= TelemetryCodec::WIND_SUMMARY_MAX_SIZE &&
+                      TelemetryCodec::WIND_BATCH_MAX_SIZE >= TelemetryCodec::WIND_READING_SIZE &&
+                      TelemetryCodec::WIND_BATCH_MAX_SIZE >= TelemetryCodec::WIND_AGGREGATES_MAX_SIZE,
+                  "Binary records are encoded into the upload record buffer");
+
+    // Composite frame: staged parts, their bodies are in the payload buffers below
+    enum FramePart : uint8_t
+    {
+        FRAME_WIND = 1,
+        FRAME_TEMPERATURE = 2,
+        FRAME_DIAGNOSTICS = 4,
+        FRAME_ALL = FRAME_WIND | FRAME_TEMPERATURE | FRAME_DIAGNOSTICS
+    };
+    unsigned long _frameWindowMs = 0;
+    uint8_t _frameParts = 0;
+    unsigned long _frameOpenedMs = 0;
+
+    // Last X-Config-Version seen on a telemetry response
+    char _configVersionHint[STATION_CONFIG_ETAG_SIZE] = "";
+
+    // Preallocated JSON bodies, one per payload, sized for the worst case so
+    // the send path never touches the heap. The batch buffer, the largest,
+    // also carries composite frames, wind aggregates, queued records and their replay timestamp.
+    static const size_t PAYLOAD_BUFFERS_BUDGET = 8192;
+    char _temperatureJson[JsonPayloads::TEMPERATURE_MAX];
+    char _windJson[JsonPayloads::WIND_READING_MAX];
+    char _windSummaryJson[JsonPayloads::WIND_SUMMARY_MAX];
+    char _windBatchJson[JsonPayloads::WIND_BATCH_MAX + JsonPayloads::TIMESTAMP_MEMBER_MAX];
+    char _diagnosticsJson[JsonPayloads::DIAGNOSTICS_MAX];
+    static_assert(JsonPayloads::TEMPERATURE_MAX + JsonPayloads::WIND_READING_MAX + JsonPayloads::WIND_SUMMARY_MAX +
+                          JsonPayloads::WIND_BATCH_MAX + JsonPayloads::TIMESTAMP_MEMBER_MAX +
+                          JsonPayloads::DIAGNOSTICS_MAX <=
+                      PAYLOAD_BUFFERS_BUDGET,
+                  "Outbound JSON buffers exceed their RAM budget");
+    static_assert(JsonPayloads::WIND_BATCH_MAX >= JsonPayloads::WIND_SUMMARY_MAX &&
+                      JsonPayloads::WIND_BATCH_MAX >= JsonPayloads::DIAGNOSTICS_MAX &&
+                      JsonPayloads::WIND_BATCH_MAX >= JsonPayloads::FRAME_MAX &&
+                      JsonPayloads::WIND_BATCH_MAX >= JsonPayloads::WIND_AGGREGATES_MAX,
+                  "Frames, wind aggregates and queued records are written to the wind batch buffer");
+
     // Backoff mechanism state
     unsigned long _backoffDelay = 0;
     unsigned long _lastAttemptTime = 0;
@@ -154,8 +550,32 @@ private:
 
     void _handleHttpFailure();
     void _resetBackoff();
+    bool _createArduinoClient();
+    bool _prepareConnection();
+    int _startRequest(const char *method, const char *path, const char *contentType, const uint8_t *body,
+                      size_t bodyLength, const char *headerName = nullptr, const char *headerValue = nullptr);
+    bool _readBodyByLength(int contentLength, String *responseBody);
+    bool _scanResponseHeaders(ResponseHeaderScanner &scanner);
+    void _finishRequest(bool reusable);
     int _performRequest(const char *method, const char *path, const char *body, String &responseBody);
-    int _performLightweightPost(const char *path, const char *body);
+    int _performJsonGet(const char *path, JsonDocument &doc, const JsonDocument &filter, DeserializationError &error,
+                        char *etag = nullptr, size_t etagSize = 0);
+    int _performLightweightPost(const char *path, const char *contentType, const uint8_t *body, size_t bodyLength);
+    void _handleLightweightStatus(int statusCode, const char *contentType, const ResponseHeaderScanner &versionHeader,
+                                  const char *configVersion);
+    bool _startAsyncPost(const char *path, const char *contentType, const uint8_t *body, size_t bodyLength);
+    void _awaitRequest();
+    size_t _binaryLength(size_t encodedLength);
+    bool _sendUpload(const char *path, const Upload &upload);
+    bool _startUpload();
+    bool _completeUpload(int statusCode);
+    bool _usesCoap(size_t length) const;
+    bool _startCoapUpload(uint16_t contentFormat, const uint8_t *body, size_t length);
+    bool _completeCoapUpload(int statusCode);
+    void _completeReplay(int statusCode);
+    void _queueIfUndelivered(TelemetryQueueRecord::Kind kind, int statusCode, const char *json);
+    bool _beginFramePart(FramePart part, const char *stationId);
+    void _stageFramePart(FramePart part);
 };
 
 extern AiolosHttpClient httpClient;
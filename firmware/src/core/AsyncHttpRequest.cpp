@@ -0,0 +1,226 @@
+/**
+ * @file AsyncHttpRequest.cpp
+ * @brief State machine behind the non-blocking HTTP POST
+ */
+
+#include "AsyncHttpRequest.h"
+#include <ArduinoHttpClient.h>
+#include "../config/Config.h"
+
+void AsyncHttpRequest::begin(TinyGsmClient &client, const char *host, uint16_t port)
+{
+    _client = &client;
+    _host = host;
+    _port = port;
+}
+
+bool AsyncHttpRequest::startPost(const char *path, const char *contentType, const uint8_t *body, size_t length,
+                                 bool keepAlive, bool reuseConnection, ResponseHeaderScanner *extraHeader)
+{
+    if (!_client || isBusy())
+    {
+        return false;
+    }
+
+    // The same request ArduinoHttpClient sends, so the server cannot tell them apart
+    char port[8] = "";
+    if (_port != 80)
+    {
+        snprintf(port, sizeof(port), ":%u", _port);
+    }
+    int headLength = snprintf(_head, sizeof(_head),
+                              "POST %s HTTP/1.1\r\n"
+                              "Host: %s%s\r\n"
+                              "User-Agent: Arduino/2.2.0\r\n"
+                              "Connection: %s\r\n"
+                              "Content-Type: %s\r\n"
+                              "Content-Length: %u\r\n"
+                              "\r\n",
+                              path, _host, port, keepAlive ? "keep-alive" : "close", contentType, (unsigned)length);
+    if (headLength < 0 || (size_t)headLength >= sizeof(_head))
+    {
+        return false;
+    }
+
+    _headLength = headLength;
+    _body = body;
+    _bodyLength = length;
+    _sent = 0;
+    _error = 0;
+    _keepAlive = keepAlive;
+    _reused = reuseConnection;
+    _extraHeader = extraHeader;
+    _parser.reset(extraHeader);
+    _lastProgressMs = millis();
+    _state = reuseConnection ? SENDING : CONNECTING;
+    return true;
+}
+
+bool AsyncHttpRequest::poll()
+{
+    if (!isBusy())
+    {
+        return false;
+    }
+
+    // Each step returns false when it has to wait for the network or is done
+    unsigned long startMs = millis();
+    bool progressing = true;
+    while (progressing && isBusy() && millis() - startMs < HTTP_ASYNC_SLICE_MS)
+    {
+        switch (_state)
+        {
+        case CONNECTING:
+            progressing = _connect();
+            break;
+        case SENDING:
+            progressing = _send();
+            break;
+        case RECEIVING:
+            progressing = _receive();
+            break;
+        default:
+            progressing = false;
+            break;
+        }
+    }
+    return _state == FINISHED;
+}
+
+/**
+ * @brief Opens the TCP connection; the one step that waits, bounded by HTTP_ASYNC_CONNECT_TIMEOUT_S.
+ */
+bool AsyncHttpRequest::_connect()
+{
+    if (!_client->connect(_host, _port, HTTP_ASYNC_CONNECT_TIMEOUT_S))
+    {
+        _fail(HTTP_ERROR_CONNECTION_FAILED);
+        return false;
+    }
+    _state = SENDING;
+    _lastProgressMs = millis();
+    return true;
+}
+
+/**
+ * @brief Writes the next chunk of the request head and body.
+ */
+bool AsyncHttpRequest::_send()
+{
+    size_t total = _headLength + _bodyLength;
+    if (_sent >= total)
+    {
+        _state = RECEIVING;
+        _lastProgressMs = millis();
+        return true;
+    }
+
+    const uint8_t *data;
+    size_t length;
+    if (_sent < _headLength)
+    {
+        data = (const uint8_t *)_head + _sent;
+        length = _headLength - _sent;
+    }
+    else
+    {
+        data = _body + (_sent - _headLength);
+        length = total - _sent;
+    }
+    if (length > HTTP_ASYNC_WRITE_CHUNK)
+    {
+        length = HTTP_ASYNC_WRITE_CHUNK;
+    }
+
+    size_t written = _client->write(data, length);
+    if (written == 0)
+    {
+        if (!_retryOnNewConnection())
+        {
+            _fail(HTTP_ERROR_CONNECTION_FAILED);
+        }
+        return false;
+    }
+    _sent += written;
+    _lastProgressMs = millis();
+    return true;
+}
+
+/**
+ * @brief Feeds the part of the response that has arrived to the parser.
+ */
+bool AsyncHttpRequest::_receive()
+{
+    int available = _client->available();
+    if (available <= 0)
+    {
+        if (!_client->connected())
+        {
+            if (_parser.finishOnClose())
+            {
+                _state = FINISHED;
+            }
+            else if (!_retryOnNewConnection())
+            {
+                _fail(_parser.hasReceived() ? HTTP_ERROR_INVALID_RESPONSE : HTTP_ERROR_CONNECTION_FAILED);
+            }
+        }
+        else if (millis() - _lastProgressMs >= HTTP_ASYNC_RESPONSE_TIMEOUT_MS)
+        {
+            _fail(HTTP_ERROR_TIMED_OUT);
+        }
+        return false;
+    }
+
+    uint8_t buffer[HTTP_ASYNC_READ_CHUNK];
+    int count = _client->read(buffer, min((size_t)available, sizeof(buffer)));
+    for (int i = 0; i < count; i++)
+    {
+        HttpResponseParser::State state = _parser.feed((char)buffer[i]);
+        if (state == HttpResponseParser::COMPLETE)
+        {
+            // Anything after the body belongs to no request; the connection is not reused
+            if (i + 1 < count)
+            {
+                _keepAlive = false;
+            }
+            _state = FINISHED;
+            return false;
+        }
+        if (state == HttpResponseParser::MALFORMED)
+        {
+            _fail(HTTP_ERROR_INVALID_RESPONSE);
+            return false;
+        }
+    }
+    if (count > 0)
+    {
+        _lastProgressMs = millis();
+    }
+    return count > 0;
+}
+
+/**
+ * @brief A reused connection the server had already closed fails before any
+ * response; the request then starts over once on a new connection.
+ * @return true if it was restarted
+ */
+bool AsyncHttpRequest::_retryOnNewConnection()
+{
+    if (!_reused || _parser.hasReceived())
+    {
+        return false;
+    }
+    _client->stop();
+    _reused = false;
+    _sent = 0;
+    _parser.reset(_extraHeader);
+    _state = CONNECTING;
+    return true;
+}
+
+void AsyncHttpRequest::_fail(int error)
+{
+    _error = error;
+    _state = FINISHED;
+}
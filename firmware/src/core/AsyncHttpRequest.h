@@ -0,0 +1,110 @@
+/**
+ * @file AsyncHttpRequest.h
+ * @brief An HTTP POST advanced in short steps from the main loop
+ *
+ * ArduinoHttpClient's post() and responseStatusCode() wait for the server,
+ * up to 30 s on a bad link, and the loop stops with them: watchdog, OTA and
+ * everything else. This sends the same request as a state machine (connect,
+ * send, receive) and poll() only does what needs no waiting: it writes the
+ * request in chunks, reads whatever part of the response has arrived into
+ * an HttpResponseParser, and returns after HTTP_ASYNC_SLICE_MS at most.
+ *
+ * The TCP connect cannot be split: TinyGSM waits for the modem to report it.
+ * It is bounded by HTTP_ASYNC_CONNECT_TIMEOUT_S and, with keep-alive, only
+ * needed once per idle period.
+ */
+
+#define TINY_GSM_MODEM_SIM7000
+
+#pragma once
+
+#include <Arduino.h>
+#include <TinyGsmClient.h>
+#include "HttpResponseParser.h"
+
+class AsyncHttpRequest
+{
+public:
+    enum State : uint8_t
+    {
+        IDLE,
+        CONNECTING,
+        SENDING,
+        RECEIVING,
+        FINISHED
+    };
+
+    /**
+     * @brief Set the socket and server the requests go to
+     */
+    void begin(TinyGsmClient &client, const char *host, uint16_t port);
+
+    /**
+     * @brief Start a POST; poll() carries it out
+     *
+     * The path and body must stay valid until the request has finished.
+     *
+     * @param keepAlive Ask the server to keep the connection open afterwards
+     * @param reuseConnection Send on the connection that is open. If the server
+     *                        has closed it, the request is sent once more on a new one.
+     * @param extraHeader Optional scanner for a response header
+     * @return false if a request is in progress or the request line does not fit
+     */
+    bool startPost(const char *path, const char *contentType, const uint8_t *body, size_t length, bool keepAlive,
+                   bool reuseConnection, ResponseHeaderScanner *extraHeader = nullptr);
+
+    /**
+     * @brief Advance the request without waiting on the network
+     *
+     * @return true if the request finished during this call, see statusCode()
+     */
+    bool poll();
+
+    bool isBusy() const { return _state != IDLE && _state != FINISHED; }
+
+    State getState() const { return _state; }
+
+    /**
+     * @brief Status code of the finished request, or a negative HTTP_ERROR_* code
+     */
+    int statusCode() const { return _error != 0 ? _error : _parser.statusCode(); }
+
+    /**
+     * @brief Whether the finished request left the connection fit for another one
+     */
+    bool isReusable() const { return _error == 0 && _keepAlive && _parser.isReusable(); }
+
+    /**
+     * @brief Whether the finished request went out on a connection that was already open
+     */
+    bool wasReused() const { return _reused; }
+
+private:
+    // Request line and headers; the path is the only part of variable length
+    static const size_t HEAD_SIZE = 256;
+
+    TinyGsmClient *_client = nullptr;
+    const char *_host = nullptr;
+    uint16_t _port = 0;
+
+    State _state = IDLE;
+    int _error = 0;
+    bool _keepAlive = false;
+    bool _reused = false;
+    unsigned long _lastProgressMs = 0;
+
+    char _head[HEAD_SIZE];
+    size_t _headLength = 0;
+    const uint8_t *_body = nullptr;
+    size_t _bodyLength = 0;
+    size_t _sent = 0; // Of head and body together
+
+    HttpResponseParser _parser;
+    ResponseHeaderScanner *_extraHeader = nullptr;
+
+    bool _connect();
+    bool _send();
+    bool _receive();
+    bool _retryOnNewConnection();
+    void _fail(int error);
+};
@@ -0,0 +1,134 @@
+/**
+ * @file CoapExchange.h
+ * @brief Retransmission of a confirmable CoAP message (RFC 7252, 4.2)
+ *
+ * A confirmable message is sent again with the same message ID until an
+ * ACK or RST with that ID arrives. The first timeout is picked at random
+ * between ACK_TIMEOUT and ACK_TIMEOUT * ACK_RANDOM_FACTOR, so stations that
+ * lost the link together do not retransmit together, and doubles with each
+ * retransmission. After MAX_RETRANSMIT retransmissions the exchange gives
+ * up. The server recognizes the retransmissions by their message ID and
+ * acknowledges them without processing the message again.
+ *
+ * A reply with any other message ID belongs to an exchange that has
+ * already ended (a late ACK of a message given up on) and is ignored.
+ *
+ * Times are millis() values; the class does no I/O and keeps no clock.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "CoapMessage.h"
+
+class CoapExchange
+{
+public:
+    enum Event
+    {
+        WAIT,       // Nothing to do yet
+        RETRANSMIT, // Send the message again
+        GIVE_UP     // No ACK within the retransmission window
+    };
+
+    /**
+     * @param ackTimeoutMs ACK_TIMEOUT, 2000 in RFC 7252
+     * @param randomFactorPercent ACK_RANDOM_FACTOR in percent, 150 in RFC 7252
+     * @param maxRetransmit MAX_RETRANSMIT, 4 in RFC 7252
+     */
+    CoapExchange(uint32_t ackTimeoutMs = 2000, uint16_t randomFactorPercent = 150, uint8_t maxRetransmit = 4)
+        : _ackTimeoutMs(ackTimeoutMs), _randomFactorPercent(randomFactorPercent), _maxRetransmit(maxRetransmit)
+    {
+    }
+
+    /**
+     * @brief The message went out for the first time
+     *
+     * @param random Any 16-bit random number; picks the first timeout
+     */
+    void start(uint16_t messageId, uint32_t nowMs, uint16_t random)
+    {
+        uint32_t spreadMs = _ackTimeoutMs * (_randomFactorPercent - 100) / 100;
+        _messageId = messageId;
+        _timeoutMs = _ackTimeoutMs + (uint32_t)((uint64_t)spreadMs * random / 0xFFFF);
+        _sentMs = nowMs;
+        _startedMs = nowMs;
+        _transmissions = 1;
+        _active = true;
+    }
+
+    /**
+     * @brief What is due at this time; a RETRANSMIT is counted as sent now
+     */
+    Event check(uint32_t nowMs)
+    {
+        if (!_active || nowMs - _sentMs < _timeoutMs)
+        {
+            return WAIT;
+        }
+        if (_transmissions > _maxRetransmit)
+        {
+            _active = false;
+            return GIVE_UP;
+        }
+        _transmissions++;
+        _timeoutMs *= 2;
+        _sentMs = nowMs;
+        return RETRANSMIT;
+    }
+
+    /**
+     * @brief Offer a received message
+     *
+     * @return true if it is the ACK or RST of this exchange, which ends it
+     */
+    bool accept(const Coap::Message &reply)
+    {
+        if (!_active || reply.messageId != _messageId ||
+            (reply.type != Coap::ACKNOWLEDGEMENT && reply.type != Coap::RESET))
+        {
+            return false;
+        }
+        _active = false;
+        return true;
+    }
+
+    void cancel() { _active = false; }
+
+    bool isActive() const { return _active; }
+
+    uint16_t messageId() const { return _messageId; }
+
+    /**
+     * @brief Times the message was sent, the first time included
+     */
+    uint8_t transmissions() const { return _transmissions; }
+
+    /**
+     * @brief Milliseconds since the first transmission, at nowMs
+     */
+    uint32_t elapsedMs(uint32_t nowMs) const { return nowMs - _startedMs; }
+
+    /**
+     * @brief Longest time an exchange can take before it gives up (MAX_TRANSMIT_WAIT)
+     */
+    uint32_t maxWaitMs() const
+    {
+        uint32_t longestFirstMs = _ackTimeoutMs * _randomFactorPercent / 100;
+        return longestFirstMs * ((1UL << (_maxRetransmit + 1)) - 1);
+    }
+
+private:
+    uint32_t _ackTimeoutMs;
+    uint16_t _randomFactorPercent;
+    uint8_t _maxRetransmit;
+
+    uint16_t _messageId = 0;
+    uint32_t _timeoutMs = 0;
+    uint32_t _sentMs = 0;
+    uint32_t _startedMs = 0;
+    uint8_t _transmissions = 0;
+    bool _active = false;
+};
@@ -0,0 +1,331 @@
+/**
+ * @file CoapMessage.h
+ * @brief Encoding and parsing of CoAP messages (RFC 7252)
+ *
+ * Just what telemetry over CoAP needs: a confirmable POST with its path as
+ * Uri-Path options, a Content-Format and a payload, and the replies to it.
+ * A message is
+ *
+ *   u8 version (1) << 6 | type << 4 | token length, u8 code, u16 message ID,
+ *   token, options (delta encoded), 0xFF and the payload if there is one
+ *
+ * big endian, written into a caller buffer without heap allocations.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace Coap
+{
+    static const uint8_t VERSION = 1;
+    static const size_t HEADER_SIZE = 4;
+    static const size_t TOKEN_MAX = 8;
+    static const uint8_t PAYLOAD_MARKER = 0xFF;
+
+    enum Type : uint8_t
+    {
+        CONFIRMABLE = 0,
+        NON_CONFIRMABLE = 1,
+        ACKNOWLEDGEMENT = 2,
+        RESET = 3
+    };
+
+    /**
+     * @brief Code c.dd: class in the top 3 bits, detail in the low 5
+     */
+    constexpr uint8_t code(uint8_t codeClass, uint8_t detail) { return (uint8_t)(codeClass << 5 | detail); }
+
+    static const uint8_t CODE_EMPTY = code(0, 0);
+    static const uint8_t CODE_POST = code(0, 2);
+    static const uint8_t CODE_CREATED = code(2, 1);
+    static const uint8_t CODE_CHANGED = code(2, 4);
+    static const uint8_t CODE_BAD_REQUEST = code(4, 0);
+    static const uint8_t CODE_NOT_FOUND = code(4, 4);
+    static const uint8_t CODE_UNSUPPORTED_CONTENT_FORMAT = code(4, 15);
+
+    /**
+     * @brief The HTTP status a response code stands for: 2.04 is 204, 4.15 is 415
+     */
+    inline int statusCode(uint8_t responseCode) { return (responseCode >> 5) * 100 + (responseCode & 0x1F); }
+
+    static const uint16_t OPTION_URI_PATH = 11;
+    static const uint16_t OPTION_CONTENT_FORMAT = 12;
+
+    static const uint16_t FORMAT_JSON = 50;
+    static const uint16_t FORMAT_NONE = 0xFFFF; // No Content-Format option
+
+    struct Message
+    {
+        Type type = CONFIRMABLE;
+        uint8_t code = CODE_EMPTY;
+        uint16_t messageId = 0;
+        uint8_t tokenLength = 0;
+        uint8_t token[TOKEN_MAX] = {};
+        uint16_t contentFormat = FORMAT_NONE;
+        const uint8_t *payload = nullptr; // Into the parsed datagram
+        size_t payloadLength = 0;
+    };
+
+    /**
+     * @brief Bounds checked writer over a caller buffer
+     */
+    class Writer
+    {
+    public:
+        Writer(uint8_t *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity) {}
+
+        void u8(uint8_t value) { bytes(&value, 1); }
+
+        void bytes(const uint8_t *data, size_t length)
+        {
+            if (length == 0)
+            {
+                return;
+            }
+            if (_overflow || length > _capacity - _size)
+            {
+                _overflow = true;
+                return;
+            }
+            memcpy(_buffer + _size, data, length);
+            _size += length;
+        }
+
+        /**
+         * @brief Option header and value; options must come in ascending order
+         */
+        void option(uint16_t number, const uint8_t *value, size_t length)
+        {
+            uint16_t delta = number - _lastOption;
+            _lastOption = number;
+            uint8_t header = (uint8_t)(_nibble(delta) << 4 | _nibble(length));
+            u8(header);
+            _extended(delta);
+            _extended(length);
+            bytes(value, length);
+        }
+
+        /**
+         * @brief Option with an unsigned integer value, in as few bytes as it needs
+         */
+        void uintOption(uint16_t number, uint32_t value)
+        {
+            uint8_t data[4];
+            size_t length = 0;
+            for (int shift = 24; shift >= 0; shift -= 8)
+            {
+                if (length > 0 || (value >> shift) != 0)
+                {
+                    data[length++] = (uint8_t)(value >> shift);
+                }
+            }
+            option(number, data, length);
+        }
+
+        size_t size() const { return _overflow ? 0 : _size; }
+
+    private:
+        uint8_t *_buffer;
+        size_t _capacity;
+        size_t _size = 0;
+        bool _overflow = false;
+        uint16_t _lastOption = 0;
+
+        // 0-12 in the nibble, 13 and 14 announce one or two extension bytes
+        static uint8_t _nibble(size_t value) { return value < 13 ? (uint8_t)value : value < 269 ? 13 : 14; }
+
+        void _extended(size_t value)
+        {
+            if (value >= 269)
+            {
+                u8((uint8_t)((value - 269) >> 8));
+                u8((uint8_t)(value - 269));
+            }
+            else if (value >= 13)
+            {
+                u8((uint8_t)(value - 13));
+            }
+        }
+    };
+
+    inline void writeHeader(Writer &writer, Type type, uint8_t messageCode, uint16_t messageId, const uint8_t *token,
+                            uint8_t tokenLength)
+    {
+        writer.u8((uint8_t)(VERSION << 6 | type << 4 | (tokenLength & 0x0F)));
+        writer.u8(messageCode);
+        writer.u8((uint8_t)(messageId >> 8));
+        writer.u8((uint8_t)messageId);
+        writer.bytes(token, tokenLength);
+    }
+
+    /**
+     * @brief Write a confirmable POST
+     *
+     * @param path Split at '/' into Uri-Path options, empty segments skipped
+     * @param contentFormat Content-Format of the payload, FORMAT_NONE to leave it out
+     * @return Size of the message, 0 if it does not fit the buffer
+     */
+    inline size_t writePost(uint8_t *buffer, size_t capacity, uint16_t messageId, const uint8_t *token,
+                            uint8_t tokenLength, const char *path, uint16_t contentFormat, const uint8_t *payload,
+                            size_t payloadLength)
+    {
+        if (tokenLength > TOKEN_MAX)
+        {
+            return 0;
+        }
+        Writer writer(buffer, capacity);
+        writeHeader(writer, CONFIRMABLE, CODE_POST, messageId, token, tokenLength);
+
+        const char *segment = path;
+        while (*segment)
+        {
+            const char *end = strchr(segment, '/');
+            size_t length = end ? (size_t)(end - segment) : strlen(segment);
+            if (length > 0)
+            {
+                writer.option(OPTION_URI_PATH, (const uint8_t *)segment, length);
+            }
+            segment += length;
+            if (*segment == '/')
+            {
+                segment++;
+            }
+        }
+        if (contentFormat != FORMAT_NONE)
+        {
+            writer.uintOption(OPTION_CONTENT_FORMAT, contentFormat);
+        }
+
+        if (payloadLength > 0)
+        {
+            writer.u8(PAYLOAD_MARKER);
+            writer.bytes(payload, payloadLength);
+        }
+        return writer.size();
+    }
+
+    /**
+     * @brief Write a message without options or payload: an empty ACK or RST, or a piggybacked response
+     *
+     * @return Size of the message, 0 if it does not fit the buffer
+     */
+    inline size_t writeReply(uint8_t *buffer, size_t capacity, Type type, uint8_t messageCode, uint16_t messageId,
+                             const uint8_t *token = nullptr, uint8_t tokenLength = 0)
+    {
+        if (tokenLength > TOKEN_MAX)
+        {
+            return 0;
+        }
+        Writer writer(buffer, capacity);
+        writeHeader(writer, type, messageCode, messageId, token, tokenLength);
+        return writer.size();
+    }
+
+    /**
+     * @brief Parse a received datagram
+     *
+     * @param path Optional, receives the Uri-Path options joined by '/'
+     * @return false if it is not a well-formed CoAP message
+     */
+    inline bool parse(const uint8_t *data, size_t length, Message &message, char *path = nullptr,
+                      size_t pathSize = 0)
+    {
+        if (length < HEADER_SIZE || (data[0] >> 6) != VERSION)
+        {
+            return false;
+        }
+        message = Message();
+        message.type = (Type)((data[0] >> 4) & 0x03);
+        message.tokenLength = data[0] & 0x0F;
+        message.code = data[1];
+        message.messageId = (uint16_t)(data[2] << 8 | data[3]);
+        if (message.tokenLength > TOKEN_MAX || HEADER_SIZE + message.tokenLength > length)
+        {
+            return false;
+        }
+        memcpy(message.token, data + HEADER_SIZE, message.tokenLength);
+
+        size_t pathLength = 0;
+        if (path && pathSize > 0)
+        {
+            path[0] = '\0';
+        }
+
+        size_t offset = HEADER_SIZE + message.tokenLength;
+        uint16_t number = 0;
+        while (offset < length)
+        {
+            uint8_t header = data[offset++];
+            if (header == PAYLOAD_MARKER)
+            {
+                // A marker must be followed by a payload
+                if (offset == length)
+                {
+                    return false;
+                }
+                message.payload = data + offset;
+                message.payloadLength = length - offset;
+                return true;
+            }
+
+            size_t fields[2] = {(size_t)(header >> 4), (size_t)(header & 0x0F)};
+            for (size_t &field : fields)
+            {
+                if (field == 15)
+                {
+                    return false;
+                }
+                if (field == 13)
+                {
+                    if (offset + 1 > length)
+                    {
+                        return false;
+                    }
+                    field = 13 + data[offset++];
+                }
+                else if (field == 14)
+                {
+                    if (offset + 2 > length)
+                    {
+                        return false;
+                    }
+                    field = 269 + (data[offset] << 8 | data[offset + 1]);
+                    offset += 2;
+                }
+            }
+            size_t valueLength = fields[1];
+            if (valueLength > length - offset)
+            {
+                return false;
+            }
+            number += (uint16_t)fields[0];
+            const uint8_t *value = data + offset;
+            offset += valueLength;
+
+            if (number == OPTION_CONTENT_FORMAT && valueLength <= 2)
+            {
+                message.contentFormat = 0;
+                for (size_t i = 0; i < valueLength; i++)
+                {
+                    message.contentFormat = (uint16_t)(message.contentFormat << 8 | value[i]);
+                }
+            }
+            else if (number == OPTION_URI_PATH && path && pathLength + valueLength + 2 <= pathSize)
+            {
+                if (pathLength > 0)
+                {
+                    path[pathLength++] = '/';
+                }
+                memcpy(path + pathLength, value, valueLength);
+                pathLength += valueLength;
+                path[pathLength] = '\0';
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,226 @@
+/**
+ * @file CoapTransport.cpp
+ * @brief UDP socket of the modem and the exchange on top of it
+ */
+
+#include "CoapTransport.h"
+#include <ArduinoHttpClient.h>
+#include <esp_system.h>
+#include "Logger.h"
+
+// Status of an empty ACK: the server has the message, its response follows separately
+static const int COAP_STATUS_ACCEPTED = 202;
+
+void CoapTransport::begin(TinyGsm &modem, const char *host, uint16_t port)
+{
+    _modem = &modem;
+    _host = host;
+    _port = port;
+    _nextMessageId = (uint16_t)esp_random(); // Not to repeat IDs the server saw before a restart
+}
+
+bool CoapTransport::start(const char *path, uint16_t contentFormat, const uint8_t *body, size_t length)
+{
+    if (!_modem || isBusy())
+    {
+        return false;
+    }
+
+    uint16_t messageId = _nextMessageId++;
+    uint32_t random = esp_random();
+    memcpy(_token, &random, sizeof(_token));
+    _datagramLength = Coap::writePost(_datagram, sizeof(_datagram), messageId, _token, TOKEN_LENGTH, path,
+                                      contentFormat, body, length);
+    if (_datagramLength == 0)
+    {
+        Logger.error(LOG_TAG_COAP, "POST to %s does not fit a datagram", path);
+        return false;
+    }
+
+    if (!_send(_datagram, _datagramLength))
+    {
+        close(); // Opened anew for the next exchange
+        return false;
+    }
+    _stats.exchanges++;
+    _exchange.start(messageId, millis(), (uint16_t)(random >> 16));
+    _lastReceiveMs = millis();
+    Logger.debug(LOG_TAG_COAP, "POST %s, message %u, %u bytes", path, messageId, (unsigned)_datagramLength);
+    return true;
+}
+
+bool CoapTransport::poll()
+{
+    if (!isBusy())
+    {
+        return false;
+    }
+
+    if (millis() - _lastReceiveMs >= COAP_POLL_INTERVAL_MS)
+    {
+        _lastReceiveMs = millis();
+        size_t length = _receive();
+        if (length > 0)
+        {
+            _handle(_received, length);
+            if (!isBusy())
+            {
+                return true;
+            }
+        }
+    }
+
+    switch (_exchange.check(millis()))
+    {
+    case CoapExchange::RETRANSMIT:
+        _stats.retransmissions++;
+        Logger.debug(LOG_TAG_COAP, "Retransmitting message %u (%u)", _exchange.messageId(), _exchange.transmissions());
+        _send(_datagram, _datagramLength);
+        return false;
+
+    case CoapExchange::GIVE_UP:
+        _stats.timeouts++;
+        Logger.warn(LOG_TAG_COAP, "No ACK for message %u after %u transmissions", _exchange.messageId(),
+                    _exchange.transmissions());
+        _finish(HTTP_ERROR_TIMED_OUT);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void CoapTransport::close()
+{
+    _exchange.cancel();
+    if (!_modem || !_open)
+    {
+        return;
+    }
+    _modem->sendAT(GF("+CIPCLOSE="), COAP_MODEM_MUX);
+    _modem->waitResponse(GF("CLOSE OK"), GF("ERROR"));
+    _open = false;
+}
+
+/**
+ * @brief Opens the UDP connection to the server; sends need no handshake after it.
+ */
+bool CoapTransport::_openSocket()
+{
+    _modem->sendAT(GF("+CIPSTART="), COAP_MODEM_MUX, GF(",\"UDP\",\""), _host, GF("\","), _port);
+    int8_t result = _modem->waitResponse(10000L, GF("CONNECT OK" GSM_NL), GF("CONNECT FAIL" GSM_NL),
+                                         GF("ALREADY CONNECT" GSM_NL), GF("ERROR" GSM_NL));
+    if (result != 1 && result != 3)
+    {
+        Logger.error(LOG_TAG_COAP, "Failed to open UDP socket to %s:%u", _host, _port);
+        return false;
+    }
+    _open = true;
+    return true;
+}
+
+/**
+ * @brief One datagram: AT+CIPSEND, the data after the prompt, the modem's confirmation.
+ */
+bool CoapTransport::_send(const uint8_t *data, size_t length)
+{
+    if (!_open && !_openSocket())
+    {
+        return false;
+    }
+
+    _modem->sendAT(GF("+CIPSEND="), COAP_MODEM_MUX, ',', (uint16_t)length);
+    if (_modem->waitResponse(GF(">")) != 1)
+    {
+        return false;
+    }
+    _modem->stream.write(data, length);
+    _modem->stream.flush();
+    if (_modem->waitResponse(GF(GSM_NL "DATA ACCEPT:")) != 1)
+    {
+        return false;
+    }
+    char rest[16]; // "<mux>,<length>" of the confirmation
+    _modem->stream.readBytesUntil('\n', rest, sizeof(rest));
+    _stats.datagramsSent++;
+    return true;
+}
+
+/**
+ * @brief Reads what the modem received on the socket: +CIPRXGET: 2,<mux>,<length>,<left>
+ * @return Bytes read into _received, 0 if there were none
+ */
+size_t CoapTransport::_receive()
+{
+    _modem->sendAT(GF("+CIPRXGET=2,"), COAP_MODEM_MUX, ',', (uint16_t)sizeof(_received));
+    if (_modem->waitResponse(GF("+CIPRXGET:")) != 1)
+    {
+        return 0;
+    }
+
+    char line[32];
+    size_t count = _modem->stream.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[count] = '\0';
+    // Mode and mux come first
+    const char *field = strchr(line, ',');
+    field = field ? strchr(field + 1, ',') : nullptr;
+    long length = field ? strtol(field + 1, nullptr, 10) : 0;
+    if (length < 0 || length > (long)sizeof(_received))
+    {
+        length = 0;
+    }
+
+    size_t read = length > 0 ? _modem->stream.readBytes(_received, length) : 0;
+    _modem->waitResponse();
+    return read;
+}
+
+/**
+ * @brief A datagram from the server: the ACK or RST of the exchange, or a
+ * separate response, which is acknowledged so the server stops sending it.
+ */
+void CoapTransport::_handle(const uint8_t *data, size_t length)
+{
+    _stats.datagramsReceived++;
+
+    Coap::Message message;
+    if (!Coap::parse(data, length, message))
+    {
+        Logger.debug(LOG_TAG_COAP, "Ignoring malformed datagram of %u bytes", (unsigned)length);
+        return;
+    }
+
+    if (message.type == Coap::CONFIRMABLE)
+    {
+        uint8_t ack[Coap::HEADER_SIZE];
+        if (Coap::writeReply(ack, sizeof(ack), Coap::ACKNOWLEDGEMENT, Coap::CODE_EMPTY, message.messageId) > 0)
+        {
+            _send(ack, sizeof(ack));
+        }
+        return;
+    }
+
+    if (!_exchange.accept(message))
+    {
+        Logger.debug(LOG_TAG_COAP, "Ignoring reply to message %u", message.messageId);
+        return;
+    }
+
+    if (message.type == Coap::RESET)
+    {
+        Logger.warn(LOG_TAG_COAP, "Server reset message %u", message.messageId);
+        _finish(HTTP_ERROR_INVALID_RESPONSE);
+    }
+    else
+    {
+        _finish(message.code == Coap::CODE_EMPTY ? COAP_STATUS_ACCEPTED : Coap::statusCode(message.code));
+    }
+}
+
+void CoapTransport::_finish(int statusCode)
+{
+    _exchange.cancel();
+    _statusCode = statusCode;
+    Logger.debug(LOG_TAG_COAP, "Message %u: %d after %u transmissions, %lu ms", _exchange.messageId(), statusCode,
+                 _exchange.transmissions(), (unsigned long)_exchange.elapsedMs(millis()));
+}
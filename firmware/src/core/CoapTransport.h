@@ -0,0 +1,110 @@
+/**
+ * @file CoapTransport.h
+ * @brief Confirmable CoAP POSTs over a UDP socket of the modem
+ *
+ * A telemetry upload over HTTP costs a TCP handshake (unless kept alive),
+ * request and response headers and the TCP acknowledgements; over CoAP it
+ * is one datagram out and one back, the ACK carrying the response code.
+ * The socket is a UDP connection of the SIM7000 (AT+CIPSTART on
+ * COAP_MODEM_MUX) next to the TCP one TinyGSM uses. Its data is written
+ * with AT+CIPSEND and read with AT+CIPRXGET, every COAP_POLL_INTERVAL_MS
+ * while an exchange waits for its ACK.
+ *
+ * One exchange at a time; CoapExchange retransmits it. Like
+ * AsyncHttpRequest, poll() advances it and never waits for the network
+ * longer than one AT command.
+ */
+
+#define TINY_GSM_MODEM_SIM7000
+
+#pragma once
+
+#include <Arduino.h>
+#include <TinyGsmClient.h>
+#include "CoapExchange.h"
+#include "../config/Config.h"
+
+class CoapTransport
+{
+public:
+    struct Stats
+    {
+        uint32_t exchanges = 0;
+        uint32_t datagramsSent = 0; // Retransmissions and ACKs of server messages included
+        uint32_t datagramsReceived = 0;
+        uint32_t retransmissions = 0;
+        uint32_t timeouts = 0; // Exchanges given up without ACK
+    };
+
+    CoapTransport() : _exchange(COAP_ACK_TIMEOUT_MS, COAP_ACK_RANDOM_FACTOR_PERCENT, COAP_MAX_RETRANSMIT) {}
+
+    /**
+     * @brief Set the modem and the server the datagrams go to
+     */
+    void begin(TinyGsm &modem, const char *host, uint16_t port);
+
+    /**
+     * @brief Send a confirmable POST; poll() waits for its ACK
+     *
+     * The body is copied into the datagram and need not stay valid.
+     *
+     * @param contentFormat CoAP Content-Format of the body, e.g. Coap::FORMAT_JSON
+     * @return false if an exchange is in progress or the datagram could not be sent
+     */
+    bool start(const char *path, uint16_t contentFormat, const uint8_t *body, size_t length);
+
+    /**
+     * @brief Check for the ACK and retransmit when due
+     *
+     * @return true if the exchange finished during this call, see statusCode()
+     */
+    bool poll();
+
+    bool isBusy() const { return _exchange.isActive(); }
+
+    /**
+     * @brief Result of the finished exchange
+     *
+     * The response code as an HTTP status (2.04 is 204, an empty ACK 202),
+     * or a negative HTTP_ERROR_* code: TIMED_OUT without ACK,
+     * INVALID_RESPONSE for a reset, CONNECTION_FAILED if nothing could be sent.
+     */
+    int statusCode() const { return _statusCode; }
+
+    /**
+     * @brief Close the UDP socket, e.g. when CoAP is switched off
+     */
+    void close();
+
+    const Stats &getStats() const { return _stats; }
+
+    /**
+     * @brief Whether a body of this length fits one datagram
+     */
+    static bool fits(size_t length) { return length <= COAP_PAYLOAD_MAX; }
+
+private:
+    static const uint8_t TOKEN_LENGTH = 4;
+
+    TinyGsm *_modem = nullptr;
+    const char *_host = nullptr;
+    uint16_t _port = 0;
+    bool _open = false;
+
+    CoapExchange _exchange;
+    uint16_t _nextMessageId = 0;
+    uint8_t _token[TOKEN_LENGTH] = {};
+    int _statusCode = 0;
+    unsigned long _lastReceiveMs = 0;
+    Stats _stats;
+
+    uint8_t _datagram[COAP_DATAGRAM_MAX];
+    size_t _datagramLength = 0;
+    uint8_t _received[COAP_DATAGRAM_MAX];
+
+    bool _openSocket();
+    bool _send(const uint8_t *data, size_t length);
+    size_t _receive();
+    void _handle(const uint8_t *data, size_t length);
+    void _finish(int statusCode);
+};
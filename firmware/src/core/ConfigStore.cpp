@@ -0,0 +1,77 @@
+/**
+ * @file ConfigStore.cpp
+ * @brief NVS backed storage of the remote configuration
+ */
+
+#include "ConfigStore.h"
+#include "Logger.h"
+#include <Preferences.h>
+#include <string.h>
+
+namespace
+{
+    const char *NVS_NAMESPACE = "config";
+    const char *NVS_KEY = "station";
+    const uint8_t FORMAT_VERSION = 2;
+
+    struct StoredConfig
+    {
+        uint8_t version;
+        char etag[STATION_CONFIG_ETAG_SIZE];
+        StationConfig config;
+    };
+}
+
+bool ConfigStore::load(StationConfig &config, char *etag, size_t etagSize)
+{
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true))
+    {
+        // Namespace does not exist yet: nothing has been stored
+        return false;
+    }
+
+    StoredConfig stored = {};
+    size_t length = prefs.getBytes(NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
+
+    // A firmware with a different StationConfig layout stored something else
+    if (length != sizeof(stored) || stored.version != FORMAT_VERSION)
+    {
+        return false;
+    }
+
+    config = stored.config;
+    if (etag && etagSize > 0)
+    {
+        stored.etag[sizeof(stored.etag) - 1] = '\0';
+        strlcpy(etag, stored.etag, etagSize);
+    }
+    return true;
+}
+
+bool ConfigStore::save(const StationConfig &config, const char *etag)
+{
+    StoredConfig stored = {};
+    stored.version = FORMAT_VERSION;
+    strlcpy(stored.etag, etag ? etag : "", sizeof(stored.etag));
+    stored.config = config;
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false))
+    {
+        Logger.error(LOG_TAG_SYSTEM, "Failed to open NVS for the station configuration");
+        return false;
+    }
+
+    size_t written = prefs.putBytes(NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
+
+    if (written != sizeof(stored))
+    {
+        Logger.error(LOG_TAG_SYSTEM, "Failed to store the station configuration");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file ConfigStore.h
+ * @brief Persistence of the last applied remote configuration in NVS
+ *
+ * Keeps the configuration together with the ETag it was served with, so
+ * the station boots with the settings it had before the restart and the
+ * next fetch can be answered with 304 Not Modified.
+ */
+
+#pragma once
+
+#include "StationConfig.h"
+
+namespace ConfigStore
+{
+    /**
+     * @brief Load the stored configuration
+     *
+     * @param config Receives the stored configuration
+     * @param etag Receives the ETag the configuration was served with (may be empty)
+     * @param etagSize Size of the etag buffer
+     * @return true if a stored configuration was loaded
+     * @return false if none was stored; config and etag are left unchanged
+     */
+    bool load(StationConfig &config, char *etag, size_t etagSize);
+
+    /**
+     * @brief Store an applied configuration and its ETag
+     *
+     * @return true if it was written
+     */
+    bool save(const StationConfig &config, const char *etag);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file CountingStream.h
+ * @brief Stream wrapper that counts the bytes passing through it
+ *
+ * Sits between TinyGSM and the modem UART so the bytes a request costs on
+ * the 115200 baud link can be measured: AT commands, socket data and modem
+ * responses alike. Reading the counters is free; they wrap after 4 GB.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class CountingStream : public Stream
+{
+public:
+    explicit CountingStream(Stream &inner) : _inner(inner) {}
+
+    size_t write(uint8_t c) override
+    {
+        size_t written = _inner.write(c);
+        _txBytes += written;
+        return written;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        size_t written = _inner.write(buffer, size);
+        _txBytes += written;
+        return written;
+    }
+
+    int available() override { return _inner.available(); }
+
+    int read() override
+    {
+        int c = _inner.read();
+        if (c >= 0)
+        {
+            _rxBytes++;
+        }
+        return c;
+    }
+
+    int peek() override { return _inner.peek(); }
+
+    void flush() override { _inner.flush(); }
+
+    /**
+     * @brief Bytes written to the modem since boot
+     */
+    uint32_t getTxBytes() const { return _txBytes; }
+
+    /**
+     * @brief Bytes read from the modem since boot
+     */
+    uint32_t getRxBytes() const { return _rxBytes; }
+
+private:
+    Stream &_inner;
+    uint32_t _txBytes = 0;
+    uint32_t _rxBytes = 0;
+};
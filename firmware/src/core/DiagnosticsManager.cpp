@@ -5,6 +5,8 @@
 
 #include "DiagnosticsManager.h"
 #include "../config/Config.h"
+#include "../sensors/WindSensor.h"
+#include "../sensors/WindSamplingTask.h"
 
 #define LOG_TAG_DIAG "DIAG"
 
@@ -119,11 +121,38 @@ bool DiagnosticsManager::sendDiagnosticsInternal(float internalTemp, float exter
     // Get system uptime in seconds
     unsigned long uptime = getSystemUptime();
 
+    // Drift of the wind vane ADC clusters from the stored calibration
+    float vaneDivergence;
+    {
+        WindSensorLock lock(windSamplingTask);
+        vaneDivergence = windSensor.getVaneDivergence();
+    }
+
+    // Wind sampling cadence since the previous report
+    SampleJitterSnapshot windJitter = windSamplingTask.takeJitterStats();
+
     // Log diagnostic values before sending
     Logger.info(LOG_TAG_DIAG, "Diagnostics - Battery: %.2fV, Solar: %.2fV, Signal: %d, Uptime: %lus",
                 batteryVoltage, solarVoltage, signalQuality, uptime);
-    Logger.info(LOG_TAG_DIAG, "Diagnostics - Internal temp: %.1f°C, External temp: %.1f°C",
-                internalTemp, externalTemp);
+    Logger.info(LOG_TAG_DIAG, "Diagnostics - Internal temp: %.1f°C, External temp: %.1f°C, Vane divergence: %.2f",
+                internalTemp, externalTemp, vaneDivergence);
+    Logger.info(LOG_TAG_DIAG, "Diagnostics - Wind ticks: %lu, jitter avg %lu us, max %lu us, overruns %lu, dropped readings %lu",
+                (unsigned long)windJitter.ticks, (unsigned long)windJitter.avgUs, (unsigned long)windJitter.maxUs,
+                (unsigned long)windJitter.overruns, (unsigned long)windSamplingTask.getDroppedReports());
+
+    // Queue latency of the outbound work since boot, by class (serial log only, not uploaded)
+    for (uint8_t i = 0; i < OutboundScheduler::CLASS_COUNT; i++)
+    {
+        OutboundScheduler::Class cls = (OutboundScheduler::Class)i;
+        const OutboundScheduler::ClassStats &stats = _httpClient->getOutboundStats(cls);
+        if (stats.dispatched == 0)
+        {
+            continue;
+        }
+        Logger.info(LOG_TAG_DIAG, "Diagnostics - Outbound %s: %lu sent (%lu failed, %lu coalesced), latency avg %lu ms, max %lu ms",
+                    OutboundScheduler::name(cls), (unsigned long)stats.dispatched, (unsigned long)stats.failed,
+                    (unsigned long)stats.coalesced, (unsigned long)stats.avgLatencyMs(), (unsigned long)stats.maxLatencyMs);
+    }
 
 #ifdef DISABLE_WDT_FOR_MODEM
     Logger.debug(LOG_TAG_DIAG, "Disabling watchdog for diagnostics");
@@ -131,7 +160,8 @@ bool DiagnosticsManager::sendDiagnosticsInternal(float internalTemp, float exter
 #endif
 
     // Send data to server
-    bool success = _httpClient->sendDiagnostics(DEVICE_ID, batteryVoltage, solarVoltage, internalTemp, signalQuality, uptime);
+    bool success = _httpClient->sendDiagnostics(DEVICE_ID, batteryVoltage, solarVoltage, internalTemp, signalQuality, uptime,
+                                                vaneDivergence, &windJitter);
 
 #ifdef DISABLE_WDT_FOR_MODEM
     Logger.debug(LOG_TAG_DIAG, "Re-enabling watchdog after diagnostics");
@@ -141,7 +171,7 @@ bool DiagnosticsManager::sendDiagnosticsInternal(float internalTemp, float exter
 
     if (success)
     {
-        Logger.info(LOG_TAG_DIAG, "Diagnostics data sent successfully");
+        Logger.info(LOG_TAG_DIAG, "Diagnostics data %s", _httpClient->describeLastSend());
     }
     else
     {
@@ -0,0 +1,102 @@
+/**
+ * @file EpochClock.h
+ * @brief Wall clock derived from the modem's network time and millis()
+ *
+ * The station has no RTC of its own. Each successful network time query
+ * anchors the UTC epoch to a millis() value; the current time is then the
+ * anchor plus the elapsed milliseconds. Used to date records that are sent
+ * long after they were taken, possibly after a restart.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+class EpochClock
+{
+public:
+    // Earliest plausible time; a modem without network time reports its 1980 or 2004 default
+    static const uint32_t MIN_VALID_EPOCH = 1577836800; // 2020-01-01T00:00:00Z
+
+    // Length of formatIso() output including the NUL: 2025-01-01T12:00:00Z
+    static const size_t ISO_SIZE = 21;
+
+    /**
+     * @brief Anchor the clock to a network time reading
+     *
+     * @param year Full year, e.g. 2025
+     * @param timezoneHours Offset of the local time from UTC, as reported by the modem
+     * @param nowMs millis() when the time was read
+     * @return false if the time is implausible; the clock keeps its anchor
+     */
+    bool sync(int year, int month, int day, int hour, int minute, int second, float timezoneHours, uint32_t nowMs)
+    {
+        int64_t local = toEpoch(year, month, day, hour, minute, second);
+        int64_t utc = local - (int64_t)(timezoneHours * 3600.0f);
+        if (utc < MIN_VALID_EPOCH || utc > UINT32_MAX)
+        {
+            return false;
+        }
+        _anchorEpoch = (uint32_t)utc;
+        _anchorMs = nowMs;
+        return true;
+    }
+
+    bool isSynced() const { return _anchorEpoch != 0; }
+
+    /**
+     * @brief UTC seconds at nowMs, or 0 if the clock was never synced
+     */
+    uint32_t now(uint32_t nowMs) const
+    {
+        return _anchorEpoch ? _anchorEpoch + (nowMs - _anchorMs) / 1000 : 0;
+    }
+
+    /**
+     * @brief Seconds since 1970-01-01 of a UTC calendar time
+     */
+    static int64_t toEpoch(int year, int month, int day, int hour, int minute, int second)
+    {
+        // Days from civil, proleptic Gregorian calendar
+        int64_t y = year - (month <= 2 ? 1 : 0);
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        int64_t yearOfEra = y - era * 400;
+        int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        int64_t days = era * 146097 + dayOfEra - 719468;
+        return days * 86400 + hour * 3600 + minute * 60 + second;
+    }
+
+    /**
+     * @brief Write an epoch as an ISO 8601 UTC timestamp
+     *
+     * @return Characters written (excluding the NUL), 0 if the buffer is too small
+     */
+    static size_t formatIso(uint32_t epoch, char *buffer, size_t size)
+    {
+        // Civil from days
+        int64_t days = epoch / 86400;
+        uint32_t secondsOfDay = epoch % 86400;
+        days += 719468;
+        int64_t era = days / 146097;
+        int64_t dayOfEra = days - era * 146097;
+        int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+        int day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+        int month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+        int year = (int)(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+
+        int length = snprintf(buffer, size, "%04d-%02d-%02dT%02d:%02d:%02dZ", year, month, day,
+                              (int)(secondsOfDay / 3600), (int)(secondsOfDay / 60 % 60), (int)(secondsOfDay % 60));
+        return length > 0 && (size_t)length < size ? (size_t)length : 0;
+    }
+
+private:
+    uint32_t _anchorEpoch = 0;
+    uint32_t _anchorMs = 0;
+};
@@ -0,0 +1,385 @@
+/**
+ * @file HttpResponseParser.h
+ * @brief Incremental HTTP/1.1 response parser, fed byte by byte
+ *
+ * Takes the response as it arrives, in pieces of any size, so reading it
+ * never waits for more than the bytes already received. Keeps the status
+ * code, the Content-Length and whether the server will close the
+ * connection; an optional ResponseHeaderScanner picks out one more header.
+ * The body is counted, not stored.
+ *
+ * Interim 1xx responses are skipped. A Transfer-Encoding: chunked body is
+ * followed through its chunk sizes to the last chunk and the trailers. A
+ * body with neither ends when the server closes the connection
+ * (finishOnClose()).
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "ResponseHeaderScanner.h"
+
+class HttpResponseParser
+{
+public:
+    enum State
+    {
+        STATUS_LINE,
+        HEADERS,
+        BODY,
+        COMPLETE,
+        MALFORMED
+    };
+
+    HttpResponseParser() { reset(); }
+
+    /**
+     * @brief Start on a new response
+     *
+     * @param extraHeader Optional scanner for a header the caller wants, fed every header byte
+     */
+    void reset(ResponseHeaderScanner *extraHeader = nullptr)
+    {
+        _extraHeader = extraHeader;
+        _state = STATUS_LINE;
+        _statusCode = 0;
+        _statusField = 0;
+        _lineLength = 0;
+        _contentLength = -1;
+        _remaining = 0;
+        _received = 0;
+        _chunked = false;
+        _chunkState = CHUNK_SIZE;
+        _chunkSizeDigits = 0;
+        _lengthScanner = ResponseHeaderScanner("Content-Length", _lengthValue, sizeof(_lengthValue));
+        _connectionScanner = ResponseHeaderScanner("Connection", _connectionValue, sizeof(_connectionValue));
+        _encodingScanner = ResponseHeaderScanner("Transfer-Encoding", _encodingValue, sizeof(_encodingValue));
+    }
+
+    /**
+     * @brief Feed the next received byte
+     *
+     * @return The state after it; bytes fed once COMPLETE or MALFORMED are ignored
+     */
+    State feed(char c)
+    {
+        _received++;
+        switch (_state)
+        {
+        case STATUS_LINE:
+            _feedStatusLine(c);
+            break;
+
+        case HEADERS:
+            _feedHeader(c);
+            break;
+
+        case BODY:
+            if (_chunked)
+            {
+                _feedChunked(c);
+            }
+            else if (_contentLength >= 0 && --_remaining == 0)
+            {
+                _state = COMPLETE;
+            }
+            break;
+
+        case COMPLETE:
+        case MALFORMED:
+            break;
+        }
+        return _state;
+    }
+
+    /**
+     * @brief The server closed the connection
+     *
+     * @return true if that ends the response: a body without Content-Length
+     *         that is not chunked
+     */
+    bool finishOnClose()
+    {
+        if (_state == BODY && _contentLength < 0 && !_chunked)
+        {
+            _state = COMPLETE;
+        }
+        return _state == COMPLETE;
+    }
+
+    State state() const { return _state; }
+
+    bool isComplete() const { return _state == COMPLETE; }
+
+    /**
+     * @brief Status code, 0 until the status line was read
+     */
+    int statusCode() const { return _statusCode; }
+
+    /**
+     * @brief Content-Length of the body, -1 if the server sent none
+     */
+    long contentLength() const { return _contentLength; }
+
+    /**
+     * @brief Whether the body is sent with Transfer-Encoding: chunked
+     */
+    bool isChunked() const { return _chunked; }
+
+    /**
+     * @brief Whether any byte of a response was received
+     */
+    bool hasReceived() const { return _received > 0; }
+
+    /**
+     * @brief Whether the connection can carry another request after this response
+     */
+    bool isReusable() const
+    {
+        return _state == COMPLETE && (_contentLength >= 0 || _chunked) &&
+               strcasecmp(_connectionValue, "close") != 0;
+    }
+
+private:
+    enum ChunkState
+    {
+        CHUNK_SIZE,     // Hex size line, possibly with extensions
+        CHUNK_DATA,
+        CHUNK_DATA_END, // CRLF after the data
+        CHUNK_TRAILER   // Trailer lines after the last chunk, up to an empty one
+    };
+
+    State _state;
+    int _statusCode;
+    unsigned _statusField; // Spaces seen on the status line
+    size_t _lineLength;
+    long _contentLength;
+    long _remaining;
+    unsigned long _received;
+    bool _chunked;
+    ChunkState _chunkState;
+    unsigned _chunkSizeDigits; // Hex digits of the current size line, UINT_MAX once in an extension
+
+    ResponseHeaderScanner *_extraHeader;
+    char _lengthValue[12];
+    ResponseHeaderScanner _lengthScanner = ResponseHeaderScanner("Content-Length", _lengthValue, sizeof(_lengthValue));
+    char _connectionValue[12];
+    ResponseHeaderScanner _connectionScanner =
+        ResponseHeaderScanner("Connection", _connectionValue, sizeof(_connectionValue));
+    char _encodingValue[32];
+    ResponseHeaderScanner _encodingScanner =
+        ResponseHeaderScanner("Transfer-Encoding", _encodingValue, sizeof(_encodingValue));
+
+    /**
+     * @brief "HTTP/1.1 200 OK": the status code is the second field
+     */
+    void _feedStatusLine(char c)
+    {
+        if (c == '\n')
+        {
+            _state = _statusCode >= 100 && _statusCode <= 999 ? HEADERS : MALFORMED;
+            _lineLength = 0;
+            return;
+        }
+        if (c == '\r')
+        {
+            return;
+        }
+        if (_lineLength++ == 0 && c != 'H')
+        {
+            _state = MALFORMED;
+            return;
+        }
+
+        if (c == ' ')
+        {
+            _statusField++;
+        }
+        else if (_statusField == 1)
+        {
+            if (c < '0' || c > '9')
+            {
+                _state = MALFORMED;
+                return;
+            }
+            _statusCode = _statusCode * 10 + (c - '0');
+            if (_statusCode > 999)
+            {
+                _state = MALFORMED;
+            }
+        }
+    }
+
+    void _feedHeader(char c)
+    {
+        _lengthScanner.feed(c);
+        _connectionScanner.feed(c);
+        _encodingScanner.feed(c);
+        if (_extraHeader)
+        {
+            _extraHeader->feed(c);
+        }
+
+        if (c != '\n')
+        {
+            if (c != '\r')
+            {
+                _lineLength++;
+            }
+            return;
+        }
+        if (_lineLength > 0)
+        {
+            _lineLength = 0;
+            return;
+        }
+
+        // Empty line: end of the headers
+        if (_statusCode < 200)
+        {
+            // Interim response (100 Continue); the final one follows
+            ResponseHeaderScanner *extraHeader = _extraHeader;
+            unsigned long received = _received;
+            reset(extraHeader);
+            _received = received;
+            return;
+        }
+
+        if (_lengthScanner.found())
+        {
+            char *end = nullptr;
+            long length = strtol(_lengthValue, &end, 10);
+            if (end == _lengthValue || *end != '\0' || length < 0)
+            {
+                _state = MALFORMED;
+                return;
+            }
+            _contentLength = length;
+        }
+
+        // These responses never carry a body, whatever their headers say
+        if (_statusCode == 204 || _statusCode == 304)
+        {
+            _contentLength = 0;
+        }
+        else if (_encodingScanner.found())
+        {
+            // Chunked must be the last coding; any other framing is only ended by the close.
+            // Either way a Transfer-Encoding overrides the Content-Length.
+            _chunked = _endsWithChunked(_encodingValue);
+            _contentLength = -1;
+        }
+
+        _remaining = _chunked ? 0 : _contentLength;
+        _state = _contentLength == 0 ? COMPLETE : BODY;
+    }
+
+    static bool _endsWithChunked(const char *value)
+    {
+        size_t length = strlen(value);
+        return length >= 7 && strcasecmp(value + length - 7, "chunked") == 0 &&
+               (length == 7 || value[length - 8] == ' ' || value[length - 8] == ',');
+    }
+
+    static int _hexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    void _feedChunked(char c)
+    {
+        switch (_chunkState)
+        {
+        case CHUNK_SIZE:
+            if (c == '\n')
+            {
+                if (_chunkSizeDigits == 0)
+                {
+                    _state = MALFORMED;
+                }
+                else if (_remaining == 0)
+                {
+                    _chunkState = CHUNK_TRAILER;
+                    _lineLength = 0;
+                }
+                else
+                {
+                    _chunkState = CHUNK_DATA;
+                }
+                _chunkSizeDigits = 0;
+            }
+            else if (c == ';')
+            {
+                if (_chunkSizeDigits == 0)
+                {
+                    _state = MALFORMED;
+                }
+                _chunkSizeDigits = UINT_MAX; // The extension is skipped
+            }
+            else if (_chunkSizeDigits != UINT_MAX && c != '\r' && c != ' ' && c != '\t')
+            {
+                int digit = _hexDigit(c);
+                // 7 hex digits is 256 MB, far beyond any response the station reads
+                if (digit < 0 || _chunkSizeDigits >= 7)
+                {
+                    _state = MALFORMED;
+                    return;
+                }
+                _remaining = _remaining * 16 + digit;
+                _chunkSizeDigits++;
+            }
+            break;
+
+        case CHUNK_DATA:
+            if (--_remaining == 0)
+            {
+                _chunkState = CHUNK_DATA_END;
+            }
+            break;
+
+        case CHUNK_DATA_END:
+            if (c == '\n')
+            {
+                _chunkState = CHUNK_SIZE;
+            }
+            else if (c != '\r')
+            {
+                _state = MALFORMED;
+            }
+            break;
+
+        case CHUNK_TRAILER:
+            if (c == '\n')
+            {
+                if (_lineLength == 0)
+                {
+                    _state = COMPLETE;
+                }
+                _lineLength = 0;
+            }
+            else if (c != '\r')
+            {
+                _lineLength++;
+            }
+            break;
+        }
+    }
+};
@@ -0,0 +1,94 @@
+/**
+ * @file HttpTransportBenchmark.cpp
+ * @brief Socket against modem HTTP transport, per request
+ */
+
+#include "HttpTransportBenchmark.h"
+#include <esp_task_wdt.h>
+#include "AiolosHttpClient.h"
+#include "ModemManager.h"
+#include "JsonPayloads.h"
+#include "WindSampleBatch.h"
+#include "Logger.h"
+
+#define LOG_TAG_BENCH "BENCH"
+
+namespace
+{
+    // Too large for the loop's stack; static so the benchmark does not allocate
+    char batchJson[JsonPayloads::WIND_BATCH_MAX];
+
+    struct Payload
+    {
+        const char *name;
+        const char *json;
+        size_t length;
+    };
+
+    void measure(const char *path, const Payload &payload, AiolosHttpClient::Transport transport, uint8_t rounds)
+    {
+        httpClient.setTransport(transport);
+
+        uint8_t delivered = 0;
+        uint32_t totalMs = 0;
+        uint32_t totalTx = 0;
+        uint32_t totalRx = 0;
+        for (uint8_t i = 0; i < rounds; i++)
+        {
+            esp_task_wdt_reset();
+            uint32_t tx = modemManager.getUartTxBytes();
+            uint32_t rx = modemManager.getUartRxBytes();
+            unsigned long startMs = millis();
+
+            int statusCode = httpClient.postRaw(path, "application/json", (const uint8_t *)payload.json, payload.length);
+
+            totalMs += millis() - startMs;
+            totalTx += modemManager.getUartTxBytes() - tx;
+            totalRx += modemManager.getUartRxBytes() - rx;
+            if (statusCode >= 200 && statusCode < 300)
+            {
+                delivered++;
+            }
+        }
+
+        Logger.info(LOG_TAG_BENCH, "%-6s %-7s body %4u B: %u/%u ok, %lu ms, UART tx %lu B, rx %lu B per request",
+                    transport == AiolosHttpClient::TRANSPORT_MODEM ? "modem" : "socket", payload.name,
+                    (unsigned)payload.length, delivered, rounds, (unsigned long)(totalMs / rounds),
+                    (unsigned long)(totalTx / rounds), (unsigned long)(totalRx / rounds));
+    }
+}
+
+void runHttpTransportBenchmark(const char *stationId, uint8_t rounds)
+{
+    if (rounds == 0)
+    {
+        return;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/api/stations/%s/benchmark", stationId);
+
+    char reading[JsonPayloads::WIND_READING_MAX];
+    size_t readingLength = JsonPayloads::writeWindReading(reading, sizeof(reading), 7.25f, 243.5f);
+
+    // A full minute of livestream readings
+    WindSampleBatch batch;
+    uint32_t nowMs = millis();
+    for (uint8_t i = 0; i < WindSampleBatch::CAPACITY; i++)
+    {
+        batch.add(5.0f + (i % 7) * 0.75f, 200.0f + i, nowMs - (WindSampleBatch::CAPACITY - i) * 1000UL);
+    }
+    size_t batchLength = JsonPayloads::writeWindBatch(batchJson, sizeof(batchJson), batch, nowMs);
+
+    const Payload payloads[] = {{"reading", reading, readingLength}, {"batch", batchJson, batchLength}};
+    AiolosHttpClient::Transport selected = httpClient.getTransport();
+
+    Logger.info(LOG_TAG_BENCH, "HTTP transport benchmark, %u requests each", rounds);
+    for (const Payload &payload : payloads)
+    {
+        measure(path, payload, AiolosHttpClient::TRANSPORT_SOCKET, rounds);
+        measure(path, payload, AiolosHttpClient::TRANSPORT_MODEM, rounds);
+    }
+
+    httpClient.setTransport(selected);
+}
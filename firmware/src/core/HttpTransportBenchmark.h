@@ -0,0 +1,25 @@
+/**
+ * @file HttpTransportBenchmark.h
+ * @brief Compares the socket and modem HTTP transports on the live link
+ *
+ * Posts the same bodies, a single livestream reading and a full batch, to
+ * the server's benchmark endpoint over each transport and logs per request
+ * the wall time and the bytes that crossed the modem UART in each
+ * direction, AT commands and modem responses included. The endpoint stores
+ * nothing. Blocks for the whole run; started from the serial console.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Run the benchmark and log the results
+ *
+ * Leaves the selected transport as it found it. Needs the blocking send
+ * path, so a request in flight is waited for first.
+ *
+ * @param stationId Station identifier
+ * @param rounds Requests per transport and payload
+ */
+void runHttpTransportBenchmark(const char *stationId, uint8_t rounds);
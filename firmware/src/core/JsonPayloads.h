@@ -0,0 +1,468 @@
+/**
+ * @file JsonPayloads.h
+ * @brief Heap-free JSON serialization of the outbound payloads
+ *
+ * Every upload body is written straight into a fixed buffer owned by the
+ * HTTP client, instead of building a JsonDocument and serializing it into
+ * a growing String on each call. The send path then allocates nothing,
+ * which matters on a station that posts several times per minute for
+ * weeks: repeated short-lived allocations of varying size fragment the
+ * heap until a larger allocation fails.
+ *
+ * Each payload has a *_MAX constant with its worst-case size (including
+ * the terminating NUL), computed at compile time from its keys and the
+ * widest value each field can take. Floats are written with a fixed
+ * number of decimals and trailing zeros removed; non-finite or absurdly
+ * large values are written as null so their width stays bounded.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "EpochClock.h"
+#include "WindAggregateBatch.h"
+#include "WindSampleBatch.h"
+#include "../sensors/SampleJitterStats.h"
+#include "../sensors/WindSummary.h"
+
+namespace JsonPayloads
+{
+    // Widest text of a value
+    static constexpr size_t INT_CHARS = 11;  // -2147483648
+    static constexpr size_t UINT_CHARS = 10; // 4294967295
+    static constexpr size_t floatChars(size_t decimals) { return 1 + 9 + 1 + decimals; } // sign, |v| < 1e9
+
+    /**
+     * @brief Worst-case size of one "key":value member including its separator
+     */
+    template <size_t N>
+    static constexpr size_t member(const char (&)[N], size_t valueChars)
+    {
+        return 1 + (N - 1) + 2 + valueChars + 1; // "key": value ,
+    }
+
+    static constexpr size_t OBJECT_OVERHEAD = 2 + 1; // {} and the NUL
+
+    /**
+     * @brief Bounds checked JSON writer over a caller buffer
+     *
+     * Pass the key for object members and nullptr for array elements.
+     */
+    class Writer
+    {
+    public:
+        Writer(char *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity)
+        {
+            if (_capacity > 0)
+            {
+                _buffer[0] = '\0';
+            }
+        }
+
+        void beginObject(const char *key = nullptr) { open(key, '{'); }
+        void endObject() { close('}'); }
+        void beginArray(const char *key = nullptr) { open(key, '['); }
+        void endArray() { close(']'); }
+
+        void addFloat(const char *key, float value, uint8_t decimals)
+        {
+            prefix(key);
+            if (!isfinite(value) || fabsf(value) >= 1e9f)
+            {
+                append("null", 4);
+                return;
+            }
+
+            char text[24];
+            int length = snprintf(text, sizeof(text), "%.*f", decimals, (double)value);
+            if (length <= 0)
+            {
+                _overflow = true;
+                return;
+            }
+            if (decimals > 0)
+            {
+                // 12.50 -> 12.5, 225.0 -> 225
+                while (text[length - 1] == '0')
+                {
+                    length--;
+                }
+                if (text[length - 1] == '.')
+                {
+                    length--;
+                }
+            }
+            append(text, (size_t)length);
+        }
+
+        void addInt(const char *key, int32_t value)
+        {
+            prefix(key);
+            char text[16];
+            int length = snprintf(text, sizeof(text), "%ld", (long)value);
+            append(text, length > 0 ? (size_t)length : 0);
+        }
+
+        void addUInt(const char *key, uint32_t value)
+        {
+            prefix(key);
+            char text[16];
+            int length = snprintf(text, sizeof(text), "%lu", (unsigned long)value);
+            append(text, length > 0 ? (size_t)length : 0);
+        }
+
+        /**
+         * @brief Add an already serialized JSON value
+         */
+        void addRaw(const char *key, const char *json)
+        {
+            prefix(key);
+            append(json, strlen(json));
+        }
+
+        /**
+         * @brief Length of the NUL terminated document, or 0 if it did not fit
+         */
+        size_t finish() const { return _overflow || _depth != 0 ? 0 : _size; }
+
+    private:
+        char *_buffer;
+        size_t _capacity;
+        size_t _size = 0;
+        uint8_t _depth = 0;
+        bool _needComma = false;
+        bool _overflow = false;
+
+        void append(const char *text, size_t length)
+        {
+            // Keep room for the NUL
+            if (_overflow || _size + length + 1 > _capacity)
+            {
+                _overflow = true;
+                return;
+            }
+            memcpy(_buffer + _size, text, length);
+            _size += length;
+            _buffer[_size] = '\0';
+        }
+
+        void prefix(const char *key)
+        {
+            if (_needComma)
+            {
+                append(",", 1);
+            }
+            if (key)
+            {
+                append("\"", 1);
+                append(key, strlen(key));
+                append("\":", 2);
+            }
+            _needComma = true;
+        }
+
+        void open(const char *key, char bracket)
+        {
+            prefix(key);
+            append(&bracket, 1);
+            _depth++;
+            _needComma = false;
+        }
+
+        void close(char bracket)
+        {
+            append(&bracket, 1);
+            _depth--;
+            _needComma = true;
+        }
+    };
+
+    // --- Temperature ---------------------------------------------------------
+
+    static constexpr size_t TEMPERATURE_MAX = OBJECT_OVERHEAD + member("temperature", floatChars(2));
+
+    inline size_t writeTemperature(char *buffer, size_t capacity, float temperature)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        out.addFloat("temperature", temperature, 2);
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Livestream wind reading ---------------------------------------------
+
+    static constexpr size_t WIND_READING_MAX =
+        OBJECT_OVERHEAD + member("windSpeed", floatChars(2)) + member("windDirection", floatChars(1));
+
+    inline size_t writeWindReading(char *buffer, size_t capacity, float speed, float direction)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        out.addFloat("windSpeed", speed, 2);
+        out.addFloat("windDirection", direction, 1);
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Averaged wind period ------------------------------------------------
+
+    static constexpr size_t WIND_ROSE_CELL_MAX = 2 + 1 + 1 + 5 + 2 + 1; // [s,b,count] and a comma
+    static constexpr size_t WIND_SUMMARY_MAX =
+        OBJECT_OVERHEAD + member("windSpeed", floatChars(2)) + member("windDirection", floatChars(1)) +
+        member("windGust", floatChars(2)) + member("windLull", floatChars(2)) +
+        member("windSpeedStdDev", floatChars(2)) + member("windDirectionStdDev", floatChars(1)) +
+        member("windResultantSpeed", floatChars(2)) + member("windResultantDirection", floatChars(1)) +
+        member("windPersistence", floatChars(4)) +
+        member("windRose", 2 + WindRoseHistogram::SECTORS * WindRoseHistogram::SPEED_BINS * WIND_ROSE_CELL_MAX);
+
+    /**
+     * @brief Averaged period; the wind rose as [sector, speedBin, count] triples of the non-zero cells
+     */
+    inline size_t writeWindSummary(char *buffer, size_t capacity, const WindSummary &summary)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        out.addFloat("windSpeed", summary.avgSpeed, 2);
+        out.addFloat("windDirection", summary.avgDirection, 1);
+        out.addFloat("windGust", summary.gust, 2);
+        out.addFloat("windLull", summary.lull, 2);
+        out.addFloat("windSpeedStdDev", summary.speedStdDev, 2);
+        out.addFloat("windDirectionStdDev", summary.directionStdDev, 1);
+        out.addFloat("windResultantSpeed", summary.resultantSpeed, 2);
+        out.addFloat("windResultantDirection", summary.resultantDirection, 1);
+        out.addFloat("windPersistence", summary.persistence, 4);
+
+        out.beginArray("windRose");
+        for (uint8_t sector = 0; sector < WindRoseHistogram::SECTORS; sector++)
+        {
+            for (uint8_t bin = 0; bin < WindRoseHistogram::SPEED_BINS; bin++)
+            {
+                uint16_t count = summary.windRose.count(sector, bin);
+                if (count == 0)
+                {
+                    continue;
+                }
+                out.beginArray();
+                out.addUInt(nullptr, sector);
+                out.addUInt(nullptr, bin);
+                out.addUInt(nullptr, count);
+                out.endArray();
+            }
+        }
+        out.endArray();
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Batched livestream readings -----------------------------------------
+
+    static constexpr size_t WIND_SAMPLE_MAX = 2 + member("windSpeed", floatChars(2)) +
+                                              member("windDirection", floatChars(1)) + member("ageMs", UINT_CHARS) +
+                                              1; // {} and a comma
+    static constexpr size_t WIND_BATCH_MAX =
+        OBJECT_OVERHEAD + member("samples", 2 + WindSampleBatch::CAPACITY * WIND_SAMPLE_MAX);
+
+    /**
+     * @brief Buffered readings with their age at nowMs
+     */
+    inline size_t writeWindBatch(char *buffer, size_t capacity, const WindSampleBatch &batch, uint32_t nowMs)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        out.beginArray("samples");
+        for (uint8_t i = 0; i < batch.size(); i++)
+        {
+            const WindSample &sample = batch.at(i);
+            out.beginObject();
+            out.addFloat("windSpeed", sample.speed, 2);
+            out.addFloat("windDirection", sample.direction, 1);
+            out.addUInt("ageMs", nowMs - sample.takenAtMs);
+            out.endObject();
+        }
+        out.endArray();
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Station wind aggregates ----------------------------------------------
+
+    static constexpr size_t WIND_AGGREGATE_MAX =
+        2 + member("level", UINT_CHARS) + member("windSpeed", floatChars(2)) + member("windDirection", floatChars(1)) +
+        member("windGust", floatChars(2)) + member("windLull", floatChars(2)) + member("sampleCount", UINT_CHARS) +
+        member("durationMs", UINT_CHARS) + member("ageMs", UINT_CHARS) + 1; // {} and a comma
+    static constexpr size_t WIND_AGGREGATES_MAX =
+        OBJECT_OVERHEAD + member("aggregates", 2 + WindAggregateBatch::CAPACITY * WIND_AGGREGATE_MAX);
+
+    /**
+     * @brief Completed 1 min and 10 min buckets; level is in minutes, ageMs is the time since the bucket closed
+     */
+    inline size_t writeWindAggregates(char *buffer, size_t capacity, const WindAggregateBatch &batch, uint32_t nowMs)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        out.beginArray("aggregates");
+        for (uint8_t i = 0; i < batch.size(); i++)
+        {
+            const WindAggregateEntry &entry = batch.at(i);
+            out.beginObject();
+            out.addUInt("level", entry.levelMinutes);
+            out.addFloat("windSpeed", entry.aggregate.avgSpeed, 2);
+            out.addFloat("windDirection", entry.aggregate.avgDirection, 1);
+            out.addFloat("windGust", entry.aggregate.gust, 2);
+            out.addFloat("windLull", entry.aggregate.lull, 2);
+            out.addUInt("sampleCount", entry.aggregate.count);
+            out.addUInt("durationMs", entry.aggregate.durationMs);
+            out.addUInt("ageMs", nowMs - entry.aggregate.endMs);
+            out.endObject();
+        }
+        out.endArray();
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Diagnostics ---------------------------------------------------------
+
+    struct Diagnostics
+    {
+        float batteryVoltage = 0.0f;
+        float solarVoltage = 0.0f;
+        float internalTemperature = 0.0f;
+        int32_t signalQuality = 0;
+        uint32_t uptime = 0;
+        float vaneDivergence = -1.0f;                      // Omitted if negative
+        const SampleJitterSnapshot *windJitter = nullptr; // Omitted if null or empty
+        bool connectionReuse = false;                      // Whether to send the reuse counters
+        uint32_t reuseHits = 0;
+        uint32_t reuseMisses = 0;
+        bool offlineQueue = false; // Whether to send the offline queue metrics
+        uint32_t queueDepth = 0;
+        uint32_t queueFill = 0; // Percent of the flash budget
+        uint32_t queueDrained = 0;
+        uint32_t queueDropped = 0;
+    };
+
+    static constexpr size_t DIAGNOSTICS_MAX =
+        OBJECT_OVERHEAD + member("batteryVoltage", floatChars(3)) + member("solarVoltage", floatChars(3)) +
+        member("internalTemperature", floatChars(2)) + member("signalQuality", INT_CHARS) +
+        member("uptime", UINT_CHARS) + member("vaneDivergence", floatChars(1)) +
+        member("windJitterAvgUs", UINT_CHARS) + member("windJitterMaxUs", UINT_CHARS) +
+        member("windTickOverruns", UINT_CHARS) + member("httpReuseHits", UINT_CHARS) +
+        member("httpReuseMisses", UINT_CHARS) + member("queueDepth", UINT_CHARS) + member("queueFill", UINT_CHARS) +
+        member("queueDrained", UINT_CHARS) + member("queueDropped", UINT_CHARS);
+
+    inline size_t writeDiagnostics(char *buffer, size_t capacity, const Diagnostics &diagnostics)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        out.addFloat("batteryVoltage", diagnostics.batteryVoltage, 3);
+        out.addFloat("solarVoltage", diagnostics.solarVoltage, 3);
+        out.addFloat("internalTemperature", diagnostics.internalTemperature, 2);
+        out.addInt("signalQuality", diagnostics.signalQuality);
+        out.addUInt("uptime", diagnostics.uptime);
+        if (diagnostics.vaneDivergence >= 0.0f)
+        {
+            out.addFloat("vaneDivergence", diagnostics.vaneDivergence, 1);
+        }
+        if (diagnostics.windJitter && diagnostics.windJitter->ticks > 0)
+        {
+            out.addUInt("windJitterAvgUs", diagnostics.windJitter->avgUs);
+            out.addUInt("windJitterMaxUs", diagnostics.windJitter->maxUs);
+            out.addUInt("windTickOverruns", diagnostics.windJitter->overruns);
+        }
+        if (diagnostics.connectionReuse)
+        {
+            // Cumulative since boot
+            out.addUInt("httpReuseHits", diagnostics.reuseHits);
+            out.addUInt("httpReuseMisses", diagnostics.reuseMisses);
+        }
+        if (diagnostics.offlineQueue)
+        {
+            // Pending records and fill level now, drained and dropped records since boot
+            out.addUInt("queueDepth", diagnostics.queueDepth);
+            out.addUInt("queueFill", diagnostics.queueFill);
+            out.addUInt("queueDrained", diagnostics.queueDrained);
+            out.addUInt("queueDropped", diagnostics.queueDropped);
+        }
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Composite frame -----------------------------------------------------
+
+    static constexpr size_t FRAME_MAX = OBJECT_OVERHEAD + member("wind", WIND_SUMMARY_MAX - 1) +
+                                        member("temperature", TEMPERATURE_MAX - 1) +
+                                        member("diagnostics", DIAGNOSTICS_MAX - 1);
+
+    /**
+     * @brief Readings due together, each part the body its own endpoint takes
+     *
+     * @param wind Averaged wind period (writeWindSummary), nullptr if absent
+     * @param temperature writeTemperature output, nullptr if absent
+     * @param diagnostics writeDiagnostics output, nullptr if absent
+     */
+    inline size_t writeFrame(char *buffer, size_t capacity, const char *wind, const char *temperature,
+                             const char *diagnostics)
+    {
+        Writer out(buffer, capacity);
+        out.beginObject();
+        if (wind)
+        {
+            out.addRaw("wind", wind);
+        }
+        if (temperature)
+        {
+            out.addRaw("temperature", temperature);
+        }
+        if (diagnostics)
+        {
+            out.addRaw("diagnostics", diagnostics);
+        }
+        out.endObject();
+        return out.finish();
+    }
+
+    // --- Replay timestamp ----------------------------------------------------
+
+    // "timestamp":"2025-01-01T12:00:00Z" and its comma
+    static constexpr size_t TIMESTAMP_MEMBER_MAX = member("timestamp", 2 + EpochClock::ISO_SIZE - 1);
+
+    /**
+     * @brief Add a "timestamp" member to a finished top-level object
+     *
+     * Used when a queued body is sent after the fact: the endpoints take the
+     * time the data was taken from it instead of the arrival time.
+     *
+     * @param length Length of the document in buffer
+     * @return New length, or 0 if it does not fit or the text is not an object
+     */
+    inline size_t appendTimestamp(char *buffer, size_t length, size_t capacity, uint32_t epoch)
+    {
+        if (length < 2 || buffer[0] != '{' || buffer[length - 1] != '}')
+        {
+            return 0;
+        }
+
+        char iso[EpochClock::ISO_SIZE];
+        if (EpochClock::formatIso(epoch, iso, sizeof(iso)) == 0)
+        {
+            return 0;
+        }
+
+        const char *separator = buffer[length - 2] == '{' ? "" : ",";
+        int written = snprintf(buffer + length - 1, capacity - (length - 1), "%s\"timestamp\":\"%s\"}", separator, iso);
+        if (written <= 0 || (size_t)written >= capacity - (length - 1))
+        {
+            buffer[length - 1] = '}'; // Leave the document as it was
+            buffer[length] = '\0';
+            return 0;
+        }
+        return length - 1 + (size_t)written;
+    }
+}
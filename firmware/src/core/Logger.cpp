@@ -191,11 +191,17 @@ void LoggerClass::setRealTime(int hour, int minute, int second)
 
 void LoggerClass::_storeLog(const char *message)
 {
+    // The wind sampling task logs too; keep the buffer consistent
+    static portMUX_TYPE storeMux = portMUX_INITIALIZER_UNLOCKED;
+    portENTER_CRITICAL(&storeMux);
+
     // Store in circular buffer
     strncpy(_recentLogs[_logIndex], message, sizeof(_recentLogs[0]) - 1);
     _recentLogs[_logIndex][sizeof(_recentLogs[0]) - 1] = '\0';
 
     _logIndex = (_logIndex + 1) % MAX_RECENT_LOGS;
+
+    portEXIT_CRITICAL(&storeMux);
 }
 
 bool LoggerClass::getRecentLogsJson(char *buffer, size_t size)
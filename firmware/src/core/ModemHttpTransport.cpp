@@ -0,0 +1,193 @@
+/**
+ * @file ModemHttpTransport.cpp
+ * @brief AT+SH command sequence of the modem's HTTP client
+ */
+
+#include "ModemHttpTransport.h"
+#include <ArduinoHttpClient.h>
+#include "Logger.h"
+#include "../config/Config.h"
+
+#define LOG_TAG_HTTP "HTTP"
+
+// The modem reports its own failures (DNS, network, timeout) as 6xx and 7xx status codes
+static const int MODEM_HTTP_ERROR_MIN = 600;
+
+void ModemHttpTransport::begin(TinyGsm &modem, const char *host, uint16_t port)
+{
+    _modem = &modem;
+    _host = host;
+    _port = port;
+}
+
+bool ModemHttpTransport::fits(size_t length)
+{
+    return length <= MODEM_HTTP_BODY_MAX;
+}
+
+int ModemHttpTransport::post(const char *path, const char *contentType, const uint8_t *body, size_t length)
+{
+    if (!_modem)
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+
+    if (_connected && millis() - _lastRequestEndMs >= HTTP_KEEP_ALIVE_IDLE_MS)
+    {
+        Logger.debug(LOG_TAG_HTTP, "Closing modem connection idle for %lu ms", millis() - _lastRequestEndMs);
+        disconnect();
+    }
+
+    bool reused = _connected;
+    int statusCode = _request(path, contentType, body, length);
+    if (statusCode < 0 && reused)
+    {
+        // The server may have closed the connection the modem still holds
+        Logger.debug(LOG_TAG_HTTP, "Modem request on reused connection failed, reconnecting");
+        disconnect();
+        statusCode = _request(path, contentType, body, length);
+    }
+    if (statusCode < 0)
+    {
+        disconnect();
+    }
+    _lastRequestEndMs = millis();
+    return statusCode;
+}
+
+void ModemHttpTransport::disconnect()
+{
+    if (!_modem || !_connected)
+    {
+        return;
+    }
+    _modem->sendAT(GF("+SHDISC"));
+    _modem->waitResponse();
+    _connected = false;
+    _contentType[0] = '\0';
+}
+
+/**
+ * @brief Configures the server and opens the modem's connection to it.
+ */
+bool ModemHttpTransport::_connect()
+{
+    _modem->sendAT(GF("+SHCONF=\"URL\",\"http://"), _host, ':', _port, '"');
+    if (_modem->waitResponse() != 1)
+    {
+        return false;
+    }
+    _modem->sendAT(GF("+SHCONF=\"BODYLEN\","), MODEM_HTTP_BODY_MAX);
+    if (_modem->waitResponse() != 1)
+    {
+        return false;
+    }
+    _modem->sendAT(GF("+SHCONF=\"HEADERLEN\","), MODEM_HTTP_HEADER_MAX);
+    if (_modem->waitResponse() != 1)
+    {
+        return false;
+    }
+
+    _modem->sendAT(GF("+SHCONN"));
+    if (_modem->waitResponse(MODEM_HTTP_CONNECT_TIMEOUT_MS) != 1)
+    {
+        Logger.error(LOG_TAG_HTTP, "Modem HTTP connect to %s:%u failed", _host, _port);
+        return false;
+    }
+    _connected = true;
+    return true;
+}
+
+/**
+ * @brief Sets the request headers, once per connection and content type.
+ */
+bool ModemHttpTransport::_setContentType(const char *contentType)
+{
+    if (strcmp(_contentType, contentType) == 0)
+    {
+        return true;
+    }
+
+    _modem->sendAT(GF("+SHCHEAD"));
+    if (_modem->waitResponse() != 1)
+    {
+        return false;
+    }
+    _modem->sendAT(GF("+SHAHEAD=\"Content-Type\",\""), contentType, '"');
+    if (_modem->waitResponse() != 1)
+    {
+        return false;
+    }
+    _modem->sendAT(GF("+SHAHEAD=\"Connection\",\"keep-alive\""));
+    if (_modem->waitResponse() != 1)
+    {
+        return false;
+    }
+    strlcpy(_contentType, contentType, sizeof(_contentType));
+    return true;
+}
+
+/**
+ * @brief One attempt: connect if needed, headers, body, request.
+ */
+int ModemHttpTransport::_request(const char *path, const char *contentType, const uint8_t *body, size_t length)
+{
+    if (!_connected && !_connect())
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+    if (!_setContentType(contentType))
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+
+    // The modem prompts with '>' and takes exactly length bytes
+    _modem->sendAT(GF("+SHBOD="), length, ',', MODEM_HTTP_BODY_TIMEOUT_MS);
+    if (_modem->waitResponse(MODEM_HTTP_BODY_TIMEOUT_MS, GF(">")) != 1)
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+    _modem->stream.write(body, length);
+    _modem->stream.flush();
+    if (_modem->waitResponse(MODEM_HTTP_BODY_TIMEOUT_MS) != 1)
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+
+    // 3: POST
+    _modem->sendAT(GF("+SHREQ=\""), path, GF("\",3"));
+    if (_modem->waitResponse() != 1)
+    {
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+    return _readStatus();
+}
+
+/**
+ * @brief Waits for the result of AT+SHREQ: +SHREQ: "POST",<status>,<body length>
+ */
+int ModemHttpTransport::_readStatus()
+{
+    if (_modem->waitResponse(MODEM_HTTP_RESPONSE_TIMEOUT_MS, GF("+SHREQ:")) != 1)
+    {
+        return HTTP_ERROR_TIMED_OUT;
+    }
+
+    char line[32];
+    size_t count = _modem->stream.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[count] = '\0';
+
+    const char *field = strchr(line, ',');
+    char *end = nullptr;
+    long statusCode = field ? strtol(field + 1, &end, 10) : 0;
+    if (!field || end == field + 1 || statusCode < 100)
+    {
+        return HTTP_ERROR_INVALID_RESPONSE;
+    }
+    if (statusCode >= MODEM_HTTP_ERROR_MIN)
+    {
+        Logger.error(LOG_TAG_HTTP, "Modem HTTP request failed, modem status: %ld", statusCode);
+        return HTTP_ERROR_CONNECTION_FAILED;
+    }
+    return (int)statusCode;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ModemHttpTransport.h
+ * @brief HTTP POST through the SIM7000's own HTTP client (AT+SH commands)
+ *
+ * The socket path frames every request on the ESP32 and pushes the request
+ * head and the whole response, headers included, through AT+CIPSEND and
+ * AT+CIPRXGET over the 115200 baud UART. Here the modem does the framing:
+ * AT+SHCONN opens the connection and keeps it on the modem side, the
+ * headers are configured once per connection (AT+SHAHEAD), and each request
+ * is only the body (AT+SHBOD) and AT+SHREQ. The modem answers with the
+ * status code and body length; the body is never read (AT+SHREAD), so a
+ * response costs one short line on the UART.
+ *
+ * The response headers stay on the modem, so this path gets no
+ * X-Config-Version hint. Bodies longer than MODEM_HTTP_BODY_MAX do not fit
+ * the modem's buffer. The data bearer (AT+CNACT) is the one TinyGSM's
+ * gprsConnect() activates.
+ */
+
+#define TINY_GSM_MODEM_SIM7000
+
+#pragma once
+
+#include <Arduino.h>
+#include <TinyGsmClient.h>
+
+class ModemHttpTransport
+{
+public:
+    /**
+     * @brief Set the modem and the server the requests go to
+     */
+    void begin(TinyGsm &modem, const char *host, uint16_t port);
+
+    /**
+     * @brief Send a POST and wait for its status code
+     *
+     * Connects if needed and reuses the modem's connection otherwise. A
+     * connection idle for HTTP_KEEP_ALIVE_IDLE_MS is opened anew first, and
+     * a request that fails on a reused connection is sent once more on a
+     * new one.
+     *
+     * @return The status code, or a negative HTTP_ERROR_* code
+     */
+    int post(const char *path, const char *contentType, const uint8_t *body, size_t length);
+
+    /**
+     * @brief Close the modem's connection (AT+SHDISC)
+     */
+    void disconnect();
+
+    bool isConnected() const { return _connected; }
+
+    /**
+     * @brief Whether a body of this length fits the modem's buffer
+     */
+    static bool fits(size_t length);
+
+private:
+    TinyGsm *_modem = nullptr;
+    const char *_host = nullptr;
+    uint16_t _port = 0;
+
+    bool _connected = false;
+    unsigned long _lastRequestEndMs = 0;
+    char _contentType[48] = ""; // Content-Type configured on the connection
+
+    bool _connect();
+    bool _setContentType(const char *contentType);
+    int _request(const char *path, const char *contentType, const uint8_t *body, size_t length);
+    int _readStatus();
+};
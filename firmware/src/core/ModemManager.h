@@ -26,6 +26,7 @@
 #define TINY_GSM_ENABLE_GSM_LOCATION true
 
 #include <TinyGsmClient.h>
+#include "CountingStream.h"
 
 // Define SerialAT - this should be consistent with LilyGO examples
 #define SerialAT Serial1
@@ -179,6 +180,16 @@ public:
      */
     TinyGsmClient *getClient() { return &_client; }
 
+    /**
+     * @brief Bytes written to the modem UART since boot, AT commands included
+     */
+    uint32_t getUartTxBytes() const { return _uart.getTxBytes(); }
+
+    /**
+     * @brief Bytes read from the modem UART since boot
+     */
+    uint32_t getUartRxBytes() const { return _uart.getRxBytes(); }
+
     /**
      * @brief Send an AT command to the modem
      *
@@ -229,7 +240,8 @@ public:
     String getLocalIP();
 
 private:
-    TinyGsm _modem = TinyGsm(SerialAT);
+    CountingStream _uart = CountingStream(SerialAT); // Declared first: the modem is built on it
+    TinyGsm _modem = TinyGsm(_uart);
     TinyGsmClient _client = TinyGsmClient(_modem);
     bool _initialized = false;
     unsigned long _lastReconnectAttempt = 0;
@@ -0,0 +1,165 @@
+/**
+ * @file OutboundScheduler.h
+ * @brief Orders the station's outbound requests by class and deadline
+ *
+ * Each kind of network work (live wind, config fetch, frame, temperature,
+ * diagnostics, station wind aggregates, offline replay) is a class with at most one pending request.
+ * Requesting a class that is already pending coalesces with it: the request
+ * keeps its original time and, when dispatched, sends the newest data. Only
+ * the latest diagnostics or temperature matter, and waiting wind readings
+ * are sent together as a batch.
+ *
+ * Dispatch is earliest deadline first, each class having a maximum wait
+ * (OUTBOUND_DEADLINE_*_MS). Short deadlines put time-critical data first
+ * while lower classes still get their turn once they have waited long
+ * enough. Queue latency (request to dispatch) is tracked per class.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class OutboundScheduler
+{
+public:
+    // In priority order: on equal deadlines the lower value goes first
+    enum Class : uint8_t
+    {
+        WIND = 0,    // Livestream readings, batches and averaged periods
+        CONFIG,      // Remote configuration fetch
+        FRAME,       // Composite frame (averaged wind, temperature, diagnostics)
+        TEMPERATURE,
+        DIAGNOSTICS,
+        AGGREGATES,  // Completed 1 min and 10 min wind buckets
+        REPLAY,      // Offline queue drain
+        CLASS_COUNT
+    };
+
+    struct ClassStats
+    {
+        uint32_t dispatched = 0;
+        uint32_t failed = 0;    // Dispatched but not delivered
+        uint32_t coalesced = 0; // Requests merged into a pending one
+        uint32_t totalLatencyMs = 0;
+        uint32_t maxLatencyMs = 0;
+
+        uint32_t avgLatencyMs() const { return dispatched ? totalLatencyMs / dispatched : 0; }
+    };
+
+    /**
+     * @brief Longest a request of this class should wait before it is dispatched
+     */
+    void setDeadline(Class cls, uint32_t maxWaitMs) { _maxWaitMs[cls] = maxWaitMs; }
+
+    /**
+     * @brief Mark a class as having data to send
+     *
+     * @return false if it was already pending and the request was coalesced
+     */
+    bool request(Class cls, uint32_t nowMs)
+    {
+        if (_pending[cls])
+        {
+            _stats[cls].coalesced++;
+            return false;
+        }
+        _pending[cls] = true;
+        _requestedMs[cls] = nowMs;
+        return true;
+    }
+
+    bool isPending(Class cls) const { return _pending[cls]; }
+
+    bool hasPending() const
+    {
+        for (uint8_t i = 0; i < CLASS_COUNT; i++)
+        {
+            if (_pending[i])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief The pending class with the earliest deadline
+     *
+     * @return false if nothing is pending
+     */
+    bool next(Class &cls) const
+    {
+        bool found = false;
+        uint32_t earliest = 0;
+        for (uint8_t i = 0; i < CLASS_COUNT; i++)
+        {
+            if (!_pending[i])
+            {
+                continue;
+            }
+            uint32_t deadline = _requestedMs[i] + _maxWaitMs[i];
+            // Signed difference so the comparison survives millis() wrapping
+            if (!found || (int32_t)(deadline - earliest) < 0)
+            {
+                found = true;
+                earliest = deadline;
+                cls = (Class)i;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * @brief Take a pending class for dispatch and record its queue latency
+     *
+     * The class can be requested again while its send is in flight.
+     */
+    void dispatch(Class cls, uint32_t nowMs)
+    {
+        if (!_pending[cls])
+        {
+            return;
+        }
+        _pending[cls] = false;
+
+        uint32_t latency = nowMs - _requestedMs[cls];
+        ClassStats &stats = _stats[cls];
+        stats.dispatched++;
+        stats.totalLatencyMs += latency;
+        if (latency > stats.maxLatencyMs)
+        {
+            stats.maxLatencyMs = latency;
+        }
+    }
+
+    /**
+     * @brief Record the outcome of a dispatched send
+     *
+     * @param delivered Whether the server accepted it; undelivered data is
+     *                  left to the offline queue, not requested again
+     */
+    void complete(Class cls, bool delivered)
+    {
+        if (!delivered)
+        {
+            _stats[cls].failed++;
+        }
+    }
+
+    const ClassStats &getStats(Class cls) const { return _stats[cls]; }
+
+    static const char *name(Class cls)
+    {
+        static const char *const NAMES[CLASS_COUNT] = {"wind", "config", "frame", "temperature", "diagnostics",
+                                                       "aggregates", "replay"};
+        return cls < CLASS_COUNT ? NAMES[cls] : "?";
+    }
+
+private:
+    bool _pending[CLASS_COUNT] = {};
+    uint32_t _requestedMs[CLASS_COUNT] = {};
+    uint32_t _maxWaitMs[CLASS_COUNT] = {};
+    ClassStats _stats[CLASS_COUNT];
+};
@@ -0,0 +1,143 @@
+/**
+ * @file ResponseHeaderScanner.h
+ * @brief Picks one header value out of an HTTP response, byte by byte
+ *
+ * Fed the response header bytes as they are read, it matches the start of
+ * each line against one header name (case-insensitive) and copies the value
+ * of a matching line into a caller buffer. Other lines are skipped as they
+ * stream past, so nothing is buffered and no String is built per header,
+ * unlike HttpClient::readHeaderName()/readHeaderValue().
+ *
+ * The first matching header wins. A value that does not fit the buffer is
+ * dropped rather than truncated.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <ctype.h>
+#include <stddef.h>
+
+class ResponseHeaderScanner
+{
+public:
+    /**
+     * @param name Header name without the colon
+     * @param value Receives the NUL terminated value of a matching header
+     * @param valueSize Size of the value buffer
+     */
+    ResponseHeaderScanner(const char *name, char *value, size_t valueSize)
+        : _name(name), _value(value), _valueSize(valueSize)
+    {
+        if (_valueSize > 0)
+        {
+            _value[0] = '\0';
+        }
+    }
+
+    /**
+     * @brief Feed the next byte of the response headers
+     *
+     * Start with the first byte after the status line.
+     */
+    void feed(char c)
+    {
+        switch (_state)
+        {
+        case MATCHING_NAME:
+            if (_name[_matched] == '\0' && c == ':' && !_found)
+            {
+                _state = SKIPPING_SPACE;
+                _length = 0;
+                _overflow = false;
+            }
+            else if (_name[_matched] != '\0' && tolower((unsigned char)c) == tolower((unsigned char)_name[_matched]))
+            {
+                _matched++;
+            }
+            else
+            {
+                skipLine(c);
+            }
+            break;
+
+        case SKIPPING_SPACE:
+            if (c == ' ' || c == '\t')
+            {
+                break;
+            }
+            _state = READING_VALUE;
+            // Fall through with the first value byte
+            [[fallthrough]];
+
+        case READING_VALUE:
+            if (c == '\r' || c == '\n')
+            {
+                while (_length > 0 && (_value[_length - 1] == ' ' || _value[_length - 1] == '\t'))
+                {
+                    _length--;
+                }
+                if (!_overflow)
+                {
+                    _value[_length] = '\0';
+                    _found = true;
+                }
+                else
+                {
+                    _value[0] = '\0';
+                }
+                skipLine(c);
+            }
+            else if (_length + 1 < _valueSize)
+            {
+                _value[_length++] = c;
+            }
+            else
+            {
+                _overflow = true;
+            }
+            break;
+
+        case SKIPPING_LINE:
+            skipLine(c);
+            break;
+        }
+    }
+
+    /**
+     * @brief Whether the header was seen with a value that fit the buffer
+     */
+    bool found() const { return _found; }
+
+private:
+    enum State
+    {
+        MATCHING_NAME,
+        SKIPPING_SPACE,
+        READING_VALUE,
+        SKIPPING_LINE
+    };
+
+    const char *_name;
+    char *_value;
+    size_t _valueSize;
+    State _state = MATCHING_NAME;
+    size_t _matched = 0;
+    size_t _length = 0;
+    bool _overflow = false;
+    bool _found = false;
+
+    void skipLine(char c)
+    {
+        if (c == '\n')
+        {
+            _state = MATCHING_NAME;
+            _matched = 0;
+        }
+        else
+        {
+            _state = SKIPPING_LINE;
+        }
+    }
+};
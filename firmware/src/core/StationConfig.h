@@ -0,0 +1,42 @@
+/**
+ * @file StationConfig.h
+ * @brief Remote station configuration as received from the server
+ *
+ * Fixed-size result of fetchConfiguration(). A field the server did not
+ * send keeps its "not received" value (0 for intervals and sizes, -1 for
+ * hours, minutes and switches), which the caller's range checks skip, so the current
+ * setting stays in effect.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../sensors/VaneCalibration.h"
+
+// Room for the configuration ETag, a quoted hash of the config response
+static const size_t STATION_CONFIG_ETAG_SIZE = 48;
+
+struct StationConfig
+{
+    unsigned long tempInterval = 0;       // ms
+    unsigned long windSendInterval = 0;   // ms
+    unsigned long windSampleInterval = 0; // ms
+    unsigned long diagInterval = 0;       // ms
+    unsigned long timeInterval = 0;       // ms
+    unsigned long restartInterval = 0;    // s, received for API compatibility only
+    unsigned long windBatchSize = 0;      // Livestream readings per request
+    int sleepStartHour = -1;
+    int sleepEndHour = -1;
+    int otaHour = -1;
+    int otaMinute = -1;
+    int otaDuration = 0; // minutes
+    bool remoteOta = false;
+    int8_t coapTelemetry = -1; // 1 on, 0 off
+
+    // Wind vane ADC levels in the order N, NE, E, SE, S, SW, W, NW
+    uint16_t vaneCalibration[VaneCalibration::DIRECTION_COUNT] = {};
+    bool vaneCalibrationReceived = false; // Set only for a complete, valid table
+};
@@ -0,0 +1,224 @@
+/**
+ * @file TelemetryCodec.h
+ * @brief Compact binary encoding of the wind uploads
+ *
+ * Alternative to the JSON bodies for the high-frequency wind sends. The
+ * body is a versioned packed record, little endian, with fixed-point
+ * fields, sent as TELEMETRY_CONTENT_TYPE so the server can pick the
+ * decoder from the Content-Type header:
+ *
+ *   u8 version (1), u8 record type, then per type:
+ *
+ *   WIND_READING  u16 speed, u16 direction                         (6 bytes)
+ *   WIND_SUMMARY  u16 speed, direction, gust, lull, speedStdDev,
+ *                 directionStdDev, resultantSpeed, resultantDirection,
+ *                 persistence, u8 cell count, cells of
+ *                 { u8 sector << 4 | speedBin, u16 count }
+ *   WIND_BATCH    u8 count, samples of { u16 speed, u16 direction, u32 ageMs }
+ *   WIND_AGGREGATES u8 count, buckets of { u8 level (minutes), u16 speed,
+ *                 direction, gust, lull, sampleCount, u32 durationMs, u32 ageMs }
+ *
+ * Speeds are in 0.01 m/s, directions and direction deviations in 0.1°,
+ * persistence in 0.0001. Values are clamped to the field range.
+ *
+ * A livestream reading is 6 bytes instead of about 40 bytes of JSON, and
+ * encoding writes into a caller buffer without heap allocations.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "WindAggregateBatch.h"
+#include "WindSampleBatch.h"
+#include "../sensors/WindSummary.h"
+
+#define TELEMETRY_CONTENT_TYPE "application/vnd.aiolos.telemetry"
+#define TELEMETRY_COAP_CONTENT_FORMAT 65000 // The same records over CoAP, from the experimental range
+
+namespace TelemetryCodec
+{
+    static const uint8_t VERSION = 1;
+
+    enum RecordType : uint8_t
+    {
+        WIND_READING = 1,
+        WIND_SUMMARY = 2,
+        WIND_BATCH = 3,
+        WIND_AGGREGATES = 4
+    };
+
+    // Record sizes, for the caller buffers
+    static const size_t WIND_READING_SIZE = 6;
+    static const size_t WIND_SUMMARY_MAX_SIZE = 21 + WindRoseHistogram::SECTORS * WindRoseHistogram::SPEED_BINS * 3;
+    static const size_t WIND_BATCH_MAX_SIZE = 3 + WindSampleBatch::CAPACITY * 8;
+    static const size_t WIND_AGGREGATES_MAX_SIZE = 3 + WindAggregateBatch::CAPACITY * 19;
+
+    /**
+     * @brief Bounds checked little endian writer over a caller buffer
+     */
+    class Writer
+    {
+    public:
+        Writer(uint8_t *buffer, size_t capacity) : _buffer(buffer), _capacity(capacity) {}
+
+        void u8(uint8_t value)
+        {
+            if (_size + 1 > _capacity)
+            {
+                _overflow = true;
+                return;
+            }
+            _buffer[_size++] = value;
+        }
+
+        void u16(uint16_t value)
+        {
+            u8((uint8_t)(value & 0xFF));
+            u8((uint8_t)(value >> 8));
+        }
+
+        void u32(uint32_t value)
+        {
+            u16((uint16_t)(value & 0xFFFF));
+            u16((uint16_t)(value >> 16));
+        }
+
+        /**
+         * @brief Store value / scale rounded to the nearest step, clamped to u16
+         */
+        void fixed16(float value, float scale)
+        {
+            float steps = value / scale + 0.5f;
+            if (!(steps > 0.0f)) // Also catches NaN
+            {
+                u16(0);
+            }
+            else if (steps >= 65535.0f)
+            {
+                u16(65535);
+            }
+            else
+            {
+                u16((uint16_t)steps);
+            }
+        }
+
+        /**
+         * @brief Bytes written, or 0 if the buffer was too small
+         */
+        size_t size() const { return _overflow ? 0 : _size; }
+
+    private:
+        uint8_t *_buffer;
+        size_t _capacity;
+        size_t _size = 0;
+        bool _overflow = false;
+    };
+
+    static constexpr float SPEED_SCALE = 0.01f;         // m/s
+    static constexpr float DIRECTION_SCALE = 0.1f;      // degrees
+    static constexpr float PERSISTENCE_SCALE = 0.0001f; // ratio
+
+    /**
+     * @brief Encode one livestream reading
+     *
+     * @return Bytes written, 0 if the buffer is too small
+     */
+    inline size_t encodeWindReading(uint8_t *buffer, size_t capacity, float speed, float direction)
+    {
+        Writer out(buffer, capacity);
+        out.u8(VERSION);
+        out.u8(WIND_READING);
+        out.fixed16(speed, SPEED_SCALE);
+        out.fixed16(direction, DIRECTION_SCALE);
+        return out.size();
+    }
+
+    /**
+     * @brief Encode an averaged period including the non-zero wind rose cells
+     *
+     * @return Bytes written, 0 if the buffer is too small
+     */
+    inline size_t encodeWindSummary(uint8_t *buffer, size_t capacity, const WindSummary &summary)
+    {
+        Writer out(buffer, capacity);
+        out.u8(VERSION);
+        out.u8(WIND_SUMMARY);
+        out.fixed16(summary.avgSpeed, SPEED_SCALE);
+        out.fixed16(summary.avgDirection, DIRECTION_SCALE);
+        out.fixed16(summary.gust, SPEED_SCALE);
+        out.fixed16(summary.lull, SPEED_SCALE);
+        out.fixed16(summary.speedStdDev, SPEED_SCALE);
+        out.fixed16(summary.directionStdDev, DIRECTION_SCALE);
+        out.fixed16(summary.resultantSpeed, SPEED_SCALE);
+        out.fixed16(summary.resultantDirection, DIRECTION_SCALE);
+        out.fixed16(summary.persistence, PERSISTENCE_SCALE);
+
+        out.u8(summary.windRose.nonZeroCells());
+        for (uint8_t sector = 0; sector < WindRoseHistogram::SECTORS; sector++)
+        {
+            for (uint8_t bin = 0; bin < WindRoseHistogram::SPEED_BINS; bin++)
+            {
+                uint16_t count = summary.windRose.count(sector, bin);
+                if (count == 0)
+                {
+                    continue;
+                }
+                out.u8((uint8_t)(sector << 4 | bin));
+                out.u16(count);
+            }
+        }
+        return out.size();
+    }
+
+    /**
+     * @brief Encode buffered livestream readings with their age at nowMs
+     *
+     * @return Bytes written, 0 if the buffer is too small
+     */
+    inline size_t encodeWindBatch(uint8_t *buffer, size_t capacity, const WindSampleBatch &batch, uint32_t nowMs)
+    {
+        Writer out(buffer, capacity);
+        out.u8(VERSION);
+        out.u8(WIND_BATCH);
+        out.u8(batch.size());
+        for (uint8_t i = 0; i < batch.size(); i++)
+        {
+            const WindSample &sample = batch.at(i);
+            out.fixed16(sample.speed, SPEED_SCALE);
+            out.fixed16(sample.direction, DIRECTION_SCALE);
+            out.u32(nowMs - sample.takenAtMs);
+        }
+        return out.size();
+    }
+
+    /**
+     * @brief Encode completed 1 min and 10 min buckets with their age at nowMs
+     *
+     * @return Bytes written, 0 if the buffer is too small
+     */
+    inline size_t encodeWindAggregates(uint8_t *buffer, size_t capacity, const WindAggregateBatch &batch,
+                                       uint32_t nowMs)
+    {
+        Writer out(buffer, capacity);
+        out.u8(VERSION);
+        out.u8(WIND_AGGREGATES);
+        out.u8(batch.size());
+        for (uint8_t i = 0; i < batch.size(); i++)
+        {
+            const WindAggregateEntry &entry = batch.at(i);
+            out.u8(entry.levelMinutes);
+            out.fixed16(entry.aggregate.avgSpeed, SPEED_SCALE);
+            out.fixed16(entry.aggregate.avgDirection, DIRECTION_SCALE);
+            out.fixed16(entry.aggregate.gust, SPEED_SCALE);
+            out.fixed16(entry.aggregate.lull, SPEED_SCALE);
+            out.u16(entry.aggregate.count > 0xFFFF ? 0xFFFF : (uint16_t)entry.aggregate.count);
+            out.u32(entry.aggregate.durationMs);
+            out.u32(nowMs - entry.aggregate.endMs);
+        }
+        return out.size();
+    }
+}
@@ -0,0 +1,397 @@
+/**
+ * @file TelemetryQueue.cpp
+ * @brief Segmented LittleFS log behind the offline telemetry queue
+ */
+
+#include "TelemetryQueue.h"
+#include "Logger.h"
+#include "../config/Config.h"
+#include <LittleFS.h>
+#include <Preferences.h>
+
+// Global instance
+TelemetryQueue telemetryQueue;
+
+namespace
+{
+    const char *QUEUE_DIRECTORY = "/telemetry";
+    const char *NVS_NAMESPACE = "tqueue";
+    const char *NVS_KEY = "read";
+
+    // Where reading continues after a restart; segments before seq are gone
+    struct ReadPosition
+    {
+        uint32_t seq;
+        uint32_t offset;
+    };
+
+    static_assert(TELEMETRY_QUEUE_MAX_SEGMENTS >= 2, "The queue needs a segment to read and one to append to");
+}
+
+void TelemetryQueue::_segmentPath(uint32_t seq, char *path) const
+{
+    snprintf(path, PATH_SIZE, "%s/%08lx.log", QUEUE_DIRECTORY, (unsigned long)seq);
+}
+
+bool TelemetryQueue::begin(const EpochClock &clock)
+{
+    _clock = &clock;
+
+    // Format on the first boot, when the partition holds no file system yet
+    if (!LittleFS.begin(true))
+    {
+        Logger.warn(LOG_TAG_SYSTEM, "File system unavailable, offline telemetry queue disabled");
+        return false;
+    }
+    if (!LittleFS.exists(QUEUE_DIRECTORY))
+    {
+        LittleFS.mkdir(QUEUE_DIRECTORY);
+    }
+
+    ReadPosition position = {1, 0}; // Sequence numbers start at 1, so an empty log is tail = head + 1
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true))
+    {
+        ReadPosition stored;
+        if (prefs.getBytes(NVS_KEY, &stored, sizeof(stored)) == sizeof(stored) && stored.seq > 0)
+        {
+            position = stored;
+        }
+        prefs.end();
+    }
+
+    // Find the segments left by the previous boot
+    uint32_t lowest = UINT32_MAX;
+    uint32_t highest = 0;
+    File directory = LittleFS.open(QUEUE_DIRECTORY);
+    File entry = directory.openNextFile();
+    while (entry)
+    {
+        const char *name = strrchr(entry.name(), '/');
+        name = name ? name + 1 : entry.name();
+        char *end = nullptr;
+        uint32_t seq = strtoul(name, &end, 16);
+        entry.close();
+
+        if (end != name && strcmp(end, ".log") == 0 && seq > 0)
+        {
+            if (seq < position.seq)
+            {
+                // Drained before the restart but not yet deleted
+                char path[PATH_SIZE];
+                _segmentPath(seq, path);
+                LittleFS.remove(path);
+            }
+            else
+            {
+                lowest = min(lowest, seq);
+                highest = max(highest, seq);
+            }
+        }
+        entry = directory.openNextFile();
+    }
+    directory.close();
+
+    if (highest == 0)
+    {
+        _tailSeq = position.seq;
+        _headSeq = position.seq - 1;
+        _readOffset = 0;
+    }
+    else
+    {
+        _tailSeq = lowest;
+        _headSeq = highest;
+        _readOffset = lowest == position.seq ? position.offset : 0;
+    }
+
+    for (uint32_t seq = _tailSeq; seq <= _headSeq; seq++)
+    {
+        uint32_t size = 0;
+        _depth += _countRecords(seq, seq == _tailSeq ? _readOffset : 0, &size);
+        _usedBytes += size;
+    }
+
+    // The last segment of the previous boot may end in a torn record; never append to it
+    _headOpened = false;
+    _ready = true;
+
+    Logger.info(LOG_TAG_SYSTEM, "Offline telemetry queue: %lu records waiting, %u%% full", (unsigned long)_depth,
+                getFillPercent());
+    return true;
+}
+
+/**
+ * @brief Count the records of a segment from an offset by their headers
+ * @param size Receives the size of the segment file
+ */
+uint32_t TelemetryQueue::_countRecords(uint32_t seq, uint32_t fromOffset, uint32_t *size) const
+{
+    char path[PATH_SIZE];
+    _segmentPath(seq, path);
+    *size = 0;
+
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file)
+    {
+        return 0;
+    }
+    *size = file.size();
+
+    uint32_t count = 0;
+    uint32_t offset = fromOffset;
+    uint8_t raw[TelemetryQueueRecord::HEADER_SIZE];
+    TelemetryQueueRecord::Header header;
+    while (offset + sizeof(raw) <= *size && file.seek(offset) && file.read(raw, sizeof(raw)) == sizeof(raw) &&
+           TelemetryQueueRecord::decodeHeader(raw, header) && offset + sizeof(raw) + header.length <= *size)
+    {
+        count++;
+        offset += sizeof(raw) + header.length;
+    }
+    file.close();
+    return count;
+}
+
+bool TelemetryQueue::_startSegment()
+{
+    while (_headSeq >= _tailSeq && _headSeq - _tailSeq + 1 >= TELEMETRY_QUEUE_MAX_SEGMENTS)
+    {
+        _dropTailSegment();
+    }
+
+    char path[PATH_SIZE];
+    _segmentPath(_headSeq + 1, path);
+    File file = LittleFS.open(path, FILE_WRITE);
+    if (!file)
+    {
+        return false;
+    }
+    file.close();
+
+    _headSeq++;
+    _headOpened = true;
+    _headSize = 0;
+    return true;
+}
+
+/**
+ * @brief Delete the oldest segment; its unread records count as dropped
+ */
+void TelemetryQueue::_dropTailSegment()
+{
+    uint32_t size = 0;
+    uint32_t lost = _countRecords(_tailSeq, _readOffset, &size);
+    if (lost > 0)
+    {
+        Logger.warn(LOG_TAG_SYSTEM, "Offline telemetry queue dropped %lu records", (unsigned long)lost);
+        _dropped += lost;
+        _depth -= min(lost, _depth);
+    }
+    _usedBytes -= min(size, _usedBytes);
+    _advanceTail();
+}
+
+void TelemetryQueue::_advanceTail()
+{
+    char path[PATH_SIZE];
+    _segmentPath(_tailSeq, path);
+    LittleFS.remove(path);
+
+    if (_tailSeq == _headSeq)
+    {
+        _headOpened = false;
+    }
+    _tailSeq++;
+    _readOffset = 0;
+    _peekedSize = 0;
+    _saveReadPosition();
+}
+
+void TelemetryQueue::_saveReadPosition()
+{
+    _unsavedReads = 0;
+    ReadPosition position = {_tailSeq, _readOffset};
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false))
+    {
+        prefs.putBytes(NVS_KEY, &position, sizeof(position));
+        prefs.end();
+    }
+}
+
+bool TelemetryQueue::push(TelemetryQueueRecord::Kind kind, const char *payload, size_t length)
+{
+    if (!_ready)
+    {
+        return false;
+    }
+
+    TelemetryQueueRecord::Header header;
+    header.kind = kind;
+    header.length = (uint16_t)length;
+    header.epoch = _clock->now(millis());
+
+    uint32_t recordSize = TelemetryQueueRecord::HEADER_SIZE + length;
+    if (header.epoch == 0 || length > UINT16_MAX || recordSize > TELEMETRY_QUEUE_SEGMENT_SIZE)
+    {
+        // Without a date the server could not place the data in time
+        Logger.warn(LOG_TAG_SYSTEM, "Cannot queue telemetry (%s)", header.epoch == 0 ? "no network time yet" : "too large");
+        _dropped++;
+        return false;
+    }
+
+    if (!_headOpened || _headSize + recordSize > TELEMETRY_QUEUE_SEGMENT_SIZE)
+    {
+        if (!_startSegment())
+        {
+            Logger.error(LOG_TAG_SYSTEM, "Failed to start an offline telemetry segment");
+            _dropped++;
+            return false;
+        }
+    }
+
+    header.crc = TelemetryQueueRecord::checksum(header, (const uint8_t *)payload);
+    uint8_t raw[TelemetryQueueRecord::HEADER_SIZE];
+    TelemetryQueueRecord::encodeHeader(header, raw);
+
+    char path[PATH_SIZE];
+    _segmentPath(_headSeq, path);
+    File file = LittleFS.open(path, FILE_APPEND);
+    size_t written = 0;
+    if (file)
+    {
+        written = file.write(raw, sizeof(raw));
+        written += file.write((const uint8_t *)payload, length);
+        file.close();
+    }
+
+    if (written != recordSize)
+    {
+        // A partial record ends the readable part of this segment; continue in a new one
+        Logger.error(LOG_TAG_SYSTEM, "Failed to append to the offline telemetry queue");
+        _headOpened = false;
+        _usedBytes += written;
+        _dropped++;
+        return false;
+    }
+
+    _headSize += recordSize;
+    _usedBytes += recordSize;
+    _depth++;
+    _appended++;
+    return true;
+}
+
+bool TelemetryQueue::peek(TelemetryQueueRecord::Header &header, char *payload, size_t capacity)
+{
+    _peekedSize = 0;
+
+    while (_ready && _tailSeq <= _headSeq)
+    {
+        char path[PATH_SIZE];
+        _segmentPath(_tailSeq, path);
+        File file = LittleFS.open(path, FILE_READ);
+        uint32_t size = file ? file.size() : 0;
+
+        if (_readOffset >= size)
+        {
+            if (file)
+            {
+                file.close();
+            }
+            if (_tailSeq == _headSeq && _headOpened)
+            {
+                return false; // Everything read; the segment is still being appended to
+            }
+            _dropTailSegment(); // Drained
+            continue;
+        }
+
+        uint8_t raw[TelemetryQueueRecord::HEADER_SIZE];
+        bool valid = file.seek(_readOffset) && file.read(raw, sizeof(raw)) == sizeof(raw) &&
+                     TelemetryQueueRecord::decodeHeader(raw, header) &&
+                     _readOffset + sizeof(raw) + header.length <= size;
+
+        if (valid && header.length >= capacity)
+        {
+            file.close();
+            Logger.warn(LOG_TAG_SYSTEM, "Queued record of %u bytes does not fit, dropped", header.length);
+            _peekedSize = sizeof(raw) + header.length;
+            _advance();
+            _dropped++;
+            continue;
+        }
+
+        valid = valid && file.read((uint8_t *)payload, header.length) == header.length &&
+                TelemetryQueueRecord::checksum(header, (const uint8_t *)payload) == header.crc;
+        file.close();
+
+        if (!valid)
+        {
+            // A torn or damaged record: the rest of the segment cannot be framed
+            Logger.warn(LOG_TAG_SYSTEM, "Damaged record in offline telemetry segment %lu", (unsigned long)_tailSeq);
+            _dropTailSegment();
+            continue;
+        }
+
+        payload[header.length] = '\0';
+        _peekedSize = sizeof(raw) + header.length;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Move past the peeked record
+ *
+ * The position is written to NVS only once per drain batch or when the queue
+ * runs empty, to spare the flash; finishing a segment writes it as well.
+ */
+void TelemetryQueue::_advance()
+{
+    _readOffset += _peekedSize;
+    _peekedSize = 0;
+    _depth -= min((uint32_t)1, _depth);
+    if (++_unsavedReads >= TELEMETRY_QUEUE_DRAIN_BATCH || _depth == 0)
+    {
+        _saveReadPosition();
+    }
+}
+
+void TelemetryQueue::pop()
+{
+    if (_peekedSize == 0)
+    {
+        return;
+    }
+    _advance();
+    _drained++;
+}
+
+void TelemetryQueue::discard()
+{
+    if (_peekedSize == 0)
+    {
+        return;
+    }
+    _advance();
+    _dropped++;
+}
+
+TelemetryQueue::Stats TelemetryQueue::getStats() const
+{
+    Stats stats;
+    stats.depth = _depth;
+    stats.usedBytes = _usedBytes;
+    stats.capacityBytes = (uint32_t)TELEMETRY_QUEUE_SEGMENT_SIZE * TELEMETRY_QUEUE_MAX_SEGMENTS;
+    stats.appended = _appended;
+    stats.drained = _drained;
+    stats.dropped = _dropped;
+    return stats;
+}
+
+uint8_t TelemetryQueue::getFillPercent() const
+{
+    uint32_t capacity = (uint32_t)TELEMETRY_QUEUE_SEGMENT_SIZE * TELEMETRY_QUEUE_MAX_SEGMENTS;
+    return (uint8_t)min((uint32_t)100, _usedBytes * 100 / capacity);
+}
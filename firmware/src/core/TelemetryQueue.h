@@ -0,0 +1,124 @@
+/**
+ * @file TelemetryQueue.h
+ * @brief Flash-backed store-and-forward queue for uploads made while offline
+ *
+ * Bodies that cannot be delivered (no GPRS, HTTP backoff, connection or
+ * server errors) are appended to a log on LittleFS instead of being lost,
+ * and sent later with the time they were taken. The log survives restarts,
+ * including the ones forced by the offline safety mechanisms.
+ *
+ * The log is a sequence of segment files, /telemetry/<seq>.log, written
+ * append-only in TelemetryQueueRecord format. Appends go to the newest
+ * segment until it reaches TELEMETRY_QUEUE_SEGMENT_SIZE; then a new one is
+ * started. A segment is deleted as a whole once drained, and when the log
+ * holds TELEMETRY_QUEUE_MAX_SEGMENTS the oldest is dropped to make room.
+ * Nothing is rewritten in place, so flash wear is spread by LittleFS over
+ * the whole partition instead of concentrating on one block. The read
+ * position is kept in NVS and written once per TELEMETRY_QUEUE_DRAIN_BATCH
+ * records, when a segment is finished and when the queue runs empty, not
+ * for every record.
+ *
+ * Delivery is at least once: a restart before the read position is written
+ * sends the records delivered since the last write again, up to one drain
+ * batch.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "EpochClock.h"
+#include "TelemetryQueueRecord.h"
+
+class TelemetryQueue
+{
+public:
+    struct Stats
+    {
+        uint32_t depth = 0;         // Records waiting
+        uint32_t usedBytes = 0;     // Flash used by the segments
+        uint32_t capacityBytes = 0; // Flash budget of the queue
+        uint32_t appended = 0;      // Since boot
+        uint32_t drained = 0;       // Since boot
+        uint32_t dropped = 0;       // Since boot: lost to rotation, corruption or oversize
+    };
+
+    /**
+     * @brief Mount the file system and recover the queue left by the previous boot
+     *
+     * @param clock Dates the appended records
+     * @return false if the file system is unavailable; the queue then stays disabled
+     */
+    bool begin(const EpochClock &clock);
+
+    bool isReady() const { return _ready; }
+    bool isEmpty() const { return _depth == 0; }
+
+    /**
+     * @brief Append one record, dated now
+     *
+     * @return false if it was not stored (queue disabled, clock not synced, write error)
+     */
+    bool push(TelemetryQueueRecord::Kind kind, const char *payload, size_t length);
+
+    /**
+     * @brief Read the oldest record without removing it
+     *
+     * Damaged records are skipped and counted as dropped.
+     *
+     * @param header Receives the record header
+     * @param payload Receives the payload
+     * @param capacity Size of the payload buffer; larger records are dropped
+     * @return false if the queue is empty
+     */
+    bool peek(TelemetryQueueRecord::Header &header, char *payload, size_t capacity);
+
+    /**
+     * @brief Remove the record returned by the last peek()
+     */
+    void pop();
+
+    /**
+     * @brief Remove the record returned by the last peek() without delivering it
+     */
+    void discard();
+
+    Stats getStats() const;
+
+    /**
+     * @brief Percent of the flash budget in use
+     */
+    uint8_t getFillPercent() const;
+
+private:
+    static const size_t PATH_SIZE = 32;
+
+    const EpochClock *_clock = nullptr;
+    bool _ready = false;
+
+    // Segments present are _tailSeq.._headSeq; the head is only appended to in this boot
+    uint32_t _tailSeq = 0;
+    uint32_t _headSeq = 0;
+    bool _headOpened = false; // A segment was started in this boot
+    uint32_t _headSize = 0;
+
+    // Read position in the tail segment
+    uint32_t _readOffset = 0;
+    uint32_t _peekedSize = 0; // Bytes of the record returned by peek(), 0 if none
+    uint8_t _unsavedReads = 0; // Records removed since the read position was last written
+
+    uint32_t _depth = 0;
+    uint32_t _usedBytes = 0;
+    uint32_t _appended = 0;
+    uint32_t _drained = 0;
+    uint32_t _dropped = 0;
+
+    void _segmentPath(uint32_t seq, char *path) const;
+    uint32_t _countRecords(uint32_t seq, uint32_t fromOffset, uint32_t *size) const;
+    bool _startSegment();
+    void _dropTailSegment();
+    void _advanceTail();
+    void _saveReadPosition();
+    void _advance();
+};
+
+extern TelemetryQueue telemetryQueue;
@@ -0,0 +1,139 @@
+/**
+ * @file TelemetryQueueRecord.h
+ * @brief On-flash record format of the offline telemetry queue
+ *
+ * Each record is a 12 byte header followed by the payload, the JSON body
+ * the upload would have sent:
+ *
+ *   u8 magic, u8 kind, u16 payload length, u32 epoch (UTC seconds when the
+ *   body was made, 0 if unknown), u32 CRC-32 of kind, length, epoch and
+ *   payload
+ *
+ * All fields are little endian. A record cut short by a power loss or
+ * damaged in flash fails the CRC check and ends the readable part of its
+ * segment.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace TelemetryQueueRecord
+{
+    static const uint8_t MAGIC = 0xA7;
+    static const size_t HEADER_SIZE = 12;
+
+    // What the payload is; selects the endpoint it is replayed to
+    enum Kind : uint8_t
+    {
+        WIND_READING = 1,
+        WIND_SUMMARY = 2,
+        WIND_BATCH = 3,
+        TEMPERATURE = 4,
+        DIAGNOSTICS = 5,
+        FRAME = 6,
+        WIND_AGGREGATES = 7
+    };
+
+    struct Header
+    {
+        uint8_t kind = 0;
+        uint16_t length = 0;
+        uint32_t epoch = 0;
+        uint32_t crc = 0;
+    };
+
+    /**
+     * @brief Endpoint below /api/stations/<id>/ a record kind is sent to, nullptr if unknown
+     */
+    inline const char *endpoint(uint8_t kind)
+    {
+        switch (kind)
+        {
+        case WIND_READING:
+        case WIND_SUMMARY:
+            return "wind";
+        case WIND_BATCH:
+            return "wind/batch";
+        case TEMPERATURE:
+            return "temperature";
+        case DIAGNOSTICS:
+            return "diagnostics";
+        case FRAME:
+            return "frame";
+        case WIND_AGGREGATES:
+            return "wind/aggregates";
+        default:
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief CRC-32 (IEEE 802.3, reflected), continued from crc
+     */
+    inline uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc = 0)
+    {
+        crc = ~crc;
+        for (size_t i = 0; i < length; i++)
+        {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+        }
+        return ~crc;
+    }
+
+    /**
+     * @brief Checksum stored in the header for this header and payload
+     */
+    inline uint32_t checksum(const Header &header, const uint8_t *payload)
+    {
+        uint8_t fields[7] = {header.kind,
+                             (uint8_t)(header.length & 0xFF),
+                             (uint8_t)(header.length >> 8),
+                             (uint8_t)(header.epoch & 0xFF),
+                             (uint8_t)(header.epoch >> 8),
+                             (uint8_t)(header.epoch >> 16),
+                             (uint8_t)(header.epoch >> 24)};
+        return crc32(payload, header.length, crc32(fields, sizeof(fields)));
+    }
+
+    inline void encodeHeader(const Header &header, uint8_t (&out)[HEADER_SIZE])
+    {
+        out[0] = MAGIC;
+        out[1] = header.kind;
+        out[2] = (uint8_t)(header.length & 0xFF);
+        out[3] = (uint8_t)(header.length >> 8);
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            out[4 + i] = (uint8_t)(header.epoch >> (8 * i));
+            out[8 + i] = (uint8_t)(header.crc >> (8 * i));
+        }
+    }
+
+    /**
+     * @return false if the bytes are not a record header (erased or torn flash)
+     */
+    inline bool decodeHeader(const uint8_t (&in)[HEADER_SIZE], Header &header)
+    {
+        if (in[0] != MAGIC || endpoint(in[1]) == nullptr)
+        {
+            return false;
+        }
+        header.kind = in[1];
+        header.length = (uint16_t)(in[2] | in[3] << 8);
+        header.epoch = 0;
+        header.crc = 0;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            header.epoch |= (uint32_t)in[4 + i] << (8 * i);
+            header.crc |= (uint32_t)in[8 + i] << (8 * i);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file WindAggregateBatch.h
+ * @brief Completed 1 min and 10 min wind buckets waiting for upload
+ *
+ * The sampling task closes a 1 min bucket every minute and a 10 min bucket
+ * with every tenth of them (WindAggregationPyramid). They are collected here
+ * until their outbound request is dispatched and then posted together, so
+ * a slow link costs one request for everything that piled up. When the
+ * buffer is full the oldest bucket gives way to the newest.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "../sensors/WindAggregationPyramid.h"
+
+/**
+ * @brief One completed bucket and the level it belongs to
+ */
+struct WindAggregateEntry
+{
+    uint8_t levelMinutes = 0; // 1 or 10
+    WindAggregate aggregate;
+};
+
+class WindAggregateBatch
+{
+public:
+    static const uint8_t CAPACITY = 12; // Ten 1 min buckets, the 10 min bucket closing with the last, a spare
+
+    /**
+     * @brief Append a bucket
+     *
+     * @return false if the batch was full and its oldest bucket was dropped
+     */
+    bool add(const WindAggregateEntry &entry)
+    {
+        bool kept = true;
+        if (_count >= CAPACITY)
+        {
+            memmove(&_entries[0], &_entries[1], (CAPACITY - 1) * sizeof(WindAggregateEntry));
+            _count--;
+            kept = false;
+        }
+        _entries[_count++] = entry;
+        return kept;
+    }
+
+    void clear() { _count = 0; }
+
+    uint8_t size() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+    const WindAggregateEntry &at(uint8_t index) const { return _entries[index]; }
+
+private:
+    WindAggregateEntry _entries[CAPACITY];
+    uint8_t _count = 0;
+};
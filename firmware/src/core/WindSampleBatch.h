@@ -0,0 +1,100 @@
+/**
+ * @file WindSampleBatch.h
+ * @brief Fixed-size buffer of livestream wind samples sent in one request
+ *
+ * Over LTE-M the TCP/HTTP setup of a request costs far more than the few
+ * bytes of one livestream reading. Readings are collected here with the
+ * time they were taken and posted together. The caller flushes when the
+ * batch reaches the configured size, when the oldest sample reaches the
+ * maximum age, and before the station restarts or sleeps, which bounds the
+ * delay added by batching.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief One buffered livestream reading
+ */
+struct WindSample
+{
+    float speed = 0.0f;     // m/s
+    float direction = 0.0f; // degrees
+    uint32_t takenAtMs = 0; // millis() when the reading was produced
+};
+
+class WindSampleBatch
+{
+public:
+    static const uint8_t CAPACITY = 60; // One minute of 1 Hz livestream readings
+
+    /**
+     * @brief Append a reading
+     *
+     * @return false if the batch is full; the reading is not stored
+     */
+    bool add(float speed, float direction, uint32_t takenAtMs)
+    {
+        if (_count >= CAPACITY)
+        {
+            return false;
+        }
+        WindSample &sample = _samples[_count++];
+        sample.speed = speed;
+        sample.direction = direction;
+        sample.takenAtMs = takenAtMs;
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest reading, making room while the batch waits for dispatch
+     */
+    void dropOldest()
+    {
+        if (_count == 0)
+        {
+            return;
+        }
+        _count--;
+        memmove(&_samples[0], &_samples[1], _count * sizeof(WindSample));
+    }
+
+    void clear() { _count = 0; }
+
+    uint8_t size() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+    const WindSample &at(uint8_t index) const { return _samples[index]; }
+
+    /**
+     * @brief Age of the oldest reading, 0 if the batch is empty
+     */
+    uint32_t oldestAgeMs(uint32_t nowMs) const
+    {
+        return _count ? nowMs - _samples[0].takenAtMs : 0;
+    }
+
+    /**
+     * @brief Whether the batch should be sent now
+     *
+     * @param nowMs Current millis()
+     * @param targetSize Configured batch size (clamped to CAPACITY)
+     * @param maxAgeMs Maximum time a reading may wait in the batch
+     */
+    bool shouldFlush(uint32_t nowMs, uint8_t targetSize, uint32_t maxAgeMs) const
+    {
+        if (_count == 0)
+        {
+            return false;
+        }
+        uint8_t limit = targetSize == 0 || targetSize > CAPACITY ? CAPACITY : targetSize;
+        return _count >= limit || oldestAgeMs(nowMs) >= maxAgeMs;
+    }
+
+private:
+    WindSample _samples[CAPACITY];
+    uint8_t _count = 0;
+};
@@ -16,17 +16,24 @@
 #include "core/Logger.h"
 #include "core/ModemManager.h"
 #include "core/AiolosHttpClient.h"
+#include "core/ConfigStore.h"
+#include "core/WindSampleBatch.h"
+#include "core/WindAggregateBatch.h"
 #include "core/DiagnosticsManager.h"
+#include "core/EpochClock.h"
+#include "core/TelemetryQueue.h"
+#include "core/JsonPayloads.h"
 #include "core/OtaManager.h"
+#include "core/HttpTransportBenchmark.h"
 #include "utils/TemperatureSensor.h"
 #include "utils/BatteryUtils.h" // For calibrated battery readings
 #include "sensors/WindSensor.h"
+#include "sensors/WindSamplingTask.h"
 #include <WiFi.h>
 
 // Global variables
 unsigned long lastTimeUpdate = 0;
 unsigned long lastDiagnosticsUpdate = 0;
-unsigned long lastWindUpdate = 0;
 unsigned long lastTemperatureUpdate = 0;
 unsigned long lastConfigUpdate = 0;
 unsigned long lastWindDataSendTime = 0;
@@ -34,9 +41,9 @@ unsigned long lastHeartbeatTime = 0;
 unsigned long lastConfigFetchTime = 0;
 int currentHour = 0, currentMinute = 0, currentSecond = 0;
 unsigned long lastNetworkTimeUpdate = 0; // Track when we last got network time
+EpochClock stationClock;                 // UTC time for dating queued telemetry
 bool otaActive = false;
 unsigned long lastOtaCheck = 0;
-bool isSamplingWind = false; // For wind data averaging
 
 // Emergency connection failure tracking
 unsigned long lastConnectionFailureTime = 0;
@@ -55,6 +62,18 @@ unsigned long lastBackoffResetTime = 0; // Track when we last reset the backoff
 bool tempConversionStarted = false;
 unsigned long tempConversionStartTime = 0;
 
+// Data waiting for its outbound request to be dispatched (see dispatchOutbound())
+WindSummary pendingWindSummaries[WIND_SUMMARY_PENDING_MAX]; // Averaged periods, oldest first
+uint8_t pendingWindSummaryCount = 0;
+float pendingInternalTemp = -127.0f;
+float pendingExternalTemp = -127.0f;
+float pendingDiagnosticsInternalTemp = -127.0f;
+float pendingDiagnosticsExternalTemp = -127.0f;
+
+// Class whose send is in flight with async HTTP, completed by onRequestDone()
+bool outboundInFlight = false;
+OutboundScheduler::Class inFlightClass = OutboundScheduler::WIND;
+
 // Dynamic interval settings, initialized with defaults from Config.h
 unsigned long dynamicTempInterval = DEFAULT_TEMP_INTERVAL;
 unsigned long dynamicWindInterval = DEFAULT_WIND_INTERVAL;
@@ -66,6 +85,19 @@ int dynamicSleepEndHour = DEFAULT_SLEEP_END_HOUR;
 int dynamicOtaHour = DEFAULT_OTA_HOUR;
 int dynamicOtaMinute = DEFAULT_OTA_MINUTE;
 int dynamicOtaDuration = DEFAULT_OTA_DURATION;
+unsigned long dynamicWindBatchSize = DEFAULT_WIND_BATCH_SIZE;
+
+// ETag of the configuration in effect, sent as If-None-Match on the next fetch
+char configEtag[STATION_CONFIG_ETAG_SIZE] = "";
+
+// Config version announced by telemetry when the last configuration fetch succeeded
+char fetchedConfigVersion[STATION_CONFIG_ETAG_SIZE] = "";
+
+// Livestream readings waiting to be sent together (windBatchSize > 1)
+WindSampleBatch windBatch;
+
+// Completed 1 min and 10 min buckets waiting for upload (WIND_AGGREGATES builds)
+WindAggregateBatch pendingWindAggregates;
 
 // Calibration mode - can be enabled via build flags
 #ifdef CALIBRATION_MODE
@@ -77,7 +109,7 @@ const bool CALIBRATION_ENABLED = false;
 #ifdef CALIBRATION_DURATION
 const unsigned long CALIBRATION_TIME = CALIBRATION_DURATION;
 #else
-const unsigned long CALIBRATION_TIME = 30000; // 30 seconds default
+const unsigned long CALIBRATION_TIME = 64000; // 8 seconds per direction
 #endif
 
 // Function prototypes
@@ -88,8 +120,21 @@ void enterDeepSleepUntil(int hour, int minute);
 void testModemConnectivity();
 bool checkAndInitOta();
 bool checkAndInitRemoteOta();
-void handleRemoteConfiguration();                                               // New function to handle remote config
+bool handleRemoteConfiguration();                                               // New function to handle remote config
+bool configVersionChanged();
+unsigned long configPollInterval();
+void applyStationConfig(const StationConfig &config);
+void restoreStoredConfiguration();
 void handleOfflineSafetyMechanisms(unsigned long currentMillis, bool isOnline); // New safety function
+void handleSerialCommands();
+bool flushWindBatch();
+void queuePendingWind(const WindSummary &summary);
+bool sendPendingWind();
+void sendAllPendingWind();
+bool sendPendingAggregates();
+void dispatchOutbound();
+void onRequestDone(bool delivered);
+bool dueWithinFrame(unsigned long sinceLast, unsigned long interval);
 
 // Sensor instances
 TemperatureSensor externalTempSensor;
@@ -124,6 +169,9 @@ void setup()
     // Initialize battery reading utility
     BatteryUtils::init();
 
+    // Start with the configuration applied before the restart, not the defaults
+    restoreStoredConfiguration();
+
     // Set up LED
     pinMode(LED_PIN, OUTPUT);
     digitalWrite(LED_PIN, HIGH);
@@ -169,6 +217,7 @@ void setup()
 
         // Record when we got network time
         lastNetworkTimeUpdate = millis();
+        stationClock.sync(year, month, day, currentHour, currentMinute, currentSecond, timezone, lastNetworkTimeUpdate);
 
         Logger.info(LOG_TAG_SYSTEM, "Network time obtained: %04d-%02d-%02d %02d:%02d:%02d (TZ: %.1f)",
                     year, month, day, currentHour, currentMinute, currentSecond, timezone);
@@ -210,6 +259,13 @@ void setup()
     }
     else
     {
+        // Keep uploads that cannot be delivered in flash and send them once back online
+        if (telemetryQueue.begin(stationClock))
+        {
+            httpClient.setOfflineQueue(&telemetryQueue);
+        }
+        httpClient.setRequestCallback(onRequestDone);
+
         // Initialize diagnostics manager with interval from config
         diagnosticsManager.init(modemManager, httpClient, dynamicDiagInterval);
 
@@ -257,22 +313,19 @@ void setup()
         // Set the interval for taking samples during an averaging period
         windSensor.setSampleInterval(dynamicWindSampleInterval);
 
-        // Run calibration if enabled
+        // Start calibration if enabled; the wizard is stepped from loop()
         if (CALIBRATION_ENABLED)
         {
             Logger.info(LOG_TAG_SYSTEM, "Starting wind vane calibration mode");
-            // Temporarily disable watchdog during calibration
-            esp_task_wdt_deinit();
-            windSensor.calibrateWindVane(CALIBRATION_TIME);
-            // Re-enable watchdog after calibration
-            setupWatchdog();
+            windSensor.startVaneCalibration(CALIBRATION_TIME);
         }
 
         // Just print a single wind reading at initialization
         windSensor.printWindReading();
 
-        // Start initial wind sampling period
-        windSensor.startSamplingPeriod();
+        // From here on the wind sensor is driven by its own fixed-rate task
+        windSamplingTask.setSendInterval(dynamicWindInterval);
+        windSamplingTask.begin(windSensor, WIND_TASK_TICK_MS);
     }
     else
     {
@@ -315,6 +368,15 @@ void loop()
     // Reset watchdog
     resetWatchdog();
 
+    // Wind acquisition runs in its own task; this only ticks it if the task could not start
+    windSamplingTask.poll();
+
+    // Advance the HTTP request in flight, if any (async HTTP)
+    httpClient.poll();
+
+    // Service console commands (e.g. starting a vane calibration on site)
+    handleSerialCommands();
+
     // Get current time
     unsigned long currentMillis = millis();
 
@@ -323,6 +385,9 @@ void loop()
     {
         Logger.info(LOG_TAG_SYSTEM, "Uptime restart: Device has been running for %.1f hours, restarting for maintenance",
                     currentMillis / 3600000.0);
+        httpClient.setAsync(false); // The last sends complete before the restart
+        sendAllPendingWind();
+        httpClient.flushFrame(DEVICE_ID);
         delay(1000); // Give time for log to be sent
         ESP.restart();
         return; // This line won't be reached, but good practice
@@ -362,6 +427,7 @@ void loop()
 
             // Record when we got network time
             lastNetworkTimeUpdate = millis();
+            stationClock.sync(year, month, day, currentHour, currentMinute, currentSecond, timezone, lastNetworkTimeUpdate);
 
             Logger.info(LOG_TAG_SYSTEM, "Time updated: %04d-%02d-%02d %02d:%02d:%02d (TZ: %.1f)",
                         year, month, day, currentHour, currentMinute, currentSecond, timezone);
@@ -483,11 +549,11 @@ void loop()
     bool isOnline = connectionSuccess && !httpClient.isConnectionThrottled();
     handleOfflineSafetyMechanisms(currentMillis, isOnline);
 
-    // Only proceed with network operations if GPRS is connected and not in backoff
-    if (connectionSuccess && !httpClient.isConnectionThrottled())
+    // Telemetry is produced while offline too when it can be queued for later delivery
+    if (isOnline || telemetryQueue.isReady())
     {
         // Send diagnostics data periodically
-        if (currentMillis - lastDiagnosticsUpdate >= dynamicDiagInterval)
+        if (dueWithinFrame(currentMillis - lastDiagnosticsUpdate, dynamicDiagInterval))
         {
             lastDiagnosticsUpdate = currentMillis;
 
@@ -518,79 +584,80 @@ void loop()
             // Get internal temperature (this uses a different bus, so should be safe)
             internalTemp = diagnosticsManager.readInternalTemperature();
 
-            // Send diagnostics with temperature readings to avoid sensor conflicts
-            diagnosticsManager.sendDiagnostics(internalTemp, externalTemp);
+            // Sent with these temperature readings to avoid sensor conflicts; a newer report replaces one still waiting
+            pendingDiagnosticsInternalTemp = internalTemp;
+            pendingDiagnosticsExternalTemp = externalTemp;
+            httpClient.requestOutbound(OutboundScheduler::DIAGNOSTICS);
         }
 
-        // Fetch remote configuration periodically
-        if (currentMillis - lastConfigUpdate >= DEFAULT_CONFIG_UPDATE_INTERVAL)
+        // Fetch remote configuration when telemetry announced a new version, or periodically as a fallback
+        unsigned long sinceConfigUpdate = currentMillis - lastConfigUpdate;
+        if (isOnline && ((configVersionChanged() && sinceConfigUpdate >= CONFIG_VERSION_FETCH_SPACING) ||
+                         sinceConfigUpdate >= configPollInterval()))
         {
             lastConfigUpdate = currentMillis;
-            handleRemoteConfiguration();
+            httpClient.requestOutbound(OutboundScheduler::CONFIG);
         }
 
-        // --- Wind Data Task (Dual Mode: Livestream vs. Averaged) ---
-        const unsigned long LIVESTREAM_THRESHOLD_MS = 5000;
-
-        if (dynamicWindInterval <= LIVESTREAM_THRESHOLD_MS)
+        // --- Wind Data (produced by the wind sampling task) ---
+        // Livestream readings (send interval <= 5 s) carry speed and direction only,
+        // averaged periods also carry gust and lull.
+        WindReport windReport;
+        if (windSamplingTask.receive(windReport))
         {
-            // --- LIVESTREAM MODE ---
-            if (currentMillis - lastWindUpdate >= dynamicWindInterval)
+            if (windReport.averaged)
             {
-                lastWindUpdate = currentMillis;
-
-                // Get instantaneous wind data
-                float windSpeed = windSensor.getWindSpeed();
-                float windDirection = windSensor.getWindDirection();
+                Logger.info(LOG_TAG_SYSTEM, "Averaged Wind: %.1f m/s at %.0f° (gust %.1f, lull %.1f)",
+                            windReport.summary.avgSpeed, windReport.summary.avgDirection,
+                            windReport.summary.gust, windReport.summary.lull);
 
-                Logger.info(LOG_TAG_SYSTEM, "Livestream Wind: %.1f m/s at %.0f°", windSpeed, windDirection);
+                // Averaged periods are never superseded; they wait in order for the wind dispatch
+                queuePendingWind(windReport.summary);
+                httpClient.requestOutbound(OutboundScheduler::WIND);
+            }
+            else
+            {
+                Logger.info(LOG_TAG_SYSTEM, "Livestream Wind: %.1f m/s at %.0f°",
+                            windReport.summary.avgSpeed, windReport.summary.avgDirection);
 
-                // Send wind data to server
-                if (httpClient.sendWindData(DEVICE_ID, windSpeed, windDirection))
+                // Buffered until the batch is due; readings that wait for dispatch are sent together.
+                // A full batch is never sent from here, that would wait for the request in flight:
+                // the oldest reading gives way and the wind dispatch sends the rest.
+                if (!windBatch.add(windReport.summary.avgSpeed, windReport.summary.avgDirection, windReport.takenAtMs))
                 {
-                    Logger.info(LOG_TAG_SYSTEM, "Livestream wind data sent successfully");
-                }
-                else
-                {
-                    Logger.warn(LOG_TAG_SYSTEM, "Failed to send livestream wind data");
+                    Logger.warn(LOG_TAG_SYSTEM, "Wind batch full while waiting for dispatch, dropped the oldest reading");
+                    windBatch.dropOldest();
+                    windBatch.add(windReport.summary.avgSpeed, windReport.summary.avgDirection, windReport.takenAtMs);
+                    httpClient.requestOutbound(OutboundScheduler::WIND);
                 }
             }
         }
-        else
+
+        WindAggregateEntry aggregate;
+        while (windSamplingTask.receiveAggregate(aggregate))
         {
-            // --- LOW-POWER AVERAGED MODE ---
-            if (!isSamplingWind)
+            Logger.info(LOG_TAG_SYSTEM, "%u min Wind: %.1f m/s at %.0f° (gust %.1f, lull %.1f)",
+                        aggregate.levelMinutes, aggregate.aggregate.avgSpeed, aggregate.aggregate.avgDirection,
+                        aggregate.aggregate.gust, aggregate.aggregate.lull);
+            if (!pendingWindAggregates.add(aggregate))
             {
-                // Start a new sampling period if one isn't running
-                Logger.info(LOG_TAG_SYSTEM, "Starting %lu-second wind sampling period.", dynamicWindInterval / 1000);
-                windSensor.startSamplingPeriod();
-                isSamplingWind = true;
+                Logger.warn(LOG_TAG_SYSTEM, "Wind aggregates waited too long, dropped the oldest");
             }
+            httpClient.requestOutbound(OutboundScheduler::AGGREGATES);
+        }
 
-            // Check if the sampling period is complete.
-            // getAveragedWindData is non-blocking and returns true only when data is ready.
-            float avgSpeed, avgDirection;
-            if (windSensor.getAveragedWindData(dynamicWindInterval, avgSpeed, avgDirection))
-            {
-                Logger.info(LOG_TAG_SYSTEM, "Averaged Wind: %.1f m/s at %.0f°", avgSpeed, avgDirection);
-
-                // Send the averaged data to the server
-                if (httpClient.sendWindData(DEVICE_ID, avgSpeed, avgDirection))
-                {
-                    Logger.info(LOG_TAG_SYSTEM, "Averaged wind data sent successfully");
-                }
-                else
-                {
-                    Logger.warn(LOG_TAG_SYSTEM, "Failed to send averaged wind data");
-                }
-
-                // Reset the flag to start a new sampling period on the next cycle
-                isSamplingWind = false;
-            }
+        // Offline, batches are filled up so that each queued record holds as many readings as possible
+        uint8_t windBatchTarget = isOnline ? (uint8_t)min(dynamicWindBatchSize, (unsigned long)WindSampleBatch::CAPACITY)
+                                           : (uint8_t)WindSampleBatch::CAPACITY;
+        if (!httpClient.isOutboundPending(OutboundScheduler::WIND) &&
+            windBatch.shouldFlush(millis(), windBatchTarget,
+                                  isOnline ? WIND_BATCH_MAX_AGE_MS : TELEMETRY_QUEUE_OFFLINE_BATCH_AGE_MS))
+        {
+            httpClient.requestOutbound(OutboundScheduler::WIND);
         }
 
         // Measure and send temperature data periodically
-        if (currentMillis - lastTemperatureUpdate >= dynamicTempInterval)
+        if (dueWithinFrame(currentMillis - lastTemperatureUpdate, dynamicTempInterval))
         {
             // Check if we need to start a new temperature conversion
             if (!tempConversionStarted)
@@ -620,15 +687,10 @@ void loop()
                     Logger.info(LOG_TAG_SYSTEM, "Temperature readings - Internal: %.2f°C, External: %.2f°C",
                                 internalTemp, externalTemp);
 
-                    // Send external temperature data to server (internal temp is sent in diagnostics)
-                    if (httpClient.sendTemperatureData(DEVICE_ID, internalTemp, externalTemp))
-                    {
-                        Logger.info(LOG_TAG_SYSTEM, "Temperature data sent successfully");
-                    }
-                    else
-                    {
-                        Logger.warn(LOG_TAG_SYSTEM, "Failed to send temperature data");
-                    }
+                    // External temperature goes to the server (internal temp is sent in diagnostics)
+                    pendingInternalTemp = internalTemp;
+                    pendingExternalTemp = externalTemp;
+                    httpClient.requestOutbound(OutboundScheduler::TEMPERATURE);
 
                     lastTemperatureUpdate = currentMillis;
                 }
@@ -658,15 +720,10 @@ void loop()
                 Logger.info(LOG_TAG_SYSTEM, "Temperature readings - Internal: %.2f°C, External: %.2f°C",
                             internalTemp, externalTemp);
 
-                // Send external temperature data to server (internal temp is sent in diagnostics)
-                if (httpClient.sendTemperatureData(DEVICE_ID, internalTemp, externalTemp))
-                {
-                    Logger.info(LOG_TAG_SYSTEM, "Temperature data sent successfully");
-                }
-                else
-                {
-                    Logger.warn(LOG_TAG_SYSTEM, "Failed to send temperature data");
-                }
+                // External temperature goes to the server (internal temp is sent in diagnostics)
+                pendingInternalTemp = internalTemp;
+                pendingExternalTemp = externalTemp;
+                httpClient.requestOutbound(OutboundScheduler::TEMPERATURE);
             }
             else if (currentMillis - tempConversionStartTime > 200)
             {
@@ -675,6 +732,20 @@ void loop()
                 tempConversionStarted = false;
             }
         }
+
+        // Send the telemetry frame once complete or its window has passed
+        if (httpClient.isFrameDue() && !httpClient.isOutboundPending(OutboundScheduler::FRAME))
+        {
+            httpClient.requestOutbound(OutboundScheduler::FRAME);
+        }
+
+        // Replay telemetry queued while offline, a few records per dispatch to keep the loop responsive
+        if (isOnline && !telemetryQueue.isEmpty() && !httpClient.isOutboundPending(OutboundScheduler::REPLAY))
+        {
+            httpClient.requestOutbound(OutboundScheduler::REPLAY);
+        }
+
+        dispatchOutbound();
     }
     else
     {
@@ -684,8 +755,8 @@ void loop()
         // For now, we'll keep it simple.
     }
 
-    // Small delay to prevent excessive looping
-    delay(100);
+    // Small delay to prevent excessive looping; shorter while a request is in flight
+    delay(httpClient.isRequestInFlight() ? HTTP_ASYNC_POLL_INTERVAL_MS : 100);
 }
 
 /**
@@ -741,6 +812,10 @@ void handleOfflineSafetyMechanisms(unsigned long currentMillis, bool isOnline)
                 Logger.error(LOG_TAG_SYSTEM, "SAFETY: Emergency recovery mode: %s", emergencyRecoveryMode ? "true" : "false");
                 Logger.error(LOG_TAG_SYSTEM, "SAFETY: HTTP throttled: %s", httpClient.isConnectionThrottled() ? "true" : "false");
 
+                // Queued in flash, replayed after the restart
+                httpClient.setAsync(false);
+                sendAllPendingWind();
+                httpClient.flushFrame(DEVICE_ID);
                 delay(1000);   // Give time for logs to be sent to serial
                 ESP.restart(); // Force complete system restart
                 return;        // This line won't be reached, but good practice
@@ -786,120 +861,533 @@ void handleOfflineSafetyMechanisms(unsigned long currentMillis, bool isOnline)
 }
 
 /**
- * @brief Fetches and applies remote configuration and handles remote OTA requests.
+ * @brief Handles commands typed on the serial console.
  *
- * This function centralizes the logic for updating the device's configuration
- * from the remote server. It also checks for a remote OTA flag and initiates
- * the OTA process if requested.
+ * Reads whatever is buffered without blocking and executes complete lines:
+ * "calibrate" starts the wind vane calibration wizard, "cancel" aborts it.
+ * This lets a field technician recalibrate without reflashing the station.
  */
-void handleRemoteConfiguration()
+void handleSerialCommands()
 {
-    Logger.info(LOG_TAG_SYSTEM, "Fetching remote configuration...");
+    static char line[32];
+    static size_t length = 0;
 
-    // Initialize variables with current values to detect if they were updated
-    unsigned long tempInterval = dynamicTempInterval;
-    unsigned long windInterval = dynamicWindInterval;
-    unsigned long windSampleInterval = dynamicWindSampleInterval;
-    unsigned long diagInterval = dynamicDiagInterval;
-    unsigned long timeInterval = dynamicTimeInterval;
-    unsigned long restartInterval = 0; // We ignore this value but keep it for API compatibility
-    int sleepStartHour = dynamicSleepStartHour;
-    int sleepEndHour = dynamicSleepEndHour;
-    int otaHour = dynamicOtaHour;
-    int otaMinute = dynamicOtaMinute;
-    int otaDuration = dynamicOtaDuration;
-    bool remoteOtaRequested = false; // Flag to check for remote OTA
-
-    Logger.debug(LOG_TAG_SYSTEM, "Before fetch - tempInterval: %lu, windInterval: %lu, windSampleInterval: %lu",
-                 tempInterval, windInterval, windSampleInterval);
-
-    if (httpClient.fetchConfiguration(DEVICE_ID, &tempInterval, &windInterval, &windSampleInterval, &diagInterval,
-                                      &timeInterval, &restartInterval, &sleepStartHour, &sleepEndHour,
-                                      &otaHour, &otaMinute, &otaDuration, &remoteOtaRequested))
-    {
-        Logger.debug(LOG_TAG_SYSTEM, "After fetch - tempInterval: %lu, windInterval: %lu, windSampleInterval: %lu",
-                     tempInterval, windInterval, windSampleInterval);
-
-        // Apply configuration if values are valid (non-zero)
-        if (tempInterval > 0)
+    while (Serial.available() > 0)
+    {
+        char c = (char)Serial.read();
+        if (c != '\n' && c != '\r')
         {
-            dynamicTempInterval = tempInterval;
-            Logger.info(LOG_TAG_SYSTEM, "Updated temperature interval to %lu ms", dynamicTempInterval);
+            if (length < sizeof(line) - 1)
+            {
+                line[length++] = c;
+            }
+            continue;
         }
 
-        if (windInterval > 0)
+        if (length == 0)
         {
-            dynamicWindInterval = windInterval;
-            Logger.info(LOG_TAG_SYSTEM, "Updated wind send interval to %lu ms", dynamicWindInterval);
+            continue;
         }
+        line[length] = '\0';
+        length = 0;
 
-        if (windSampleInterval > 0)
+        if (strcmp(line, "calibrate") == 0)
         {
-            dynamicWindSampleInterval = windSampleInterval;
-            windSensor.setSampleInterval(dynamicWindSampleInterval);
-            Logger.info(LOG_TAG_SYSTEM, "Updated wind sample interval to %lu ms", dynamicWindSampleInterval);
+            WindSensorLock lock(windSamplingTask);
+            windSensor.startVaneCalibration(CALIBRATION_TIME);
         }
-
-        if (diagInterval > 0)
+        else if (strcmp(line, "cancel") == 0)
         {
-            dynamicDiagInterval = diagInterval;
-            diagnosticsManager.setInterval(dynamicDiagInterval);
-            Logger.info(LOG_TAG_SYSTEM, "Updated diagnostics interval to %lu ms", dynamicDiagInterval);
+            WindSensorLock lock(windSamplingTask);
+            windSensor.cancelVaneCalibration();
         }
+        else if (strcmp(line, "bench") == 0)
+        {
+            runHttpTransportBenchmark(DEVICE_ID, HTTP_BENCHMARK_ROUNDS);
+        }
+        else
+        {
+            Logger.warn(LOG_TAG_SYSTEM, "Unknown command '%s' (available: calibrate, cancel, bench)", line);
+        }
+    }
+}
+
+/**
+ * @brief Sends the buffered livestream readings, if any.
+ *
+ * Called when the batch is due, and before a restart or deep sleep. A
+ * failed batch is cleared like a failed single reading (the offline queue
+ * keeps it if enabled), so the buffer never holds readings older than one flush.
+ *
+ * @return false if the readings could not be sent
+ */
+bool flushWindBatch()
+{
+    if (windBatch.isEmpty())
+    {
+        return true;
+    }
 
-        if (timeInterval > 0)
+    bool sent;
+    if (windBatch.size() == 1)
+    {
+        // A lone reading goes to the single reading endpoint, as with a batch size of 1
+        const WindSample &sample = windBatch.at(0);
+        sent = httpClient.sendWindData(DEVICE_ID, sample.speed, sample.direction);
+        if (sent)
+        {
+            Logger.info(LOG_TAG_SYSTEM, "Livestream wind data %s", httpClient.describeLastSend());
+        }
+        else
+        {
+            Logger.warn(LOG_TAG_SYSTEM, "Failed to send livestream wind data");
+        }
+    }
+    else
+    {
+        sent = httpClient.sendWindBatch(DEVICE_ID, windBatch);
+        if (sent)
+        {
+            Logger.info(LOG_TAG_SYSTEM, "Batch of %u wind readings %s", windBatch.size(), httpClient.describeLastSend());
+        }
+        else
         {
-            dynamicTimeInterval = timeInterval;
-            Logger.info(LOG_TAG_SYSTEM, "Updated time update interval to %lu ms", dynamicTimeInterval);
+            Logger.warn(LOG_TAG_SYSTEM, "Failed to send batch of %u wind readings", windBatch.size());
         }
+    }
+    windBatch.clear();
+    return sent;
+}
 
-        // Note: restartInterval is received from server for API compatibility but ignored
-        // We use a fixed uptime-based restart (UPTIME_RESTART_INTERVAL) instead
-        if (restartInterval > 0)
+/**
+ * @brief Keep an averaged wind period until the wind dispatch sends it
+ *
+ * When WIND_SUMMARY_PENDING_MAX periods already wait, the oldest moves to the
+ * offline queue (or is dropped without one) instead of being sent here, so
+ * the sampling loop never blocks on the network.
+ */
+void queuePendingWind(const WindSummary &summary)
+{
+    if (pendingWindSummaryCount == WIND_SUMMARY_PENDING_MAX)
+    {
+        static char json[JsonPayloads::WIND_SUMMARY_MAX];
+        size_t length = JsonPayloads::writeWindSummary(json, sizeof(json), pendingWindSummaries[0]);
+        if (telemetryQueue.isReady() && length > 0 &&
+            telemetryQueue.push(TelemetryQueueRecord::WIND_SUMMARY, json, length))
+        {
+            Logger.warn(LOG_TAG_SYSTEM, "Averaged wind period waited too long, moved to the offline queue");
+        }
+        else
         {
-            Logger.info(LOG_TAG_SYSTEM, "Received restart interval %lu seconds from server (ignored - using fixed uptime restart)", restartInterval);
+            Logger.warn(LOG_TAG_SYSTEM, "Averaged wind period waited too long, dropped");
         }
+        pendingWindSummaryCount--;
+        memmove(&pendingWindSummaries[0], &pendingWindSummaries[1],
+                pendingWindSummaryCount * sizeof(WindSummary));
+    }
+    pendingWindSummaries[pendingWindSummaryCount++] = summary;
+}
 
-        if (sleepStartHour >= 0 && sleepStartHour < 24)
+/**
+ * @brief Send the oldest waiting averaged wind period, or the buffered livestream readings
+ *
+ * One period is sent per call; if more wind waits, it is requested again
+ * so the rest goes out on a later dispatch, within the dispatch budget.
+ * With async HTTP only one request is started; the readings then wait for
+ * the next wind dispatch.
+ *
+ * @return false if the period or readings could not be sent
+ */
+bool sendPendingWind()
+{
+    if (pendingWindSummaryCount > 0)
+    {
+        WindSummary summary = pendingWindSummaries[0];
+        pendingWindSummaryCount--;
+        memmove(&pendingWindSummaries[0], &pendingWindSummaries[1],
+                pendingWindSummaryCount * sizeof(WindSummary));
+
+        bool sent = httpClient.sendWindData(DEVICE_ID, summary);
+        if (sent)
+        {
+            Logger.info(LOG_TAG_SYSTEM, "Averaged wind data %s",
+                        httpClient.describeLastSend());
+        }
+        else
         {
-            dynamicSleepStartHour = sleepStartHour;
-            Logger.info(LOG_TAG_SYSTEM, "Updated sleep start hour to %d", dynamicSleepStartHour);
+            Logger.warn(LOG_TAG_SYSTEM, "Failed to send averaged wind data");
         }
+        if (pendingWindSummaryCount > 0 || !windBatch.isEmpty())
+        {
+            httpClient.requestOutbound(OutboundScheduler::WIND);
+        }
+        return sent;
+    }
+    if (httpClient.isRequestInFlight())
+    {
+        return true;
+    }
+    return flushWindBatch();
+}
 
-        if (sleepEndHour >= 0 && sleepEndHour < 24)
+/**
+ * @brief Send every waiting averaged wind period, the buffered readings and the wind aggregates
+ *
+ * For a restart or deep sleep, with async HTTP switched off.
+ */
+void sendAllPendingWind()
+{
+    while (pendingWindSummaryCount > 0 || !windBatch.isEmpty())
+    {
+        sendPendingWind();
+    }
+    sendPendingAggregates();
+}
+
+/**
+ * @brief Send the completed 1 min and 10 min buckets in one request
+ *
+ * The buckets are cleared like a sent batch; if the upload fails the
+ * offline queue keeps them, if enabled.
+ *
+ * @return false if they could not be sent
+ */
+bool sendPendingAggregates()
+{
+    if (pendingWindAggregates.isEmpty())
+    {
+        return true;
+    }
+
+    bool sent = httpClient.sendWindAggregates(DEVICE_ID, pendingWindAggregates);
+    if (sent)
+    {
+        Logger.info(LOG_TAG_SYSTEM, "%u wind aggregates %s", pendingWindAggregates.size(),
+                    httpClient.describeLastSend());
+    }
+    else
+    {
+        Logger.warn(LOG_TAG_SYSTEM, "Failed to send %u wind aggregates", pendingWindAggregates.size());
+    }
+    pendingWindAggregates.clear();
+    return sent;
+}
+
+/**
+ * @brief Send one class of outbound work with the newest data waiting for it
+ *
+ * @return true if it was delivered (or staged for a frame)
+ */
+bool sendOutbound(OutboundScheduler::Class cls)
+{
+    switch (cls)
+    {
+    case OutboundScheduler::WIND:
+        return sendPendingWind();
+
+    case OutboundScheduler::CONFIG:
+        return handleRemoteConfiguration();
+
+    case OutboundScheduler::FRAME:
+        return httpClient.flushFrame(DEVICE_ID);
+
+    case OutboundScheduler::TEMPERATURE:
+        if (httpClient.sendTemperatureData(DEVICE_ID, pendingInternalTemp, pendingExternalTemp))
         {
-            dynamicSleepEndHour = sleepEndHour;
-            Logger.info(LOG_TAG_SYSTEM, "Updated sleep end hour to %d", dynamicSleepEndHour);
+            Logger.info(LOG_TAG_SYSTEM, "Temperature data %s",
+                        httpClient.describeLastSend());
+            return true;
         }
+        Logger.warn(LOG_TAG_SYSTEM, "Failed to send temperature data");
+        return false;
+
+    case OutboundScheduler::DIAGNOSTICS:
+        return diagnosticsManager.sendDiagnostics(pendingDiagnosticsInternalTemp, pendingDiagnosticsExternalTemp);
+
+    case OutboundScheduler::AGGREGATES:
+        return sendPendingAggregates();
+
+    case OutboundScheduler::REPLAY:
+        return httpClient.drainOfflineQueue(DEVICE_ID, TELEMETRY_QUEUE_DRAIN_BATCH) > 0;
+
+    default:
+        return false;
+    }
+}
 
-        if (otaHour >= 0 && otaHour < 24)
+/**
+ * @brief Send the pending outbound work, earliest deadline first
+ *
+ * Stops starting new requests once the pass has used OUTBOUND_DISPATCH_BUDGET_MS,
+ * so one slow request on a degraded link does not hold the loop; the rest keeps
+ * its place and goes out on the next pass, most urgent first. With async HTTP
+ * a pass starts at most one request and the next waits until it has finished.
+ */
+void dispatchOutbound()
+{
+    unsigned long startMs = millis();
+    OutboundScheduler::Class cls;
+    while (!httpClient.isRequestInFlight() && millis() - startMs < OUTBOUND_DISPATCH_BUDGET_MS &&
+           httpClient.nextOutbound(cls))
+    {
+        httpClient.beginOutbound(cls);
+        bool delivered = sendOutbound(cls);
+        if (httpClient.isRequestInFlight())
         {
-            dynamicOtaHour = otaHour;
-            Logger.info(LOG_TAG_SYSTEM, "Updated OTA hour to %d", dynamicOtaHour);
+            // Its outcome arrives in onRequestDone()
+            outboundInFlight = true;
+            inFlightClass = cls;
+            return;
         }
+        httpClient.completeOutbound(cls, delivered);
+    }
+}
+
+/**
+ * @brief Outcome of each telemetry send, from the HTTP client
+ *
+ * Only async sends started by dispatchOutbound() are still open here; the
+ * others were completed when their send returned.
+ */
+void onRequestDone(bool delivered)
+{
+    if (outboundInFlight)
+    {
+        outboundInFlight = false;
+        httpClient.completeOutbound(inFlightClass, delivered);
+    }
+}
 
-        if (otaMinute >= 0 && otaMinute < 60)
+/**
+ * @brief Whether a periodic reading is due, or will be before the open telemetry frame is sent
+ *
+ * Taking a reading early to ride along in the frame saves it a request of its
+ * own, and keeps the intervals aligned so later readings coalesce as well.
+ */
+bool dueWithinFrame(unsigned long sinceLast, unsigned long interval)
+{
+    return sinceLast + httpClient.getFrameTimeLeft() >= interval;
+}
+
+/**
+ * @brief Applies a remote configuration to the running station.
+ *
+ * Only fields within their valid range are applied; fields the server did
+ * not send keep the current setting.
+ */
+void applyStationConfig(const StationConfig &config)
+{
+    // Apply configuration if values are valid (non-zero)
+    if (config.tempInterval > 0)
+    {
+        dynamicTempInterval = config.tempInterval;
+        Logger.info(LOG_TAG_SYSTEM, "Updated temperature interval to %lu ms", dynamicTempInterval);
+    }
+
+    if (config.windSendInterval > 0)
+    {
+        dynamicWindInterval = config.windSendInterval;
+        windSamplingTask.setSendInterval(dynamicWindInterval);
+        Logger.info(LOG_TAG_SYSTEM, "Updated wind send interval to %lu ms", dynamicWindInterval);
+    }
+
+    if (config.windBatchSize > 0)
+    {
+        dynamicWindBatchSize = min(config.windBatchSize, (unsigned long)WindSampleBatch::CAPACITY);
+        Logger.info(LOG_TAG_SYSTEM, "Updated wind batch size to %lu readings", dynamicWindBatchSize);
+        if (dynamicWindBatchSize <= 1 && !windBatch.isEmpty())
         {
-            dynamicOtaMinute = otaMinute;
-            Logger.info(LOG_TAG_SYSTEM, "Updated OTA minute to %d", otaMinute);
+            // Readings buffered under the previous size go with the next wind dispatch
+            httpClient.requestOutbound(OutboundScheduler::WIND);
         }
+    }
 
-        if (otaDuration > 0)
+    if (config.coapTelemetry >= 0)
+    {
+#ifdef HTTP_ASYNC
+        httpClient.setCoapTelemetry(config.coapTelemetry == 1);
+#else
+        // Without async HTTP a CoAP exchange holds the loop for up to 21 s
+        if (config.coapTelemetry == 1)
         {
-            dynamicOtaDuration = otaDuration;
-            Logger.info(LOG_TAG_SYSTEM, "Updated OTA duration to %d minutes", dynamicOtaDuration);
+            Logger.warn(LOG_TAG_SYSTEM, "Remote CoAP telemetry ignored: firmware built without HTTP_ASYNC");
         }
+        else
+        {
+            httpClient.setCoapTelemetry(false);
+        }
+#endif
+    }
+
+    if (config.windSampleInterval > 0)
+    {
+        dynamicWindSampleInterval = config.windSampleInterval;
+        WindSensorLock lock(windSamplingTask);
+        windSensor.setSampleInterval(dynamicWindSampleInterval);
+        Logger.info(LOG_TAG_SYSTEM, "Updated wind sample interval to %lu ms", dynamicWindSampleInterval);
+    }
 
-        // Check for remote OTA flag after config update
-        if (!otaActive && remoteOtaRequested)
+    if (config.diagInterval > 0)
+    {
+        dynamicDiagInterval = config.diagInterval;
+        diagnosticsManager.setInterval(dynamicDiagInterval);
+        Logger.info(LOG_TAG_SYSTEM, "Updated diagnostics interval to %lu ms", dynamicDiagInterval);
+    }
+
+    if (config.timeInterval > 0)
+    {
+        dynamicTimeInterval = config.timeInterval;
+        Logger.info(LOG_TAG_SYSTEM, "Updated time update interval to %lu ms", dynamicTimeInterval);
+    }
+
+    // Note: restartInterval is received from server for API compatibility but ignored
+    // We use a fixed uptime-based restart (UPTIME_RESTART_INTERVAL) instead
+    if (config.restartInterval > 0)
+    {
+        Logger.info(LOG_TAG_SYSTEM, "Received restart interval %lu seconds from server (ignored - using fixed uptime restart)", config.restartInterval);
+    }
+
+    if (config.sleepStartHour >= 0 && config.sleepStartHour < 24)
+    {
+        dynamicSleepStartHour = config.sleepStartHour;
+        Logger.info(LOG_TAG_SYSTEM, "Updated sleep start hour to %d", dynamicSleepStartHour);
+    }
+
+    if (config.sleepEndHour >= 0 && config.sleepEndHour < 24)
+    {
+        dynamicSleepEndHour = config.sleepEndHour;
+        Logger.info(LOG_TAG_SYSTEM, "Updated sleep end hour to %d", dynamicSleepEndHour);
+    }
+
+    if (config.otaHour >= 0 && config.otaHour < 24)
+    {
+        dynamicOtaHour = config.otaHour;
+        Logger.info(LOG_TAG_SYSTEM, "Updated OTA hour to %d", dynamicOtaHour);
+    }
+
+    if (config.otaMinute >= 0 && config.otaMinute < 60)
+    {
+        dynamicOtaMinute = config.otaMinute;
+        Logger.info(LOG_TAG_SYSTEM, "Updated OTA minute to %d", dynamicOtaMinute);
+    }
+
+    if (config.otaDuration > 0)
+    {
+        dynamicOtaDuration = config.otaDuration;
+        Logger.info(LOG_TAG_SYSTEM, "Updated OTA duration to %d minutes", dynamicOtaDuration);
+    }
+
+    // Recalibrate the wind vane without a firmware rebuild
+    if (config.vaneCalibrationReceived)
+    {
+        WindSensorLock lock(windSamplingTask);
+        windSensor.applyVaneCalibration(config.vaneCalibration);
+    }
+}
+
+/**
+ * @brief Applies the configuration stored with its ETag before the last restart.
+ *
+ * Runs early in setup(), so the components started afterwards pick up the
+ * stored intervals and schedule, and the first fetch can be answered with 304.
+ */
+void restoreStoredConfiguration()
+{
+    StationConfig config;
+    if (!ConfigStore::load(config, configEtag, sizeof(configEtag)))
+    {
+        Logger.info(LOG_TAG_SYSTEM, "No stored configuration, using defaults");
+        return;
+    }
+
+    Logger.info(LOG_TAG_SYSTEM, "Restoring stored configuration (ETag %s)", configEtag);
+
+    // The vane calibration has its own NVS record, loaded by the wind sensor
+    config.vaneCalibrationReceived = false;
+    applyStationConfig(config);
+}
+
+/**
+ * @brief Whether telemetry announced a config version that has not been fetched.
+ *
+ * The version equals the ETag of the configuration, so a matching configEtag
+ * means the configuration in effect is current. A version already fetched is
+ * not fetched again, which covers a cleared configEtag (pending remote OTA).
+ */
+bool configVersionChanged()
+{
+    const char *announced = httpClient.getConfigVersionHint();
+    return announced[0] != '\0' && strcmp(announced, configEtag) != 0 && strcmp(announced, fetchedConfigVersion) != 0;
+}
+
+/**
+ * @brief Interval of the periodic configuration fetch.
+ *
+ * While telemetry responses carry version hints a change is picked up with
+ * the next upload, so polling is only a fallback. Without hints (older
+ * server) or without a known ETag (pending remote OTA) the configuration is
+ * polled as before.
+ */
+unsigned long configPollInterval()
+{
+    if (httpClient.getConfigVersionHint()[0] != '\0' && configEtag[0] != '\0')
+    {
+        return CONFIG_VERSION_POLL_INTERVAL;
+    }
+    return DEFAULT_CONFIG_UPDATE_INTERVAL;
+}
+
+/**
+ * @brief Fetches and applies remote configuration and handles remote OTA requests.
+ *
+ * This function centralizes the logic for updating the device's configuration
+ * from the remote server. It also checks for a remote OTA flag and initiates
+ * the OTA process if requested.
+ *
+ * @return true if the configuration was fetched (including an unchanged one)
+ */
+bool handleRemoteConfiguration()
+{
+    Logger.info(LOG_TAG_SYSTEM, "Fetching remote configuration...");
+
+    // Fields the server does not send stay at their "not received" values and are skipped below
+    StationConfig config;
+    bool notModified = false;
+
+    bool fetched = httpClient.fetchConfiguration(DEVICE_ID, config, configEtag, sizeof(configEtag), &notModified);
+    if (fetched)
+    {
+        // The announced version is handled, whatever the outcome below
+        strlcpy(fetchedConfigVersion, httpClient.getConfigVersionHint(), sizeof(fetchedConfigVersion));
+
+        // On 304 the configuration in effect is still current; nothing to apply
+        if (!notModified)
         {
-            Logger.info(LOG_TAG_SYSTEM, "Remote OTA flag detected, attempting to start remote OTA...");
-            if (checkAndInitRemoteOta())
+            Logger.debug(LOG_TAG_SYSTEM, "After fetch - tempInterval: %lu, windInterval: %lu, windSampleInterval: %lu",
+                         config.tempInterval, config.windSendInterval, config.windSampleInterval);
+
+            applyStationConfig(config);
+
+            // Check for remote OTA flag after config update
+            bool remoteOtaStarted = false;
+            if (!otaActive && config.remoteOta)
             {
-                // If OTA started successfully, confirm with the server to clear the flag
-                Logger.info(LOG_TAG_SYSTEM, "Remote OTA started, confirming with server.");
-                httpClient.confirmOtaStarted(DEVICE_ID);
+                Logger.info(LOG_TAG_SYSTEM, "Remote OTA flag detected, attempting to start remote OTA...");
+                remoteOtaStarted = checkAndInitRemoteOta();
+                if (remoteOtaStarted)
+                {
+                    // If OTA started successfully, confirm with the server to clear the flag
+                    Logger.info(LOG_TAG_SYSTEM, "Remote OTA started, confirming with server.");
+                    httpClient.confirmOtaStarted(DEVICE_ID);
+                }
+            }
+            if (config.remoteOta && !remoteOtaStarted)
+            {
+                // A 304 would hide the pending request; fetch the full configuration next time
+                configEtag[0] = '\0';
             }
+
+            ConfigStore::save(config, configEtag);
         }
 
         // Check for sleep time after configuration update
@@ -912,12 +1400,12 @@ void handleRemoteConfiguration()
             Logger.info(LOG_TAG_SYSTEM, "Sleep time detected after config update. Entering deep sleep...");
             enterDeepSleepUntil(dynamicSleepEndHour, 0);
             // Note: This will cause the device to restart, so execution won't continue past this point
-            return;
+            return fetched;
         }
     }
     else
     {
-        Logger.warn(LOG_TAG_SYSTEM, "Failed to fetch remote configuration. Using default values.");
+        Logger.warn(LOG_TAG_SYSTEM, "Failed to fetch remote configuration. Keeping the current configuration.");
 
         // Still check for sleep time even if config fetch failed
         bool sleepTimeCheck = isSleepTime();
@@ -929,9 +1417,11 @@ void handleRemoteConfiguration()
             Logger.info(LOG_TAG_SYSTEM, "Sleep time detected after failed config fetch. Entering deep sleep...");
             enterDeepSleepUntil(dynamicSleepEndHour, 0);
             // Note: This will cause the device to restart, so execution won't continue past this point
-            return;
+            return fetched;
         }
     }
+
+    return fetched;
 }
 
 /**
@@ -1075,6 +1565,11 @@ void enterDeepSleepUntil(int hour, int minute)
                 currentHour, currentMinute, currentSecond, hour, minute);
     Logger.info(LOG_TAG_SYSTEM, "Sleeping for %d seconds (%.1f hours)", sleepSeconds, sleepSeconds / 3600.0);
 
+    // Send buffered wind data and the open frame while the modem is still up
+    httpClient.setAsync(false);
+    sendAllPendingWind();
+    httpClient.flushFrame(DEVICE_ID);
+
     // Disconnect GPRS to save power before sleeping
     modemManager.maintainConnection(false);
 
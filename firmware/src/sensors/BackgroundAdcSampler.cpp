@@ -0,0 +1,81 @@
+/**
+ * @file BackgroundAdcSampler.cpp
+ * @brief Implementation of the background wind vane ADC sampler
+ */
+
+#include "BackgroundAdcSampler.h"
+#include "../core/Logger.h"
+
+#define LOG_TAG_WIND "WIND"
+
+BackgroundAdcSampler::BackgroundAdcSampler(uint32_t samplePeriodMs)
+    : _samplePeriodMs(samplePeriodMs > 0 ? samplePeriodMs : 1)
+{
+}
+
+void BackgroundAdcSampler::_onTimer(void *arg)
+{
+    BackgroundAdcSampler *self = static_cast<BackgroundAdcSampler *>(arg);
+
+    // Runs in the esp_timer task, not in an ISR, so analogRead() is allowed
+    uint16_t sample = analogRead(self->_pin);
+    self->_filter.push(sample);
+
+    self->_raw.store(sample, std::memory_order_release);
+    self->_filtered.store(self->_filter.value(), std::memory_order_release);
+    self->_sampleCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool BackgroundAdcSampler::begin(uint8_t pin)
+{
+    if (_timer)
+    {
+        return true;
+    }
+
+    _pin = pin;
+    _filter.reset();
+    _filtered.store(-1);
+    _raw.store(-1);
+    _sampleCount.store(0);
+
+    // Take the first sample synchronously so readers have a value right away
+    _onTimer(this);
+
+    esp_timer_create_args_t args = {};
+    args.callback = &BackgroundAdcSampler::_onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "vane_adc";
+
+    if (esp_timer_create(&args, &_timer) != ESP_OK)
+    {
+        Logger.error(LOG_TAG_WIND, "Failed to create wind vane sampling timer");
+        _timer = nullptr;
+        return false;
+    }
+
+    if (esp_timer_start_periodic(_timer, (uint64_t)_samplePeriodMs * 1000ULL) != ESP_OK)
+    {
+        Logger.error(LOG_TAG_WIND, "Failed to start wind vane sampling timer");
+        esp_timer_delete(_timer);
+        _timer = nullptr;
+        return false;
+    }
+
+    Logger.info(LOG_TAG_WIND, "Wind vane sampled in background every %lu ms (%u sample average)",
+                (unsigned long)_samplePeriodMs, FILTER_SAMPLES);
+    return true;
+}
+
+void BackgroundAdcSampler::end()
+{
+    if (!_timer)
+    {
+        return;
+    }
+
+    esp_timer_stop(_timer);
+    esp_timer_delete(_timer);
+    _timer = nullptr;
+}
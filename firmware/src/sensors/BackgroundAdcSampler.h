@@ -0,0 +1,58 @@
+/**
+ * @file BackgroundAdcSampler.h
+ * @brief Timer driven background sampling of the wind vane ADC
+ *
+ * An esp_timer callback takes one ADC sample every period and pushes it
+ * through a moving average. The filtered value is published atomically, so
+ * readers never block and never touch the ADC themselves.
+ *
+ * ADC1 is shared with the battery and solar voltage pins, which are read
+ * with analogRead(). The continuous (I2S DMA) ADC mode on the ESP32 claims
+ * all of ADC1, so single conversions from a timer are used instead.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include "VaneAdcSource.h"
+
+class BackgroundAdcSampler : public VaneAdcSource
+{
+public:
+    static const uint8_t FILTER_SAMPLES = 8;
+
+    /**
+     * @brief Construct a background sampler
+     *
+     * @param samplePeriodMs Time between two ADC samples
+     */
+    explicit BackgroundAdcSampler(uint32_t samplePeriodMs = 10);
+
+    bool begin(uint8_t pin) override;
+    void end() override;
+    int readFiltered() override { return _filtered.load(std::memory_order_acquire); }
+    int readRaw() override { return _raw.load(std::memory_order_acquire); }
+    const char *name() const override { return "background"; }
+
+    /**
+     * @brief Number of samples taken since begin()
+     */
+    uint32_t getSampleCount() const { return _sampleCount.load(std::memory_order_relaxed); }
+
+private:
+    uint8_t _pin = 0;
+    uint32_t _samplePeriodMs;
+    esp_timer_handle_t _timer = nullptr;
+
+    // Only touched from the timer callback
+    AdcSampleFilter<FILTER_SAMPLES> _filter;
+
+    // Published to readers
+    std::atomic<int> _filtered{-1};
+    std::atomic<int> _raw{-1};
+    std::atomic<uint32_t> _sampleCount{0};
+
+    static void _onTimer(void *arg);
+};
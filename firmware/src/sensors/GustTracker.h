@@ -0,0 +1,144 @@
+/**
+ * @file GustTracker.h
+ * @brief WMO style 3 second gust and lull tracking
+ *
+ * The WMO defines a gust as the highest 3 s running mean of the wind speed,
+ * sampled at 4 Hz. The tracker receives pulse counts per tick (nominally
+ * 250 ms), keeps a sliding window of the ticks covering the last 3 s with
+ * running sums, and records the highest and lowest window mean seen since
+ * the last resetPeriod(). Every update is O(1).
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "WindMath.h"
+
+class GustTracker
+{
+public:
+    static const uint32_t GUST_WINDOW_MS = 3000; // WMO gust duration
+    static const uint32_t TICK_MS = 250;         // WMO sampling rate (4 Hz)
+
+    /**
+     * @brief Add the pulses counted during one tick
+     *
+     * @param pulses Pulses counted since the previous tick
+     * @param elapsedMs Duration of the tick in milliseconds
+     */
+    void addTick(uint32_t pulses, uint32_t elapsedMs)
+    {
+        if (elapsedMs == 0)
+        {
+            return;
+        }
+
+        // Drop the oldest tick if the ring is full (ticks much shorter than TICK_MS)
+        if (_count == MAX_TICKS)
+        {
+            evictOldest();
+        }
+
+        uint8_t index = (_first + _count) % MAX_TICKS;
+        _ticks[index].pulses = pulses;
+        _ticks[index].elapsedMs = elapsedMs;
+        _count++;
+        _windowPulses += pulses;
+        _windowMs += elapsedMs;
+
+        // Slide the window: keep the newest ticks that still cover 3 s
+        while (_count > 1 && _windowMs - _ticks[_first].elapsedMs >= GUST_WINDOW_MS)
+        {
+            evictOldest();
+        }
+
+        // Only a full window yields a 3 s mean. A single tick longer than the
+        // window (the caller was blocked) is accepted as its own mean.
+        if (_windowMs >= GUST_WINDOW_MS)
+        {
+            float mean = WindMath::pulsesToSpeed(_windowPulses, _windowMs);
+            if (!_hasPeriodValue || mean > _gust)
+            {
+                _gust = mean;
+            }
+            if (!_hasPeriodValue || mean < _lull)
+            {
+                _lull = mean;
+            }
+            _hasPeriodValue = true;
+        }
+    }
+
+    /**
+     * @brief Start a new reporting period
+     *
+     * Clears gust and lull but keeps the sliding window, so the first
+     * 3 s mean of the new period is available after the next tick.
+     */
+    void resetPeriod()
+    {
+        _hasPeriodValue = false;
+        _gust = 0.0f;
+        _lull = 0.0f;
+    }
+
+    /**
+     * @brief Forget the sliding window and the period values
+     */
+    void reset()
+    {
+        _first = 0;
+        _count = 0;
+        _windowPulses = 0;
+        _windowMs = 0;
+        resetPeriod();
+    }
+
+    /**
+     * @brief Whether at least one full 3 s window was seen this period
+     */
+    bool hasValue() const { return _hasPeriodValue; }
+
+    float gust() const { return _gust; }
+    float lull() const { return _lull; }
+
+    /**
+     * @brief Whether the sliding window currently covers a full 3 s
+     */
+    bool hasWindowMean() const { return _windowMs >= GUST_WINDOW_MS; }
+
+    /**
+     * @brief Current 3 s running mean speed (m/s)
+     */
+    float windowMean() const { return WindMath::pulsesToSpeed(_windowPulses, _windowMs); }
+
+private:
+    // 3 s at 4 Hz needs 12 ticks; leave headroom for a faster caller
+    static const uint8_t MAX_TICKS = 32;
+
+    struct Tick
+    {
+        uint32_t pulses;
+        uint32_t elapsedMs;
+    };
+
+    Tick _ticks[MAX_TICKS] = {};
+    uint8_t _first = 0;
+    uint8_t _count = 0;
+    uint32_t _windowPulses = 0;
+    uint32_t _windowMs = 0;
+
+    bool _hasPeriodValue = false;
+    float _gust = 0.0f;
+    float _lull = 0.0f;
+
+    void evictOldest()
+    {
+        _windowPulses -= _ticks[_first].pulses;
+        _windowMs -= _ticks[_first].elapsedMs;
+        _first = (_first + 1) % MAX_TICKS;
+        _count--;
+    }
+};
@@ -0,0 +1,75 @@
+/**
+ * @file IsrPulseSource.cpp
+ * @brief Implementation of the interrupt driven anemometer pulse source
+ */
+
+#include "IsrPulseSource.h"
+#include "../core/Logger.h"
+
+#define LOG_TAG_WIND "WIND"
+
+IsrPulseSource *IsrPulseSource::_instance = nullptr;
+
+IsrPulseSource::IsrPulseSource(unsigned long debounceMs) : _debounceMs(debounceMs), _debounceUs(debounceMs * 1000UL)
+{
+}
+
+// Interrupt handler for anemometer pulse counting
+void IRAM_ATTR IsrPulseSource::_handleInterrupt()
+{
+    IsrPulseSource *self = _instance;
+    if (!self)
+    {
+        return;
+    }
+
+    uint32_t interruptUs = micros();
+
+    // Debounce: ignore interrupts that occur too quickly
+    if (interruptUs - self->_lastInterruptUs > self->_debounceUs)
+    {
+        self->_pulseCount++;
+        self->_lastInterruptUs = interruptUs;
+        self->_timestamps.push(interruptUs);
+    }
+}
+
+bool IsrPulseSource::begin(uint8_t pin)
+{
+    if (_instance && _instance != this)
+    {
+        Logger.error(LOG_TAG_WIND, "Another interrupt pulse source is already active");
+        return false;
+    }
+
+    _pin = pin;
+    _pulseCount = 0;
+    _lastInterruptUs = micros() - _debounceUs - 1;
+    _instance = this;
+
+    // Configure anemometer pin with pull-up and interrupt
+    pinMode(_pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(_pin), _handleInterrupt, FALLING);
+
+    _running = true;
+    Logger.info(LOG_TAG_WIND, "Interrupt pulse counter active (debounce: %lu ms)", _debounceMs);
+    return true;
+}
+
+void IsrPulseSource::end()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    detachInterrupt(digitalPinToInterrupt(_pin));
+    _instance = nullptr;
+    _running = false;
+}
+
+uint32_t IsrPulseSource::readTotal()
+{
+    // 32-bit reads are atomic on the ESP32, no need to mask interrupts
+    return _pulseCount;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file IsrPulseSource.h
+ * @brief GPIO interrupt based anemometer pulse counting
+ *
+ * The default source, and the fallback if PCNT setup fails. Every falling
+ * edge wakes the CPU and is debounced in software, which a reed switch needs. Because
+ * every accepted pulse passes through the ISR, it is also timestamped into
+ * a lock-free ring for period based speed measurement.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "PulseSource.h"
+
+class IsrPulseSource : public PulseSource
+{
+public:
+    /**
+     * @brief Construct an interrupt driven pulse source
+     *
+     * @param debounceMs Minimum time between two accepted pulses
+     */
+    explicit IsrPulseSource(unsigned long debounceMs = 10);
+
+    bool begin(uint8_t pin) override;
+    void end() override;
+    uint32_t readTotal() override;
+    AnemometerTimestampRing *timestamps() override { return &_timestamps; }
+    const char *name() const override { return "isr"; }
+
+private:
+    uint8_t _pin = 0;
+    bool _running = false;
+    unsigned long _debounceMs;
+    uint32_t _debounceUs;
+    volatile uint32_t _pulseCount = 0;
+    volatile uint32_t _lastInterruptUs = 0;
+    AnemometerTimestampRing _timestamps;
+
+    // Only one pin can be serviced by the static interrupt handler
+    static IsrPulseSource *_instance;
+
+    static void IRAM_ATTR _handleInterrupt();
+};
@@ -0,0 +1,123 @@
+/**
+ * @file PcntPulseSource.cpp
+ * @brief Implementation of the PCNT backed anemometer pulse source
+ */
+
+#include "PcntPulseSource.h"
+#include "../core/Logger.h"
+
+#define LOG_TAG_WIND "WIND"
+
+PcntPulseSource::PcntPulseSource(pcnt_unit_t unit, uint16_t filterApbCycles)
+    : _unit(unit), _filterApbCycles(filterApbCycles > 1023 ? 1023 : filterApbCycles)
+{
+}
+
+void IRAM_ATTR PcntPulseSource::_onOverflow(void *arg)
+{
+    PcntPulseSource *self = static_cast<PcntPulseSource *>(arg);
+    self->_overflowCount++;
+}
+
+bool PcntPulseSource::begin(uint8_t pin)
+{
+    // Reed switch pulls the line low, keep the idle level defined
+    pinMode(pin, INPUT_PULLUP);
+
+    pcnt_config_t config = {};
+    config.pulse_gpio_num = pin;
+    config.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+    config.channel = PCNT_CHANNEL_0;
+    config.unit = _unit;
+    config.pos_mode = PCNT_COUNT_DIS; // Ignore rising edges
+    config.neg_mode = PCNT_COUNT_INC; // Count falling edges, same as the old ISR
+    config.lctrl_mode = PCNT_MODE_KEEP;
+    config.hctrl_mode = PCNT_MODE_KEEP;
+    config.counter_h_lim = PCNT_HIGH_LIMIT;
+    config.counter_l_lim = 0;
+
+    if (pcnt_unit_config(&config) != ESP_OK)
+    {
+        Logger.error(LOG_TAG_WIND, "PCNT unit %d configuration failed", _unit);
+        return false;
+    }
+
+    // The glitch filter ignores pulses shorter than the given number of
+    // APB cycles (80 MHz), i.e. at most ~12.8 us. It removes EMI spikes on
+    // the cable but not millisecond reed switch bounce.
+    pcnt_set_filter_value(_unit, _filterApbCycles);
+    pcnt_filter_enable(_unit);
+
+    pcnt_event_enable(_unit, PCNT_EVT_H_LIM);
+
+    // The ISR service may already be installed by another unit
+    esp_err_t err = pcnt_isr_service_install(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+    {
+        Logger.error(LOG_TAG_WIND, "PCNT ISR service install failed: %d", err);
+        return false;
+    }
+
+    if (pcnt_isr_handler_add(_unit, _onOverflow, this) != ESP_OK)
+    {
+        Logger.error(LOG_TAG_WIND, "PCNT overflow handler registration failed");
+        return false;
+    }
+
+    _overflowCount = 0;
+    _lastTotal = 0;
+
+    pcnt_counter_pause(_unit);
+    pcnt_counter_clear(_unit);
+    pcnt_counter_resume(_unit);
+
+    _running = true;
+    Logger.info(LOG_TAG_WIND, "PCNT pulse counter active on unit %d (filter: %u APB cycles)", _unit, _filterApbCycles);
+    return true;
+}
+
+void PcntPulseSource::end()
+{
+    if (!_running)
+    {
+        return;
+    }
+
+    pcnt_counter_pause(_unit);
+    pcnt_event_disable(_unit, PCNT_EVT_H_LIM);
+    pcnt_isr_handler_remove(_unit);
+    _running = false;
+}
+
+uint32_t PcntPulseSource::readTotal()
+{
+    if (!_running)
+    {
+        return _lastTotal;
+    }
+
+    int16_t count = 0;
+    uint32_t overflows;
+    uint32_t overflowsAfter;
+
+    // Re-read if the overflow ISR ran between the two reads
+    do
+    {
+        overflows = _overflowCount;
+        pcnt_get_counter_value(_unit, &count);
+        overflowsAfter = _overflowCount;
+    } while (overflows != overflowsAfter);
+
+    uint32_t total = overflows * (uint32_t)PCNT_HIGH_LIMIT + (uint32_t)count;
+
+    // The hardware clears the counter before the ISR increments
+    // _overflowCount. If we caught that window the total appears to go
+    // backwards, so account for the pending overflow here.
+    if ((int32_t)(total - _lastTotal) < 0)
+    {
+        total += PCNT_HIGH_LIMIT;
+    }
+
+    _lastTotal = total;
+    return total;
+}
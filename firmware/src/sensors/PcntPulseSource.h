@@ -0,0 +1,47 @@
+/**
+ * @file PcntPulseSource.h
+ * @brief Anemometer pulse counting on the ESP32 PCNT peripheral
+ *
+ * The pulse counter increments in hardware on every falling edge, so the
+ * CPU is not woken per pulse. The only interrupt left is the counter
+ * overflow event, which fires once every PCNT_HIGH_LIMIT pulses.
+ *
+ * Opt-in with ANEMOMETER_USE_PCNT: the glitch filter is too short for reed
+ * switch bounce, so this is for anemometers with a clean output.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/pcnt.h>
+#include "PulseSource.h"
+
+class PcntPulseSource : public PulseSource
+{
+public:
+    /**
+     * @brief Construct a PCNT pulse source
+     *
+     * @param unit PCNT unit to use (one unit per source)
+     * @param filterApbCycles Glitch filter length in APB clock cycles (max 1023)
+     */
+    explicit PcntPulseSource(pcnt_unit_t unit = PCNT_UNIT_0, uint16_t filterApbCycles = 1023);
+
+    bool begin(uint8_t pin) override;
+    void end() override;
+    uint32_t readTotal() override;
+    const char *name() const override { return "pcnt"; }
+
+private:
+    // The hardware counter is 16-bit signed; it is reset to zero at this
+    // limit and the overflow is folded into _overflowCount by the ISR.
+    static const int16_t PCNT_HIGH_LIMIT = 30000;
+
+    pcnt_unit_t _unit;
+    uint16_t _filterApbCycles;
+    bool _running = false;
+    volatile uint32_t _overflowCount = 0;
+    uint32_t _lastTotal = 0;
+
+    static void IRAM_ATTR _onOverflow(void *arg);
+};
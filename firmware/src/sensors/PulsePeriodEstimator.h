@@ -0,0 +1,118 @@
+/**
+ * @file PulsePeriodEstimator.h
+ * @brief Reciprocal (period based) wind speed from pulse timestamps
+ *
+ * Counting whole pulses in a 1 s window quantizes the speed to steps of
+ * 0.67 m/s. Measuring the time between the first and last pulse instead
+ * gives a resolution limited only by the timestamp clock.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "WindMath.h"
+
+class PulsePeriodEstimator
+{
+public:
+    /**
+     * @brief Construct an estimator
+     *
+     * @param stallTimeoutUs Silence after which the rotor is considered stopped
+     */
+    explicit PulsePeriodEstimator(uint32_t stallTimeoutUs = 5000000UL) : _stallTimeoutUs(stallTimeoutUs) {}
+
+    /**
+     * @brief Forget all pulse history, e.g. after timestamps were dropped
+     */
+    void reset()
+    {
+        _hasReference = false;
+        _pulses = 0;
+        _lastPeriodUs = 0;
+    }
+
+    /**
+     * @brief Feed the next pulse timestamp, in order of arrival
+     */
+    void addPulse(uint32_t timestampUs)
+    {
+        if (!_hasReference)
+        {
+            // The first pulse only marks the start of the first period
+            _referenceUs = timestampUs;
+            _lastUs = timestampUs;
+            _hasReference = true;
+            return;
+        }
+
+        _lastUs = timestampUs;
+        _pulses++;
+    }
+
+    /**
+     * @brief Speed over the pulses fed since the previous call
+     *
+     * With new pulses the speed is the number of periods divided by their
+     * total duration. Without new pulses the speed decays: it cannot be
+     * higher than one pulse per time since the last one.
+     *
+     * @param nowUs Current time in microseconds
+     * @return float Wind speed in m/s
+     */
+    float takeSpeed(uint32_t nowUs)
+    {
+        if (!_hasReference)
+        {
+            return 0.0f;
+        }
+
+        if (_pulses > 0)
+        {
+            uint32_t spanUs = _lastUs - _referenceUs;
+            _lastPeriodUs = spanUs / _pulses;
+            float speed = periodToSpeed(spanUs, _pulses);
+            _referenceUs = _lastUs;
+            _pulses = 0;
+            return speed;
+        }
+
+        uint32_t silenceUs = nowUs - _referenceUs;
+        if (silenceUs >= _stallTimeoutUs || _lastPeriodUs == 0)
+        {
+            return 0.0f;
+        }
+
+        return periodToSpeed(silenceUs > _lastPeriodUs ? silenceUs : _lastPeriodUs, 1);
+    }
+
+    /**
+     * @brief Duration of the most recent complete pulse period in microseconds
+     */
+    uint32_t lastPeriodUs() const { return _lastPeriodUs; }
+
+    /**
+     * @brief Convert a span of pulse periods to wind speed
+     *
+     * @param spanUs Duration covered by the periods in microseconds
+     * @param periods Number of complete periods in the span
+     */
+    static float periodToSpeed(uint32_t spanUs, uint32_t periods)
+    {
+        if (spanUs == 0)
+        {
+            return 0.0f;
+        }
+        return (float)periods * 1000000.0f / (float)spanUs * WindMath::ANEMOMETER_FACTOR;
+    }
+
+private:
+    uint32_t _stallTimeoutUs;
+    bool _hasReference = false;
+    uint32_t _referenceUs = 0; // Last pulse of the previous estimate
+    uint32_t _lastUs = 0;      // Most recent pulse
+    uint32_t _pulses = 0;      // Pulses after the reference
+    uint32_t _lastPeriodUs = 0;
+};
@@ -0,0 +1,118 @@
+/**
+ * @file PulseSource.h
+ * @brief Abstract anemometer pulse source
+ *
+ * Decouples WindSensor from the mechanism that counts anemometer pulses.
+ * On the station this is either the debounced GPIO interrupt counter or,
+ * opted in, the ESP32 PCNT peripheral. On a host build the FakePulseSource
+ * can be used to drive the wind speed math without any hardware.
+ *
+ * This header must stay free of Arduino/ESP-IDF includes so it can be
+ * compiled on Linux.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "PulseTimestampRing.h"
+
+class PulseSource
+{
+public:
+    virtual ~PulseSource() {}
+
+    /**
+     * @brief Start counting pulses on the given pin
+     *
+     * @param pin GPIO connected to the anemometer reed switch
+     * @return true if the source is counting
+     * @return false if the source could not be set up
+     */
+    virtual bool begin(uint8_t pin) = 0;
+
+    /**
+     * @brief Stop counting and release the underlying hardware
+     */
+    virtual void end() = 0;
+
+    /**
+     * @brief Get the cumulative number of pulses since begin()
+     *
+     * The value only ever increases (modulo 2^32), so callers measure a
+     * period by subtracting two readings.
+     *
+     * @return uint32_t Total pulse count
+     */
+    virtual uint32_t readTotal() = 0;
+
+    /**
+     * @brief Per-pulse timestamp ring, if the source records one
+     *
+     * Only sources that see every edge in software can timestamp pulses.
+     *
+     * @return AnemometerTimestampRing* Ring to consume from, or nullptr
+     */
+    virtual AnemometerTimestampRing *timestamps() { return nullptr; }
+
+    /**
+     * @brief Short human-readable name for logging
+     */
+    virtual const char *name() const = 0;
+};
+
+/**
+ * @brief Pulse source driven by software, for host-side tests
+ *
+ * Pulses are injected with addPulses(). Nothing in here touches hardware.
+ */
+class FakePulseSource : public PulseSource
+{
+public:
+    bool begin(uint8_t pin) override
+    {
+        (void)pin;
+        _total = 0;
+        _running = true;
+        return true;
+    }
+
+    void end() override { _running = false; }
+
+    uint32_t readTotal() override { return _total; }
+
+    AnemometerTimestampRing *timestamps() override { return &_timestamps; }
+
+    const char *name() const override { return "fake"; }
+
+    /**
+     * @brief Inject pulses as if the anemometer had turned
+     *
+     * @param count Number of pulses to add
+     */
+    void addPulses(uint32_t count)
+    {
+        if (_running)
+        {
+            _total += count;
+        }
+    }
+
+    /**
+     * @brief Inject a single pulse with a timestamp
+     *
+     * @param timestampUs Pulse time in microseconds
+     */
+    void addPulseAt(uint32_t timestampUs)
+    {
+        if (_running)
+        {
+            _total++;
+            _timestamps.push(timestampUs);
+        }
+    }
+
+private:
+    uint32_t _total = 0;
+    bool _running = false;
+    AnemometerTimestampRing _timestamps;
+};
@@ -0,0 +1,96 @@
+/**
+ * @file PulseTimestampRing.h
+ * @brief Lock-free single-producer/single-consumer ring of pulse timestamps
+ *
+ * The anemometer ISR is the only producer and WindSensor the only consumer.
+ * Each side owns one index, so no critical section is needed: the producer
+ * publishes a slot by advancing _head with release ordering and the consumer
+ * frees it by advancing _tail.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+template <uint32_t Capacity>
+class PulseTimestampRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * @brief Store a timestamp (producer side, ISR safe)
+     *
+     * Forced inline so an ISR placed in IRAM does not call into flash.
+     *
+     * @param timestampUs Pulse time in microseconds
+     * @return true if stored
+     * @return false if the ring was full; the drop is counted instead
+     */
+    inline __attribute__((always_inline)) bool push(uint32_t timestampUs)
+    {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t tail = _tail.load(std::memory_order_acquire);
+
+        if (head - tail >= Capacity)
+        {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            return false;
+        }
+
+        _slots[head & (Capacity - 1)] = timestampUs;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest timestamp (consumer side)
+     *
+     * @param timestampUs Receives the timestamp
+     * @return true if a timestamp was available
+     */
+    bool pop(uint32_t &timestampUs)
+    {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        uint32_t head = _head.load(std::memory_order_acquire);
+
+        if (tail == head)
+        {
+            return false;
+        }
+
+        timestampUs = _slots[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of timestamps waiting to be consumed
+     */
+    uint32_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Total number of timestamps dropped because the ring was full
+     *
+     * The consumer compares this against the last value it saw to detect a
+     * gap in the pulse history.
+     */
+    uint32_t droppedCount() const { return _dropped.load(std::memory_order_acquire); }
+
+    static constexpr uint32_t capacity() { return Capacity; }
+
+private:
+    uint32_t _slots[Capacity] = {};
+    std::atomic<uint32_t> _head{0};    // Written by the producer only
+    std::atomic<uint32_t> _tail{0};    // Written by the consumer only
+    std::atomic<uint32_t> _dropped{0}; // Written by the producer only
+};
+
+// Ring size used for anemometer pulses: 256 entries cover ~3.4 s at 75 Hz (50 m/s)
+typedef PulseTimestampRing<256> AnemometerTimestampRing;
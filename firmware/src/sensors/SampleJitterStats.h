@@ -0,0 +1,89 @@
+/**
+ * @file SampleJitterStats.h
+ * @brief Running statistics of the wind sampling cadence
+ *
+ * Each tick of a fixed-rate sampler should start exactly one period after
+ * the previous one. The stats record how far every wake-up deviates from
+ * that schedule, so the sampler can prove it holds its cadence while the
+ * modem is busy. Every record() is O(1).
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+struct SampleJitterSnapshot
+{
+    uint32_t ticks = 0;    // Ticks recorded since the last reset
+    uint32_t avgUs = 0;    // Mean absolute deviation from the schedule
+    uint32_t maxUs = 0;    // Worst absolute deviation from the schedule
+    uint32_t overruns = 0; // Ticks late by a full period or more (a tick was lost)
+};
+
+class SampleJitterStats
+{
+public:
+    /**
+     * @brief Record the wake-up time of one tick
+     *
+     * @param nowUs Wake-up time in microseconds
+     * @param periodUs Nominal period between ticks in microseconds
+     */
+    void record(uint64_t nowUs, uint32_t periodUs)
+    {
+        if (_hasPrevious)
+        {
+            uint64_t interval = nowUs - _previousUs;
+            uint32_t deviation = interval > periodUs ? (uint32_t)(interval - periodUs)
+                                                     : (uint32_t)(periodUs - interval);
+
+            _ticks++;
+            _sumUs += deviation;
+            if (deviation > _maxUs)
+            {
+                _maxUs = deviation;
+            }
+            if (interval >= 2ULL * periodUs)
+            {
+                _overruns++;
+            }
+        }
+
+        _previousUs = nowUs;
+        _hasPrevious = true;
+    }
+
+    /**
+     * @brief Statistics since the last reset
+     */
+    SampleJitterSnapshot snapshot() const
+    {
+        SampleJitterSnapshot result;
+        result.ticks = _ticks;
+        result.avgUs = _ticks ? (uint32_t)(_sumUs / _ticks) : 0;
+        result.maxUs = _maxUs;
+        result.overruns = _overruns;
+        return result;
+    }
+
+    /**
+     * @brief Start a new statistics window, keeping the schedule reference
+     */
+    void reset()
+    {
+        _ticks = 0;
+        _sumUs = 0;
+        _maxUs = 0;
+        _overruns = 0;
+    }
+
+private:
+    bool _hasPrevious = false;
+    uint64_t _previousUs = 0;
+    uint32_t _ticks = 0;
+    uint64_t _sumUs = 0;
+    uint32_t _maxUs = 0;
+    uint32_t _overruns = 0;
+};
@@ -0,0 +1,172 @@
+/**
+ * @file VaneAdcSource.h
+ * @brief Abstract source of wind vane ADC readings
+ *
+ * WindSensor reads the vane through this interface. On the station a
+ * background sampler keeps a filtered value up to date, so a direction
+ * read is a single load instead of several blocking analogRead() calls.
+ * On a host, TraceAdcSource replays recorded ADC traces.
+ *
+ * This header must stay free of Arduino/ESP-IDF includes so it can be
+ * compiled on Linux.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Moving average over the last N ADC samples with a running sum
+ *
+ * Each push() is O(1) regardless of the window length.
+ */
+template <uint8_t N>
+class AdcSampleFilter
+{
+    static_assert(N > 0, "Filter needs at least one sample");
+
+public:
+    void push(uint16_t sample)
+    {
+        if (_count == N)
+        {
+            _sum -= _samples[_next];
+        }
+        else
+        {
+            _count++;
+        }
+
+        _samples[_next] = sample;
+        _sum += sample;
+        _next = (_next + 1) % N;
+    }
+
+    void reset()
+    {
+        _sum = 0;
+        _count = 0;
+        _next = 0;
+    }
+
+    /**
+     * @brief Current average, or -1 before the first sample
+     */
+    int value() const { return _count ? (int)(_sum / _count) : -1; }
+
+private:
+    uint16_t _samples[N] = {};
+    uint32_t _sum = 0;
+    uint8_t _count = 0;
+    uint8_t _next = 0;
+};
+
+class VaneAdcSource
+{
+public:
+    virtual ~VaneAdcSource() {}
+
+    /**
+     * @brief Start sampling the vane on the given pin
+     *
+     * @param pin ADC pin connected to the wind vane divider
+     * @return true if sampling is running
+     * @return false if the source could not be started
+     */
+    virtual bool begin(uint8_t pin) = 0;
+
+    /**
+     * @brief Stop sampling and release the underlying resources
+     */
+    virtual void end() = 0;
+
+    /**
+     * @brief Latest filtered ADC value (0-4095) in O(1)
+     *
+     * @return int Filtered value, or -1 if no sample has been taken yet
+     */
+    virtual int readFiltered() = 0;
+
+    /**
+     * @brief Latest single ADC sample, for debugging and calibration
+     *
+     * @return int Raw value, or -1 if no sample has been taken yet
+     */
+    virtual int readRaw() = 0;
+
+    /**
+     * @brief Short human-readable name for logging
+     */
+    virtual const char *name() const = 0;
+};
+
+/**
+ * @brief Vane source replaying a recorded ADC trace, for host-side tests
+ *
+ * Every advance() feeds the next trace samples through the same filter the
+ * station uses. The trace wraps around at its end.
+ */
+template <uint8_t N = 8>
+class TraceAdcSource : public VaneAdcSource
+{
+public:
+    /**
+     * @brief Set the recorded samples to replay
+     *
+     * @param samples ADC samples in recording order (must outlive the source)
+     * @param count Number of samples
+     */
+    void setTrace(const uint16_t *samples, size_t count)
+    {
+        _trace = samples;
+        _traceLength = count;
+        _position = 0;
+        _filter.reset();
+        _raw = -1;
+    }
+
+    /**
+     * @brief Feed the next samples of the trace, as the sampler timer would
+     *
+     * @param count Number of samples to feed
+     */
+    void advance(size_t count = 1)
+    {
+        if (!_running || !_trace || _traceLength == 0)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint16_t sample = _trace[_position];
+            _position = (_position + 1) % _traceLength;
+            _filter.push(sample);
+            _raw = sample;
+        }
+    }
+
+    bool begin(uint8_t pin) override
+    {
+        (void)pin;
+        _running = true;
+        return true;
+    }
+
+    void end() override { _running = false; }
+
+    int readFiltered() override { return _filter.value(); }
+
+    int readRaw() override { return _raw; }
+
+    const char *name() const override { return "trace"; }
+
+private:
+    const uint16_t *_trace = nullptr;
+    size_t _traceLength = 0;
+    size_t _position = 0;
+    bool _running = false;
+    int _raw = -1;
+    AdcSampleFilter<N> _filter;
+};
@@ -0,0 +1,162 @@
+/**
+ * @file VaneCalibration.h
+ * @brief Table driven wind vane calibration with a constant time lookup
+ *
+ * The vane is a resistor divider with one ADC level per direction. The
+ * calibration stores the measured ADC value for each of the 8 directions
+ * (N, NE, E, SE, S, SW, W, NW). When the table changes it is expanded into
+ * a 4096 entry lookup table, with the boundaries halfway between adjacent
+ * ADC levels, so classifying a reading is a single array index.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+class VaneCalibration
+{
+public:
+    static const uint8_t DIRECTION_COUNT = 8;
+    static const uint16_t ADC_RANGE = 4096; // 12 bit ADC
+    static const uint16_t DEGREES_PER_DIRECTION = 360 / DIRECTION_COUNT;
+
+    VaneCalibration() { setDefaults(); }
+
+    /**
+     * @brief Restore the calibration measured with the wizard (July 2025)
+     *
+     * Sorted by ADC: E 330, SE 586, S 1023, NE 1909, SW 2427, N 3071,
+     * NW 3546, W 3927.
+     */
+    void setDefaults() { setAdcLevels(defaultLevels()); }
+
+    /**
+     * @brief Built-in table, in the order N, NE, E, ..., NW
+     */
+    static const uint16_t *defaultLevels()
+    {
+        static const uint16_t defaults[DIRECTION_COUNT] = {3071, 1909, 330, 586, 1023, 2427, 3927, 3546};
+        return defaults;
+    }
+
+    /**
+     * @brief Check whether a table can be used for classification
+     *
+     * Every level must be within the ADC range and all levels must differ,
+     * otherwise two directions would share a boundary.
+     *
+     * @param adcLevels ADC value per direction, in the order N, NE, E, ..., NW
+     */
+    static bool isValid(const uint16_t adcLevels[DIRECTION_COUNT])
+    {
+        for (uint8_t i = 0; i < DIRECTION_COUNT; i++)
+        {
+            if (adcLevels[i] >= ADC_RANGE)
+            {
+                return false;
+            }
+            for (uint8_t j = i + 1; j < DIRECTION_COUNT; j++)
+            {
+                if (adcLevels[i] == adcLevels[j])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Replace the calibration table and rebuild the lookup table
+     *
+     * @param adcLevels ADC value per direction, in the order N, NE, E, ..., NW
+     * @return true if the table was valid and applied
+     * @return false if the table was rejected; the previous one stays active
+     */
+    bool setAdcLevels(const uint16_t adcLevels[DIRECTION_COUNT])
+    {
+        if (!isValid(adcLevels))
+        {
+            return false;
+        }
+
+        memcpy(_adcLevels, adcLevels, sizeof(_adcLevels));
+        rebuildLookup();
+        return true;
+    }
+
+    /**
+     * @brief Whether the given table equals the active one
+     */
+    bool matches(const uint16_t adcLevels[DIRECTION_COUNT]) const
+    {
+        return memcmp(_adcLevels, adcLevels, sizeof(_adcLevels)) == 0;
+    }
+
+    /**
+     * @brief ADC level per direction, in the order N, NE, E, ..., NW
+     */
+    const uint16_t *adcLevels() const { return _adcLevels; }
+
+    /**
+     * @brief Direction index (0 = N ... 7 = NW) for an ADC value
+     */
+    uint8_t directionIndexFor(int adcValue) const
+    {
+        if (adcValue < 0)
+        {
+            adcValue = 0;
+        }
+        else if (adcValue >= ADC_RANGE)
+        {
+            adcValue = ADC_RANGE - 1;
+        }
+        return _lookup[adcValue];
+    }
+
+    /**
+     * @brief Direction in degrees (0-315) for an ADC value
+     */
+    float directionFor(int adcValue) const
+    {
+        return (float)(directionIndexFor(adcValue) * DEGREES_PER_DIRECTION);
+    }
+
+private:
+    uint16_t _adcLevels[DIRECTION_COUNT] = {};
+    uint8_t _lookup[ADC_RANGE] = {};
+
+    void rebuildLookup()
+    {
+        // Direction indices sorted by ascending ADC level (insertion sort, 8 entries)
+        uint8_t order[DIRECTION_COUNT];
+        for (uint8_t i = 0; i < DIRECTION_COUNT; i++)
+        {
+            uint8_t j = i;
+            while (j > 0 && _adcLevels[order[j - 1]] > _adcLevels[i])
+            {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = i;
+        }
+
+        // Each direction owns the values up to the midpoint with the next level
+        uint16_t adc = 0;
+        for (uint8_t k = 0; k < DIRECTION_COUNT; k++)
+        {
+            uint16_t end = ADC_RANGE;
+            if (k + 1 < DIRECTION_COUNT)
+            {
+                end = (uint16_t)((_adcLevels[order[k]] + _adcLevels[order[k + 1]]) / 2);
+            }
+            for (; adc < end; adc++)
+            {
+                _lookup[adc] = order[k];
+            }
+        }
+    }
+};
@@ -0,0 +1,75 @@
+/**
+ * @file VaneCalibrationStore.cpp
+ * @brief NVS backed storage of the wind vane calibration table
+ */
+
+#include "VaneCalibrationStore.h"
+#include "../core/Logger.h"
+#include <Preferences.h>
+
+#define LOG_TAG_WIND "WIND"
+
+namespace
+{
+    const char *NVS_NAMESPACE = "vane";
+    const char *NVS_KEY = "cal";
+    const uint8_t FORMAT_VERSION = 1;
+
+    struct StoredCalibration
+    {
+        uint8_t version;
+        uint16_t adcLevels[VaneCalibration::DIRECTION_COUNT];
+    };
+}
+
+bool VaneCalibrationStore::load(VaneCalibration &calibration)
+{
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true))
+    {
+        // Namespace does not exist yet: nothing has been stored
+        return false;
+    }
+
+    StoredCalibration stored = {};
+    size_t length = prefs.getBytes(NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
+
+    if (length != sizeof(stored) || stored.version != FORMAT_VERSION)
+    {
+        return false;
+    }
+
+    if (!calibration.setAdcLevels(stored.adcLevels))
+    {
+        Logger.warn(LOG_TAG_WIND, "Stored wind vane calibration is invalid, ignoring it");
+        return false;
+    }
+
+    return true;
+}
+
+bool VaneCalibrationStore::save(const VaneCalibration &calibration)
+{
+    StoredCalibration stored = {};
+    stored.version = FORMAT_VERSION;
+    memcpy(stored.adcLevels, calibration.adcLevels(), sizeof(stored.adcLevels));
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false))
+    {
+        Logger.error(LOG_TAG_WIND, "Failed to open NVS for the wind vane calibration");
+        return false;
+    }
+
+    size_t written = prefs.putBytes(NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
+
+    if (written != sizeof(stored))
+    {
+        Logger.error(LOG_TAG_WIND, "Failed to store the wind vane calibration");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file VaneCalibrationStore.h
+ * @brief Persistence of the wind vane calibration table in NVS
+ */
+
+#pragma once
+
+#include "VaneCalibration.h"
+
+namespace VaneCalibrationStore
+{
+    /**
+     * @brief Load the stored calibration table
+     *
+     * @param calibration Receives the stored table if one is present and valid
+     * @return true if a stored table was applied
+     * @return false if none was stored; the calibration is left unchanged
+     */
+    bool load(VaneCalibration &calibration);
+
+    /**
+     * @brief Store the active calibration table
+     *
+     * @param calibration Calibration whose table is written
+     * @return true if the table was written
+     */
+    bool save(const VaneCalibration &calibration);
+}
@@ -0,0 +1,229 @@
+/**
+ * @file VaneCalibrationWizard.h
+ * @brief Non-blocking wind vane calibration state machine
+ *
+ * The wizard walks through the 8 directions (N to NW). For each one it
+ * waits a short pause for the vane to be turned, then measures for a fixed
+ * window and takes the mean of the longest stable run of readings. step()
+ * is called from the main loop with the current time and filtered ADC
+ * value and never blocks; it returns an event so the caller can log
+ * progress. After the last direction the state is COMPLETE, and levels()
+ * is a valid VaneCalibration table, or FAILED.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "VaneCalibration.h"
+
+class VaneCalibrationWizard
+{
+public:
+    static const uint32_t SAMPLE_INTERVAL_MS = 500; // One reading per step
+    static const uint32_t PAUSE_MS = 3000;          // Time to turn the vane to the next direction
+    static const int STABLE_THRESHOLD = 15;         // ADC must stay within ±15 of the previous reading
+    static const uint8_t STABLE_READINGS_NEEDED = 6; // 3 s of stable readings at 2 Hz
+
+    enum State
+    {
+        IDLE,
+        PAUSE,     // Waiting for the vane to be pointed to the next direction
+        MEASURING, // Collecting readings for the current direction
+        COMPLETE,  // All directions measured, table valid
+        FAILED     // Unstable direction or ambiguous table, nothing applied
+    };
+
+    enum Event
+    {
+        EVENT_NONE,
+        EVENT_DIRECTION_STARTED, // Pause over, measuring direction()
+        EVENT_SAMPLE,            // New reading in lastAdc()
+        EVENT_DIRECTION_DONE     // direction() measured, see level()/isStable() and state()
+    };
+
+    /**
+     * @brief Start a calibration run
+     *
+     * @param nowMs Current time in milliseconds
+     * @param measureMs Measuring window per direction
+     */
+    void start(uint32_t nowMs, uint32_t measureMs)
+    {
+        _measureMs = measureMs > SAMPLE_INTERVAL_MS * STABLE_READINGS_NEEDED
+                         ? measureMs
+                         : SAMPLE_INTERVAL_MS * STABLE_READINGS_NEEDED;
+        _direction = 0;
+        _measuredCount = 0;
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            _levels[i] = 0;
+            _stable[i] = false;
+        }
+        enterPause(nowMs);
+    }
+
+    /**
+     * @brief Abort a running calibration
+     */
+    void cancel() { _state = IDLE; }
+
+    /**
+     * @brief Advance the state machine
+     *
+     * @param nowMs Current time in milliseconds
+     * @param adcValue Latest filtered vane ADC value (0-4095)
+     * @return Event Progress event for logging
+     */
+    Event step(uint32_t nowMs, int adcValue)
+    {
+        switch (_state)
+        {
+        case PAUSE:
+            if (nowMs - _stateStartMs < PAUSE_MS)
+            {
+                return EVENT_NONE;
+            }
+            enterMeasuring(nowMs);
+            return EVENT_DIRECTION_STARTED;
+
+        case MEASURING:
+            if (nowMs - _stateStartMs >= _measureMs)
+            {
+                return finishDirection(nowMs);
+            }
+            if (nowMs - _lastSampleMs < SAMPLE_INTERVAL_MS)
+            {
+                return EVENT_NONE;
+            }
+            _lastSampleMs = nowMs;
+            addReading(adcValue);
+            return EVENT_SAMPLE;
+
+        default:
+            return EVENT_NONE;
+        }
+    }
+
+    State state() const { return _state; }
+    bool isRunning() const { return _state == PAUSE || _state == MEASURING; }
+
+    /**
+     * @brief Direction index being (or last) measured, 0 = N ... 7 = NW
+     */
+    uint8_t direction() const { return _direction; }
+
+    /**
+     * @brief Most recent reading and whether the current run is stable
+     */
+    int lastAdc() const { return _lastAdc; }
+    bool isCurrentStable() const { return _runLength >= STABLE_READINGS_NEEDED; }
+
+    /**
+     * @brief Remaining measuring time for the current direction
+     */
+    uint32_t remainingMs(uint32_t nowMs) const
+    {
+        uint32_t elapsed = nowMs - _stateStartMs;
+        return _state == MEASURING && elapsed < _measureMs ? _measureMs - elapsed : 0;
+    }
+
+    uint16_t level(uint8_t direction) const { return _levels[direction]; }
+    bool isStable(uint8_t direction) const { return _stable[direction]; }
+
+    /**
+     * @brief Measured ADC level per direction, in the order N, NE, E, ..., NW
+     */
+    const uint16_t *levels() const { return _levels; }
+
+private:
+    State _state = IDLE;
+    uint32_t _measureMs = 0;
+    uint32_t _stateStartMs = 0;
+    uint32_t _lastSampleMs = 0;
+    uint8_t _direction = 0;
+    uint8_t _measuredCount = 0;
+
+    uint16_t _levels[VaneCalibration::DIRECTION_COUNT] = {};
+    bool _stable[VaneCalibration::DIRECTION_COUNT] = {};
+
+    // Readings of the current direction
+    int _lastAdc = -1;
+    uint32_t _runSum = 0; // Current run of consecutive stable readings
+    uint16_t _runLength = 0;
+    uint32_t _bestRunSum = 0; // Longest stable run seen so far
+    uint16_t _bestRunLength = 0;
+
+    void enterPause(uint32_t nowMs)
+    {
+        _state = PAUSE;
+        _stateStartMs = nowMs;
+    }
+
+    void enterMeasuring(uint32_t nowMs)
+    {
+        _state = MEASURING;
+        _stateStartMs = nowMs;
+        _direction = _measuredCount;
+        _lastSampleMs = nowMs - SAMPLE_INTERVAL_MS; // Take the first reading right away
+        _lastAdc = -1;
+        _runSum = 0;
+        _runLength = 0;
+        _bestRunSum = 0;
+        _bestRunLength = 0;
+    }
+
+    void addReading(int adcValue)
+    {
+        if (adcValue < 0)
+        {
+            return; // No sample available yet
+        }
+
+        if (_lastAdc >= 0 && abs(adcValue - _lastAdc) <= STABLE_THRESHOLD)
+        {
+            _runSum += adcValue;
+            _runLength++;
+        }
+        else
+        {
+            // A jump starts a new run with this reading
+            _runSum = adcValue;
+            _runLength = 1;
+        }
+
+        if (_runLength > _bestRunLength)
+        {
+            _bestRunSum = _runSum;
+            _bestRunLength = _runLength;
+        }
+        _lastAdc = adcValue;
+    }
+
+    Event finishDirection(uint32_t nowMs)
+    {
+        _stable[_direction] = _bestRunLength >= STABLE_READINGS_NEEDED;
+        // Mean of the longest stable run; the vane may have been moving at the start
+        _levels[_direction] = _bestRunLength ? (uint16_t)(_bestRunSum / _bestRunLength) : 0;
+
+        _measuredCount++;
+        if (_measuredCount < VaneCalibration::DIRECTION_COUNT)
+        {
+            enterPause(nowMs);
+            return EVENT_DIRECTION_DONE;
+        }
+
+        // Last direction: the table is only usable if every direction was
+        // stable and the levels can be told apart
+        bool allStable = true;
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            allStable = allStable && _stable[i];
+        }
+        _state = allStable && VaneCalibration::isValid(_levels) ? COMPLETE : FAILED;
+        return EVENT_DIRECTION_DONE;
+    }
+
+};
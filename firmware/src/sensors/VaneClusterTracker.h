@@ -0,0 +1,188 @@
+/**
+ * @file VaneClusterTracker.h
+ * @brief Online tracking of the wind vane ADC clusters
+ *
+ * The ADC level of each vane direction drifts with temperature, supply
+ * voltage and resistor aging. The tracker runs a one dimensional online
+ * k-means over the filtered vane readings: each stable reading is assigned
+ * to the nearest center (the direction the lookup table classifies it as)
+ * and pulls that center towards it. The per center weights act as a
+ * histogram of how often each direction was seen.
+ *
+ * Centers start at the baseline table (from NVS, the configuration or the
+ * wizard) with a prior weight, so a handful of readings cannot move them
+ * far. The learning rate falls as 1/n and is floored at 1/MAX_WEIGHT, so
+ * centers keep following slow drift.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "VaneCalibration.h"
+
+class VaneClusterTracker
+{
+public:
+    static const uint16_t PRIOR_WEIGHT = 16; // Baseline counts as this many readings
+    static const uint16_t MAX_WEIGHT = 1024; // Slowest learning rate is 1/MAX_WEIGHT
+    static const int MAX_DEVIATION = 150;    // Readings further from the center are ignored
+    static const int STABLE_DELTA = 15;      // Max change from the previous reading to learn
+
+    VaneClusterTracker() { reset(VaneCalibration::defaultLevels()); }
+
+    /**
+     * @brief Restart tracking from a new baseline table
+     *
+     * @param baseline ADC level per direction, in the order N, NE, E, ..., NW
+     */
+    void reset(const uint16_t baseline[VaneCalibration::DIRECTION_COUNT])
+    {
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            _baseline[i] = baseline[i];
+            _centers[i] = baseline[i];
+            _weights[i] = PRIOR_WEIGHT;
+            _hits[i] = 0;
+        }
+        _lastAdc = -1;
+    }
+
+    /**
+     * @brief Feed one filtered vane reading
+     *
+     * Readings taken while the vane swings, or far from every center, are
+     * ignored so transitions between positions do not drag the centers.
+     *
+     * @param adcValue Filtered ADC value (0-4095)
+     * @param direction Direction index the reading was classified as
+     * @return true if the reading moved a center
+     */
+    bool addSample(int adcValue, uint8_t direction)
+    {
+        int previous = _lastAdc;
+        _lastAdc = adcValue;
+
+        if (adcValue < 0 || direction >= VaneCalibration::DIRECTION_COUNT ||
+            previous < 0 || abs(adcValue - previous) > STABLE_DELTA)
+        {
+            return false;
+        }
+
+        float offset = adcValue - _centers[direction];
+        if (offset > MAX_DEVIATION || offset < -MAX_DEVIATION)
+        {
+            return false;
+        }
+
+        if (_weights[direction] < MAX_WEIGHT)
+        {
+            _weights[direction]++;
+        }
+        _centers[direction] += offset / _weights[direction];
+
+        if (_hits[direction] < UINT32_MAX)
+        {
+            _hits[direction]++;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Current centers rounded to ADC counts
+     *
+     * @param out ADC level per direction, in the order N, NE, E, ..., NW
+     */
+    void getCenters(uint16_t out[VaneCalibration::DIRECTION_COUNT]) const
+    {
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            out[i] = (uint16_t)(_centers[i] + 0.5f);
+        }
+    }
+
+    /**
+     * @brief Largest distance between a center and the given table, in ADC counts
+     */
+    uint16_t maxShiftFrom(const uint16_t levels[VaneCalibration::DIRECTION_COUNT]) const
+    {
+        uint16_t maxShift = 0;
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            int shift = abs((int)(_centers[i] + 0.5f) - (int)levels[i]);
+            if (shift > maxShift)
+            {
+                maxShift = (uint16_t)shift;
+            }
+        }
+        return maxShift;
+    }
+
+    /**
+     * @brief Whether the given table equals the baseline
+     */
+    bool baselineMatches(const uint16_t levels[VaneCalibration::DIRECTION_COUNT]) const
+    {
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            if (_baseline[i] != levels[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Drift of the centers relative to the baseline decision margins
+     *
+     * For each direction the distance between its center and its baseline
+     * level is divided by the distance from the baseline level to the
+     * nearest baseline threshold (half the gap to the closest neighbor).
+     * The maximum over all directions is returned: 0 means no drift, 1 means
+     * a center has reached the threshold the baseline table would use, i.e.
+     * the baseline table alone would now misclassify that direction.
+     */
+    float divergence() const
+    {
+        float worst = 0.0f;
+        for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+        {
+            int gap = VaneCalibration::ADC_RANGE;
+            for (uint8_t j = 0; j < VaneCalibration::DIRECTION_COUNT; j++)
+            {
+                int distance = abs((int)_baseline[j] - (int)_baseline[i]);
+                if (j != i && distance < gap)
+                {
+                    gap = distance;
+                }
+            }
+
+            float drift = _centers[i] - _baseline[i];
+            if (drift < 0)
+            {
+                drift = -drift;
+            }
+            float ratio = gap > 0 ? drift / (gap / 2.0f) : 0.0f;
+            if (ratio > worst)
+            {
+                worst = ratio;
+            }
+        }
+        return worst;
+    }
+
+    /**
+     * @brief Number of readings that moved the center of a direction
+     */
+    uint32_t hits(uint8_t direction) const { return _hits[direction]; }
+
+private:
+    uint16_t _baseline[VaneCalibration::DIRECTION_COUNT] = {};
+    float _centers[VaneCalibration::DIRECTION_COUNT] = {};
+    uint16_t _weights[VaneCalibration::DIRECTION_COUNT] = {};
+    uint32_t _hits[VaneCalibration::DIRECTION_COUNT] = {};
+    int _lastAdc = -1;
+};
@@ -0,0 +1,188 @@
+/**
+ * @file WindAggregationPyramid.h
+ * @brief Incremental 1 s / 1 min / 10 min wind statistics
+ *
+ * Every 250 ms tick of the sampling task feeds the 1 s level. When a level
+ * has covered its duration it closes: the completed bucket is kept as the
+ * level's latest aggregate and its raw sums are folded into the next level
+ * up. Each tick therefore costs O(1) and the 10 min mean is exact over all
+ * ticks, not a mean of means.
+ *
+ * Per bucket:
+ *  - mean speed from the pulse count over the covered time
+ *  - vector mean direction from the summed unit vectors of the ticks
+ *  - gust and lull as the highest and lowest 3 s running mean (GustTracker)
+ *    seen in the bucket, falling back to the bucket mean without a window
+ *  - the number of ticks
+ *
+ * Buckets follow uptime, not wall clock time; the station has no reliable
+ * clock until the modem reports one.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include "WindMath.h"
+
+/**
+ * @brief One completed bucket of a pyramid level
+ */
+struct WindAggregate
+{
+    uint32_t endMs = 0;        // Uptime when the bucket closed
+    uint32_t durationMs = 0;   // Time covered by the ticks of the bucket
+    float avgSpeed = 0.0f;     // Mean speed (m/s)
+    float avgDirection = 0.0f; // Vector mean direction (degrees, 0-360)
+    float gust = 0.0f;         // Highest 3 s mean speed (m/s)
+    float lull = 0.0f;         // Lowest 3 s mean speed (m/s)
+    uint32_t count = 0;        // Ticks in the bucket
+    uint32_t sequence = 0;     // Increments with every completed bucket of the level
+};
+
+class WindAggregationPyramid
+{
+public:
+    enum Level : uint8_t
+    {
+        LEVEL_1S = 0,
+        LEVEL_1MIN = 1,
+        LEVEL_10MIN = 2,
+        LEVEL_COUNT = 3
+    };
+
+    /**
+     * @brief Bucket length of a level in milliseconds
+     */
+    static uint32_t levelDurationMs(uint8_t level)
+    {
+        static const uint32_t durations[LEVEL_COUNT] = {1000, 60000, 600000};
+        return durations[level < LEVEL_COUNT ? level : LEVEL_COUNT - 1];
+    }
+
+    /**
+     * @brief Feed one sampling tick
+     *
+     * @param nowMs Uptime at the end of the tick
+     * @param pulses Anemometer pulses counted during the tick
+     * @param elapsedMs Duration of the tick
+     * @param directionDeg Vane direction at the tick (degrees)
+     * @param windowMean Current 3 s running mean (m/s), negative if none yet
+     * @return Bit mask of the levels that closed a bucket on this tick
+     */
+    uint8_t addTick(uint32_t nowMs, uint32_t pulses, uint32_t elapsedMs, float directionDeg, float windowMean)
+    {
+        if (elapsedMs == 0)
+        {
+            return 0;
+        }
+
+        float radians = directionDeg * DEG_TO_RAD_F;
+        Accumulator tick;
+        tick.pulses = pulses;
+        tick.durationMs = elapsedMs;
+        tick.sumSin = sinf(radians);
+        tick.sumCos = cosf(radians);
+        tick.count = 1;
+        if (windowMean >= 0.0f)
+        {
+            tick.gust = windowMean;
+            tick.lull = windowMean;
+            tick.hasExtremes = true;
+        }
+
+        uint8_t closed = 0;
+        for (uint8_t level = 0; level < LEVEL_COUNT; level++)
+        {
+            _open[level].merge(tick);
+            if (_open[level].durationMs < levelDurationMs(level))
+            {
+                break;
+            }
+
+            // Close the bucket and carry its sums one level up
+            tick = _open[level];
+            close(level, nowMs);
+            closed |= (uint8_t)(1u << level);
+        }
+        return closed;
+    }
+
+    /**
+     * @brief Latest completed bucket of a level
+     *
+     * sequence is 0 until the level completed its first bucket.
+     */
+    const WindAggregate &latest(uint8_t level) const { return _latest[level < LEVEL_COUNT ? level : LEVEL_COUNT - 1]; }
+
+    /**
+     * @brief Drop the open buckets and the completed aggregates
+     */
+    void reset()
+    {
+        for (uint8_t level = 0; level < LEVEL_COUNT; level++)
+        {
+            _open[level] = Accumulator();
+            _latest[level] = WindAggregate();
+        }
+    }
+
+private:
+    static constexpr float DEG_TO_RAD_F = 0.017453292f;
+    static constexpr float RAD_TO_DEG_F = 57.29577951f;
+
+    // Raw sums of an open bucket; merging two buckets is adding their sums
+    struct Accumulator
+    {
+        uint32_t pulses = 0;
+        uint32_t durationMs = 0;
+        float sumSin = 0.0f;
+        float sumCos = 0.0f;
+        uint32_t count = 0;
+        float gust = 0.0f;
+        float lull = 0.0f;
+        bool hasExtremes = false;
+
+        void merge(const Accumulator &other)
+        {
+            pulses += other.pulses;
+            durationMs += other.durationMs;
+            sumSin += other.sumSin;
+            sumCos += other.sumCos;
+            count += other.count;
+            if (other.hasExtremes)
+            {
+                gust = hasExtremes && gust > other.gust ? gust : other.gust;
+                lull = hasExtremes && lull < other.lull ? lull : other.lull;
+                hasExtremes = true;
+            }
+        }
+    };
+
+    Accumulator _open[LEVEL_COUNT];
+    WindAggregate _latest[LEVEL_COUNT];
+
+    void close(uint8_t level, uint32_t nowMs)
+    {
+        const Accumulator &bucket = _open[level];
+        WindAggregate &result = _latest[level];
+
+        result.endMs = nowMs;
+        result.durationMs = bucket.durationMs;
+        result.avgSpeed = WindMath::pulsesToSpeed(bucket.pulses, bucket.durationMs);
+        float direction = atan2f(bucket.sumSin, bucket.sumCos) * RAD_TO_DEG_F;
+        if (direction < 0.0f)
+        {
+            direction += 360.0f;
+        }
+        result.avgDirection = direction >= 360.0f ? direction - 360.0f : direction;
+        result.gust = bucket.hasExtremes ? bucket.gust : result.avgSpeed;
+        result.lull = bucket.hasExtremes ? bucket.lull : result.avgSpeed;
+        result.count = bucket.count;
+        result.sequence++;
+
+        _open[level] = Accumulator();
+    }
+};
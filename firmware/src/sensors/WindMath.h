@@ -0,0 +1,46 @@
+/**
+ * @file WindMath.h
+ * @brief Hardware independent wind speed conversions
+ *
+ * Kept free of Arduino includes so the conversions can be exercised on a
+ * host machine together with FakePulseSource.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace WindMath
+{
+    // From datasheet: 2.4 km/h causes the switch to close once per second
+    // 2.4 km/h = 2.4 * (1000/3600) = 0.6667 m/s per Hz
+    constexpr float ANEMOMETER_FACTOR = 0.6667f; // m/s per Hz (2.4 km/h per Hz)
+
+    /**
+     * @brief Convert a pulse count over a period to wind speed
+     *
+     * @param pulses Number of anemometer pulses in the period
+     * @param elapsedMs Length of the period in milliseconds
+     * @return float Wind speed in m/s, 0 if the period is empty
+     */
+    inline float pulsesToSpeed(uint32_t pulses, uint32_t elapsedMs)
+    {
+        if (elapsedMs == 0)
+        {
+            return 0.0f;
+        }
+
+        float frequency = (float)pulses * 1000.0f / (float)elapsedMs;
+        return frequency * ANEMOMETER_FACTOR;
+    }
+
+    /**
+     * @brief Number of pulses between two cumulative counter readings
+     *
+     * Unsigned subtraction keeps this correct across a 32-bit wrap.
+     */
+    inline uint32_t pulseDelta(uint32_t previousTotal, uint32_t currentTotal)
+    {
+        return currentTotal - previousTotal;
+    }
+}
@@ -0,0 +1,156 @@
+/**
+ * @file WindPeriodStats.h
+ * @brief Single-pass wind statistics over one averaging period
+ *
+ * Accumulates the samples taken during an averaging period in O(1) memory:
+ *  - speed mean and variance with Welford's online algorithm, which stays
+ *    numerically stable where the naive sum of squares would not
+ *  - unit vector sums for the mean direction, and from them the direction
+ *    standard deviation with the Yamartino (1984) single-pass estimator
+ *  - speed weighted vector sums for the resultant wind, so calm samples
+ *    barely move the resultant direction
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+class WindPeriodStats
+{
+public:
+    /**
+     * @brief Forget all samples
+     */
+    void reset()
+    {
+        _count = 0;
+        _speedMean = 0.0f;
+        _speedM2 = 0.0f;
+        _sumSin = 0.0f;
+        _sumCos = 0.0f;
+        _sumSpeedSin = 0.0f;
+        _sumSpeedCos = 0.0f;
+    }
+
+    /**
+     * @brief Add one sample
+     *
+     * @param speed Wind speed of the sample (m/s)
+     * @param directionDeg Wind direction of the sample (degrees)
+     */
+    void addSample(float speed, float directionDeg)
+    {
+        _count++;
+
+        // Welford: update the mean and the sum of squared differences from it
+        float delta = speed - _speedMean;
+        _speedMean += delta / _count;
+        _speedM2 += delta * (speed - _speedMean);
+
+        float radians = directionDeg * DEG_TO_RAD_F;
+        float s = sinf(radians);
+        float c = cosf(radians);
+        _sumSin += s;
+        _sumCos += c;
+        _sumSpeedSin += speed * s;
+        _sumSpeedCos += speed * c;
+    }
+
+    uint32_t count() const { return _count; }
+
+    /**
+     * @brief Mean of the sample speeds (m/s)
+     */
+    float speedMean() const { return _speedMean; }
+
+    /**
+     * @brief Population standard deviation of the sample speeds (m/s)
+     */
+    float speedStdDev() const
+    {
+        return _count > 0 ? sqrtf(_speedM2 / _count) : 0.0f;
+    }
+
+    /**
+     * @brief Unit vector mean direction (degrees, 0-360)
+     */
+    float directionMean() const
+    {
+        return _count > 0 ? vectorDirection(_sumSin, _sumCos) : 0.0f;
+    }
+
+    /**
+     * @brief Magnitude of the mean speed weighted wind vector (m/s)
+     */
+    float resultantSpeed() const
+    {
+        return _count > 0 ? sqrtf(_sumSpeedSin * _sumSpeedSin + _sumSpeedCos * _sumSpeedCos) / _count : 0.0f;
+    }
+
+    /**
+     * @brief Direction of the mean speed weighted wind vector (degrees, 0-360)
+     */
+    float resultantDirection() const
+    {
+        return _count > 0 ? vectorDirection(_sumSpeedSin, _sumSpeedCos) : 0.0f;
+    }
+
+    /**
+     * @brief Persistence (steadiness) ratio: resultant speed / scalar mean speed
+     *
+     * 1 means the wind blew from one direction the whole period, values
+     * near 0 mean the vectors cancelled out. 0 when the period was calm.
+     */
+    float persistence() const
+    {
+        return _speedMean > 0.0f ? resultantSpeed() / _speedMean : 0.0f;
+    }
+
+    /**
+     * @brief Yamartino estimate of the direction standard deviation (degrees)
+     *
+     * sigma = asin(e) * (1 + (2 / sqrt(3) - 1) * e^3), with
+     * e = sqrt(1 - (mean sin^2 + mean cos^2)).
+     */
+    float directionStdDev() const
+    {
+        if (_count == 0)
+        {
+            return 0.0f;
+        }
+
+        float meanSin = _sumSin / _count;
+        float meanCos = _sumCos / _count;
+        float r2 = meanSin * meanSin + meanCos * meanCos;
+        float epsilon = r2 < 1.0f ? sqrtf(1.0f - r2) : 0.0f;
+
+        const float b = 0.1547005f; // 2 / sqrt(3) - 1
+        return asinf(epsilon) * (1.0f + b * epsilon * epsilon * epsilon) * RAD_TO_DEG_F;
+    }
+
+private:
+    static float vectorDirection(float sumSin, float sumCos)
+    {
+        float direction = atan2f(sumSin, sumCos) * RAD_TO_DEG_F;
+        if (direction < 0.0f)
+        {
+            direction += 360.0f;
+        }
+        // A tiny negative angle rounds up to exactly 360
+        return direction >= 360.0f ? direction - 360.0f : direction;
+    }
+
+    static constexpr float DEG_TO_RAD_F = 0.017453292f;
+    static constexpr float RAD_TO_DEG_F = 57.29577951f;
+
+    uint32_t _count = 0;
+    float _speedMean = 0.0f;
+    float _speedM2 = 0.0f;
+    float _sumSin = 0.0f;
+    float _sumCos = 0.0f;
+    float _sumSpeedSin = 0.0f;
+    float _sumSpeedCos = 0.0f;
+};
@@ -0,0 +1,120 @@
+/**
+ * @file WindRoseHistogram.h
+ * @brief Direction sector x speed bin histogram of one averaging period
+ *
+ * Every sample of an averaging period increments one cell, so the period
+ * keeps its full speed/direction distribution in a fixed 128 byte array.
+ * The vane resolves 8 directions, so there are 8 sectors of 45° centered
+ * on N, NE, ..., NW. Speed bins follow the Beaufort scale up to 7 and
+ * lump everything above together.
+ *
+ * Upload encoding: only non-zero cells are sent, as [sector, bin, count]
+ * triples, which is tens of bytes for a typical period.
+ *
+ * Kept free of Arduino includes so it can be compiled on a host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class WindRoseHistogram
+{
+public:
+    static const uint8_t SECTORS = 8;
+    static const uint8_t SPEED_BINS = 8;
+
+    /**
+     * @brief Lower edge of each speed bin (m/s), Beaufort 0-7
+     *
+     * Bin i holds speeds in [edge[i], edge[i + 1]); the last bin is open.
+     */
+    static float speedBinLowerEdge(uint8_t bin)
+    {
+        static const float edges[SPEED_BINS] = {0.0f, 0.3f, 1.6f, 3.4f, 5.5f, 8.0f, 10.8f, 13.9f};
+        return edges[bin < SPEED_BINS ? bin : SPEED_BINS - 1];
+    }
+
+    void reset()
+    {
+        for (uint8_t s = 0; s < SECTORS; s++)
+        {
+            for (uint8_t b = 0; b < SPEED_BINS; b++)
+            {
+                _counts[s][b] = 0;
+            }
+        }
+        _total = 0;
+    }
+
+    /**
+     * @brief Count one sample
+     *
+     * @param speed Wind speed (m/s)
+     * @param directionDeg Wind direction (degrees)
+     */
+    void addSample(float speed, float directionDeg)
+    {
+        uint8_t sector = sectorFor(directionDeg);
+        uint8_t bin = speedBinFor(speed);
+        if (_counts[sector][bin] < UINT16_MAX)
+        {
+            _counts[sector][bin]++;
+        }
+        if (_total < UINT32_MAX)
+        {
+            _total++;
+        }
+    }
+
+    uint16_t count(uint8_t sector, uint8_t bin) const { return _counts[sector][bin]; }
+
+    /**
+     * @brief Number of samples counted since the last reset
+     */
+    uint32_t total() const { return _total; }
+
+    /**
+     * @brief Number of non-zero cells, i.e. triples in the upload encoding
+     */
+    uint8_t nonZeroCells() const
+    {
+        uint8_t cells = 0;
+        for (uint8_t s = 0; s < SECTORS; s++)
+        {
+            for (uint8_t b = 0; b < SPEED_BINS; b++)
+            {
+                cells += _counts[s][b] ? 1 : 0;
+            }
+        }
+        return cells;
+    }
+
+    /**
+     * @brief Sector index (0 = N ... 7 = NW) for a direction
+     */
+    static uint8_t sectorFor(float directionDeg)
+    {
+        const float width = 360.0f / SECTORS;
+        int sector = (int)((directionDeg + width / 2.0f) / width);
+        sector %= SECTORS;
+        return (uint8_t)(sector < 0 ? sector + SECTORS : sector);
+    }
+
+    /**
+     * @brief Speed bin index for a speed
+     */
+    static uint8_t speedBinFor(float speed)
+    {
+        uint8_t bin = 0;
+        while (bin + 1 < SPEED_BINS && speed >= speedBinLowerEdge(bin + 1))
+        {
+            bin++;
+        }
+        return bin;
+    }
+
+private:
+    uint16_t _counts[SECTORS][SPEED_BINS] = {};
+    uint32_t _total = 0;
+};
@@ -0,0 +1,215 @@
+/**
+ * @file WindSamplingTask.cpp
+ * @brief Implementation of the fixed-rate wind sampling task
+ */
+
+#include "WindSamplingTask.h"
+#include "../core/Logger.h"
+#include "../config/Config.h"
+#include <esp_timer.h>
+
+#define LOG_TAG_WIND "WIND"
+
+// Global instance
+WindSamplingTask windSamplingTask;
+
+bool WindSamplingTask::begin(WindSensor &sensor, uint32_t tickMs)
+{
+    _sensor = &sensor;
+    _tickMs = tickMs > 0 ? tickMs : 1;
+
+    if (!_sensorMutex)
+    {
+        _sensorMutex = xSemaphoreCreateMutex();
+    }
+    if (!_queue)
+    {
+        _queue = xQueueCreate(QUEUE_LENGTH, sizeof(WindReport));
+    }
+#ifdef WIND_AGGREGATES
+    if (!_aggregateQueue)
+    {
+        _aggregateQueue = xQueueCreate(AGGREGATE_QUEUE_LENGTH, sizeof(WindAggregateEntry));
+    }
+    if (!_aggregateQueue)
+    {
+        Logger.error(LOG_TAG_WIND, "Failed to allocate wind aggregate queue");
+    }
+#endif
+    if (!_sensorMutex || !_queue)
+    {
+        Logger.error(LOG_TAG_WIND, "Failed to allocate wind task queue or mutex");
+        return false;
+    }
+
+    if (_task)
+    {
+        return true;
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(&WindSamplingTask::_taskEntry, "wind", WIND_TASK_STACK_SIZE,
+                                                 this, WIND_TASK_PRIORITY, &_task, WIND_TASK_CORE);
+    if (created != pdPASS)
+    {
+        _task = nullptr;
+        Logger.error(LOG_TAG_WIND, "Failed to create wind sampling task, sampling from the loop");
+        return false;
+    }
+
+    Logger.info(LOG_TAG_WIND, "Wind sampling task started on core %d (every %lu ms, priority %d)",
+                WIND_TASK_CORE, (unsigned long)_tickMs, WIND_TASK_PRIORITY);
+    return true;
+}
+
+void WindSamplingTask::_taskEntry(void *arg)
+{
+    WindSamplingTask *self = static_cast<WindSamplingTask *>(arg);
+    const TickType_t period = pdMS_TO_TICKS(self->_tickMs);
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;)
+    {
+        // Fixed-rate cadence: the next wake-up is relative to the previous one,
+        // not to when the previous tick finished
+        vTaskDelayUntil(&lastWake, period);
+
+        portENTER_CRITICAL(&self->_statsMux);
+        self->_jitter.record(esp_timer_get_time(), self->_tickMs * 1000UL);
+        portEXIT_CRITICAL(&self->_statsMux);
+
+        self->_tick();
+    }
+}
+
+void WindSamplingTask::poll()
+{
+    if (_task || !_sensor)
+    {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (now - _lastPollMs < _tickMs)
+    {
+        return;
+    }
+    _lastPollMs = now;
+
+    portENTER_CRITICAL(&_statsMux);
+    _jitter.record(esp_timer_get_time(), _tickMs * 1000UL);
+    portEXIT_CRITICAL(&_statsMux);
+
+    _tick();
+}
+
+void WindSamplingTask::_tick()
+{
+    WindSensorLock lock(*this);
+
+    // Gust window, vane cluster tracking, aggregation pyramid and the calibration wizard
+    _sensor->update();
+    _postAggregates();
+
+    unsigned long sendIntervalMs = _sendIntervalMs.load();
+    unsigned long now = millis();
+
+    if (sendIntervalMs <= LIVESTREAM_THRESHOLD_MS)
+    {
+        // --- LIVESTREAM MODE ---
+        _sampling = false;
+        if (now - _lastLiveReadingMs < sendIntervalMs)
+        {
+            return;
+        }
+        _lastLiveReadingMs = now;
+
+        WindReport report;
+        report.averaged = false;
+        report.summary.avgSpeed = _sensor->getWindSpeed();
+        report.summary.avgDirection = _sensor->getWindDirection();
+        report.takenAtMs = now;
+        _post(report);
+        return;
+    }
+
+    // --- LOW-POWER AVERAGED MODE ---
+    if (!_sampling)
+    {
+        Logger.info(LOG_TAG_WIND, "Starting %lu-second wind sampling period.", sendIntervalMs / 1000);
+        _sensor->startSamplingPeriod();
+        _sampling = true;
+    }
+
+    WindReport report;
+    if (_sensor->getAveragedWindData(sendIntervalMs, report.summary))
+    {
+        report.averaged = true;
+        report.takenAtMs = now;
+        _post(report);
+        _sampling = false; // Start a new period on the next tick
+    }
+}
+
+void WindSamplingTask::_post(const WindReport &report)
+{
+    if (xQueueSend(_queue, &report, 0) == pdTRUE)
+    {
+        return;
+    }
+
+    // Queue full (network side stalled): drop the oldest reading, keep the newest
+    WindReport oldest;
+    xQueueReceive(_queue, &oldest, 0);
+    xQueueSend(_queue, &report, 0);
+    _droppedReports.fetch_add(1);
+}
+
+void WindSamplingTask::_postAggregates()
+{
+    if (!_aggregateQueue)
+    {
+        return;
+    }
+
+    // A 10 min bucket closes on the same tick as a 1 min bucket and is posted after it
+    static const uint8_t LEVELS[2] = {WindAggregationPyramid::LEVEL_1MIN, WindAggregationPyramid::LEVEL_10MIN};
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        WindAggregateEntry entry;
+        entry.aggregate = _sensor->getAggregate(LEVELS[i]);
+        if (entry.aggregate.sequence == _aggregateSequence[i])
+        {
+            continue;
+        }
+        _aggregateSequence[i] = entry.aggregate.sequence;
+        entry.levelMinutes = (uint8_t)(WindAggregationPyramid::levelDurationMs(LEVELS[i]) / 60000);
+
+        if (xQueueSend(_aggregateQueue, &entry, 0) != pdTRUE)
+        {
+            // Queue full: drop the oldest bucket, keep the newest
+            WindAggregateEntry oldest;
+            xQueueReceive(_aggregateQueue, &oldest, 0);
+            xQueueSend(_aggregateQueue, &entry, 0);
+            _droppedReports.fetch_add(1);
+        }
+    }
+}
+
+bool WindSamplingTask::receiveAggregate(WindAggregateEntry &entry)
+{
+    return _aggregateQueue && xQueueReceive(_aggregateQueue, &entry, 0) == pdTRUE;
+}
+
+bool WindSamplingTask::receive(WindReport &report)
+{
+    return _queue && xQueueReceive(_queue, &report, 0) == pdTRUE;
+}
+
+SampleJitterSnapshot WindSamplingTask::takeJitterStats()
+{
+    portENTER_CRITICAL(&_statsMux);
+    SampleJitterSnapshot snapshot = _jitter.snapshot();
+    _jitter.reset();
+    portEXIT_CRITICAL(&_statsMux);
+    return snapshot;
+}
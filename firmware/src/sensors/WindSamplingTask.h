@@ -0,0 +1,152 @@
+/**
+ * @file WindSamplingTask.h
+ * @brief Fixed-rate wind acquisition in a dedicated FreeRTOS task
+ *
+ * The main loop blocks for tens of seconds in modem and HTTP calls, which
+ * used to stall wind sampling. This task owns the wind acquisition: it
+ * wakes every tick with vTaskDelayUntil(), advances WindSensor, and runs
+ * the livestream or averaging logic. Finished readings are posted to a
+ * queue that the main loop drains and sends. Built with WIND_AGGREGATES,
+ * completed 1 min and 10 min buckets go through a second queue.
+ *
+ * The task is pinned to the application core at a priority above the
+ * Arduino loop, so it preempts the loop while the loop waits on the modem.
+ * Calls into WindSensor from other tasks must hold a WindSensorLock.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "WindSensor.h"
+#include "WindSummary.h"
+#include "SampleJitterStats.h"
+#include "../core/WindAggregateBatch.h"
+
+/**
+ * @brief One wind reading ready to be sent
+ */
+struct WindReport
+{
+    bool averaged = false;       // true: averaged period with gust/lull, false: livestream reading
+    WindSummary summary;         // Livestream readings only fill avgSpeed and avgDirection
+    unsigned long takenAtMs = 0; // millis() when the reading was produced
+};
+
+class WindSamplingTask
+{
+public:
+    /**
+     * @brief Start the sampling task
+     *
+     * If the task cannot be created, poll() must be called from the loop
+     * instead; it runs the same tick logic without the fixed cadence.
+     *
+     * @param sensor Initialized wind sensor to drive
+     * @param tickMs Period between two ticks
+     * @return true if the task is running
+     */
+    bool begin(WindSensor &sensor, uint32_t tickMs);
+
+    /**
+     * @brief Run a tick from the loop if the task is not running
+     */
+    void poll();
+
+    /**
+     * @brief Set the interval between two readings
+     *
+     * Intervals up to the livestream threshold send instantaneous readings,
+     * longer ones are averaged over the interval.
+     *
+     * @param intervalMs Wind send interval in milliseconds
+     */
+    void setSendInterval(unsigned long intervalMs) { _sendIntervalMs.store(intervalMs); }
+
+    /**
+     * @brief Take the next reading produced by the task
+     *
+     * @param report Receives the reading
+     * @return true if a reading was available
+     */
+    bool receive(WindReport &report);
+
+    /**
+     * @brief Take the next completed 1 min or 10 min bucket (WIND_AGGREGATES builds)
+     *
+     * @param entry Receives the bucket and its level
+     * @return true if a bucket was available
+     */
+    bool receiveAggregate(WindAggregateEntry &entry);
+
+    /**
+     * @brief Jitter of the tick cadence since the last call, then reset
+     */
+    SampleJitterSnapshot takeJitterStats();
+
+    /**
+     * @brief Readings and aggregate buckets dropped because their queue was full
+     */
+    uint32_t getDroppedReports() const { return _droppedReports.load(); }
+
+    bool isRunning() const { return _task != nullptr; }
+
+    // Serializes access to the wind sensor between the task and the loop
+    void lock()
+    {
+        if (_sensorMutex)
+            xSemaphoreTake(_sensorMutex, portMAX_DELAY);
+    }
+    void unlock()
+    {
+        if (_sensorMutex)
+            xSemaphoreGive(_sensorMutex);
+    }
+
+private:
+    static const unsigned long LIVESTREAM_THRESHOLD_MS = 5000;
+    static const UBaseType_t QUEUE_LENGTH = 8;
+    static const UBaseType_t AGGREGATE_QUEUE_LENGTH = 4; // Minutes of buckets the loop may fall behind
+
+    WindSensor *_sensor = nullptr;
+    uint32_t _tickMs = 250;
+    TaskHandle_t _task = nullptr;
+    QueueHandle_t _queue = nullptr;
+    QueueHandle_t _aggregateQueue = nullptr;
+    SemaphoreHandle_t _sensorMutex = nullptr;
+    portMUX_TYPE _statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+    std::atomic<unsigned long> _sendIntervalMs{60000};
+    std::atomic<uint32_t> _droppedReports{0};
+
+    // Only touched by the tick
+    SampleJitterStats _jitter;
+    bool _sampling = false;
+    unsigned long _lastLiveReadingMs = 0;
+    unsigned long _lastPollMs = 0;
+    uint32_t _aggregateSequence[2] = {}; // Last posted 1 min and 10 min buckets
+
+    static void _taskEntry(void *arg);
+    void _tick();
+    void _post(const WindReport &report);
+    void _postAggregates();
+};
+
+/**
+ * @brief Scoped lock around WindSensor calls made outside the sampling task
+ */
+class WindSensorLock
+{
+public:
+    explicit WindSensorLock(WindSamplingTask &task) : _task(task) { _task.lock(); }
+    ~WindSensorLock() { _task.unlock(); }
+
+private:
+    WindSamplingTask &_task;
+};
+
+extern WindSamplingTask windSamplingTask;
@@ -4,36 +4,35 @@
  */
 
 #include "WindSensor.h"
+#include "PcntPulseSource.h"
+#include "IsrPulseSource.h"
+#include "BackgroundAdcSampler.h"
+#include "VaneCalibrationStore.h"
+#include "WindMath.h"
 #include "../core/Logger.h"
+#include "../config/Config.h"
 #include <Arduino.h>     // Make sure this is included
 #include <esp_adc_cal.h> // Added for ADC calibration as in the old code
 
 #define LOG_TAG_WIND "WIND"
 
-// Global instance for the interrupt handler
+// Global instance
 WindSensor windSensor;
 
-// Interrupt handler for anemometer pulse counting
-void IRAM_ATTR handleAnemometerInterrupt()
-{
-    static unsigned long lastInterruptTime = 0;
-    unsigned long interruptTime = millis();
+// Anemometer pulse sources. The debounced interrupt path is the default,
+// PCNT is opted into with ANEMOMETER_USE_PCNT and falls back to it.
+#ifdef ANEMOMETER_USE_PCNT
+static PcntPulseSource pcntPulseSource(PCNT_UNIT_0, ANEMOMETER_PCNT_FILTER_CYCLES);
+#endif
+static IsrPulseSource isrPulseSource(ANEMOMETER_DEBOUNCE_MS);
 
-    // Debounce: ignore interrupts that occur too quickly (< 10ms apart)
-    if (interruptTime - lastInterruptTime > 10)
-    {
-        windSensor.countAnemometerPulse();
-        lastInterruptTime = interruptTime;
-    }
-}
+// Background wind vane sampler
+static BackgroundAdcSampler vaneAdcSampler(WIND_VANE_SAMPLE_PERIOD_MS);
 
 bool WindSensor::init(uint8_t anemometerPin, uint8_t windVanePin)
 {
     _anemometerPin = anemometerPin;
     _windVanePin = windVanePin;
-    _pulseCount = 0;
-    _lastPulseCount = 0; // Initialize pulse tracking
-    _lastMeasurementTime = millis();
 
     // Configure wind vane pin as analog input
     pinMode(_windVanePin, INPUT);
@@ -42,9 +41,54 @@ bool WindSensor::init(uint8_t anemometerPin, uint8_t windVanePin)
     analogReadResolution(12);                        // Set ADC resolution to 12 bits (0-4095)
     analogSetPinAttenuation(_windVanePin, ADC_11db); // For 3.3V input range
 
-    // Configure anemometer pin with pull-up and interrupt
-    pinMode(_anemometerPin, INPUT_PULLUP);
-    attachInterrupt(digitalPinToInterrupt(_anemometerPin), handleAnemometerInterrupt, FALLING);
+    // Load the vane calibration from NVS, or keep the built-in table
+    if (VaneCalibrationStore::load(_vaneCalibration))
+    {
+        Logger.info(LOG_TAG_WIND, "Wind vane calibration loaded from NVS");
+    }
+    else
+    {
+        Logger.info(LOG_TAG_WIND, "Using default wind vane calibration");
+    }
+    _clusterTracker.reset(_vaneCalibration.adcLevels());
+
+    // Sample the wind vane in the background so direction reads never block
+    if (vaneAdcSampler.begin(_windVanePin))
+    {
+        _adcSource = &vaneAdcSampler;
+    }
+    else
+    {
+        Logger.warn(LOG_TAG_WIND, "Background vane sampling unavailable, using blocking ADC reads");
+    }
+
+    // Start anemometer pulse counting
+#ifdef ANEMOMETER_USE_PCNT
+    if (pcntPulseSource.begin(_anemometerPin))
+    {
+        _pulseSource = &pcntPulseSource;
+    }
+    else
+    {
+        Logger.warn(LOG_TAG_WIND, "PCNT unavailable, falling back to interrupt pulse counting");
+    }
+#endif
+    if (!_pulseSource)
+    {
+        if (!isrPulseSource.begin(_anemometerPin))
+        {
+            Logger.error(LOG_TAG_WIND, "Failed to start anemometer pulse counting");
+            return false;
+        }
+        _pulseSource = &isrPulseSource;
+    }
+
+    _lastPulseCount = readPulseTotal(); // Initialize pulse tracking
+    _lastMeasurementTime = millis();
+    _periodEstimator.reset();
+    _gustTracker.reset();
+    _lastGustPulseCount = _lastPulseCount;
+    _lastGustTickTime = _lastMeasurementTime;
 
     // Optional: setup ADC calibration as in the old code
     esp_adc_cal_characteristics_t adc_chars;
@@ -63,84 +107,151 @@ bool WindSensor::init(uint8_t anemometerPin, uint8_t windVanePin)
     }
 
     Logger.info(LOG_TAG_WIND, "Wind sensor initialized");
-    Logger.info(LOG_TAG_WIND, "Anemometer pin: %d, Wind vane pin: %d", _anemometerPin, _windVanePin);
+    Logger.info(LOG_TAG_WIND, "Anemometer pin: %d (%s, %s-based speed), Wind vane pin: %d",
+                _anemometerPin, _pulseSource->name(), _pulseSource->timestamps() ? "period" : "count",
+                _windVanePin);
 
     return true;
 }
 
-int WindSensor::getAveragedAdcReading()
+void WindSensor::setPulseSource(PulseSource &source)
 {
-    int total = 0;
-
-    // Take multiple ADC readings and average them
-    for (int i = 0; i < ADC_SAMPLE_COUNT; i++)
-    {
-        total += analogRead(_windVanePin);
-        delay(2); // Small delay between readings
-    }
+    _pulseSource = &source;
+    _periodEstimator.reset();
+    _lastDroppedTimestamps = source.timestamps() ? source.timestamps()->droppedCount() : 0;
+    _lastPulseCount = source.readTotal();
+    _periodStartPulseCount = _lastPulseCount;
+    _lastMeasurementTime = millis();
+    _gustTracker.reset();
+    _lastGustPulseCount = _lastPulseCount;
+    _lastGustTickTime = _lastMeasurementTime;
+}
 
-    return total / ADC_SAMPLE_COUNT;
+void WindSensor::setVaneAdcSource(VaneAdcSource &source)
+{
+    _adcSource = &source;
 }
 
-float WindSensor::getWindDirection()
+bool WindSensor::applyVaneCalibration(const uint16_t adcLevels[VaneCalibration::DIRECTION_COUNT])
 {
-    // Get averaged ADC value to reduce noise
-    int adcValue = getAveragedAdcReading();
+    // Compare with the calibrated table, not the drift-corrected one
+    if (_clusterTracker.baselineMatches(adcLevels))
+    {
+        return true; // Unchanged, avoid an NVS write on every config fetch
+    }
 
-    // Use direct ADC value mapping from the old working code
-    float direction;
+    if (!_vaneCalibration.setAdcLevels(adcLevels))
+    {
+        Logger.warn(LOG_TAG_WIND, "Rejected wind vane calibration (values must be distinct and below 4096)");
+        return false;
+    }
 
-    // Log the raw ADC value for debugging
-    Logger.debug(LOG_TAG_WIND, "Wind vane raw ADC value: %d", adcValue);
+    VaneCalibrationStore::save(_vaneCalibration);
+    _clusterTracker.reset(adcLevels);
+    Logger.info(LOG_TAG_WIND, "Wind vane calibration updated: N=%u NE=%u E=%u SE=%u S=%u SW=%u W=%u NW=%u",
+                adcLevels[0], adcLevels[1], adcLevels[2], adcLevels[3],
+                adcLevels[4], adcLevels[5], adcLevels[6], adcLevels[7]);
+    return true;
+}
 
-    // Map ADC value to wind direction based on calibrated ranges
-    // Updated with calibration results from wizard (July 2025)
-    // Calibration data (sorted by ADC):
-    // EAST(90°): 330, SOUTHEAST(135°): 586, SOUTH(180°): 1023,
-    // NORTHEAST(45°): 1909, SOUTHWEST(225°): 2427, NORTH(0°): 3071,
-    // NORTHWEST(315°): 3546, WEST(270°): 3927
+void WindSensor::update()
+{
+    if (_calibrationWizard.isRunning())
+    {
+        stepVaneCalibration();
+    }
 
-    if (adcValue < 458) // Below 458 (midpoint of 330 and 586)
+    if (!_pulseSource)
     {
-        direction = 90; // EAST
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> EAST (90°)", adcValue);
+        return;
     }
-    else if (adcValue < 804) // 458-804 (midpoint of 586 and 1023)
+
+    unsigned long currentTime = millis();
+    unsigned long elapsed = currentTime - _lastGustTickTime;
+    // Accept a tick slightly early so a fixed-rate caller never skips one
+    if (elapsed + UPDATE_TICK_SLACK_MS < GustTracker::TICK_MS)
     {
-        direction = 135; // SOUTHEAST
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> SOUTHEAST (135°)", adcValue);
+        return;
     }
-    else if (adcValue < 1466) // 804-1466 (midpoint of 1023 and 1909)
+
+    uint32_t total = readPulseTotal();
+    uint32_t pulses = WindMath::pulseDelta(_lastGustPulseCount, total);
+    _gustTracker.addTick(pulses, elapsed);
+    _lastGustPulseCount = total;
+    _lastGustTickTime = currentTime;
+
+    int adcValue = readVaneAdc();
+
+    // The wizard measures the vane on purpose; do not learn from it
+    if (!_calibrationWizard.isRunning())
     {
-        direction = 180; // SOUTH
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> SOUTH (180°)", adcValue);
+        trackVaneClusters(adcValue);
     }
-    else if (adcValue < 2168) // 1466-2168 (midpoint of 1909 and 2427)
+
+#ifdef WIND_AGGREGATES
+    _aggregationPyramid.addTick(currentTime, pulses, elapsed, _vaneCalibration.directionFor(adcValue),
+                                _gustTracker.hasWindowMean() ? _gustTracker.windowMean() : -1.0f);
+#endif
+}
+
+void WindSensor::trackVaneClusters(int adcValue)
+{
+    if (!_clusterTracker.addSample(adcValue, _vaneCalibration.directionIndexFor(adcValue)))
     {
-        direction = 45; // NORTHEAST
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> NORTHEAST (45°)", adcValue);
+        return;
     }
-    else if (adcValue < 2749) // 2168-2749 (midpoint of 2427 and 3071)
+
+    if (_clusterTracker.maxShiftFrom(_vaneCalibration.adcLevels()) < WIND_VANE_RETUNE_SHIFT_ADC)
     {
-        direction = 225; // SOUTHWEST
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> SOUTHWEST (225°)", adcValue);
+        return;
     }
-    else if (adcValue < 3308) // 2749-3308 (midpoint of 3071 and 3546)
+
+    // Move the thresholds with the centers. Not written to NVS: the stored
+    // table stays the calibrated baseline and tracking restarts from it.
+    uint16_t centers[VaneCalibration::DIRECTION_COUNT];
+    _clusterTracker.getCenters(centers);
+    if (_vaneCalibration.setAdcLevels(centers))
     {
-        direction = 0; // NORTH
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> NORTH (0°)", adcValue);
+        Logger.debug(LOG_TAG_WIND, "Vane thresholds retuned, divergence %.2f", _clusterTracker.divergence());
     }
-    else if (adcValue < 3736) // 3308-3736 (midpoint of 3546 and 3927)
+}
+
+int WindSensor::getAveragedAdcReading()
+{
+    int total = 0;
+
+    // Take multiple ADC readings and average them
+    for (int i = 0; i < ADC_SAMPLE_COUNT; i++)
     {
-        direction = 315; // NORTHWEST
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> NORTHWEST (315°)", adcValue);
+        total += analogRead(_windVanePin);
+        delay(2); // Small delay between readings
     }
-    else
+
+    return total / ADC_SAMPLE_COUNT;
+}
+
+int WindSensor::readVaneAdc()
+{
+    if (_adcSource)
     {
-        direction = 270; // WEST (3736+)
-        Logger.debug(LOG_TAG_WIND, "ADC %d -> WEST (270°)", adcValue);
+        int value = _adcSource->readFiltered();
+        if (value >= 0)
+        {
+            return value;
+        }
     }
 
+    return getAveragedAdcReading();
+}
+
+float WindSensor::getWindDirection()
+{
+    // Get filtered ADC value from the background sampler
+    int adcValue = readVaneAdc();
+
+    // Classify with the calibration lookup table (one array index)
+    float direction = _vaneCalibration.directionFor(adcValue);
+
     // Note: No adjustment needed since calibration already gives us correct directions
     // The old code needed -90 adjustment because it used different direction mapping
     // Our calibration wizard mapped directions correctly, so we use them directly
@@ -201,16 +312,14 @@ float WindSensor::getWindSpeed(unsigned long samplePeriodMs)
 
     unsigned long currentTime = millis();
 
-    // Safely read current cumulative pulse count without resetting it
-    noInterrupts();
-    unsigned long currentTotalPulses = _pulseCount;
-    interrupts();
+    // Read current cumulative pulse count without resetting it
+    uint32_t currentTotalPulses = readPulseTotal();
 
     // Calculate actual elapsed time since last measurement
     unsigned long elapsedTime = currentTime - _lastMeasurementTime;
 
     // Calculate pulses that occurred during this specific time period
-    unsigned long pulsesInPeriod = currentTotalPulses - _lastPulseCount;
+    uint32_t pulsesInPeriod = WindMath::pulseDelta(_lastPulseCount, currentTotalPulses);
 
     // Update tracking variables for next measurement
     _lastMeasurementTime = currentTime;
@@ -223,24 +332,61 @@ float WindSensor::getWindSpeed(unsigned long samplePeriodMs)
         return 0.0;
     }
 
-    // Calculate frequency (pulses per second) using synchronized pulse count and time
-    float frequency = (float)pulsesInPeriod * 1000.0 / elapsedTime;
+    float windSpeed;
+    if (drainPulseTimestamps())
+    {
+        // Reciprocal measurement: periods between the timestamped pulses
+        windSpeed = _periodEstimator.takeSpeed(micros());
 
-    // Convert frequency to wind speed using calibration factor
-    float windSpeed = frequency * ANEMOMETER_FACTOR;
+        Logger.debug(LOG_TAG_WIND, "Anemometer: %u pulses in %lu ms (last period: %u us), Speed: %.2f m/s",
+                     pulsesInPeriod, elapsedTime, _periodEstimator.lastPeriodUs(), windSpeed);
+    }
+    else
+    {
+        // Convert pulse frequency to wind speed using calibration factor
+        windSpeed = WindMath::pulsesToSpeed(pulsesInPeriod, elapsedTime);
 
-    Logger.debug(LOG_TAG_WIND, "Anemometer: %lu pulses in %lu ms (total: %lu), Speed: %.2f m/s",
-                 pulsesInPeriod, elapsedTime, currentTotalPulses, windSpeed);
+        Logger.debug(LOG_TAG_WIND, "Anemometer: %u pulses in %lu ms (total: %u), Speed: %.2f m/s",
+                     pulsesInPeriod, elapsedTime, currentTotalPulses, windSpeed);
+    }
 
     return windSpeed;
 }
 
+bool WindSensor::drainPulseTimestamps()
+{
+    AnemometerTimestampRing *ring = _pulseSource ? _pulseSource->timestamps() : nullptr;
+    if (!ring)
+    {
+        return false;
+    }
+
+    // A dropped timestamp leaves a hole in the pulse history; restart the
+    // estimate rather than stretching one period over the gap.
+    uint32_t dropped = ring->droppedCount();
+    if (dropped != _lastDroppedTimestamps)
+    {
+        Logger.debug(LOG_TAG_WIND, "%u pulse timestamps dropped, restarting period measurement",
+                     dropped - _lastDroppedTimestamps);
+        _lastDroppedTimestamps = dropped;
+        _periodEstimator.reset();
+    }
+
+    uint32_t timestampUs;
+    while (ring->pop(timestampUs))
+    {
+        _periodEstimator.addPulse(timestampUs);
+    }
+
+    return true;
+}
+
 void WindSensor::printWindReading(unsigned long samplePeriodMs)
 {
     float windSpeed = getWindSpeed(samplePeriodMs);
 
     // Get raw ADC value for debugging
-    int adcValue = analogRead(_windVanePin);
+    int adcValue = _adcSource ? _adcSource->readRaw() : analogRead(_windVanePin);
     float windDirection = getWindDirection();
 
     Logger.info(LOG_TAG_WIND, "------------------------------");
@@ -251,190 +397,123 @@ void WindSensor::printWindReading(unsigned long samplePeriodMs)
     Logger.info(LOG_TAG_WIND, "------------------------------");
 }
 
-void WindSensor::countAnemometerPulse()
-{
-    _pulseCount++;
-}
+// Direction names in calibration table order
+static const char *const VANE_DIRECTION_NAMES[VaneCalibration::DIRECTION_COUNT] = {
+    "NORTH", "NORTHEAST", "EAST", "SOUTHEAST", "SOUTH", "SOUTHWEST", "WEST", "NORTHWEST"};
 
-void WindSensor::calibrateWindVane(unsigned long durationMs)
+bool WindSensor::startVaneCalibration(unsigned long durationMs)
 {
+    if (_calibrationWizard.isRunning())
+    {
+        Logger.warn(LOG_TAG_WIND, "Wind vane calibration already running");
+        return false;
+    }
+
+    // The duration covers all directions, split evenly
+    uint32_t measureMs = durationMs / VaneCalibration::DIRECTION_COUNT;
+    _calibrationWizard.start(millis(), measureMs);
+
     Logger.info(LOG_TAG_WIND, "=========================================");
     Logger.info(LOG_TAG_WIND, "=== WIND VANE CALIBRATION WIZARD ===");
     Logger.info(LOG_TAG_WIND, "=========================================");
-    Logger.info(LOG_TAG_WIND, "");
-    Logger.info(LOG_TAG_WIND, "This wizard will guide you through calibrating");
-    Logger.info(LOG_TAG_WIND, "your wind vane for 8 cardinal directions.");
-    Logger.info(LOG_TAG_WIND, "");
-    Logger.info(LOG_TAG_WIND, "Instructions:");
-    Logger.info(LOG_TAG_WIND, "1. Point wind vane to the direction shown");
-    Logger.info(LOG_TAG_WIND, "2. Hold steady until 'STABLE' appears");
-    Logger.info(LOG_TAG_WIND, "3. Wait for automatic progression to next direction");
-    Logger.info(LOG_TAG_WIND, "4. At the end, you'll get a summary table");
-    Logger.info(LOG_TAG_WIND, "");
-    Logger.info(LOG_TAG_WIND, "Starting calibration in 3 seconds...");
+    Logger.info(LOG_TAG_WIND, "The station keeps running while you calibrate.");
+    Logger.info(LOG_TAG_WIND, "1. Point the wind vane to the direction shown");
+    Logger.info(LOG_TAG_WIND, "2. Hold it steady until 'STABLE' appears");
+    Logger.info(LOG_TAG_WIND, "3. Turn it to the next direction during the %lu s pause",
+                (unsigned long)(VaneCalibrationWizard::PAUSE_MS / 1000));
+    Logger.info(LOG_TAG_WIND, "The new table is stored and used as soon as all 8 directions are stable.");
+    Logger.info(LOG_TAG_WIND, ">>> First direction: %s <<<", VANE_DIRECTION_NAMES[0]);
     Logger.info(LOG_TAG_WIND, "=========================================");
 
-    delay(3000); // Give user time to read instructions
-
-    // Structure to store calibration results
-    struct CalibrationResult
-    {
-        const char *direction;
-        float degrees;
-        int adcValue;
-        float voltage;
-        bool success;
-    };
-
-    // Define the 8 cardinal directions to test
-    CalibrationResult results[] = {
-        {"NORTH", 0.0, 0, 0.0, false},
-        {"NORTHEAST", 45.0, 0, 0.0, false},
-        {"EAST", 90.0, 0, 0.0, false},
-        {"SOUTHEAST", 135.0, 0, 0.0, false},
-        {"SOUTH", 180.0, 0, 0.0, false},
-        {"SOUTHWEST", 225.0, 0, 0.0, false},
-        {"WEST", 270.0, 0, 0.0, false},
-        {"NORTHWEST", 315.0, 0, 0.0, false}};
-
-    const int numDirections = sizeof(results) / sizeof(results[0]);
-    const int STABLE_THRESHOLD = 15;      // ADC value must be stable within ±15
-    const int STABLE_READINGS_NEEDED = 6; // Need 6 stable readings (3 seconds)
-    const int MEASUREMENT_TIME = 8;       // 8 seconds to measure each direction
-
-    // Calibrate each direction
-    for (int dir = 0; dir < numDirections; dir++)
-    {
-        Logger.info(LOG_TAG_WIND, "");
-        Logger.info(LOG_TAG_WIND, "========================================");
-        Logger.info(LOG_TAG_WIND, "Direction %d of %d: %s (%.0f°)",
-                    dir + 1, numDirections, results[dir].direction, results[dir].degrees);
-        Logger.info(LOG_TAG_WIND, "========================================");
-        Logger.info(LOG_TAG_WIND, "");
-        Logger.info(LOG_TAG_WIND, ">>> Point the wind vane to %s <<<", results[dir].direction);
-        Logger.info(LOG_TAG_WIND, ">>> Hold steady and wait for STABLE readings <<<");
-        Logger.info(LOG_TAG_WIND, "");
-
-        unsigned long directionStartTime = millis();
-        unsigned long lastPrintTime = 0;
-        int lastAdcValue = -1;
-        int stableCount = 0;
-        int totalReadings = 0;
-        long adcSum = 0;
-        bool gotStableReading = false;
-
-        while (millis() - directionStartTime < (MEASUREMENT_TIME * 1000))
+    return true;
+}
+
+void WindSensor::cancelVaneCalibration()
+{
+    if (_calibrationWizard.isRunning())
+    {
+        _calibrationWizard.cancel();
+        Logger.info(LOG_TAG_WIND, "Wind vane calibration cancelled, keeping the current table");
+    }
+}
+
+void WindSensor::stepVaneCalibration()
+{
+    unsigned long now = millis();
+    uint8_t dir = _calibrationWizard.direction();
+
+    switch (_calibrationWizard.step(now, readVaneAdc()))
+    {
+    case VaneCalibrationWizard::EVENT_DIRECTION_STARTED:
+        dir = _calibrationWizard.direction();
+        Logger.info(LOG_TAG_WIND, "Direction %u of %u: %s (%u°) - hold steady",
+                    dir + 1, VaneCalibration::DIRECTION_COUNT, VANE_DIRECTION_NAMES[dir],
+                    dir * VaneCalibration::DEGREES_PER_DIRECTION);
+        break;
+
+    case VaneCalibrationWizard::EVENT_SAMPLE:
+        Logger.info(LOG_TAG_WIND, "ADC=%4d, V=%.3f %s (%lus)",
+                    _calibrationWizard.lastAdc(), (_calibrationWizard.lastAdc() * 3.3) / 4095.0,
+                    _calibrationWizard.isCurrentStable() ? "**STABLE**" : "Stabilizing...",
+                    (unsigned long)(_calibrationWizard.remainingMs(now) / 1000));
+        break;
+
+    case VaneCalibrationWizard::EVENT_DIRECTION_DONE:
+        if (_calibrationWizard.isStable(dir))
         {
-            // Print every 500ms
-            if (millis() - lastPrintTime >= 500)
-            {
-                lastPrintTime = millis();
-                totalReadings++;
-
-                // Get averaged ADC reading for more stability
-                int adcValue = getAveragedAdcReading();
-                float voltage = (adcValue * 3.3) / 4095.0;
-
-                // Check if reading is stable
-                bool isStable = false;
-                if (abs(adcValue - lastAdcValue) <= STABLE_THRESHOLD)
-                {
-                    stableCount++;
-                    if (stableCount >= STABLE_READINGS_NEEDED)
-                    {
-                        isStable = true;
-                        gotStableReading = true;
-                    }
-                }
-                else
-                {
-                    stableCount = 0;
-                }
-
-                // Accumulate ADC values for averaging
-                adcSum += adcValue;
-
-                // Calculate remaining time
-                unsigned long elapsed = millis() - directionStartTime;
-                int remaining = MEASUREMENT_TIME - (elapsed / 1000);
-
-                // Print the reading with stability indicator
-                if (isStable)
-                {
-                    Logger.info(LOG_TAG_WIND, "ADC=%4d, V=%.3f **STABLE** (Time: %ds)",
-                                adcValue, voltage, remaining);
-                }
-                else
-                {
-                    Logger.info(LOG_TAG_WIND, "ADC=%4d, V=%.3f (Stabilizing... %ds)",
-                                adcValue, voltage, remaining);
-                }
-
-                lastAdcValue = adcValue;
-            }
-
-            delay(10);
+            Logger.info(LOG_TAG_WIND, "✓ %s calibration COMPLETE (ADC %u)",
+                        VANE_DIRECTION_NAMES[dir], _calibrationWizard.level(dir));
         }
-
-        // Store results
-        if (totalReadings > 0)
+        else
         {
-            results[dir].adcValue = adcSum / totalReadings;
-            results[dir].voltage = (results[dir].adcValue * 3.3) / 4095.0;
-            results[dir].success = gotStableReading;
+            Logger.warn(LOG_TAG_WIND, "⚠ %s readings were unstable (ADC %u)",
+                        VANE_DIRECTION_NAMES[dir], _calibrationWizard.level(dir));
         }
 
-        if (gotStableReading)
+        if (_calibrationWizard.isRunning())
         {
-            Logger.info(LOG_TAG_WIND, "");
-            Logger.info(LOG_TAG_WIND, "✓ %s calibration COMPLETE", results[dir].direction);
+            Logger.info(LOG_TAG_WIND, ">>> Turn the wind vane to %s <<<", VANE_DIRECTION_NAMES[dir + 1]);
         }
         else
         {
-            Logger.info(LOG_TAG_WIND, "");
-            Logger.info(LOG_TAG_WIND, "⚠ %s calibration completed (but readings were unstable)", results[dir].direction);
+            finishVaneCalibration();
         }
+        break;
 
-        // Short pause before next direction
-        if (dir < numDirections - 1)
-        {
-            Logger.info(LOG_TAG_WIND, "");
-            Logger.info(LOG_TAG_WIND, "Moving to next direction in 2 seconds...");
-            delay(2000);
-        }
+    default:
+        break;
     }
+}
 
-    // Print summary table
-    Logger.info(LOG_TAG_WIND, "");
-    Logger.info(LOG_TAG_WIND, "");
+void WindSensor::finishVaneCalibration()
+{
     Logger.info(LOG_TAG_WIND, "=========================================");
     Logger.info(LOG_TAG_WIND, "=== CALIBRATION SUMMARY TABLE ===");
-    Logger.info(LOG_TAG_WIND, "=========================================");
     Logger.info(LOG_TAG_WIND, "Direction     | Degrees | ADC  | Voltage | Status");
     Logger.info(LOG_TAG_WIND, "------------- | ------- | ---- | ------- | ------");
+    for (uint8_t i = 0; i < VaneCalibration::DIRECTION_COUNT; i++)
+    {
+        Logger.info(LOG_TAG_WIND, "%-13s | %7u | %4u | %7.3f | %s",
+                    VANE_DIRECTION_NAMES[i], i * VaneCalibration::DEGREES_PER_DIRECTION,
+                    _calibrationWizard.level(i), (_calibrationWizard.level(i) * 3.3) / 4095.0,
+                    _calibrationWizard.isStable(i) ? "STABLE" : "UNSTABLE");
+    }
+    Logger.info(LOG_TAG_WIND, "=========================================");
 
-    for (int i = 0; i < numDirections; i++)
+    if (_calibrationWizard.state() != VaneCalibrationWizard::COMPLETE ||
+        !applyVaneCalibration(_calibrationWizard.levels()))
     {
-        Logger.info(LOG_TAG_WIND, "%-13s | %7.0f | %4d | %7.3f | %s",
-                    results[i].direction,
-                    results[i].degrees,
-                    results[i].adcValue,
-                    results[i].voltage,
-                    results[i].success ? "STABLE" : "UNSTABLE");
+        Logger.warn(LOG_TAG_WIND, "Calibration NOT applied: every direction must be stable with a distinct ADC value");
+        Logger.info(LOG_TAG_WIND, "Run the wizard again to retry; the current table stays active");
+        return;
     }
 
-    Logger.info(LOG_TAG_WIND, "=========================================");
-    Logger.info(LOG_TAG_WIND, "");
-    Logger.info(LOG_TAG_WIND, "=== NEXT STEPS ===");
-    Logger.info(LOG_TAG_WIND, "1. Copy the ADC values above");
-    Logger.info(LOG_TAG_WIND, "2. Update getWindDirection() method with new ranges:");
-    Logger.info(LOG_TAG_WIND, "   if (adcValue < XXX) direction = YYY;");
-    Logger.info(LOG_TAG_WIND, "3. Sort ADC values from lowest to highest");
-    Logger.info(LOG_TAG_WIND, "4. Create ranges between adjacent ADC values");
-    Logger.info(LOG_TAG_WIND, "5. Test with aiolos-esp32dev-debug environment");
-    Logger.info(LOG_TAG_WIND, "");
+    const uint16_t *levels = _vaneCalibration.adcLevels();
+    Logger.info(LOG_TAG_WIND, "Calibration applied and stored in NVS");
+    Logger.info(LOG_TAG_WIND, "To keep it in the server configuration, set:");
+    Logger.info(LOG_TAG_WIND, "   \"vaneCalibration\": [%u, %u, %u, %u, %u, %u, %u, %u]",
+                levels[0], levels[1], levels[2], levels[3], levels[4], levels[5], levels[6], levels[7]);
     Logger.info(LOG_TAG_WIND, "=== CALIBRATION WIZARD COMPLETE ===");
-    Logger.info(LOG_TAG_WIND, "====================================");
 }
 
 void WindSensor::setSampleInterval(unsigned long intervalMs)
@@ -447,21 +526,37 @@ void WindSensor::startSamplingPeriod()
 {
     _samplingStartTime = millis();
     _lastSampleTime = _samplingStartTime;
-    _directionSumX = 0.0;
-    _directionSumY = 0.0;
-    _directionSampleCount = 0;
+    _periodStats.reset();
+    _windRose.reset();
 
-    // Reset pulse counter for this sampling period
-    noInterrupts();
+    // Remember where the cumulative pulse counter stood at the start of this period
     _totalPulseCount = 0;
-    _pulseCount = 0;
-    interrupts();
+    _periodStartPulseCount = readPulseTotal();
+    _lastSamplePulseCount = _periodStartPulseCount;
+
+    // Gust and lull are reported per period
+    _gustTracker.resetPeriod();
 
     Logger.debug(LOG_TAG_WIND, "Started wind sampling period (sample interval: %lu ms)", _sampleIntervalMs);
 }
 
 bool WindSensor::getAveragedWindData(unsigned long samplingPeriodMs, float &avgSpeed, float &avgDirection)
 {
+    WindSummary summary;
+    bool complete = getAveragedWindData(samplingPeriodMs, summary);
+    if (complete)
+    {
+        avgSpeed = summary.avgSpeed;
+        avgDirection = summary.avgDirection;
+    }
+    return complete;
+}
+
+bool WindSensor::getAveragedWindData(unsigned long samplingPeriodMs, WindSummary &summary)
+{
+    // Keep the gust window current even if the caller does not call update()
+    update();
+
     unsigned long currentTime = millis();
 
     // Check if sampling period has been started
@@ -479,21 +574,21 @@ bool WindSensor::getAveragedWindData(unsigned long samplingPeriodMs, float &avgS
         // Time for a new sample
         float currentDirection = getWindDirection();
 
-        // Convert direction to X,Y components for vector averaging
-        float radians = currentDirection * PI / 180.0;
-        _directionSumX += cos(radians);
-        _directionSumY += sin(radians);
-        _directionSampleCount++;
+        // Speed of this sample from the pulses since the previous one
+        uint32_t total = readPulseTotal();
+        float sampleSpeed = WindMath::pulsesToSpeed(WindMath::pulseDelta(_lastSamplePulseCount, total),
+                                                    currentTime - _lastSampleTime);
+        _periodStats.addSample(sampleSpeed, currentDirection);
+        _windRose.addSample(sampleSpeed, currentDirection);
+        _lastSamplePulseCount = total;
 
-        // Accumulate pulse count
-        noInterrupts();
-        _totalPulseCount += _pulseCount;
-        _pulseCount = 0; // Reset for next sample
-        interrupts();
+        // Pulse count accumulated since the start of the period
+        _totalPulseCount = WindMath::pulseDelta(_periodStartPulseCount, total);
 
         _lastSampleTime = currentTime;
 
-        Logger.debug(LOG_TAG_WIND, "Wind sample taken: Dir=%.1f°, Samples=%d", currentDirection, _directionSampleCount);
+        Logger.debug(LOG_TAG_WIND, "Wind sample taken: Speed=%.2f m/s, Dir=%.1f°, Samples=%lu",
+                     sampleSpeed, currentDirection, (unsigned long)_periodStats.count());
     }
 
     // Check if sampling period is complete
@@ -503,34 +598,54 @@ bool WindSensor::getAveragedWindData(unsigned long samplingPeriodMs, float &avgS
     }
 
     // Sampling period complete - calculate averages
-    if (_directionSampleCount == 0)
+    if (_periodStats.count() == 0)
     {
         Logger.error(LOG_TAG_WIND, "No direction samples collected during sampling period");
-        avgSpeed = 0.0;
-        avgDirection = 0.0;
+        summary = WindSummary();
         return false;
     }
 
     // Calculate averaged wind direction using vector averaging
-    float avgX = _directionSumX / _directionSampleCount;
-    float avgY = _directionSumY / _directionSampleCount;
-    avgDirection = atan2(avgY, avgX) * 180.0 / PI;
+    summary.avgDirection = _periodStats.directionMean();
+
+    // Variability of the samples: gustiness and direction spread
+    summary.speedStdDev = _periodStats.speedStdDev();
+    summary.directionStdDev = _periodStats.directionStdDev();
+
+    // Speed weighted resultant: calm samples barely pull the direction
+    summary.resultantSpeed = _periodStats.resultantSpeed();
+    summary.resultantDirection = _periodStats.resultantDirection();
+    summary.persistence = _periodStats.persistence();
 
-    // Ensure direction is in 0-360 range
-    if (avgDirection < 0)
-        avgDirection += 360.0;
+    // Full distribution of the samples for wind rose climatology
+    summary.windRose = _windRose;
 
     // Calculate averaged wind speed
-    float frequency = (float)_totalPulseCount * 1000.0 / elapsedTime;
-    avgSpeed = frequency * ANEMOMETER_FACTOR;
+    summary.avgSpeed = WindMath::pulsesToSpeed(_totalPulseCount, elapsedTime);
+
+    // Gust and lull from the 3 s running mean. A period shorter than the
+    // gust window has no 3 s mean, so fall back to the period mean.
+    if (_gustTracker.hasValue())
+    {
+        summary.gust = _gustTracker.gust();
+        summary.lull = _gustTracker.lull();
+    }
+    else
+    {
+        summary.gust = summary.avgSpeed;
+        summary.lull = summary.avgSpeed;
+    }
 
-    Logger.info(LOG_TAG_WIND, "Sampling complete: Avg Speed: %.2f m/s, Avg Direction: %.1f° (Samples: %d, Pulses: %lu)",
-                avgSpeed, avgDirection, _directionSampleCount, _totalPulseCount);
+    Logger.info(LOG_TAG_WIND, "Sampling complete: Avg Speed: %.2f m/s (σ %.2f), Gust: %.2f m/s, Lull: %.2f m/s, Avg Direction: %.1f° (σ %.1f°) (Samples: %lu, Pulses: %u)",
+                summary.avgSpeed, summary.speedStdDev, summary.gust, summary.lull, summary.avgDirection,
+                summary.directionStdDev, (unsigned long)_periodStats.count(), _totalPulseCount);
+    Logger.info(LOG_TAG_WIND, "Resultant: %.2f m/s at %.1f°, persistence %.2f, wind rose cells: %u",
+                summary.resultantSpeed, summary.resultantDirection, summary.persistence,
+                summary.windRose.nonZeroCells());
 
     // Reset sampling period data for next measurement
-    _directionSumX = 0.0;
-    _directionSumY = 0.0;
-    _directionSampleCount = 0;
+    _periodStats.reset();
+    _windRose.reset();
     _totalPulseCount = 0;
     _samplingStartTime = 0; // Mark sampling as complete/inactive
 
@@ -9,6 +9,17 @@
 #pragma once
 
 #include <Arduino.h>
+#include "PulseSource.h"
+#include "PulsePeriodEstimator.h"
+#include "GustTracker.h"
+#include "WindSummary.h"
+#include "WindPeriodStats.h"
+#include "WindRoseHistogram.h"
+#include "WindAggregationPyramid.h"
+#include "VaneAdcSource.h"
+#include "VaneCalibration.h"
+#include "VaneCalibrationWizard.h"
+#include "VaneClusterTracker.h"
 
 class WindSensor
 {
@@ -35,6 +46,10 @@ public:
     /**
      * @brief Get the current wind speed
      *
+     * If the pulse source records per-pulse timestamps, the speed is derived
+     * from the inter-pulse periods since the last call (reciprocal counting).
+     * Otherwise whole pulses are counted over the time since the last call.
+     *
      * @param samplePeriodMs The period over which to measure wind speed
      * @return float Wind speed in meters per second
      */
@@ -48,20 +63,94 @@ public:
     void printWindReading(unsigned long samplePeriodMs = 1000);
 
     /**
-     * @brief Handle interrupt for anemometer pulse counting
-     * This is called from the interrupt service routine
+     * @brief Replace the anemometer pulse source
+     *
+     * init() selects the interrupt source, or PCNT when built with
+     * ANEMOMETER_USE_PCNT. This allows injecting a different source,
+     * e.g. a FakePulseSource in host tests.
+     * The new source must already be started.
+     *
+     * @param source Pulse source to read from
      */
-    void countAnemometerPulse();
+    void setPulseSource(PulseSource &source);
 
     /**
-     * @brief Run a calibration routine to help determine wind vane voltage values
+     * @brief Replace the wind vane ADC source
      *
-     * This function continuously reads the wind vane and prints the readings.
-     * Use this to determine the actual voltage values for each direction.
+     * init() starts a background sampler. This allows injecting a different
+     * source, e.g. a TraceAdcSource replaying recorded data. The new source
+     * must already be started.
      *
-     * @param durationMs How long to run the calibration routine (in milliseconds)
+     * @param source ADC source to read the vane from
+     */
+    void setVaneAdcSource(VaneAdcSource &source);
+
+    /**
+     * @brief Replace the wind vane calibration table
+     *
+     * The table is validated, stored in NVS and expanded into the direction
+     * lookup table. An unchanged table is ignored, so this can be called on
+     * every configuration fetch without wearing the flash.
+     *
+     * @param adcLevels ADC value per direction, in the order N, NE, E, SE, S, SW, W, NW
+     * @return true if the table is active
+     * @return false if the table was rejected; the previous one stays active
+     */
+    bool applyVaneCalibration(const uint16_t adcLevels[VaneCalibration::DIRECTION_COUNT]);
+
+    /**
+     * @brief Get the active wind vane calibration
+     */
+    const VaneCalibration &getVaneCalibration() const { return _vaneCalibration; }
+
+    /**
+     * @brief Get the name of the active pulse source ("pcnt", "isr", ...)
      */
-    void calibrateWindVane(unsigned long durationMs = 30000);
+    const char *getPulseSourceName() const { return _pulseSource ? _pulseSource->name() : "none"; }
+
+    /**
+     * @brief Start the wind vane calibration wizard
+     *
+     * The wizard is stepped from update() and never blocks: it asks for each
+     * of the 8 directions in turn, measures the background ADC samples, and
+     * on success applies and stores the new table immediately.
+     *
+     * @param durationMs Total measuring time, split evenly across the directions
+     * @return true if the wizard was started
+     * @return false if a calibration is already running
+     */
+    bool startVaneCalibration(unsigned long durationMs = 64000);
+
+    /**
+     * @brief Abort a running calibration and keep the current table
+     */
+    void cancelVaneCalibration();
+
+    /**
+     * @brief Drift of the vane clusters from the stored calibration
+     *
+     * 0 means the tracked ADC centers sit on the calibrated levels; 1 means a
+     * center has drifted as far as the calibrated threshold, so the stored
+     * table alone would misclassify that direction. See VaneClusterTracker.
+     */
+    float getVaneDivergence() const { return _clusterTracker.divergence(); }
+
+    /**
+     * @brief Latest completed 1 s, 1 min or 10 min aggregate
+     *
+     * Built with WIND_AGGREGATES, the pyramid is fed on every update() tick
+     * regardless of the send interval, so each level can be read and
+     * uploaded at its own cadence; otherwise it stays empty. Compare
+     * sequence with the previously read aggregate to detect a new one.
+     *
+     * @param level WindAggregationPyramid::LEVEL_1S, LEVEL_1MIN or LEVEL_10MIN
+     */
+    WindAggregate getAggregate(uint8_t level) const { return _aggregationPyramid.latest(level); }
+
+    /**
+     * @brief Whether the calibration wizard is running
+     */
+    bool isCalibratingVane() const { return _calibrationWizard.isRunning(); }
 
     /**
      * @brief Start a new wind sampling period
@@ -80,6 +169,31 @@ public:
      */
     bool getAveragedWindData(unsigned long samplingPeriodMs, float &avgSpeed, float &avgDirection);
 
+    /**
+     * @brief Get averaged wind data including gust and lull over the sampling period
+     *
+     * Gust and lull are the highest and lowest 3 s mean speeds seen during
+     * the period. They are only as fine grained as update() is called.
+     * The speed and direction standard deviations are computed from the
+     * samples taken every sample interval.
+     *
+     * @param samplingPeriodMs The duration in milliseconds to sample over
+     * @param summary Receives mean speed, mean direction, gust and lull
+     * @return true if sampling period is complete and data is valid
+     */
+    bool getAveragedWindData(unsigned long samplingPeriodMs, WindSummary &summary);
+
+    /**
+     * @brief Advance the continuous wind statistics
+     *
+     * Steps the calibration wizard if it is running, feeds the pulses
+     * counted since the previous tick into the 3 s gust window and the
+     * vane reading into the cluster tracker, and both into the 1 s / 1 min /
+     * 10 min aggregation pyramid. Call as often as possible (at least every 250 ms); calls in
+     * between ticks return immediately.
+     */
+    void update();
+
     /**
      * @brief Set the internal sampling interval for wind readings
      *
@@ -97,9 +211,26 @@ public:
 private:
     uint8_t _anemometerPin = 0;
     uint8_t _windVanePin = 0;
-    volatile unsigned long _pulseCount = 0;
+    PulseSource *_pulseSource = nullptr;
+    VaneAdcSource *_adcSource = nullptr;
+    VaneCalibration _vaneCalibration; // ADC to direction table, loaded from NVS in init()
+    VaneCalibrationWizard _calibrationWizard;
+    VaneClusterTracker _clusterTracker; // Follows ADC drift, retunes _vaneCalibration in RAM
     unsigned long _lastMeasurementTime = 0;
-    unsigned long _lastPulseCount = 0; // Track last pulse count for differential measurement
+    uint32_t _lastPulseCount = 0; // Track last pulse count for differential measurement
+
+    // Period based speed measurement from pulse timestamps
+    PulsePeriodEstimator _periodEstimator;
+    uint32_t _lastDroppedTimestamps = 0; // Ring drop counter seen at the last drain
+
+    // 3 s gust/lull tracking, advanced by update()
+    GustTracker _gustTracker;
+    unsigned long _lastGustTickTime = 0;
+    uint32_t _lastGustPulseCount = 0;
+
+    // 1 s / 1 min / 10 min statistics, advanced by update()
+    WindAggregationPyramid _aggregationPyramid;
+    static const unsigned long UPDATE_TICK_SLACK_MS = 5; // Tolerated early wake-up of the sampling task
 
     // Wind direction stability variables
     float _lastStableDirection = 0.0;
@@ -109,27 +240,63 @@ private:
 
     // Wind sampling/averaging variables
     unsigned long _samplingStartTime = 0;
-    float _directionSumX = 0.0; // X component sum for vector averaging
-    float _directionSumY = 0.0; // Y component sum for vector averaging
-    unsigned int _directionSampleCount = 0;
-    unsigned long _totalPulseCount = 0;     // Total pulses during sampling period
+    WindPeriodStats _periodStats;           // Per-sample speed variance and direction spread
+    WindRoseHistogram _windRose;            // Per-sample direction/speed distribution
+    uint32_t _periodStartPulseCount = 0;    // Cumulative pulse count when the sampling period started
+    uint32_t _lastSamplePulseCount = 0;     // Cumulative pulse count at the previous sample
+    uint32_t _totalPulseCount = 0;          // Total pulses during sampling period
     unsigned long _lastSampleTime = 0;      // For internal sampling rate control
     unsigned long _sampleIntervalMs = 2000; // Default: 2s (ONLY used in averaging mode, ignored in live-stream mode)
 
-    // Constants for anemometer calibration
-    // From datasheet: 2.4 km/h causes the switch to close once per second
-    // 2.4 km/h = 2.4 * (1000/3600) = 0.6667 m/s per Hz
-    const float ANEMOMETER_FACTOR = 0.6667; // m/s per Hz (2.4 km/h per Hz)
+    /**
+     * @brief Move pending pulse timestamps from the ring into the period estimator
+     *
+     * @return true if the active source provides timestamps
+     */
+    bool drainPulseTimestamps();
+
+    /**
+     * @brief Advance the calibration wizard and log its progress
+     */
+    void stepVaneCalibration();
+
+    /**
+     * @brief Print the calibration summary and apply the table if it is usable
+     */
+    void finishVaneCalibration();
+
+    /**
+     * @brief Feed the vane reading to the cluster tracker and retune if the centers moved
+     *
+     * @param adcValue Filtered vane ADC value of this tick
+     */
+    void trackVaneClusters(int adcValue);
+
+    /**
+     * @brief Read the cumulative pulse count from the active source
+     */
+    uint32_t readPulseTotal() { return _pulseSource ? _pulseSource->readTotal() : 0; }
 
     /**
      * @brief Get averaged ADC reading for wind vane
      *
-     * Takes multiple ADC samples and returns the average to reduce noise
+     * Takes multiple ADC samples and returns the average to reduce noise.
+     * Blocks for ~10 ms; only used if no background ADC source is running.
      *
      * @return int Averaged ADC value
      */
     int getAveragedAdcReading();
+
+    /**
+     * @brief Get the filtered wind vane ADC value
+     *
+     * Reads the background sampler in O(1), falling back to the blocking
+     * getAveragedAdcReading() only if no sample is available.
+     *
+     * @return int Filtered ADC value (0-4095)
+     */
+    int readVaneAdc();
 };
 
-// Global instance for the interrupt handler
+// Global instance
 extern WindSensor windSensor;
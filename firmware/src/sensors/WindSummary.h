@@ -0,0 +1,25 @@
+/**
+ * @file WindSummary.h
+ * @brief Result of one wind averaging period
+ *
+ * Plain data shared between WindSensor and the HTTP client. Kept free of
+ * Arduino includes so it can be used on a host.
+ */
+
+#pragma once
+
+#include "WindRoseHistogram.h"
+
+struct WindSummary
+{
+    float avgSpeed = 0.0f;           // Mean speed over the period (m/s)
+    float avgDirection = 0.0f;       // Vector mean direction (degrees, 0-360)
+    float gust = 0.0f;               // Highest 3 s mean speed in the period (m/s)
+    float lull = 0.0f;               // Lowest 3 s mean speed in the period (m/s)
+    float speedStdDev = 0.0f;        // Standard deviation of the sample speeds (m/s)
+    float directionStdDev = 0.0f;    // Yamartino direction standard deviation (degrees)
+    float resultantSpeed = 0.0f;     // Magnitude of the speed weighted mean vector (m/s)
+    float resultantDirection = 0.0f; // Direction of the speed weighted mean vector (degrees)
+    float persistence = 0.0f;        // resultantSpeed / scalar mean speed (0-1)
+    WindRoseHistogram windRose;      // Sample counts per direction sector and speed bin
+};
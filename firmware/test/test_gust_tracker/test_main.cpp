@@ -0,0 +1,116 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the WMO 3 s gust and lull tracking
+ */
+
+#include <unity.h>
+#include "sensors/GustTracker.h"
+
+static GustTracker tracker;
+
+// Pulses per 250 ms tick and the speed they stand for
+static const float ONE_PULSE_SPEED = 4 * WindMath::ANEMOMETER_FACTOR;
+static const float THREE_PULSE_SPEED = 12 * WindMath::ANEMOMETER_FACTOR;
+
+void setUp()
+{
+    tracker.reset();
+}
+
+void tearDown() {}
+
+static void addTicks(uint32_t count, uint32_t pulses)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        tracker.addTick(pulses, GustTracker::TICK_MS);
+    }
+}
+
+void test_no_value_before_a_full_window()
+{
+    addTicks(11, 1);
+    TEST_ASSERT_FALSE(tracker.hasValue());
+    TEST_ASSERT_FALSE(tracker.hasWindowMean());
+
+    addTicks(1, 1);
+    TEST_ASSERT_TRUE(tracker.hasValue());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, ONE_PULSE_SPEED, tracker.windowMean());
+}
+
+void test_steady_wind_has_equal_gust_and_lull()
+{
+    addTicks(40, 1);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, ONE_PULSE_SPEED, tracker.gust());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, ONE_PULSE_SPEED, tracker.lull());
+}
+
+void test_gust_and_lull_are_the_extreme_3_s_means()
+{
+    addTicks(12, 1);
+    addTicks(12, 3);
+    addTicks(12, 1);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, THREE_PULSE_SPEED, tracker.gust());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, ONE_PULSE_SPEED, tracker.lull());
+}
+
+void test_a_single_tick_spike_is_averaged_over_3_s()
+{
+    addTicks(12, 1);
+    addTicks(1, 12);
+    addTicks(12, 1);
+
+    // 11 ticks of 1 pulse and the spike of 12 over 3 s
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, WindMath::pulsesToSpeed(23, 3000), tracker.gust());
+}
+
+void test_reset_period_keeps_the_window()
+{
+    addTicks(12, 3);
+    tracker.resetPeriod();
+    TEST_ASSERT_FALSE(tracker.hasValue());
+
+    addTicks(1, 1);
+    TEST_ASSERT_TRUE(tracker.hasValue());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, WindMath::pulsesToSpeed(34, 3000), tracker.gust());
+}
+
+void test_a_blocked_caller_tick_is_its_own_mean()
+{
+    tracker.addTick(10, 5000);
+    TEST_ASSERT_TRUE(tracker.hasValue());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, WindMath::pulsesToSpeed(10, 5000), tracker.gust());
+}
+
+void test_empty_tick_is_ignored()
+{
+    addTicks(12, 1);
+    tracker.addTick(50, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, ONE_PULSE_SPEED, tracker.gust());
+}
+
+void test_fast_ticks_overflowing_the_ring_keep_the_window_consistent()
+{
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        tracker.addTick(1, 50);
+    }
+
+    // The ring holds 32 ticks of 50 ms, less than the 3 s window
+    TEST_ASSERT_FALSE(tracker.hasValue());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, WindMath::pulsesToSpeed(1, 50), tracker.windowMean());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_value_before_a_full_window);
+    RUN_TEST(test_steady_wind_has_equal_gust_and_lull);
+    RUN_TEST(test_gust_and_lull_are_the_extreme_3_s_means);
+    RUN_TEST(test_a_single_tick_spike_is_averaged_over_3_s);
+    RUN_TEST(test_reset_period_keeps_the_window);
+    RUN_TEST(test_a_blocked_caller_tick_is_its_own_mean);
+    RUN_TEST(test_empty_tick_is_ignored);
+    RUN_TEST(test_fast_ticks_overflowing_the_ring_keep_the_window_consistent);
+    return UNITY_END();
+}
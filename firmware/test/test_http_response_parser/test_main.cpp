@@ -0,0 +1,226 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the incremental HTTP response parser
+ *
+ * Every response is fed both whole and split at each possible byte, since
+ * the async request hands the parser whatever the modem has received.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "core/HttpResponseParser.h"
+
+static HttpResponseParser parser;
+
+void setUp()
+{
+    parser.reset();
+}
+
+void tearDown() {}
+
+/**
+ * @brief Feed bytes until the parser finishes
+ * @return Number of bytes taken, so the caller can see what was left over
+ */
+static size_t feed(HttpResponseParser &target, const char *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        HttpResponseParser::State state = target.feed(bytes[i]);
+        if (state == HttpResponseParser::COMPLETE || state == HttpResponseParser::MALFORMED)
+        {
+            return i + 1;
+        }
+    }
+    return length;
+}
+
+static size_t feed(const char *response)
+{
+    return feed(parser, response, strlen(response));
+}
+
+/**
+ * @brief Feed the response in two pieces split at every offset; all must agree
+ */
+static void assertSameForEverySplit(const char *response, HttpResponseParser::State expected)
+{
+    size_t length = strlen(response);
+    for (size_t split = 0; split <= length; split++)
+    {
+        HttpResponseParser piecewise;
+        size_t taken = feed(piecewise, response, split);
+        if (taken == split)
+        {
+            feed(piecewise, response + split, length - split);
+        }
+        TEST_ASSERT_EQUAL_INT_MESSAGE(expected, piecewise.state(), response);
+    }
+}
+
+void test_content_length_body()
+{
+    const char *response = "HTTP/1.1 201 Created\r\nContent-Length: 11\r\n\r\n{\"ok\":true}";
+    TEST_ASSERT_EQUAL_size_t(strlen(response), feed(response));
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_INT(201, parser.statusCode());
+    TEST_ASSERT_EQUAL_INT32(11, parser.contentLength());
+    TEST_ASSERT_TRUE(parser.isReusable());
+    assertSameForEverySplit(response, HttpResponseParser::COMPLETE);
+}
+
+void test_status_code_is_known_before_the_body()
+{
+    feed("HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nab");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::BODY, parser.state());
+    TEST_ASSERT_EQUAL_INT(200, parser.statusCode());
+    TEST_ASSERT_FALSE(parser.isReusable());
+}
+
+void test_interim_response_is_skipped()
+{
+    const char *response = "HTTP/1.1 100 Continue\r\n\r\n"
+                           "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+    feed(response);
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_INT(200, parser.statusCode());
+    assertSameForEverySplit(response, HttpResponseParser::COMPLETE);
+}
+
+void test_no_content_and_not_modified_have_no_body()
+{
+    const char *noContent = "HTTP/1.1 204 No Content\r\nContent-Length: 5\r\n\r\n";
+    TEST_ASSERT_EQUAL_size_t(strlen(noContent), feed(noContent));
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_TRUE(parser.isReusable());
+
+    parser.reset();
+    const char *notModified = "HTTP/1.1 304 Not Modified\r\nETag: \"v3\"\r\nTransfer-Encoding: chunked\r\n\r\n";
+    feed(notModified);
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_INT(304, parser.statusCode());
+    TEST_ASSERT_FALSE(parser.isChunked());
+}
+
+void test_connection_close_is_not_reusable()
+{
+    feed("HTTP/1.1 200 OK\r\nconnection: Close\r\nContent-Length: 2\r\n\r\nok");
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_FALSE(parser.isReusable());
+}
+
+void test_body_without_length_ends_on_close()
+{
+    feed("HTTP/1.0 200 OK\r\n\r\nsome body");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::BODY, parser.state());
+    TEST_ASSERT_TRUE(parser.finishOnClose());
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_FALSE(parser.isReusable());
+}
+
+void test_bytes_after_the_body_are_left_over()
+{
+    const char *response = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nokHTTP/1.1";
+    TEST_ASSERT_EQUAL_size_t(strlen(response) - 8, feed(response));
+    TEST_ASSERT_TRUE(parser.isComplete());
+
+    // Bytes fed once complete are ignored
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::COMPLETE, parser.feed('x'));
+    TEST_ASSERT_EQUAL_INT(200, parser.statusCode());
+}
+
+void test_chunked_body_is_followed_to_the_last_chunk()
+{
+    const char *response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "4\r\n{\"ok\r\n"
+                           "A;name=value\r\n\":true}   \r\n"
+                           "0\r\n\r\n";
+    TEST_ASSERT_EQUAL_size_t(strlen(response), feed(response));
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_TRUE(parser.isChunked());
+    TEST_ASSERT_EQUAL_INT32(-1, parser.contentLength());
+    TEST_ASSERT_TRUE(parser.isReusable());
+    assertSameForEverySplit(response, HttpResponseParser::COMPLETE);
+}
+
+void test_chunked_body_with_trailers()
+{
+    const char *response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip, chunked\r\nContent-Length: 99\r\n\r\n"
+                           "2\r\nok\r\n"
+                           "0\r\nX-Checksum: 1234\r\n\r\n"
+                           "left over";
+    TEST_ASSERT_EQUAL_size_t(strlen(response) - 9, feed(response));
+    TEST_ASSERT_TRUE(parser.isComplete());
+    assertSameForEverySplit(response, HttpResponseParser::COMPLETE);
+}
+
+void test_truncated_chunked_body_does_not_end_on_close()
+{
+    feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n8\r\npart");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::BODY, parser.state());
+    TEST_ASSERT_FALSE(parser.finishOnClose());
+}
+
+void test_bad_chunk_size_is_malformed()
+{
+    feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::MALFORMED, parser.state());
+
+    parser.reset();
+    feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nokX");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::MALFORMED, parser.state());
+}
+
+void test_other_transfer_coding_ends_on_close()
+{
+    feed("HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip\r\nContent-Length: 2\r\n\r\nokok");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::BODY, parser.state());
+    TEST_ASSERT_TRUE(parser.finishOnClose());
+    TEST_ASSERT_FALSE(parser.isReusable());
+}
+
+void test_garbage_status_line_is_malformed()
+{
+    feed("SSH-2.0-OpenSSH\r\n");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::MALFORMED, parser.state());
+
+    parser.reset();
+    feed("HTTP/1.1 2x0 OK\r\n");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::MALFORMED, parser.state());
+
+    parser.reset();
+    feed("HTTP/1.1 200 OK\r\nContent-Length: -3\r\n\r\n");
+    TEST_ASSERT_EQUAL_INT(HttpResponseParser::MALFORMED, parser.state());
+}
+
+void test_extra_header_is_scanned()
+{
+    char version[16];
+    ResponseHeaderScanner scanner("X-Config-Version", version, sizeof(version));
+    parser.reset(&scanner);
+    feed("HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nX-Config-Version: \"v7\"\r\nContent-Length: 0\r\n\r\n");
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_TRUE(scanner.found());
+    TEST_ASSERT_EQUAL_STRING("\"v7\"", version);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_content_length_body);
+    RUN_TEST(test_status_code_is_known_before_the_body);
+    RUN_TEST(test_interim_response_is_skipped);
+    RUN_TEST(test_no_content_and_not_modified_have_no_body);
+    RUN_TEST(test_connection_close_is_not_reusable);
+    RUN_TEST(test_body_without_length_ends_on_close);
+    RUN_TEST(test_bytes_after_the_body_are_left_over);
+    RUN_TEST(test_chunked_body_is_followed_to_the_last_chunk);
+    RUN_TEST(test_chunked_body_with_trailers);
+    RUN_TEST(test_truncated_chunked_body_does_not_end_on_close);
+    RUN_TEST(test_bad_chunk_size_is_malformed);
+    RUN_TEST(test_other_transfer_coding_ends_on_close);
+    RUN_TEST(test_garbage_status_line_is_malformed);
+    RUN_TEST(test_extra_header_is_scanned);
+    return UNITY_END();
+}
@@ -0,0 +1,333 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the heap-free JSON payloads
+ *
+ * Each payload is written with the widest values its fields can take into
+ * a buffer of exactly its *_MAX size, followed by a guard area. The test
+ * fails if the payload does not fit, if a byte past the buffer changes, or
+ * if operator new is called while writing.
+ */
+
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include "core/JsonPayloads.h"
+
+static size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    allocations++;
+    void *memory = malloc(size ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+static const size_t GUARD_SIZE = 32;
+static const char GUARD = 0x5A;
+
+// Widest finite values below the 1e9 limit, negative for the sign
+static const float WIDE = -999999936.0f;
+static const float WIDE_FRACTION = -1234567.125f;
+
+/**
+ * @brief A payload buffer of exactly Size bytes with a guard area behind it
+ */
+template <size_t Size>
+struct GuardedBuffer
+{
+    char data[Size];
+    char guard[GUARD_SIZE];
+
+    GuardedBuffer()
+    {
+        memset(data, 0, sizeof(data));
+        memset(guard, GUARD, sizeof(guard));
+    }
+
+    void assertFits(size_t length)
+    {
+        TEST_ASSERT_GREATER_THAN(0, length);
+        TEST_ASSERT_LESS_THAN(Size, length);
+        TEST_ASSERT_EQUAL_size_t(length, strlen(data));
+        for (size_t i = 0; i < GUARD_SIZE; i++)
+        {
+            TEST_ASSERT_EQUAL_INT(GUARD, guard[i]);
+        }
+    }
+};
+
+static WindSummary widestSummary(float value)
+{
+    WindSummary summary;
+    summary.avgSpeed = value;
+    summary.avgDirection = value;
+    summary.gust = value;
+    summary.lull = value;
+    summary.speedStdDev = value;
+    summary.directionStdDev = value;
+    summary.resultantSpeed = value;
+    summary.resultantDirection = value;
+    summary.persistence = value;
+    // Every cell at its saturated count of 65535
+    for (uint8_t sector = 0; sector < WindRoseHistogram::SECTORS; sector++)
+    {
+        for (uint8_t bin = 0; bin < WindRoseHistogram::SPEED_BINS; bin++)
+        {
+            for (uint32_t i = 0; i < UINT16_MAX; i++)
+            {
+                summary.windRose.addSample(WindRoseHistogram::speedBinLowerEdge(bin), sector * 45.0f);
+            }
+        }
+    }
+    return summary;
+}
+
+static JsonPayloads::Diagnostics widestDiagnostics(float value, const SampleJitterSnapshot &jitter)
+{
+    JsonPayloads::Diagnostics diagnostics;
+    diagnostics.batteryVoltage = value;
+    diagnostics.solarVoltage = value;
+    diagnostics.internalTemperature = value;
+    diagnostics.signalQuality = INT32_MIN;
+    diagnostics.uptime = UINT32_MAX;
+    diagnostics.vaneDivergence = 999999936.0f;
+    diagnostics.windJitter = &jitter;
+    diagnostics.connectionReuse = true;
+    diagnostics.reuseHits = UINT32_MAX;
+    diagnostics.reuseMisses = UINT32_MAX;
+    diagnostics.offlineQueue = true;
+    diagnostics.queueDepth = UINT32_MAX;
+    diagnostics.queueFill = UINT32_MAX;
+    diagnostics.queueDrained = UINT32_MAX;
+    diagnostics.queueDropped = UINT32_MAX;
+    return diagnostics;
+}
+
+static SampleJitterSnapshot widestJitter()
+{
+    SampleJitterSnapshot jitter;
+    jitter.ticks = UINT32_MAX;
+    jitter.avgUs = UINT32_MAX;
+    jitter.maxUs = UINT32_MAX;
+    jitter.overruns = UINT32_MAX;
+    return jitter;
+}
+
+void setUp()
+{
+    allocations = 0;
+}
+
+void tearDown() {}
+
+void test_values_are_written_as_compact_json()
+{
+    GuardedBuffer<JsonPayloads::WIND_READING_MAX> buffer;
+    size_t length = JsonPayloads::writeWindReading(buffer.data, sizeof(buffer.data), 5.5f, 225.0f);
+    buffer.assertFits(length);
+    TEST_ASSERT_EQUAL_STRING("{\"windSpeed\":5.5,\"windDirection\":225}", buffer.data);
+}
+
+void test_non_finite_and_huge_values_are_null()
+{
+    GuardedBuffer<JsonPayloads::WIND_READING_MAX> buffer;
+    buffer.assertFits(JsonPayloads::writeWindReading(buffer.data, sizeof(buffer.data), NAN, 1e12f));
+    TEST_ASSERT_EQUAL_STRING("{\"windSpeed\":null,\"windDirection\":null}", buffer.data);
+}
+
+void test_temperature_fits_its_maximum()
+{
+    const float values[] = {WIDE, WIDE_FRACTION};
+    for (float value : values)
+    {
+        GuardedBuffer<JsonPayloads::TEMPERATURE_MAX> buffer;
+        buffer.assertFits(JsonPayloads::writeTemperature(buffer.data, sizeof(buffer.data), value));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_wind_reading_fits_its_maximum()
+{
+    const float values[] = {WIDE, WIDE_FRACTION};
+    for (float value : values)
+    {
+        GuardedBuffer<JsonPayloads::WIND_READING_MAX> buffer;
+        buffer.assertFits(JsonPayloads::writeWindReading(buffer.data, sizeof(buffer.data), value, value));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_wind_summary_fits_its_maximum()
+{
+    static WindSummary wide = widestSummary(WIDE);
+    static WindSummary wideFraction = widestSummary(WIDE_FRACTION);
+    allocations = 0;
+
+    const WindSummary *summaries[] = {&wide, &wideFraction};
+    for (const WindSummary *summary : summaries)
+    {
+        GuardedBuffer<JsonPayloads::WIND_SUMMARY_MAX> buffer;
+        buffer.assertFits(JsonPayloads::writeWindSummary(buffer.data, sizeof(buffer.data), *summary));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_full_wind_batch_fits_its_maximum()
+{
+    WindSampleBatch batch;
+    while (batch.add(WIDE, WIDE_FRACTION, 1))
+    {
+    }
+
+    // Taken 1 ms after "now": the age wraps to the widest 4294967295
+    GuardedBuffer<JsonPayloads::WIND_BATCH_MAX> buffer;
+    buffer.assertFits(JsonPayloads::writeWindBatch(buffer.data, sizeof(buffer.data), batch, 0));
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_full_wind_aggregates_fit_their_maximum()
+{
+    WindAggregateBatch batch;
+    WindAggregateEntry entry;
+    entry.levelMinutes = UINT8_MAX;
+    entry.aggregate.avgSpeed = WIDE;
+    entry.aggregate.avgDirection = WIDE;
+    entry.aggregate.gust = WIDE;
+    entry.aggregate.lull = WIDE;
+    entry.aggregate.count = UINT32_MAX;
+    entry.aggregate.durationMs = UINT32_MAX;
+    entry.aggregate.endMs = 1;
+    while (batch.add(entry))
+    {
+    }
+
+    // Closed 1 ms after "now": the age wraps to the widest 4294967295
+    GuardedBuffer<JsonPayloads::WIND_AGGREGATES_MAX> buffer;
+    buffer.assertFits(JsonPayloads::writeWindAggregates(buffer.data, sizeof(buffer.data), batch, 0));
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_wind_aggregates_are_written_with_their_age()
+{
+    WindAggregateBatch batch;
+    WindAggregateEntry entry;
+    entry.levelMinutes = 10;
+    entry.aggregate.avgSpeed = 3.9f;
+    entry.aggregate.avgDirection = 265.5f;
+    entry.aggregate.gust = 7.2f;
+    entry.aggregate.lull = 1.5f;
+    entry.aggregate.count = 2400;
+    entry.aggregate.durationMs = 600000;
+    entry.aggregate.endMs = 50000;
+    batch.add(entry);
+
+    GuardedBuffer<JsonPayloads::WIND_AGGREGATES_MAX> buffer;
+    buffer.assertFits(JsonPayloads::writeWindAggregates(buffer.data, sizeof(buffer.data), batch, 60000));
+    TEST_ASSERT_EQUAL_STRING("{\"aggregates\":[{\"level\":10,\"windSpeed\":3.9,\"windDirection\":265.5,"
+                             "\"windGust\":7.2,\"windLull\":1.5,\"sampleCount\":2400,\"durationMs\":600000,"
+                             "\"ageMs\":10000}]}",
+                             buffer.data);
+}
+
+void test_diagnostics_fit_their_maximum()
+{
+    SampleJitterSnapshot jitter = widestJitter();
+    const float values[] = {WIDE, WIDE_FRACTION};
+    for (float value : values)
+    {
+        JsonPayloads::Diagnostics diagnostics = widestDiagnostics(value, jitter);
+        GuardedBuffer<JsonPayloads::DIAGNOSTICS_MAX> buffer;
+        buffer.assertFits(JsonPayloads::writeDiagnostics(buffer.data, sizeof(buffer.data), diagnostics));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_frame_of_the_widest_parts_fits_its_maximum()
+{
+    static WindSummary summary = widestSummary(WIDE);
+    static GuardedBuffer<JsonPayloads::WIND_SUMMARY_MAX> wind;
+    static GuardedBuffer<JsonPayloads::TEMPERATURE_MAX> temperature;
+    static GuardedBuffer<JsonPayloads::DIAGNOSTICS_MAX> diagnostics;
+    static GuardedBuffer<JsonPayloads::FRAME_MAX> frame;
+    SampleJitterSnapshot jitter = widestJitter();
+    allocations = 0;
+
+    JsonPayloads::writeWindSummary(wind.data, sizeof(wind.data), summary);
+    JsonPayloads::writeTemperature(temperature.data, sizeof(temperature.data), WIDE);
+    JsonPayloads::writeDiagnostics(diagnostics.data, sizeof(diagnostics.data), widestDiagnostics(WIDE, jitter));
+    frame.assertFits(
+        JsonPayloads::writeFrame(frame.data, sizeof(frame.data), wind.data, temperature.data, diagnostics.data));
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_timestamp_fits_behind_a_full_batch()
+{
+    WindSampleBatch batch;
+    while (batch.add(WIDE, WIDE_FRACTION, 1))
+    {
+    }
+
+    // The batch buffer of the HTTP client has room for the replay timestamp
+    GuardedBuffer<JsonPayloads::WIND_BATCH_MAX + JsonPayloads::TIMESTAMP_MEMBER_MAX> buffer;
+    size_t length = JsonPayloads::writeWindBatch(buffer.data, sizeof(buffer.data), batch, 0);
+    buffer.assertFits(JsonPayloads::appendTimestamp(buffer.data, length, sizeof(buffer.data), UINT32_MAX));
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+void test_too_small_buffer_is_reported_and_not_overrun()
+{
+    GuardedBuffer<JsonPayloads::WIND_READING_MAX / 2> buffer;
+    TEST_ASSERT_EQUAL_size_t(0, JsonPayloads::writeWindReading(buffer.data, sizeof(buffer.data), WIDE, WIDE));
+    for (size_t i = 0; i < GUARD_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(GUARD, buffer.guard[i]);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_values_are_written_as_compact_json);
+    RUN_TEST(test_non_finite_and_huge_values_are_null);
+    RUN_TEST(test_temperature_fits_its_maximum);
+    RUN_TEST(test_wind_reading_fits_its_maximum);
+    RUN_TEST(test_wind_summary_fits_its_maximum);
+    RUN_TEST(test_full_wind_batch_fits_its_maximum);
+    RUN_TEST(test_full_wind_aggregates_fit_their_maximum);
+    RUN_TEST(test_wind_aggregates_are_written_with_their_age);
+    RUN_TEST(test_diagnostics_fit_their_maximum);
+    RUN_TEST(test_frame_of_the_widest_parts_fits_its_maximum);
+    RUN_TEST(test_timestamp_fits_behind_a_full_batch);
+    RUN_TEST(test_too_small_buffer_is_reported_and_not_overrun);
+    return UNITY_END();
+}
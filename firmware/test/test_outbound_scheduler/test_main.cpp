@@ -0,0 +1,175 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the earliest deadline first outbound scheduler
+ */
+
+#include <unity.h>
+#include "core/OutboundScheduler.h"
+
+static OutboundScheduler scheduler;
+
+void setUp()
+{
+    scheduler = OutboundScheduler();
+    scheduler.setDeadline(OutboundScheduler::WIND, 1000);
+    scheduler.setDeadline(OutboundScheduler::CONFIG, 5000);
+    scheduler.setDeadline(OutboundScheduler::FRAME, 10000);
+    scheduler.setDeadline(OutboundScheduler::TEMPERATURE, 30000);
+    scheduler.setDeadline(OutboundScheduler::DIAGNOSTICS, 60000);
+    scheduler.setDeadline(OutboundScheduler::AGGREGATES, 60000);
+    scheduler.setDeadline(OutboundScheduler::REPLAY, 120000);
+}
+
+void tearDown() {}
+
+void test_nothing_pending_at_start()
+{
+    OutboundScheduler::Class cls;
+    TEST_ASSERT_FALSE(scheduler.hasPending());
+    TEST_ASSERT_FALSE(scheduler.next(cls));
+}
+
+void test_earliest_deadline_goes_first()
+{
+    OutboundScheduler::Class cls;
+    scheduler.request(OutboundScheduler::DIAGNOSTICS, 0);
+    scheduler.request(OutboundScheduler::TEMPERATURE, 100);
+    scheduler.request(OutboundScheduler::WIND, 200);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::WIND, cls);
+    scheduler.dispatch(cls, 300);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::TEMPERATURE, cls);
+    scheduler.dispatch(cls, 400);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::DIAGNOSTICS, cls);
+    scheduler.dispatch(cls, 500);
+
+    TEST_ASSERT_FALSE(scheduler.hasPending());
+}
+
+void test_equal_deadlines_go_in_class_order()
+{
+    OutboundScheduler::Class cls;
+    scheduler.request(OutboundScheduler::AGGREGATES, 0);
+    scheduler.request(OutboundScheduler::DIAGNOSTICS, 0);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::DIAGNOSTICS, cls);
+}
+
+void test_waiting_lower_class_overtakes_new_wind()
+{
+    OutboundScheduler::Class cls;
+    scheduler.request(OutboundScheduler::TEMPERATURE, 0);
+    // Due at 30000; a wind reading requested later is due after it
+    scheduler.request(OutboundScheduler::WIND, 29500);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::TEMPERATURE, cls);
+}
+
+void test_ordering_survives_millis_wrap()
+{
+    OutboundScheduler::Class cls;
+    // Due at 0xFFFFFFF0 + 30000, which wraps to 29984
+    scheduler.request(OutboundScheduler::TEMPERATURE, 0xFFFFFFF0u);
+    // Due at 0xFFFFF000 + 1000 = 0xFFFFF3E8, before the wrap: earlier despite the larger value
+    scheduler.request(OutboundScheduler::WIND, 0xFFFFF000u);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::WIND, cls);
+    scheduler.dispatch(cls, 0xFFFFF100u);
+
+    // Requested after the wrap, due at 1010, still before the temperature
+    scheduler.request(OutboundScheduler::WIND, 10);
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::WIND, cls);
+    scheduler.dispatch(cls, 20);
+
+    TEST_ASSERT_TRUE(scheduler.next(cls));
+    TEST_ASSERT_EQUAL_UINT8(OutboundScheduler::TEMPERATURE, cls);
+}
+
+void test_latency_survives_millis_wrap()
+{
+    scheduler.request(OutboundScheduler::FRAME, 0xFFFFFF00u);
+    scheduler.dispatch(OutboundScheduler::FRAME, 0x100u);
+
+    const OutboundScheduler::ClassStats &stats = scheduler.getStats(OutboundScheduler::FRAME);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dispatched);
+    TEST_ASSERT_EQUAL_UINT32(0x200u, stats.maxLatencyMs);
+}
+
+void test_repeated_requests_coalesce_and_keep_their_time()
+{
+    TEST_ASSERT_TRUE(scheduler.request(OutboundScheduler::WIND, 1000));
+    TEST_ASSERT_FALSE(scheduler.request(OutboundScheduler::WIND, 1200));
+    TEST_ASSERT_FALSE(scheduler.request(OutboundScheduler::WIND, 1400));
+
+    scheduler.dispatch(OutboundScheduler::WIND, 1500);
+
+    const OutboundScheduler::ClassStats &stats = scheduler.getStats(OutboundScheduler::WIND);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dispatched);
+    TEST_ASSERT_EQUAL_UINT32(500, stats.totalLatencyMs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(OutboundScheduler::TEMPERATURE).coalesced);
+}
+
+void test_class_can_be_requested_again_while_in_flight()
+{
+    scheduler.request(OutboundScheduler::WIND, 0);
+    scheduler.dispatch(OutboundScheduler::WIND, 100);
+    TEST_ASSERT_FALSE(scheduler.isPending(OutboundScheduler::WIND));
+
+    TEST_ASSERT_TRUE(scheduler.request(OutboundScheduler::WIND, 150));
+    TEST_ASSERT_TRUE(scheduler.isPending(OutboundScheduler::WIND));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getStats(OutboundScheduler::WIND).coalesced);
+}
+
+void test_latency_and_failures_are_counted()
+{
+    scheduler.request(OutboundScheduler::DIAGNOSTICS, 0);
+    scheduler.dispatch(OutboundScheduler::DIAGNOSTICS, 300);
+    scheduler.complete(OutboundScheduler::DIAGNOSTICS, false);
+
+    scheduler.request(OutboundScheduler::DIAGNOSTICS, 1000);
+    scheduler.dispatch(OutboundScheduler::DIAGNOSTICS, 1100);
+    scheduler.complete(OutboundScheduler::DIAGNOSTICS, true);
+
+    // Dispatching a class that is not pending changes nothing
+    scheduler.dispatch(OutboundScheduler::DIAGNOSTICS, 5000);
+
+    const OutboundScheduler::ClassStats &stats = scheduler.getStats(OutboundScheduler::DIAGNOSTICS);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.dispatched);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.failed);
+    TEST_ASSERT_EQUAL_UINT32(200, stats.avgLatencyMs());
+    TEST_ASSERT_EQUAL_UINT32(300, stats.maxLatencyMs);
+}
+
+void test_class_names()
+{
+    TEST_ASSERT_EQUAL_STRING("wind", OutboundScheduler::name(OutboundScheduler::WIND));
+    TEST_ASSERT_EQUAL_STRING("aggregates", OutboundScheduler::name(OutboundScheduler::AGGREGATES));
+    TEST_ASSERT_EQUAL_STRING("replay", OutboundScheduler::name(OutboundScheduler::REPLAY));
+    TEST_ASSERT_EQUAL_STRING("?", OutboundScheduler::name(OutboundScheduler::CLASS_COUNT));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_nothing_pending_at_start);
+    RUN_TEST(test_earliest_deadline_goes_first);
+    RUN_TEST(test_equal_deadlines_go_in_class_order);
+    RUN_TEST(test_waiting_lower_class_overtakes_new_wind);
+    RUN_TEST(test_ordering_survives_millis_wrap);
+    RUN_TEST(test_latency_survives_millis_wrap);
+    RUN_TEST(test_repeated_requests_coalesce_and_keep_their_time);
+    RUN_TEST(test_class_can_be_requested_again_while_in_flight);
+    RUN_TEST(test_latency_and_failures_are_counted);
+    RUN_TEST(test_class_names);
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the reciprocal wind speed, fed from FakePulseSource timestamps
+ */
+
+#include <unity.h>
+#include "sensors/PulsePeriodEstimator.h"
+#include "sensors/PulseSource.h"
+
+static FakePulseSource source;
+static PulsePeriodEstimator estimator(5000000UL);
+
+void setUp()
+{
+    source.begin(0);
+    estimator.reset();
+}
+
+void tearDown()
+{
+    source.end();
+}
+
+/**
+ * @brief Pulses at a fixed period, starting at firstUs
+ * @return Timestamp of the last pulse
+ */
+static uint32_t addPulses(uint32_t count, uint32_t firstUs, uint32_t periodUs)
+{
+    uint32_t timestampUs = firstUs;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        timestampUs = firstUs + i * periodUs;
+        source.addPulseAt(timestampUs);
+    }
+    return timestampUs;
+}
+
+/**
+ * @brief Drains the ring into the estimator, as WindSensor does
+ */
+static float takeSpeed(uint32_t nowUs)
+{
+    uint32_t timestampUs;
+    while (source.timestamps()->pop(timestampUs))
+    {
+        estimator.addPulse(timestampUs);
+    }
+    return estimator.takeSpeed(nowUs);
+}
+
+void test_no_pulses_is_calm()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, takeSpeed(1000000));
+}
+
+void test_a_single_pulse_only_starts_the_first_period()
+{
+    addPulses(1, 1000, 0);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, takeSpeed(2000));
+}
+
+void test_speed_from_the_periods()
+{
+    addPulses(5, 0, 250000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4 * WindMath::ANEMOMETER_FACTOR, takeSpeed(1000000));
+    TEST_ASSERT_EQUAL_UINT32(250000, estimator.lastPeriodUs());
+}
+
+void test_speed_is_not_quantized_to_whole_pulses()
+{
+    // 3.33 Hz: a 1 s count would say 3 or 4 pulses, i.e. 2.0 or 2.67 m/s
+    addPulses(4, 0, 300000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, WindMath::ANEMOMETER_FACTOR / 0.3f, takeSpeed(1000000));
+}
+
+void test_consecutive_estimates_share_the_boundary_pulse()
+{
+    uint32_t lastUs = addPulses(3, 0, 500000);
+    takeSpeed(lastUs);
+
+    // One more pulse after the previous estimate's last one is one period
+    source.addPulseAt(lastUs + 250000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4 * WindMath::ANEMOMETER_FACTOR, takeSpeed(lastUs + 250000));
+}
+
+void test_speed_decays_while_no_pulse_arrives()
+{
+    uint32_t lastUs = addPulses(5, 0, 250000);
+    takeSpeed(lastUs);
+
+    // Still within the last period: the last speed holds
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4 * WindMath::ANEMOMETER_FACTOR, takeSpeed(lastUs + 100000));
+    // At most one pulse per time since the last one
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, WindMath::ANEMOMETER_FACTOR, takeSpeed(lastUs + 1000000));
+}
+
+void test_rotor_stalls_after_the_timeout()
+{
+    uint32_t lastUs = addPulses(5, 0, 250000);
+    takeSpeed(lastUs);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, takeSpeed(lastUs + 5000000));
+}
+
+void test_periods_across_the_micros_wrap()
+{
+    addPulses(5, 0xFFFFFFFFUL - 500000, 250000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4 * WindMath::ANEMOMETER_FACTOR, takeSpeed(500000));
+}
+
+void test_reset_forgets_the_history()
+{
+    addPulses(5, 0, 250000);
+    takeSpeed(1000000);
+    estimator.reset();
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, takeSpeed(1100000));
+    TEST_ASSERT_EQUAL_UINT32(0, estimator.lastPeriodUs());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_pulses_is_calm);
+    RUN_TEST(test_a_single_pulse_only_starts_the_first_period);
+    RUN_TEST(test_speed_from_the_periods);
+    RUN_TEST(test_speed_is_not_quantized_to_whole_pulses);
+    RUN_TEST(test_consecutive_estimates_share_the_boundary_pulse);
+    RUN_TEST(test_speed_decays_while_no_pulse_arrives);
+    RUN_TEST(test_rotor_stalls_after_the_timeout);
+    RUN_TEST(test_periods_across_the_micros_wrap);
+    RUN_TEST(test_reset_forgets_the_history);
+    return UNITY_END();
+}
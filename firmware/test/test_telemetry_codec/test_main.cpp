@@ -0,0 +1,184 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the binary telemetry encoder
+ *
+ * The vectors are the ones apps/adonis-api/tests/unit/telemetry_codec.spec.ts
+ * decodes and encodes, so the firmware and the API codec cannot drift apart
+ * without one of the two suites failing. Change them in both places.
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "core/TelemetryCodec.h"
+
+// TelemetryCodec::encodeWindReading(5.123, 271.26)
+static const char *WIND_READING_HEX = "01010002990a";
+static const char *WIND_SUMMARY_HEX = "01026c02ca08d40336018c00b9003002ec08282302630200740100";
+static const char *WIND_BATCH_HEX = "010302fe010807d00700001c023a07e8030000";
+static const char *WIND_AGGREGATES_HEX =
+    "01040201a9018c0aa802d200f00060ea0000102700000a86015f0ad00296006009c027090010270000";
+
+static uint8_t buffer[TelemetryCodec::WIND_BATCH_MAX_SIZE];
+
+void setUp()
+{
+    memset(buffer, 0xAA, sizeof(buffer));
+}
+
+void tearDown() {}
+
+/**
+ * @brief Asserts that the encoded bytes are the hex vector
+ */
+static void assertEncodedAs(const char *hex, size_t length)
+{
+    uint8_t expected[sizeof(buffer)];
+    size_t expectedLength = strlen(hex) / 2;
+    for (size_t i = 0; i < expectedLength; i++)
+    {
+        unsigned value;
+        sscanf(hex + 2 * i, "%2x", &value);
+        expected[i] = (uint8_t)value;
+    }
+    TEST_ASSERT_EQUAL_size_t(expectedLength, length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buffer, expectedLength);
+}
+
+static WindSummary apiTestSummary()
+{
+    WindSummary summary;
+    summary.avgSpeed = 6.2f;
+    summary.avgDirection = 225.0f;
+    summary.gust = 9.8f;
+    summary.lull = 3.1f;
+    summary.speedStdDev = 1.4f;
+    summary.directionStdDev = 18.5f;
+    summary.resultantSpeed = 5.6f;
+    summary.resultantDirection = 228.4f;
+    summary.persistence = 0.9f;
+    // Wind rose cells [6, 3, 2] and [7, 4, 1]: W at Beaufort 3 twice, NW at Beaufort 4 once
+    summary.windRose.addSample(4.0f, 270.0f);
+    summary.windRose.addSample(4.0f, 270.0f);
+    summary.windRose.addSample(6.0f, 315.0f);
+    return summary;
+}
+
+void test_wind_reading_matches_the_api_vector()
+{
+    size_t length = TelemetryCodec::encodeWindReading(buffer, sizeof(buffer), 5.123f, 271.26f);
+    assertEncodedAs(WIND_READING_HEX, length);
+    TEST_ASSERT_EQUAL_size_t(TelemetryCodec::WIND_READING_SIZE, length);
+}
+
+void test_wind_summary_matches_the_api_vector()
+{
+    WindSummary summary = apiTestSummary();
+    assertEncodedAs(WIND_SUMMARY_HEX, TelemetryCodec::encodeWindSummary(buffer, sizeof(buffer), summary));
+}
+
+void test_wind_batch_matches_the_api_vector()
+{
+    WindSampleBatch batch;
+    batch.add(5.1f, 180.0f, 8000);
+    batch.add(5.4f, 185.0f, 9000);
+    assertEncodedAs(WIND_BATCH_HEX, TelemetryCodec::encodeWindBatch(buffer, sizeof(buffer), batch, 10000));
+}
+
+// A 1 min and a 10 min bucket, both closed 10 s before sending
+static WindAggregateBatch apiTestAggregates()
+{
+    WindAggregateBatch batch;
+    WindAggregateEntry entry;
+    entry.levelMinutes = 1;
+    entry.aggregate.avgSpeed = 4.25f;
+    entry.aggregate.avgDirection = 270.0f;
+    entry.aggregate.gust = 6.8f;
+    entry.aggregate.lull = 2.1f;
+    entry.aggregate.count = 240;
+    entry.aggregate.durationMs = 60000;
+    entry.aggregate.endMs = 50000;
+    batch.add(entry);
+
+    entry.levelMinutes = 10;
+    entry.aggregate.avgSpeed = 3.9f;
+    entry.aggregate.avgDirection = 265.5f;
+    entry.aggregate.gust = 7.2f;
+    entry.aggregate.lull = 1.5f;
+    entry.aggregate.count = 2400;
+    entry.aggregate.durationMs = 600000;
+    batch.add(entry);
+    return batch;
+}
+
+void test_wind_aggregates_match_the_api_vector()
+{
+    WindAggregateBatch batch = apiTestAggregates();
+    assertEncodedAs(WIND_AGGREGATES_HEX, TelemetryCodec::encodeWindAggregates(buffer, sizeof(buffer), batch, 60000));
+}
+
+void test_values_are_clamped_to_the_field_range()
+{
+    TelemetryCodec::encodeWindReading(buffer, sizeof(buffer), -1.0f, 9999.0f);
+    assertEncodedAs("01010000ffff", TelemetryCodec::WIND_READING_SIZE);
+
+    TelemetryCodec::encodeWindReading(buffer, sizeof(buffer), NAN, 0.04f);
+    assertEncodedAs("010100000000", TelemetryCodec::WIND_READING_SIZE);
+}
+
+void test_too_small_buffer_encodes_nothing()
+{
+    TEST_ASSERT_EQUAL_size_t(0, TelemetryCodec::encodeWindReading(buffer, TelemetryCodec::WIND_READING_SIZE - 1,
+                                                                  5.0f, 90.0f));
+
+    WindSummary summary = apiTestSummary();
+    TEST_ASSERT_EQUAL_size_t(0, TelemetryCodec::encodeWindSummary(buffer, 10, summary));
+}
+
+void test_fullest_records_fit_their_maximum_size()
+{
+    WindSummary summary = apiTestSummary();
+    for (uint8_t sector = 0; sector < WindRoseHistogram::SECTORS; sector++)
+    {
+        for (uint8_t bin = 0; bin < WindRoseHistogram::SPEED_BINS; bin++)
+        {
+            summary.windRose.addSample(WindRoseHistogram::speedBinLowerEdge(bin), sector * 45.0f);
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(TelemetryCodec::WIND_SUMMARY_MAX_SIZE,
+                             TelemetryCodec::encodeWindSummary(buffer, TelemetryCodec::WIND_SUMMARY_MAX_SIZE, summary));
+
+    WindSampleBatch batch;
+    while (batch.add(60.0f, 359.0f, 0))
+    {
+    }
+    TEST_ASSERT_EQUAL_size_t(TelemetryCodec::WIND_BATCH_MAX_SIZE,
+                             TelemetryCodec::encodeWindBatch(buffer, TelemetryCodec::WIND_BATCH_MAX_SIZE, batch, 0));
+
+    WindAggregateBatch aggregates;
+    WindAggregateEntry entry;
+    entry.levelMinutes = 10;
+    entry.aggregate.count = 100000; // Clamped to u16
+    while (aggregates.add(entry))
+    {
+    }
+    TEST_ASSERT_EQUAL_size_t(TelemetryCodec::WIND_AGGREGATES_MAX_SIZE,
+                             TelemetryCodec::encodeWindAggregates(buffer, TelemetryCodec::WIND_AGGREGATES_MAX_SIZE,
+                                                                  aggregates, 0));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buffer[3 + 9]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, buffer[3 + 10]);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_wind_reading_matches_the_api_vector);
+    RUN_TEST(test_wind_summary_matches_the_api_vector);
+    RUN_TEST(test_wind_batch_matches_the_api_vector);
+    RUN_TEST(test_wind_aggregates_match_the_api_vector);
+    RUN_TEST(test_values_are_clamped_to_the_field_range);
+    RUN_TEST(test_too_small_buffer_encodes_nothing);
+    RUN_TEST(test_fullest_records_fit_their_maximum_size);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests replaying recorded vane ADC traces through the filter and the calibration
+ */
+
+#include <unity.h>
+#include "sensors/VaneAdcSource.h"
+#include "sensors/VaneCalibration.h"
+
+enum Direction
+{
+    N,
+    NE,
+    E,
+    SE,
+    S,
+    SW,
+    W,
+    NW
+};
+
+static TraceAdcSource<8> source;
+static VaneCalibration calibration;
+
+// Vane resting at N (3071) with a few counts of ADC noise
+static const uint16_t NORTH_TRACE[] = {3068, 3075, 3071, 3066, 3079, 3070, 3073, 3069};
+
+// Vane at E (330) with one spike to the S level, as a loose contact would give
+static const uint16_t SPIKE_TRACE[] = {331, 328, 1023, 333, 329, 330, 332, 327};
+
+// Vane turning from E (330) to SE (586), eight samples each
+static const uint16_t TURN_TRACE[] = {330, 332, 329, 331, 330, 328, 331, 330,
+                                      586, 588, 584, 587, 585, 586, 589, 584};
+
+void setUp()
+{
+    calibration.setDefaults();
+    source.begin(34);
+}
+
+void tearDown()
+{
+    source.end();
+}
+
+void test_no_value_before_the_first_sample()
+{
+    source.setTrace(NORTH_TRACE, 8);
+    TEST_ASSERT_EQUAL_INT(-1, source.readFiltered());
+    TEST_ASSERT_EQUAL_INT(-1, source.readRaw());
+}
+
+void test_noisy_trace_classifies_as_its_direction()
+{
+    source.setTrace(NORTH_TRACE, 8);
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        source.advance();
+        TEST_ASSERT_EQUAL_UINT8(N, calibration.directionIndexFor(source.readRaw()));
+        TEST_ASSERT_EQUAL_UINT8(N, calibration.directionIndexFor(source.readFiltered()));
+    }
+    TEST_ASSERT_EQUAL_INT(3071, source.readFiltered());
+}
+
+void test_filter_dilutes_a_short_spike()
+{
+    source.setTrace(SPIKE_TRACE, 8);
+    source.advance(3);
+    TEST_ASSERT_EQUAL_UINT8(S, calibration.directionIndexFor(source.readRaw()));
+    TEST_ASSERT_EQUAL_UINT8(SE, calibration.directionIndexFor(source.readFiltered()));
+
+    // Diluted over the full window the spike no longer moves the reading off E
+    source.advance(5);
+    TEST_ASSERT_EQUAL_UINT8(E, calibration.directionIndexFor(source.readFiltered()));
+}
+
+void test_turn_is_followed_within_the_filter_window()
+{
+    source.setTrace(TURN_TRACE, 16);
+    source.advance(8);
+    TEST_ASSERT_EQUAL_UINT8(E, calibration.directionIndexFor(source.readFiltered()));
+
+    // The average crosses the E/SE boundary (458) halfway through the window
+    source.advance(3);
+    TEST_ASSERT_EQUAL_UINT8(E, calibration.directionIndexFor(source.readFiltered()));
+    source.advance(2);
+    TEST_ASSERT_EQUAL_UINT8(SE, calibration.directionIndexFor(source.readFiltered()));
+
+    source.advance(3);
+    TEST_ASSERT_EQUAL_UINT8(SE, calibration.directionIndexFor(source.readFiltered()));
+    TEST_ASSERT_EQUAL_INT(586, source.readFiltered());
+}
+
+void test_trace_wraps_around_at_its_end()
+{
+    source.setTrace(TURN_TRACE, 16);
+    source.advance(16 + 8);
+    TEST_ASSERT_EQUAL_INT(330, source.readRaw());
+    TEST_ASSERT_EQUAL_UINT8(E, calibration.directionIndexFor(source.readFiltered()));
+}
+
+void test_every_calibrated_level_replays_to_its_direction()
+{
+    const uint16_t *levels = VaneCalibration::defaultLevels();
+    for (uint8_t direction = 0; direction < VaneCalibration::DIRECTION_COUNT; direction++)
+    {
+        uint16_t trace[4] = {(uint16_t)(levels[direction] - 6), (uint16_t)(levels[direction] + 6),
+                             (uint16_t)(levels[direction] - 3), (uint16_t)(levels[direction] + 3)};
+        source.setTrace(trace, 4);
+        source.advance(8);
+        TEST_ASSERT_EQUAL_UINT8(direction, calibration.directionIndexFor(source.readFiltered()));
+        TEST_ASSERT_EQUAL_FLOAT(direction * VaneCalibration::DEGREES_PER_DIRECTION,
+                                calibration.directionFor(source.readFiltered()));
+    }
+}
+
+void test_stopped_source_does_not_advance()
+{
+    source.setTrace(NORTH_TRACE, 8);
+    source.end();
+    source.advance(4);
+    TEST_ASSERT_EQUAL_INT(-1, source.readFiltered());
+
+    source.begin(34);
+    source.advance();
+    TEST_ASSERT_EQUAL_INT(3068, source.readRaw());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_no_value_before_the_first_sample);
+    RUN_TEST(test_noisy_trace_classifies_as_its_direction);
+    RUN_TEST(test_filter_dilutes_a_short_spike);
+    RUN_TEST(test_turn_is_followed_within_the_filter_window);
+    RUN_TEST(test_trace_wraps_around_at_its_end);
+    RUN_TEST(test_every_calibrated_level_replays_to_its_direction);
+    RUN_TEST(test_stopped_source_does_not_advance);
+    return UNITY_END();
+}
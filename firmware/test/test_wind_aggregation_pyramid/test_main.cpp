@@ -0,0 +1,157 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the 1 s / 1 min / 10 min wind aggregation pyramid
+ */
+
+#include <unity.h>
+#include "sensors/WindAggregationPyramid.h"
+#include "core/WindAggregateBatch.h"
+
+static WindAggregationPyramid pyramid;
+static uint32_t nowMs;
+
+static const uint32_t TICK_MS = 250;
+static const uint32_t TICKS_PER_MINUTE = 60000 / TICK_MS;
+
+void setUp()
+{
+    pyramid.reset();
+    nowMs = 0;
+}
+
+void tearDown() {}
+
+/**
+ * @return Bit mask of the levels closed by the last tick
+ */
+static uint8_t addTicks(uint32_t count, uint32_t pulses, float direction, float windowMean = -1.0f)
+{
+    uint8_t closed = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        nowMs += TICK_MS;
+        closed = pyramid.addTick(nowMs, pulses, TICK_MS, direction, windowMean);
+    }
+    return closed;
+}
+
+void test_levels_close_at_their_duration()
+{
+    TEST_ASSERT_EQUAL_UINT8(0, addTicks(3, 1, 90.0f));
+    TEST_ASSERT_EQUAL_UINT8(1u << WindAggregationPyramid::LEVEL_1S, addTicks(1, 1, 90.0f));
+
+    addTicks(TICKS_PER_MINUTE - 5, 1, 90.0f);
+    TEST_ASSERT_EQUAL_UINT32(0, pyramid.latest(WindAggregationPyramid::LEVEL_1MIN).sequence);
+    uint8_t closed = addTicks(1, 1, 90.0f);
+    TEST_ASSERT_EQUAL_UINT8((1u << WindAggregationPyramid::LEVEL_1S) | (1u << WindAggregationPyramid::LEVEL_1MIN),
+                            closed);
+
+    const WindAggregate &minute = pyramid.latest(WindAggregationPyramid::LEVEL_1MIN);
+    TEST_ASSERT_EQUAL_UINT32(1, minute.sequence);
+    TEST_ASSERT_EQUAL_UINT32(60000, minute.durationMs);
+    TEST_ASSERT_EQUAL_UINT32(TICKS_PER_MINUTE, minute.count);
+    TEST_ASSERT_EQUAL_UINT32(60000, minute.endMs);
+}
+
+void test_ten_minutes_close_with_the_tenth_minute()
+{
+    addTicks(9 * TICKS_PER_MINUTE, 1, 0.0f);
+    TEST_ASSERT_EQUAL_UINT32(9, pyramid.latest(WindAggregationPyramid::LEVEL_1MIN).sequence);
+    TEST_ASSERT_EQUAL_UINT32(0, pyramid.latest(WindAggregationPyramid::LEVEL_10MIN).sequence);
+
+    uint8_t closed = addTicks(TICKS_PER_MINUTE, 1, 0.0f);
+    TEST_ASSERT_EQUAL_UINT8(0x07, closed);
+    const WindAggregate &tenMin = pyramid.latest(WindAggregationPyramid::LEVEL_10MIN);
+    TEST_ASSERT_EQUAL_UINT32(1, tenMin.sequence);
+    TEST_ASSERT_EQUAL_UINT32(600000, tenMin.durationMs);
+    TEST_ASSERT_EQUAL_UINT32(10 * TICKS_PER_MINUTE, tenMin.count);
+}
+
+void test_ten_minute_mean_covers_all_pulses()
+{
+    // One windy minute, then calm: the 10 min bucket holds the merged pulse sums
+    addTicks(TICKS_PER_MINUTE, 4, 0.0f);
+    addTicks(9 * TICKS_PER_MINUTE, 0, 0.0f);
+
+    float oneMinute = WindMath::pulsesToSpeed(4 * TICKS_PER_MINUTE, 60000);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, pyramid.latest(WindAggregationPyramid::LEVEL_1MIN).avgSpeed);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, oneMinute / 10.0f, pyramid.latest(WindAggregationPyramid::LEVEL_10MIN).avgSpeed);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, WindMath::pulsesToSpeed(4 * TICKS_PER_MINUTE, 600000),
+                             pyramid.latest(WindAggregationPyramid::LEVEL_10MIN).avgSpeed);
+}
+
+void test_direction_is_the_vector_mean_across_north()
+{
+    addTicks(TICKS_PER_MINUTE / 2, 1, 350.0f);
+    addTicks(TICKS_PER_MINUTE / 2, 1, 10.0f);
+
+    float direction = pyramid.latest(WindAggregationPyramid::LEVEL_1MIN).avgDirection;
+    // 0°, not the arithmetic mean of 180°
+    TEST_ASSERT_TRUE(direction < 0.1f || direction > 359.9f);
+}
+
+void test_gust_and_lull_merge_across_levels()
+{
+    addTicks(TICKS_PER_MINUTE, 1, 0.0f, 3.0f);
+    addTicks(TICKS_PER_MINUTE, 1, 0.0f, 7.5f);
+    addTicks(8 * TICKS_PER_MINUTE, 1, 0.0f, 1.5f);
+
+    const WindAggregate &minute = pyramid.latest(WindAggregationPyramid::LEVEL_1MIN);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, minute.gust);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, minute.lull);
+
+    const WindAggregate &tenMin = pyramid.latest(WindAggregationPyramid::LEVEL_10MIN);
+    TEST_ASSERT_EQUAL_FLOAT(7.5f, tenMin.gust);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, tenMin.lull);
+}
+
+void test_gust_falls_back_to_the_mean_without_a_window()
+{
+    addTicks(TICKS_PER_MINUTE, 2, 0.0f);
+
+    const WindAggregate &minute = pyramid.latest(WindAggregationPyramid::LEVEL_1MIN);
+    TEST_ASSERT_EQUAL_FLOAT(minute.avgSpeed, minute.gust);
+    TEST_ASSERT_EQUAL_FLOAT(minute.avgSpeed, minute.lull);
+}
+
+void test_zero_length_tick_is_ignored()
+{
+    TEST_ASSERT_EQUAL_UINT8(0, pyramid.addTick(100, 5, 0, 0.0f, -1.0f));
+    addTicks(4, 0, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f, pyramid.latest(WindAggregationPyramid::LEVEL_1S).avgSpeed);
+}
+
+void test_batch_drops_the_oldest_bucket_when_full()
+{
+    WindAggregateBatch batch;
+    WindAggregateEntry entry;
+    entry.levelMinutes = 1;
+    for (uint8_t i = 1; i <= WindAggregateBatch::CAPACITY; i++)
+    {
+        entry.aggregate.sequence = i;
+        TEST_ASSERT_TRUE(batch.add(entry));
+    }
+
+    entry.aggregate.sequence = WindAggregateBatch::CAPACITY + 1;
+    TEST_ASSERT_FALSE(batch.add(entry));
+    TEST_ASSERT_EQUAL_UINT8(WindAggregateBatch::CAPACITY, batch.size());
+    TEST_ASSERT_EQUAL_UINT32(2, batch.at(0).aggregate.sequence);
+    TEST_ASSERT_EQUAL_UINT32(WindAggregateBatch::CAPACITY + 1, batch.at(batch.size() - 1).aggregate.sequence);
+
+    batch.clear();
+    TEST_ASSERT_TRUE(batch.isEmpty());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_levels_close_at_their_duration);
+    RUN_TEST(test_ten_minutes_close_with_the_tenth_minute);
+    RUN_TEST(test_ten_minute_mean_covers_all_pulses);
+    RUN_TEST(test_direction_is_the_vector_mean_across_north);
+    RUN_TEST(test_gust_and_lull_merge_across_levels);
+    RUN_TEST(test_gust_falls_back_to_the_mean_without_a_window);
+    RUN_TEST(test_zero_length_tick_is_ignored);
+    RUN_TEST(test_batch_drops_the_oldest_bucket_when_full);
+    return UNITY_END();
+}
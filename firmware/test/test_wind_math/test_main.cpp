@@ -0,0 +1,113 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the wind speed conversions, driven through FakePulseSource
+ */
+
+#include <unity.h>
+#include "sensors/PulseSource.h"
+#include "sensors/WindMath.h"
+
+static FakePulseSource source;
+
+void setUp()
+{
+    source.begin(0);
+}
+
+void tearDown()
+{
+    source.end();
+}
+
+/**
+ * @brief Speed over a period measured like WindSensor: two readings of the total
+ */
+static float measure(uint32_t pulses, uint32_t elapsedMs)
+{
+    uint32_t before = source.readTotal();
+    source.addPulses(pulses);
+    return WindMath::pulsesToSpeed(WindMath::pulseDelta(before, source.readTotal()), elapsedMs);
+}
+
+void test_one_pulse_per_second_is_the_anemometer_factor()
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, WindMath::ANEMOMETER_FACTOR, measure(1, 1000));
+}
+
+void test_speed_scales_with_pulse_rate()
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0001f, measure(3, 1000));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.0001f, measure(6, 2000));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.3334f, measure(1, 500));
+}
+
+void test_no_pulses_is_calm()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, measure(0, 1000));
+}
+
+void test_empty_period_is_calm()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, measure(5, 0));
+}
+
+void test_pulse_delta_across_32_bit_wrap()
+{
+    TEST_ASSERT_EQUAL_UINT32(5, WindMath::pulseDelta(0xFFFFFFFEUL, 3));
+    TEST_ASSERT_EQUAL_UINT32(1, WindMath::pulseDelta(0xFFFFFFFFUL, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, WindMath::pulseDelta(0xFFFFFFFFUL, 0xFFFFFFFFUL));
+}
+
+void test_speed_across_counter_wrap()
+{
+    source.addPulses(0xFFFFFFFDUL);
+
+    // The total wraps from 0xFFFFFFFD to 4 during this period
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.6669f, measure(7, 1000));
+    TEST_ASSERT_EQUAL_UINT32(4, source.readTotal());
+}
+
+void test_pulses_are_ignored_while_stopped()
+{
+    source.addPulses(10);
+    source.end();
+    source.addPulses(10);
+    source.addPulseAt(1000);
+    TEST_ASSERT_EQUAL_UINT32(10, source.readTotal());
+}
+
+void test_begin_restarts_the_total()
+{
+    source.addPulses(10);
+    source.begin(0);
+    TEST_ASSERT_EQUAL_UINT32(0, source.readTotal());
+}
+
+void test_timestamped_pulses_are_counted_and_queued()
+{
+    source.addPulseAt(1000);
+    source.addPulseAt(251000);
+
+    TEST_ASSERT_EQUAL_UINT32(2, source.readTotal());
+    uint32_t timestampUs;
+    TEST_ASSERT_TRUE(source.timestamps()->pop(timestampUs));
+    TEST_ASSERT_EQUAL_UINT32(1000, timestampUs);
+    TEST_ASSERT_TRUE(source.timestamps()->pop(timestampUs));
+    TEST_ASSERT_EQUAL_UINT32(251000, timestampUs);
+    TEST_ASSERT_FALSE(source.timestamps()->pop(timestampUs));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_one_pulse_per_second_is_the_anemometer_factor);
+    RUN_TEST(test_speed_scales_with_pulse_rate);
+    RUN_TEST(test_no_pulses_is_calm);
+    RUN_TEST(test_empty_period_is_calm);
+    RUN_TEST(test_pulse_delta_across_32_bit_wrap);
+    RUN_TEST(test_speed_across_counter_wrap);
+    RUN_TEST(test_pulses_are_ignored_while_stopped);
+    RUN_TEST(test_begin_restarts_the_total);
+    RUN_TEST(test_timestamped_pulses_are_counted_and_queued);
+    return UNITY_END();
+}
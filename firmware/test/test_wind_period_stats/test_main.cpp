@@ -0,0 +1,128 @@
+/**
+ * @file test_main.cpp
+ * @brief Host tests of the single-pass wind statistics of an averaging period
+ */
+
+#include <unity.h>
+#include "sensors/WindPeriodStats.h"
+
+static WindPeriodStats stats;
+
+void setUp()
+{
+    stats.reset();
+}
+
+void tearDown() {}
+
+/**
+ * @brief Angle between two directions, 0-180 degrees
+ */
+static float angleBetween(float a, float b)
+{
+    float difference = fmodf(fabsf(a - b), 360.0f);
+    return difference > 180.0f ? 360.0f - difference : difference;
+}
+
+void test_empty_period_is_all_zero()
+{
+    TEST_ASSERT_EQUAL_UINT32(0, stats.count());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.speedMean());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.speedStdDev());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.directionMean());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.directionStdDev());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.resultantSpeed());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.persistence());
+}
+
+void test_speed_mean_and_standard_deviation()
+{
+    const float speeds[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    for (float speed : speeds)
+    {
+        stats.addSample(speed, 90.0f);
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, stats.count());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 5.0f, stats.speedMean());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, stats.speedStdDev());
+}
+
+void test_welford_is_stable_with_a_large_offset()
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        stats.addSample(i % 2 ? 1000.1f : 999.9f, 0.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f, stats.speedMean());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.1f, stats.speedStdDev());
+}
+
+void test_steady_wind_is_fully_persistent()
+{
+    for (int i = 0; i < 10; i++)
+    {
+        stats.addSample(6.0f, 225.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 225.0f, stats.directionMean());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 225.0f, stats.resultantDirection());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 6.0f, stats.resultantSpeed());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, stats.persistence());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, stats.directionStdDev());
+}
+
+void test_mean_direction_across_north()
+{
+    stats.addSample(5.0f, 350.0f);
+    stats.addSample(5.0f, 10.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, angleBetween(0.0f, stats.directionMean()));
+    TEST_ASSERT_LESS_THAN(360.0f, stats.directionMean());
+}
+
+void test_yamartino_direction_standard_deviation()
+{
+    for (int i = 0; i < 100; i++)
+    {
+        stats.addSample(5.0f, i % 2 ? 80.0f : 100.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 10.0f, stats.directionStdDev());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, stats.directionMean());
+}
+
+void test_opposite_winds_cancel_out()
+{
+    stats.addSample(4.0f, 90.0f);
+    stats.addSample(4.0f, 270.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.0f, stats.speedMean());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, stats.resultantSpeed());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, stats.persistence());
+}
+
+void test_calm_samples_barely_move_the_resultant_direction()
+{
+    stats.addSample(10.0f, 90.0f);
+    stats.addSample(0.0f, 270.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, stats.resultantDirection());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 5.0f, stats.resultantSpeed());
+}
+
+void test_calm_period_has_no_persistence()
+{
+    stats.addSample(0.0f, 0.0f);
+    stats.addSample(0.0f, 0.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.persistence());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_period_is_all_zero);
+    RUN_TEST(test_speed_mean_and_standard_deviation);
+    RUN_TEST(test_welford_is_stable_with_a_large_offset);
+    RUN_TEST(test_steady_wind_is_fully_persistent);
+    RUN_TEST(test_mean_direction_across_north);
+    RUN_TEST(test_yamartino_direction_standard_deviation);
+    RUN_TEST(test_opposite_winds_cancel_out);
+    RUN_TEST(test_calm_samples_barely_move_the_resultant_direction);
+    RUN_TEST(test_calm_period_has_no_persistence);
+    return UNITY_END();
+}
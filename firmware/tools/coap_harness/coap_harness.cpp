@@ -0,0 +1,504 @@
+/**
+ * @file coap_harness.cpp
+ * @brief Local CoAP server and client for measuring the telemetry exchange on Linux
+ *
+ * Built on the firmware's own CoapMessage.h and CoapExchange.h, with the
+ * retransmission settings of Config.h, so the exchange measured here is
+ * the one the station runs; only the socket differs (a host UDP socket
+ * instead of the modem's). Loss is simulated per datagram and direction.
+ *
+ *   coap_harness server   [--port 5683] [--loss 0.2] [--seed 1]
+ *   coap_harness client   [--host 127.0.0.1] [--port 5683] [--count 20] [--interval 1000] [--loss 0.2]
+ *   coap_harness selftest [--count 50] [--loss 0.2]
+ *
+ * The server acknowledges each confirmable POST with a piggybacked 2.04
+ * and recognizes retransmissions by message ID (EXCHANGE_LIFETIME), so it
+ * records each message once and answers a retransmission with the cached
+ * ACK. The client posts livestream wind readings like the station and
+ * reports per exchange the round trip and the transmissions it took, and
+ * in total the datagrams each way. selftest runs both over loopback and
+ * fails if a message was recorded twice or, without loss, not delivered.
+ *
+ * Build, from firmware/:
+ *
+ *   g++ -std=c++17 -O2 -pthread -o coap_harness tools/coap_harness/coap_harness.cpp
+ */
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../src/config/Config.h"
+#include "../../src/core/CoapExchange.h"
+#include "../../src/core/CoapMessage.h"
+#include "../../src/core/JsonPayloads.h"
+
+namespace
+{
+    // RFC 7252 EXCHANGE_LIFETIME: how long a message ID marks a retransmission
+    const uint32_t EXCHANGE_LIFETIME_MS = 247000;
+    const int RECEIVE_TIMEOUT_MS = 10;
+
+    uint32_t nowMs()
+    {
+        using namespace std::chrono;
+        return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct Options
+    {
+        std::string mode;
+        std::string host = "127.0.0.1";
+        uint16_t port = COAP_PORT;
+        unsigned count = 20;
+        unsigned intervalMs = 1000;
+        double loss = 0.0;
+        unsigned seed = 1;
+        std::string path = "api/stations/harness/wind";
+    };
+
+    /**
+     * @brief UDP socket that drops datagrams at random, each direction on its own
+     */
+    class LossySocket
+    {
+    public:
+        LossySocket(double loss, unsigned seed) : _loss(loss), _random(seed) {}
+        ~LossySocket()
+        {
+            if (_fd >= 0)
+            {
+                close(_fd);
+            }
+        }
+
+        bool bind(uint16_t port)
+        {
+            _fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if (_fd < 0)
+            {
+                return false;
+            }
+            timeval timeout = {0, RECEIVE_TIMEOUT_MS * 1000};
+            setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+            address.sin_port = htons(port);
+            return ::bind(_fd, (sockaddr *)&address, sizeof(address)) == 0;
+        }
+
+        uint16_t localPort() const
+        {
+            sockaddr_in address = {};
+            socklen_t length = sizeof(address);
+            getsockname(_fd, (sockaddr *)&address, &length);
+            return ntohs(address.sin_port);
+        }
+
+        void sendTo(const uint8_t *data, size_t length, const sockaddr_in &to)
+        {
+            sent++;
+            if (_lost())
+            {
+                droppedSent++;
+                return;
+            }
+            sendto(_fd, data, length, 0, (const sockaddr *)&to, sizeof(to));
+        }
+
+        /**
+         * @return Length of the datagram received within RECEIVE_TIMEOUT_MS, 0 if none or dropped
+         */
+        size_t receive(uint8_t *buffer, size_t capacity, sockaddr_in &from)
+        {
+            socklen_t fromLength = sizeof(from);
+            ssize_t length = recvfrom(_fd, buffer, capacity, 0, (sockaddr *)&from, &fromLength);
+            if (length <= 0)
+            {
+                return 0;
+            }
+            received++;
+            if (_lost())
+            {
+                droppedReceived++;
+                return 0;
+            }
+            return (size_t)length;
+        }
+
+        unsigned sent = 0;            // Datagrams put on the wire, dropped ones included
+        unsigned received = 0;        // Datagrams that arrived, dropped ones included
+        unsigned droppedSent = 0;     // Lost on the way out
+        unsigned droppedReceived = 0; // Lost on the way in
+
+    private:
+        int _fd = -1;
+        double _loss;
+        std::mt19937 _random;
+
+        bool _lost() { return _loss > 0 && std::uniform_real_distribution<double>(0, 1)(_random) < _loss; }
+    };
+
+    class Server
+    {
+    public:
+        Server(double loss, unsigned seed) : _socket(loss, seed) {}
+
+        bool open(uint16_t port) { return _socket.bind(port); }
+
+        uint16_t port() const { return _socket.localPort(); }
+
+        void run(const std::atomic<bool> &stop, bool verbose)
+        {
+            uint8_t datagram[COAP_DATAGRAM_MAX];
+            while (!stop)
+            {
+                sockaddr_in from = {};
+                size_t length = _socket.receive(datagram, sizeof(datagram), from);
+                if (length > 0)
+                {
+                    _handle(datagram, length, from, verbose);
+                }
+            }
+        }
+
+        void printStats() const
+        {
+            printf("server: %u datagrams in (%u lost), %u out (%u lost), %u messages recorded, %u retransmissions "
+                   "recognized, %u malformed\n",
+                   _socket.received, _socket.droppedReceived, _socket.sent, _socket.droppedSent, recorded,
+                   duplicates, malformed);
+        }
+
+        unsigned recorded = 0;
+        unsigned duplicates = 0;
+        unsigned malformed = 0;
+        unsigned recordedTwice = 0; // Must stay 0: a message ID processed again within its lifetime
+
+    private:
+        struct Seen
+        {
+            uint32_t atMs;
+            std::vector<uint8_t> reply;
+        };
+
+        LossySocket _socket;
+        std::map<std::pair<uint64_t, uint16_t>, Seen> _seen; // By sender and message ID
+        std::map<std::pair<uint64_t, uint16_t>, unsigned> _records;
+
+        void _handle(const uint8_t *data, size_t length, const sockaddr_in &from, bool verbose)
+        {
+            Coap::Message message;
+            char path[128];
+            if (!Coap::parse(data, length, message, path, sizeof(path)))
+            {
+                malformed++;
+                return;
+            }
+            if (message.type != Coap::CONFIRMABLE)
+            {
+                return; // ACKs and resets of the client; the server sends nothing confirmable
+            }
+
+            uint64_t sender = (uint64_t)from.sin_addr.s_addr << 16 | from.sin_port;
+            auto key = std::make_pair(sender, message.messageId);
+            uint32_t now = nowMs();
+            for (auto it = _seen.begin(); it != _seen.end();)
+            {
+                it = now - it->second.atMs >= EXCHANGE_LIFETIME_MS ? _seen.erase(it) : std::next(it);
+            }
+
+            auto seen = _seen.find(key);
+            if (seen != _seen.end())
+            {
+                duplicates++;
+                _socket.sendTo(seen->second.reply.data(), seen->second.reply.size(), from);
+                return;
+            }
+
+            uint8_t reply[Coap::HEADER_SIZE + Coap::TOKEN_MAX];
+            size_t replyLength;
+            if (message.code == Coap::CODE_POST)
+            {
+                recorded++;
+                if (++_records[key] > 1)
+                {
+                    recordedTwice++;
+                }
+                if (verbose)
+                {
+                    printf("POST /%s message %u, format %u: %.*s\n", path, message.messageId, message.contentFormat,
+                           (int)message.payloadLength, (const char *)message.payload);
+                }
+                replyLength = Coap::writeReply(reply, sizeof(reply), Coap::ACKNOWLEDGEMENT, Coap::CODE_CHANGED,
+                                               message.messageId, message.token, message.tokenLength);
+            }
+            else
+            {
+                replyLength = Coap::writeReply(reply, sizeof(reply), Coap::RESET, Coap::CODE_EMPTY, message.messageId);
+            }
+            _seen[key] = Seen{now, std::vector<uint8_t>(reply, reply + replyLength)};
+            _socket.sendTo(reply, replyLength, from);
+        }
+    };
+
+    class Client
+    {
+    public:
+        Client(double loss, unsigned seed)
+            : _socket(loss, seed + 1), _random(seed + 2),
+              _exchange(COAP_ACK_TIMEOUT_MS, COAP_ACK_RANDOM_FACTOR_PERCENT, COAP_MAX_RETRANSMIT)
+        {
+        }
+
+        bool open(const std::string &host, uint16_t port)
+        {
+            addrinfo hints = {};
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_DGRAM;
+            addrinfo *result = nullptr;
+            if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result)
+            {
+                return false;
+            }
+            _server = *(sockaddr_in *)result->ai_addr;
+            _server.sin_port = htons(port);
+            freeaddrinfo(result);
+            return _socket.bind(0);
+        }
+
+        void run(unsigned count, unsigned intervalMs, const std::string &path)
+        {
+            _messageId = (uint16_t)_random();
+            for (unsigned i = 0; i < count; i++)
+            {
+                uint32_t startMs = nowMs();
+                _post(i, path);
+                uint32_t spentMs = nowMs() - startMs;
+                if (i + 1 < count && spentMs < intervalMs)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs - spentMs));
+                }
+            }
+        }
+
+        void printStats() const
+        {
+            printf("client: %u exchanges, %u delivered, %u given up, %u retransmissions\n", exchanges, delivered,
+                   timeouts, retransmissions);
+            printf("client: %u datagrams out (%u lost), %u in (%u lost), %.2f datagrams per delivered reading\n",
+                   _socket.sent, _socket.droppedSent, _socket.received, _socket.droppedReceived,
+                   delivered ? (double)(_socket.sent + _socket.received) / delivered : 0.0);
+            printf("client: round trip %.1f ms average, %u ms longest; max transmit wait %u ms\n",
+                   delivered ? (double)_totalRoundTripMs / delivered : 0.0, _longestRoundTripMs,
+                   _exchange.maxWaitMs());
+        }
+
+        unsigned exchanges = 0;
+        unsigned delivered = 0;
+        unsigned timeouts = 0;
+        unsigned retransmissions = 0;
+
+    private:
+        LossySocket _socket;
+        std::mt19937 _random;
+        CoapExchange _exchange;
+        sockaddr_in _server = {};
+        uint16_t _messageId = 0;
+        uint64_t _totalRoundTripMs = 0;
+        uint32_t _longestRoundTripMs = 0;
+
+        void _post(unsigned index, const std::string &path)
+        {
+            char body[JsonPayloads::WIND_READING_MAX];
+            size_t bodyLength = JsonPayloads::writeWindReading(body, sizeof(body), 5.0f + (index % 10) * 0.5f,
+                                                               (float)(index * 37 % 360));
+            uint32_t random = _random();
+            uint8_t token[4];
+            memcpy(token, &random, sizeof(token));
+
+            uint8_t datagram[COAP_DATAGRAM_MAX];
+            uint16_t messageId = _messageId++;
+            size_t length = Coap::writePost(datagram, sizeof(datagram), messageId, token, sizeof(token), path.c_str(),
+                                            Coap::FORMAT_JSON, (const uint8_t *)body, bodyLength);
+
+            exchanges++;
+            _socket.sendTo(datagram, length, _server);
+            _exchange.start(messageId, nowMs(), (uint16_t)(random >> 16));
+
+            uint8_t reply[COAP_DATAGRAM_MAX];
+            while (_exchange.isActive())
+            {
+                sockaddr_in from = {};
+                size_t replyLength = _socket.receive(reply, sizeof(reply), from);
+                Coap::Message message;
+                if (replyLength > 0 && Coap::parse(reply, replyLength, message) && _exchange.accept(message))
+                {
+                    uint32_t roundTripMs = _exchange.elapsedMs(nowMs());
+                    bool ok = message.type == Coap::ACKNOWLEDGEMENT;
+                    delivered += ok;
+                    _totalRoundTripMs += ok ? roundTripMs : 0;
+                    _longestRoundTripMs = ok && roundTripMs > _longestRoundTripMs ? roundTripMs : _longestRoundTripMs;
+                    printf("#%u message %u: %s %d after %u transmissions, %u ms\n", index, messageId,
+                           ok ? "ACK" : "RST", Coap::statusCode(message.code), _exchange.transmissions(), roundTripMs);
+                    return;
+                }
+
+                switch (_exchange.check(nowMs()))
+                {
+                case CoapExchange::RETRANSMIT:
+                    retransmissions++;
+                    _socket.sendTo(datagram, length, _server);
+                    break;
+                case CoapExchange::GIVE_UP:
+                    timeouts++;
+                    printf("#%u message %u: no ACK after %u transmissions\n", index, messageId,
+                           _exchange.transmissions());
+                    return;
+                default:
+                    break;
+                }
+            }
+        }
+    };
+
+    bool parseOptions(int argc, char **argv, Options &options)
+    {
+        if (argc < 2)
+        {
+            return false;
+        }
+        options.mode = argv[1];
+        for (int i = 2; i + 1 < argc; i += 2)
+        {
+            std::string name = argv[i];
+            const char *value = argv[i + 1];
+            if (name == "--host")
+                options.host = value;
+            else if (name == "--port")
+                options.port = (uint16_t)atoi(value);
+            else if (name == "--count")
+                options.count = (unsigned)atoi(value);
+            else if (name == "--interval")
+                options.intervalMs = (unsigned)atoi(value);
+            else if (name == "--loss")
+                options.loss = atof(value);
+            else if (name == "--seed")
+                options.seed = (unsigned)atoi(value);
+            else if (name == "--path")
+                options.path = value;
+            else
+                return false;
+        }
+        return options.mode == "server" || options.mode == "client" || options.mode == "selftest";
+    }
+
+    int runServer(const Options &options)
+    {
+        Server server(options.loss, options.seed);
+        if (!server.open(options.port))
+        {
+            perror("bind");
+            return 1;
+        }
+        printf("Listening on UDP %u, loss %.0f%%\n", server.port(), options.loss * 100);
+        static std::atomic<bool> stop(false);
+        std::thread statsThread([&]() {
+            // Periodic totals; the server runs until killed
+            while (!stop)
+            {
+                std::this_thread::sleep_for(std::chrono::seconds(10));
+                server.printStats();
+            }
+        });
+        server.run(stop, true);
+        statsThread.join();
+        return 0;
+    }
+
+    int runClient(const Options &options)
+    {
+        Client client(options.loss, options.seed);
+        if (!client.open(options.host, options.port))
+        {
+            fprintf(stderr, "Cannot reach %s\n", options.host.c_str());
+            return 1;
+        }
+        client.run(options.count, options.intervalMs, options.path);
+        client.printStats();
+        return client.delivered == client.exchanges ? 0 : 1;
+    }
+
+    int runSelftest(const Options &options)
+    {
+        Server server(options.loss, options.seed);
+        if (!server.open(0))
+        {
+            perror("bind");
+            return 1;
+        }
+        std::atomic<bool> stop(false);
+        std::thread serverThread([&]() { server.run(stop, false); });
+
+        Client client(options.loss, options.seed);
+        bool opened = client.open("127.0.0.1", server.port());
+        if (opened)
+        {
+            client.run(options.count, 0, options.path);
+        }
+        stop = true;
+        serverThread.join();
+        if (!opened)
+        {
+            fprintf(stderr, "Cannot open the client socket\n");
+            return 1;
+        }
+
+        client.printStats();
+        server.printStats();
+        bool ok = server.recordedTwice == 0 && server.recorded <= client.exchanges &&
+                  (options.loss > 0 || client.delivered == client.exchanges);
+        printf("selftest %s\n", ok ? "passed" : "FAILED");
+        return ok ? 0 : 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        fprintf(stderr,
+                "usage: %s server|client|selftest [--host H] [--port P] [--count N] [--interval MS] [--loss 0..1] "
+                "[--seed S] [--path P]\n",
+                argv[0]);
+        return 2;
+    }
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    if (options.mode == "server")
+    {
+        return runServer(options);
+    }
+    if (options.mode == "client")
+    {
+        return runClient(options);
+    }
+    return runSelftest(options);
+}